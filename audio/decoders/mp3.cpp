@@ -23,16 +23,21 @@
 
 #ifdef USE_MAD
 
+#include "common/array.h"
+#include "common/config-manager.h"
 #include "common/debug.h"
+#include "common/endian.h"
 #include "common/mutex.h"
 #include "common/ptr.h"
 #include "common/queue.h"
 #include "common/stream.h"
 #include "common/substream.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 #include "common/util.h"
 
 #include "audio/audiostream.h"
+#include "audio/decoders/mp3index.h"
 
 #include <mad.h>
 
@@ -66,6 +71,12 @@ protected:
 
 	int fillBuffer(Common::ReadStream &stream, int16 *buffer, const int numSamples);
 
+	/**
+	 * Called by readHeader() for every frame header it decodes, before the
+	 * frame's duration is added to _curTime.
+	 */
+	virtual void headerDecoded() {}
+
 	enum State {
 		MP3_STATE_INIT,	// Need to init the decoder
 		MP3_STATE_READY,	// ready for processing data
@@ -102,12 +113,44 @@ public:
 	Timestamp getLength() const override { return _length; }
 
 protected:
+	void headerDecoded() override;
+
 	Common::ScopedPtr<Common::SeekableReadStream> _inStream;
 
 	Timestamp _length;
 
 private:
+	enum {
+		kIndexInterval = 16,		///< Frames between two entries of the seek index
+		kIndexCacheMinLength = 60	///< Minimum length in seconds of streams whose index is cached
+	};
+
+	/** An approximate seek point from a Xing or VBRI table of contents. */
+	struct TocEntry {
+		uint32 offset;
+		uint32 sample;
+	};
+
 	static Common::SeekableReadStream *skipID3(Common::SeekableReadStream *stream, DisposeAfterUse::Flag dispose);
+
+	uint32 getFrameOffset() const;
+	bool readInfoHeader(uint32 &frames);
+	void readXingToc(const byte *toc, uint32 frames, uint32 bytes);
+	void readVbriToc(const byte *toc, uint16 entries, uint16 entrySize, uint16 scale, uint16 framesPerEntry);
+
+	void seekToOffset(uint32 offset, uint32 sample, int32 frame);
+	bool isBetween(uint32 sample, const mad_timer_t &destination) const;
+
+	bool loadIndex();
+	void saveIndex();
+
+	uint32 _samplesPerFrame;
+	Common::Array<uint32> _index;	///< Offsets of every kIndexInterval-th frame, starting with the first
+	uint32 _indexedFrames;			///< Number of frames covered by _index
+	bool _indexComplete;			///< Whether _index covers the whole stream
+	int32 _curFrame;				///< Number of the frame readHeader() reads next, or -1 if unknown
+	Common::Array<TocEntry> _toc;
+	MP3SeekIndexKey _indexCacheKey;	///< Invalid unless the index of the stream may be cached
 };
 
 class PacketizedMP3Stream : private BaseMP3Stream, public PacketizedAudioStream {
@@ -268,6 +311,8 @@ void BaseMP3Stream::readHeader(Common::ReadStream &stream) {
 			}
 		}
 
+		headerDecoded();
+
 		// Sum up the total playback time so far
 		mad_timer_add(&_curTime, _frame.header.duration);
 		break;
@@ -328,41 +373,205 @@ int BaseMP3Stream::fillBuffer(Common::ReadStream &stream, int16 *buffer, const i
 MP3Stream::MP3Stream(Common::SeekableReadStream *inStream, DisposeAfterUse::Flag dispose) :
 		BaseMP3Stream(),
 		_inStream(skipID3(inStream, dispose)),
-		_length(0, 1000) {
+		_length(0, 1000),
+		_samplesPerFrame(0),
+		_indexedFrames(0),
+		_indexComplete(false),
+		_curFrame(-1) {
+
+	// Only the constructor uses the index cache, as seek() may be called
+	// from the mixer thread. Small streams are never cached.
+	if (ConfMan.getBool("mp3_seek_index_cache"))
+		_indexCacheKey = MP3SeekIndexCache::computeKey(*_inStream);
 
 	// Initialize the stream with some data and set the channels and rate
 	// variables
 	decodeMP3Data(*_inStream);
 	_channels = MAD_NCHANNELS(&_frame.header);
 	_rate = _frame.header.samplerate;
-
-	// Calculate the length of the stream
-	while (_state != MP3_STATE_EOS)
-		readHeader(*_inStream);
-
-	// To rule out any invalid sample rate to be encountered here, say in case the
-	// MP3 stream is invalid, we just check the MAD error code here.
-	// We need to assure this, since else we might trigger an assertion in Timestamp
-	// (When getRate() returns 0 or a negative number to be precise).
-	// Note that we allow "MAD_ERROR_BUFLEN" as error code here, since according
-	// to mad.h it is also set on EOF.
-	if ((_stream.error == MAD_ERROR_NONE || _stream.error == MAD_ERROR_BUFLEN) && getRate() > 0)
-		_length = Timestamp(mad_timer_count(_curTime, MAD_UNITS_MILLISECONDS), getRate());
+	_samplesPerFrame = 32 * MAD_NSBSAMPLES(&_frame.header);
+
+	uint32 infoFrames;
+	if (_state == MP3_STATE_EOS || getRate() <= 0) {
+		// Invalid stream, leave the length at zero
+	} else if (loadIndex()) {
+		debug(3, "MP3Stream: Using the cached seek index of %u frames", _indexedFrames);
+	} else if (readInfoHeader(infoFrames)) {
+		// The info frame itself is decoded as a frame of silence. The frame
+		// count is the one written by the encoder, so the length is only
+		// approximate for streams cut or edited afterwards: playback then
+		// ends early, and seeking past the actual end fails. The encoder
+		// delay and padding of LAME headers are decoded, so they count.
+		_index.push_back(getFrameOffset());
+		_indexedFrames = 1;
+		_length = Timestamp(0, (infoFrames + 1) * _samplesPerFrame, getRate());
+	} else {
+		// Calculate the length of the stream, and index it on the way
+		_inStream->seek(0);
+		initStream(*_inStream);
+		_curFrame = 0;
+		while (_state != MP3_STATE_EOS)
+			readHeader(*_inStream);
+
+		// To rule out any invalid sample rate to be encountered here, say in case the
+		// MP3 stream is invalid, we just check the MAD error code here.
+		// We need to assure this, since else we might trigger an assertion in Timestamp
+		// (When getRate() returns 0 or a negative number to be precise).
+		// Note that we allow "MAD_ERROR_BUFLEN" as error code here, since according
+		// to mad.h it is also set on EOF.
+		if (_stream.error == MAD_ERROR_NONE || _stream.error == MAD_ERROR_BUFLEN) {
+			_length = Timestamp(mad_timer_count(_curTime, MAD_UNITS_MILLISECONDS), getRate());
+			_indexComplete = true;
+			saveIndex();
+		}
+	}
 
 	deinitStream();
 
 	// Reinit stream
 	_state = MP3_STATE_INIT;
 	_inStream->seek(0);
+	_curFrame = -1;
 
 	// Decode the first chunk of data to set up the stream again.
 	decodeMP3Data(*_inStream);
 }
 
 int MP3Stream::readBuffer(int16 *buffer, const int numSamples) {
+	// Frames decoded for playback are not counted
+	_curFrame = -1;
 	return fillBuffer(*_inStream, buffer, numSamples);
 }
 
+void MP3Stream::headerDecoded() {
+	if (_curFrame < 0)
+		return;
+
+	// Extend the index while scanning contiguously past its end
+	if ((uint32)_curFrame == _indexedFrames && !_indexComplete) {
+		if (_indexedFrames % kIndexInterval == 0)
+			_index.push_back(getFrameOffset());
+		_indexedFrames++;
+	}
+
+	_curFrame++;
+}
+
+uint32 MP3Stream::getFrameOffset() const {
+	// The end of the MAD buffer is the current position of the input stream
+	return _inStream->pos() - (_stream.bufend - _stream.this_frame);
+}
+
+bool MP3Stream::readInfoHeader(uint32 &frames) {
+	if (_frame.header.layer != MAD_LAYER_III || !_stream.this_frame || !_stream.next_frame)
+		return false;
+
+	const byte *frame = _stream.this_frame;
+	const uint32 frameSize = _stream.next_frame - _stream.this_frame;
+
+	// The Xing (VBR) or Info (CBR) header follows the side information
+	uint32 pos = 4;
+	if (_frame.header.flags & MAD_FLAG_LSF_EXT)
+		pos += (_channels == 2) ? 17 : 9;
+	else
+		pos += (_channels == 2) ? 32 : 17;
+
+	if (pos + 8 <= frameSize) {
+		const uint32 tag = READ_BE_UINT32(frame + pos);
+		if (tag == MKTAG('X', 'i', 'n', 'g') || tag == MKTAG('I', 'n', 'f', 'o')) {
+			const uint32 flags = READ_BE_UINT32(frame + pos + 4);
+			pos += 8;
+
+			const uint32 headerSize = ((flags & 1) ? 4 : 0) + ((flags & 2) ? 4 : 0) + ((flags & 4) ? 100 : 0);
+			if (!(flags & 1) || pos + headerSize > frameSize)
+				return false;
+
+			frames = READ_BE_UINT32(frame + pos);
+			pos += 4;
+
+			uint32 bytes = _inStream->size() - getFrameOffset();
+			if (flags & 2) {
+				bytes = READ_BE_UINT32(frame + pos);
+				pos += 4;
+			}
+
+			if (flags & 4)
+				readXingToc(frame + pos, frames, bytes);
+
+			debug(3, "MP3Stream: Xing header with %u frames, %u TOC entries", frames, _toc.size());
+			return true;
+		}
+	}
+
+	// The VBRI header always follows 32 bytes of side information
+	pos = 4 + 32;
+	if (pos + 26 <= frameSize && READ_BE_UINT32(frame + pos) == MKTAG('V', 'B', 'R', 'I')) {
+		frames = READ_BE_UINT32(frame + pos + 14);
+
+		const uint16 entries = READ_BE_UINT16(frame + pos + 18);
+		const uint16 scale = READ_BE_UINT16(frame + pos + 20);
+		const uint16 entrySize = READ_BE_UINT16(frame + pos + 22);
+		const uint16 framesPerEntry = READ_BE_UINT16(frame + pos + 24);
+		pos += 26;
+
+		if (entrySize >= 1 && entrySize <= 4 && pos + entries * entrySize <= frameSize)
+			readVbriToc(frame + pos, entries, entrySize, scale, framesPerEntry);
+
+		debug(3, "MP3Stream: VBRI header with %u frames, %u TOC entries", frames, _toc.size());
+		return true;
+	}
+
+	return false;
+}
+
+void MP3Stream::readXingToc(const byte *toc, uint32 frames, uint32 bytes) {
+	// Entry i holds the position at i percent of the playback time, in
+	// 1/256 of the stream size. Positions are relative to the info frame.
+	const uint32 start = getFrameOffset();
+	const uint64 samples = (uint64)frames * _samplesPerFrame;
+
+	_toc.resize(100);
+	for (uint i = 0; i < 100; i++) {
+		_toc[i].offset = start + (uint32)((uint64)toc[i] * bytes / 256);
+		_toc[i].sample = _samplesPerFrame + (uint32)(samples * i / 100);
+	}
+}
+
+void MP3Stream::readVbriToc(const byte *toc, uint16 entries, uint16 entrySize, uint16 scale, uint16 framesPerEntry) {
+	// Entry i holds the size of the i-th block of framesPerEntry frames,
+	// the first block starting after the info frame
+	uint32 offset = getFrameOffset() + (_stream.next_frame - _stream.this_frame);
+
+	_toc.resize(entries);
+	for (uint i = 0; i < entries; i++) {
+		_toc[i].offset = offset;
+		_toc[i].sample = _samplesPerFrame * (1 + i * framesPerEntry);
+
+		uint32 size = 0;
+		for (uint j = 0; j < entrySize; j++)
+			size = (size << 8) | *toc++;
+		offset += size * scale;
+	}
+}
+
+void MP3Stream::seekToOffset(uint32 offset, uint32 sample, int32 frame) {
+	_inStream->seek(offset);
+	initStream(*_inStream);
+	mad_timer_set(&_curTime, 0, sample, getRate());
+	_curFrame = frame;
+}
+
+bool MP3Stream::isBetween(uint32 sample, const mad_timer_t &destination) const {
+	// Whether continuing to read from the current position reaches the
+	// destination at least as fast as starting over at the given sample
+	if (_state != MP3_STATE_READY || mad_timer_compare(destination, _curTime) < 0)
+		return false;
+
+	mad_timer_t time;
+	mad_timer_set(&time, 0, sample, getRate());
+	return mad_timer_compare(_curTime, time) >= 0;
+}
+
 bool MP3Stream::seek(const Timestamp &where) {
 	if (where == _length) {
 		_state = MP3_STATE_EOS;
@@ -376,19 +585,83 @@ bool MP3Stream::seek(const Timestamp &where) {
 	mad_timer_t destination;
 	mad_timer_set(&destination, time / 1000, time % 1000, 1000);
 
-	if (_state != MP3_STATE_READY || mad_timer_compare(destination, _curTime) < 0) {
-		_inStream->seek(0);
-		initStream(*_inStream);
+	const uint32 sample = where.convertToFramerate(getRate()).totalNumberOfFrames();
+	const uint32 frame = _samplesPerFrame ? sample / _samplesPerFrame : 0;
+
+	if (_index.empty()) {
+		if (_state != MP3_STATE_READY || mad_timer_compare(destination, _curTime) < 0)
+			seekToOffset(0, 0, -1);
+	} else if (frame < _indexedFrames || _toc.empty()) {
+		// Start at the closest indexed frame. When seeking past the end of
+		// the index, its last frame is used and the index grows on the way.
+		const uint32 entry = MIN<uint32>(frame, _indexedFrames - 1) / kIndexInterval;
+		const uint32 entryFrame = entry * kIndexInterval;
+		if (!isBetween(entryFrame * _samplesPerFrame, destination))
+			seekToOffset(_index[entry], entryFrame * _samplesPerFrame, entryFrame);
+	} else {
+		// Start at the closest table of contents entry. Its time is only
+		// approximate, so the frame number is unknown from here on.
+		uint lo = 0, hi = _toc.size();
+		while (hi - lo > 1) {
+			const uint mid = (lo + hi) / 2;
+			if (_toc[mid].sample <= sample)
+				lo = mid;
+			else
+				hi = mid;
+		}
+
+		const TocEntry &entry = _toc[lo];
+		if (entry.sample > sample) {
+			if (!isBetween(0, destination))
+				seekToOffset(_index[0], 0, 0);
+		} else if (!isBetween(entry.sample, destination)) {
+			seekToOffset(entry.offset, entry.sample, -1);
+		}
 	}
 
 	while (mad_timer_compare(destination, _curTime) > 0 && _state != MP3_STATE_EOS)
 		readHeader(*_inStream);
 
+	// Reaching the end while scanning the index completes it. It is not
+	// cached from here, since this may run on the mixer thread.
+	if (_state == MP3_STATE_EOS && _curFrame >= 0 && (uint32)_curFrame == _indexedFrames && !_indexComplete)
+		_indexComplete = true;
+
+	_curFrame = -1;
 	decodeMP3Data(*_inStream);
 
 	return (_state != MP3_STATE_EOS);
 }
 
+bool MP3Stream::loadIndex() {
+	MP3SeekIndex index;
+	if (!MP3SeekIndexCache::load(_indexCacheKey, index))
+		return false;
+
+	if (index.rate != (uint32)getRate() || index.samplesPerFrame != _samplesPerFrame || index.interval != kIndexInterval)
+		return false;
+
+	_index.swap(index.offsets);
+	_indexedFrames = index.frames;
+	_indexComplete = true;
+	_length = Timestamp(index.lengthMs, getRate());
+	return true;
+}
+
+void MP3Stream::saveIndex() {
+	if (!_indexCacheKey.isValid() || _index.empty() || _length.secs() < kIndexCacheMinLength)
+		return;
+
+	MP3SeekIndex index;
+	index.rate = getRate();
+	index.samplesPerFrame = _samplesPerFrame;
+	index.lengthMs = _length.msecs();
+	index.frames = _indexedFrames;
+	index.interval = kIndexInterval;
+	index.offsets = _index;
+	MP3SeekIndexCache::save(_indexCacheKey, index);
+}
+
 Common::SeekableReadStream *MP3Stream::skipID3(Common::SeekableReadStream *stream, DisposeAfterUse::Flag dispose) {
 	// Skip ID3 TAG if any
 	// ID3v1 (beginning with with 'TAG') is located at the end of files. So we can ignore those.
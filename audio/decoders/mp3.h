@@ -59,6 +59,11 @@ class SeekableAudioStream;
  * Create a new SeekableAudioStream from the MP3 data in the given stream.
  * Allows for seeking (which is why we require a SeekableReadStream).
  *
+ * The length of the stream is taken from its Xing or VBRI header when
+ * present, otherwise all frame headers are scanned once. The scan builds
+ * a seek index, which is kept in the MP3SeekIndexCache for long streams
+ * unless the "mp3_seek_index_cache" setting is disabled.
+ *
  * @param stream			the SeekableReadStream from which to read the MP3 data
  * @param disposeAfterUse	whether to delete the stream after use
  * @return	a new SeekableAudioStream, or NULL, if an error occurred
@@ -0,0 +1,146 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/decoders/mp3index.h"
+
+#include "common/config-manager.h"
+#include "common/crc.h"
+#include "common/file.h"
+#include "common/fs.h"
+#include "common/ptr.h"
+#include "common/stream.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+namespace Audio {
+
+MP3SeekIndexKey MP3SeekIndexCache::computeKey(Common::SeekableReadStream &stream) {
+	MP3SeekIndexKey key;
+
+	const int32 size = stream.size();
+	if (size < kMinStreamSize)
+		return key;
+
+	Common::Array<byte> data(MIN<int32>(size, 2 * kHashSize));
+	const uint32 head = MIN<uint32>(size, kHashSize);
+	stream.seek(0);
+	stream.read(&data[0], head);
+	if (data.size() > head) {
+		stream.seek(size - (data.size() - head));
+		stream.read(&data[head], data.size() - head);
+	}
+	stream.seek(0);
+
+	key.size = size;
+	key.crc = Common::CRC32().crcFast(&data[0], data.size());
+	return key;
+}
+
+bool MP3SeekIndexCache::load(const MP3SeekIndexKey &key, MP3SeekIndex &index) {
+	Common::FSNode dir = getDirectory();
+	if (!key.isValid() || !dir.exists())
+		return false;
+
+	Common::FSNode node = dir.getChild(getSlotName(key));
+	if (!node.exists())
+		return false;
+
+	Common::File file;
+	if (!file.open(node))
+		return false;
+
+	return read(file, key, index);
+}
+
+void MP3SeekIndexCache::save(const MP3SeekIndexKey &key, const MP3SeekIndex &index) {
+	Common::FSNode dir = getDirectory();
+	if (!key.isValid() || (!dir.exists() && !dir.createDirectory()))
+		return;
+
+	Common::FSNode node = dir.getChild(getSlotName(key));
+	Common::DumpFile file;
+	if (!file.open(node))
+		return;
+
+	write(file, key, index);
+
+	if (!file.flush() || file.err())
+		warning("MP3SeekIndexCache: Could not write %s", node.getName().c_str());
+}
+
+bool MP3SeekIndexCache::read(Common::ReadStream &in, const MP3SeekIndexKey &key, MP3SeekIndex &index) {
+	if (!key.isValid())
+		return false;
+
+	if (in.readUint32BE() != MKTAG('M', 'P', '3', 'I') || in.readUint32LE() != kVersion)
+		return false;
+
+	// The slot may hold the index of another stream
+	if (in.readUint32LE() != key.size || in.readUint32LE() != key.crc)
+		return false;
+
+	MP3SeekIndex result;
+	result.rate = in.readUint32LE();
+	result.samplesPerFrame = in.readUint32LE();
+	result.lengthMs = in.readUint32LE();
+	result.frames = in.readUint32LE();
+	result.interval = in.readUint32LE();
+	const uint32 entries = in.readUint32LE();
+	if (!result.frames || !result.interval || entries != (result.frames + result.interval - 1) / result.interval)
+		return false;
+
+	result.offsets.resize(entries);
+	for (uint32 i = 0; i < entries; i++)
+		result.offsets[i] = in.readUint32LE();
+	if (in.err() || in.eos())
+		return false;
+
+	index = result;
+	return true;
+}
+
+void MP3SeekIndexCache::write(Common::WriteStream &out, const MP3SeekIndexKey &key, const MP3SeekIndex &index) {
+	out.writeUint32BE(MKTAG('M', 'P', '3', 'I'));
+	out.writeUint32LE(kVersion);
+	out.writeUint32LE(key.size);
+	out.writeUint32LE(key.crc);
+	out.writeUint32LE(index.rate);
+	out.writeUint32LE(index.samplesPerFrame);
+	out.writeUint32LE(index.lengthMs);
+	out.writeUint32LE(index.frames);
+	out.writeUint32LE(index.interval);
+	out.writeUint32LE(index.offsets.size());
+	for (uint i = 0; i < index.offsets.size(); i++)
+		out.writeUint32LE(index.offsets[i]);
+}
+
+Common::String MP3SeekIndexCache::getSlotName(const MP3SeekIndexKey &key) {
+	return Common::String::format("%02u.idx", (key.size ^ key.crc) % kSlots);
+}
+
+Common::FSNode MP3SeekIndexCache::getDirectory() {
+	if (!ConfMan.hasKey("iconspath") || ConfMan.get("iconspath").empty())
+		return Common::FSNode();
+
+	return Common::FSNode(ConfMan.get("iconspath")).getChild("mp3index");
+}
+
+} // End of namespace Audio
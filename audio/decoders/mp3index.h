@@ -0,0 +1,115 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef AUDIO_DECODERS_MP3INDEX_H
+#define AUDIO_DECODERS_MP3INDEX_H
+
+#include "common/array.h"
+#include "common/str.h"
+#include "common/types.h"
+
+namespace Common {
+class FSNode;
+class ReadStream;
+class SeekableReadStream;
+class WriteStream;
+}
+
+namespace Audio {
+
+/**
+ * The seek index of an MP3 stream, as stored in the seek index cache.
+ */
+struct MP3SeekIndex {
+	uint32 rate;
+	uint32 samplesPerFrame;
+	uint32 lengthMs;
+	uint32 frames;					///< Number of frames covered by the index
+	uint32 interval;				///< Frames between two offsets
+	Common::Array<uint32> offsets;	///< Offsets of every interval-th frame, starting with the first
+
+	MP3SeekIndex() : rate(0), samplesPerFrame(0), lengthMs(0), frames(0), interval(0) {}
+};
+
+/**
+ * Identifies an MP3 stream in the seek index cache by its size and a
+ * checksum of both of its ends.
+ */
+struct MP3SeekIndexKey {
+	uint32 size;
+	uint32 crc;
+
+	MP3SeekIndexKey() : size(0), crc(0) {}
+	bool isValid() const { return size != 0; }
+};
+
+/**
+ * Cache of the seek indexes of long MP3 streams, so that opening them again
+ * does not need to scan all of their frames.
+ *
+ * The cache lives in the "mp3index" directory of the icons path, which
+ * defaults to the user's cache directory. It has a fixed number of slot
+ * files, picked by the key, so it never grows past kSlots files. A stream
+ * which maps to a used slot replaces its index.
+ *
+ * The cache does file I/O, so it must not be used from the mixer thread.
+ */
+class MP3SeekIndexCache {
+public:
+	enum {
+		kMinStreamSize = 1024 * 1024,	///< Smaller streams are quick to scan and are never cached
+		kSlots = 32
+	};
+
+	/**
+	 * Compute the key of a stream, or return an invalid key for streams
+	 * smaller than kMinStreamSize. The stream is rewound afterwards.
+	 */
+	static MP3SeekIndexKey computeKey(Common::SeekableReadStream &stream);
+
+	/** Load the index of a stream, and return whether it was found. */
+	static bool load(const MP3SeekIndexKey &key, MP3SeekIndex &index);
+
+	/** Store the index of a stream, replacing the index in its slot. */
+	static void save(const MP3SeekIndexKey &key, const MP3SeekIndex &index);
+
+	/** Read an index in the format of the slot files, and check that it belongs to the key. */
+	static bool read(Common::ReadStream &in, const MP3SeekIndexKey &key, MP3SeekIndex &index);
+
+	/** Write an index in the format of the slot files. */
+	static void write(Common::WriteStream &out, const MP3SeekIndexKey &key, const MP3SeekIndex &index);
+
+	/** Return the name of the slot file of a key. There are only kSlots different names. */
+	static Common::String getSlotName(const MP3SeekIndexKey &key);
+
+private:
+	static Common::FSNode getDirectory();
+
+	enum {
+		kVersion = 2,
+		kHashSize = 64 * 1024	///< Bytes hashed at both ends of the stream
+	};
+};
+
+} // End of namespace Audio
+
+#endif
@@ -219,6 +219,32 @@ public:
 	 */
 	virtual uint16 sysExNoDelay(const byte *msg, uint16 length) { sysEx(msg, length); return 0; }
 
+	/**
+	 * Send a MIDI command, to be played the given number of microseconds
+	 * after the start of the current timer callback. This allows a parser
+	 * to hand over all events of a timer tick at once, without quantizing
+	 * them to the tick.
+	 *
+	 * Drivers which cannot schedule events play the command right away.
+	 *
+	 * @param source The source sending the command, or -1.
+	 * @param b      The packed command, as for send().
+	 * @param delay  The delay in microseconds.
+	 */
+	virtual void sendDelayed(int8 source, uint32 b, uint32 delay) {
+		if (source < 0)
+			send(b);
+		else
+			send(source, b);
+	}
+
+	/**
+	 * Transmit a SysEx to the MIDI device, to be played the given number
+	 * of microseconds after the start of the current timer callback. See
+	 * sendDelayed() and sysExNoDelay().
+	 */
+	virtual uint16 sysExDelayed(const byte *msg, uint16 length, uint32 delay) { return sysExNoDelay(msg, length); }
+
 	// TODO: Document this.
 	virtual void metaEvent(byte type, byte *data, uint16 length) { }
 
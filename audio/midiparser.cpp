@@ -39,6 +39,7 @@ _ppqn(96),
 _tempo(500000),
 _psecPerTick(5208), // 500000 / 96
 _sysExDelay(0),
+_eventDelay(0),
 _autoLoop(false),
 _smartJump(false),
 _centerPitchWheelOnUnload(false),
@@ -85,7 +86,9 @@ void MidiParser::property(int prop, int value) {
 }
 
 void MidiParser::sendToDriver(uint32 b) {
-	if (_source < 0) {
+	if (_eventDelay) {
+		_driver->sendDelayed(_source, b, _eventDelay);
+	} else if (_source < 0) {
 		_driver->send(b);
 	} else {
 		_driver->send(_source, b);
@@ -199,6 +202,7 @@ void MidiParser::onTimer() {
 		return;
 
 	_abortParse = false;
+	_eventDelay = 0;
 	endTime = _position._playTime + _timerRate;
 
 	// Scan our hanging notes for any
@@ -209,7 +213,11 @@ void MidiParser::onTimer() {
 		for (i = ARRAYSIZE(_hangingNotes); i; --i, ++ptr) {
 			if (ptr->timeLeft) {
 				if (ptr->timeLeft <= _timerRate) {
+					// Schedule the note off within this tick, so that
+					// drivers able to do so play it at its exact time
+					_eventDelay = ptr->timeLeft;
 					sendToDriver(0x80 | ptr->channel, ptr->note, 0);
+					_eventDelay = 0;
 					ptr->timeLeft = 0;
 					--_hangingNotesCount;
 				} else {
@@ -244,11 +252,18 @@ void MidiParser::onTimer() {
 					activeNote(info.channel(), info.basic.param1, true);
 			}
 
+			// The events of this tick are sent at its start, together with
+			// their offset into the tick. Drivers able to schedule events
+			// play them at their exact time instead of in a burst.
+			_eventDelay = eventTime > _position._playTime ? eventTime - _position._playTime : 0;
+
 			// Player::metaEvent() in SCUMM will delete the parser object,
 			// so return immediately if that might have happened.
 			bool ret = processEvent(info);
 			if (!ret)
 				return;
+
+			_eventDelay = 0;
 		}
 
 		loopEvent |= info.loop;
@@ -280,16 +295,21 @@ bool MidiParser::processEvent(const EventInfo &info, bool fireEvents) {
 		// SysEx event
 		// Check for trailing 0xF7 -- if present, remove it.
 		if (fireEvents) {
-			if (_sysExDelay > 0)
+			if (_sysExDelay > 0) {
 				// Don't process this event if the delay from
 				// the previous SysEx hasn't passed yet.
+				_eventDelay = 0;
 				return false;
+			}
 
 			uint16 delay;
+			uint16 length = info.length;
 			if (info.ext.data[info.length-1] == 0xF7)
-				delay = _driver->sysExNoDelay(info.ext.data, (uint16)info.length-1);
+				length--;
+			if (_eventDelay)
+				delay = _driver->sysExDelayed(info.ext.data, length, _eventDelay);
 			else
-				delay = _driver->sysExNoDelay(info.ext.data, (uint16)info.length);
+				delay = _driver->sysExNoDelay(info.ext.data, length);
 
 			// Set the delay in microseconds so the next
 			// SysEx event will be delayed if necessary.
@@ -302,8 +322,11 @@ bool MidiParser::processEvent(const EventInfo &info, bool fireEvents) {
 			// as well as sending it to the output device.
 			if (_autoLoop) {
 				jumpToTick(0);
+				_eventDelay = 0;
 			} else {
 				stopPlaying();
+				// The parser may be deleted by the meta event handler
+				_eventDelay = 0;
 				if (fireEvents)
 					sendMetaEventToDriver(info.ext.type, info.ext.data, (uint16)info.length);
 			}
@@ -21,6 +21,7 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/profiler.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
@@ -301,6 +302,7 @@ void MixerImpl::playStream(
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
+	PROFILE_SCOPE_ON(Common::kProfilerTrackAudio, "Mixer::mixCallback");
 	Common::StackLock lock(_mutex);
 
 	int16 *buf = (int16 *)samples;
@@ -322,6 +324,7 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 
 	// mix all channels
 	int res = 0, tmp;
+	int mixed = 0;
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i]) {
 			if (_channels[i]->isFinished()) {
@@ -329,12 +332,15 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 				_channels[i] = nullptr;
 			} else if (!_channels[i]->isPaused()) {
 				tmp = _channels[i]->mix(buf, len);
+				mixed++;
 
 				if (tmp > res)
 					res = tmp;
 			}
 		}
 
+	PROFILE_COUNTER_ON(Common::kProfilerTrackAudio, "Mixer channels", mixed);
+
 	return res;
 }
 
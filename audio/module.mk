@@ -8,6 +8,7 @@ MODULE_OBJS := \
 	cms.o \
 	fmopl.o \
 	mididrv.o \
+	mididrv_base.o \
 	mididrv_ms.o \
 	midiparser_qt.o \
 	midiparser_smf.o \
@@ -21,6 +22,7 @@ MODULE_OBJS := \
 	mt32gm.o \
 	musicplugin.o \
 	null.o \
+	pcmcache.o \
 	rate.o \
 	timestamp.o \
 	decoders/3do.o \
@@ -34,6 +36,7 @@ MODULE_OBJS := \
 	decoders/iff_sound.o \
 	decoders/mac_snd.o \
 	decoders/mp3.o \
+	decoders/mp3index.o \
 	decoders/qdm2.o \
 	decoders/quicktime.o \
 	decoders/raw.o \
@@ -55,6 +58,8 @@ MODULE_OBJS := \
 	mods/soundfx.o \
 	mods/tfmx.o \
 	softsynth/cms.o \
+	softsynth/emumidi.o \
+	softsynth/emumidi_queue.o \
 	softsynth/opl/dbopl.o \
 	softsynth/opl/dosbox.o \
 	softsynth/opl/mame.o \
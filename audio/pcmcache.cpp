@@ -0,0 +1,216 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/pcmcache.h"
+#include "audio/audiostream.h"
+
+#include "common/debug.h"
+#include "common/hash-str.h"
+#include "common/util.h"
+
+namespace Common {
+DECLARE_SINGLETON(Audio::PCMCache);
+}
+
+namespace Audio {
+
+uint PCMCacheKey_Hash::operator()(const PCMCacheKey &key) const {
+	uint hash = Common::hashit(key.name.c_str());
+	hash = hash * 31 + key.offset;
+	hash = hash * 31 + key.codec;
+	hash = hash * 31 + key.params;
+	return hash;
+}
+
+/**
+ * A stream over decoded data owned by the PCM cache.
+ */
+class PCMCacheStream : public SeekableAudioStream {
+public:
+	PCMCacheStream(PCMCache::Buffer *buffer) : _buffer(buffer), _pos(0) {}
+	~PCMCacheStream() override { PCMCache::instance().release(_buffer); }
+
+	int readBuffer(int16 *buffer, const int numSamples) override {
+		const int samples = MIN<uint32>(numSamples, _buffer->numSamples - _pos);
+		memcpy(buffer, _buffer->samples + _pos, samples * sizeof(int16));
+		_pos += samples;
+		return samples;
+	}
+
+	bool isStereo() const override { return _buffer->stereo; }
+	int getRate() const override { return _buffer->rate; }
+	bool endOfData() const override { return _pos >= _buffer->numSamples; }
+
+	bool seek(const Timestamp &where) override {
+		const uint32 channels = _buffer->stereo ? 2 : 1;
+		const uint32 pos = where.convertToFramerate(_buffer->rate).totalNumberOfFrames() * channels;
+		if (pos > _buffer->numSamples)
+			return false;
+
+		_pos = pos;
+		return true;
+	}
+
+	Timestamp getLength() const override {
+		return Timestamp(0, _buffer->numSamples / (_buffer->stereo ? 2 : 1), _buffer->rate);
+	}
+
+private:
+	PCMCache::Buffer *_buffer;
+	uint32 _pos;
+};
+
+PCMCache::PCMCache() : _bytes(0), _budget(kDefaultBudget), _hits(0), _misses(0), _evictions(0), _uncached(0) {
+}
+
+PCMCache::~PCMCache() {
+	clear();
+}
+
+SeekableAudioStream *PCMCache::find(const PCMCacheKey &key) {
+	Common::StackLock lock(_mutex);
+
+	EntryMap::iterator i = _map.find(key);
+	if (i == _map.end()) {
+		_misses++;
+		return nullptr;
+	}
+
+	_hits++;
+
+	// Move the entry to the front of the LRU list
+	Buffer *buffer = i->_value->buffer;
+	_entries.erase(i->_value);
+	Entry entry;
+	entry.key = key;
+	entry.buffer = buffer;
+	_entries.push_front(entry);
+	i->_value = _entries.begin();
+
+	buffer->refCount++;
+	return new PCMCacheStream(buffer);
+}
+
+SeekableAudioStream *PCMCache::insert(const PCMCacheKey &key, AudioStream *stream, DisposeAfterUse::Flag disposeAfterUse) {
+	Buffer *buffer = new Buffer();
+	buffer->rate = stream->getRate();
+	buffer->stereo = stream->isStereo();
+	buffer->refCount = 1;
+
+	// Decode everything, growing the buffer as needed
+	uint32 capacity = 16384;
+	buffer->samples = (int16 *)malloc(capacity * sizeof(int16));
+	buffer->numSamples = 0;
+	while (!stream->endOfData()) {
+		if (buffer->numSamples == capacity) {
+			capacity *= 2;
+			buffer->samples = (int16 *)realloc(buffer->samples, capacity * sizeof(int16));
+		}
+
+		const int samples = stream->readBuffer(buffer->samples + buffer->numSamples, capacity - buffer->numSamples);
+		if (samples <= 0)
+			break;
+		buffer->numSamples += samples;
+	}
+	if (buffer->numSamples)
+		buffer->samples = (int16 *)realloc(buffer->samples, buffer->numSamples * sizeof(int16));
+
+	if (disposeAfterUse == DisposeAfterUse::YES)
+		delete stream;
+
+	const uint32 bytes = buffer->numSamples * sizeof(int16);
+
+	Common::StackLock lock(_mutex);
+	if (bytes > _budget / 8 || _map.contains(key)) {
+		// Only the returned stream uses the buffer
+		_uncached++;
+		return new PCMCacheStream(buffer);
+	}
+
+	evict(bytes);
+
+	Entry entry;
+	entry.key = key;
+	entry.buffer = buffer;
+	_entries.push_front(entry);
+	_map[key] = _entries.begin();
+	_bytes += bytes;
+
+	buffer->refCount++;
+	return new PCMCacheStream(buffer);
+}
+
+void PCMCache::clear() {
+	Common::StackLock lock(_mutex);
+
+	for (EntryList::iterator i = _entries.begin(); i != _entries.end(); ++i)
+		release(i->buffer);
+	_entries.clear();
+	_map.clear();
+	_bytes = 0;
+}
+
+void PCMCache::setBudget(uint32 bytes) {
+	Common::StackLock lock(_mutex);
+
+	_budget = bytes;
+	evict(0);
+}
+
+PCMCacheStats PCMCache::getStats() const {
+	Common::StackLock lock(_mutex);
+
+	PCMCacheStats stats;
+	stats.hits = _hits;
+	stats.misses = _misses;
+	stats.evictions = _evictions;
+	stats.uncached = _uncached;
+	stats.entries = _map.size();
+	stats.bytes = _bytes;
+	stats.budget = _budget;
+	return stats;
+}
+
+void PCMCache::release(Buffer *buffer) {
+	// Streams are destroyed by the mixer thread, so the reference count is
+	// only changed with the lock held
+	Common::StackLock lock(_mutex);
+
+	if (--buffer->refCount == 0) {
+		free(buffer->samples);
+		delete buffer;
+	}
+}
+
+void PCMCache::evict(uint32 bytes) {
+	while (!_entries.empty() && _bytes + bytes > _budget) {
+		const Entry &entry = _entries.back();
+		debug(5, "PCMCache: Evicting %s:%u", entry.key.name.c_str(), entry.key.offset);
+
+		_bytes -= entry.buffer->numSamples * sizeof(int16);
+		_evictions++;
+		release(entry.buffer);
+		_map.erase(entry.key);
+		_entries.pop_back();
+	}
+}
+
+} // End of namespace Audio
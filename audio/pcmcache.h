@@ -0,0 +1,166 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_PCMCACHE_H
+#define AUDIO_PCMCACHE_H
+
+#include "common/hashmap.h"
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+#include "common/str.h"
+#include "common/types.h"
+
+namespace Audio {
+
+class AudioStream;
+class SeekableAudioStream;
+
+/**
+ * @defgroup audio_pcmcache PCM cache
+ * @ingroup audio
+ *
+ * @brief Cache of decoded sound effects.
+ * @{
+ */
+
+/**
+ * Identifies a sound in the PCM cache. All fields which influence the
+ * decoded output must be part of the key.
+ */
+struct PCMCacheKey {
+	Common::String name;	///< Archive member or resource name
+	uint32 offset;			///< Offset of the sound in the member
+	uint32 codec;			///< Codec tag, for example MKTAG('V', 'O', 'C', ' ')
+	uint32 params;			///< Codec parameters, for example flags or a rate override
+
+	PCMCacheKey() : offset(0), codec(0), params(0) {}
+	PCMCacheKey(const Common::String &n, uint32 o, uint32 c, uint32 p = 0) : name(n), offset(o), codec(c), params(p) {}
+
+	bool operator==(const PCMCacheKey &key) const {
+		return offset == key.offset && codec == key.codec && params == key.params && name == key.name;
+	}
+};
+
+struct PCMCacheKey_Hash {
+	uint operator()(const PCMCacheKey &key) const;
+};
+
+/** Statistics of the PCM cache, as returned by PCMCache::getStats(). */
+struct PCMCacheStats {
+	uint32 hits;		///< Lookups which found the sound
+	uint32 misses;		///< Lookups which did not find the sound
+	uint32 evictions;	///< Sounds dropped to stay within the budget
+	uint32 uncached;	///< Sounds decoded but too large to be cached
+	uint32 entries;		///< Sounds in the cache
+	uint32 bytes;		///< Size of the decoded data in the cache
+	uint32 budget;		///< Maximum size of the decoded data in the cache
+};
+
+/**
+ * Keeps the decoded PCM data of recently played sounds, so that playing a
+ * sound again does not need to read and decode it again.
+ *
+ * The cache hands out SeekableAudioStream views over the shared data. The
+ * data stays alive while views on it exist, even when it is evicted. Sounds
+ * are evicted in least recently used order once the byte budget is
+ * exceeded. The cache may be used from the mixer thread.
+ */
+class PCMCache : public Common::Singleton<PCMCache> {
+public:
+	enum {
+		kDefaultBudget = 8 * 1024 * 1024
+	};
+
+	PCMCache();
+	~PCMCache();
+
+	/**
+	 * Look up a sound.
+	 *
+	 * @return A new stream over the decoded sound, or nullptr if it is not
+	 *         in the cache.
+	 */
+	SeekableAudioStream *find(const PCMCacheKey &key);
+
+	/**
+	 * Decode the given stream completely and store the result.
+	 *
+	 * Sounds larger than an eighth of the budget are not stored, but a
+	 * stream over the decoded data is returned all the same. The stream
+	 * must end, so do not pass looping streams.
+	 *
+	 * @param key              The key of the sound.
+	 * @param stream           The stream to decode.
+	 * @param disposeAfterUse  Whether to delete the stream after decoding it.
+	 *
+	 * @return A new stream over the decoded sound.
+	 */
+	SeekableAudioStream *insert(const PCMCacheKey &key, AudioStream *stream, DisposeAfterUse::Flag disposeAfterUse);
+
+	/** Drop all sounds. Streams over them keep working. */
+	void clear();
+
+	/** Set the maximum size of the decoded data, and evict sounds to stay within it. */
+	void setBudget(uint32 bytes);
+
+	/** Return the statistics of the cache. */
+	PCMCacheStats getStats() const;
+
+private:
+	friend class PCMCacheStream;
+
+	struct Buffer {
+		int16 *samples;
+		uint32 numSamples;
+		int rate;
+		bool stereo;
+		int refCount;		///< Streams using the buffer, plus one while it is cached
+	};
+
+	struct Entry {
+		PCMCacheKey key;
+		Buffer *buffer;
+	};
+
+	typedef Common::List<Entry> EntryList;
+	typedef Common::HashMap<PCMCacheKey, EntryList::iterator, PCMCacheKey_Hash> EntryMap;
+
+	void release(Buffer *buffer);
+	void evict(uint32 bytes);
+
+	mutable Common::Mutex _mutex;
+	EntryList _entries;	///< Most recently used first
+	EntryMap _map;
+	uint32 _bytes;
+	uint32 _budget;
+
+	uint32 _hits;
+	uint32 _misses;
+	uint32 _evictions;
+	uint32 _uncached;
+};
+
+/** @} */
+
+} // End of namespace Audio
+
+#endif
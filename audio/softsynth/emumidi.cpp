@@ -0,0 +1,352 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/softsynth/emumidi.h"
+
+#include "common/config-manager.h"
+#include "common/singleton.h"
+#include "common/system.h"
+#include "common/timer.h"
+
+/**
+ * Fills the ring buffers of all drivers rendering ahead. This runs as a
+ * timer callback, so it executes on the timer thread of the backend.
+ */
+class MidiDriver_EmulatedRenderThread : public Common::Singleton<MidiDriver_EmulatedRenderThread> {
+public:
+	MidiDriver_EmulatedRenderThread() : _timerInstalled(false) {}
+
+	void add(MidiDriver_Emulated *driver, uint32 aheadMs) {
+		{
+			Common::StackLock lock(_mutex);
+			_drivers.push_back(driver);
+		}
+
+		// Run often enough to refill the ring well before it runs dry.
+		// The timer manager must not be called with _mutex held, as the
+		// timer thread holds its own lock while running timerProc().
+		// Without a timer manager, the mixer callback renders everything.
+		Common::TimerManager *timer = g_system->getTimerManager();
+		if (!_timerInstalled && timer) {
+			_timerInstalled = true;
+			timer->installTimerProc(&timerProc, MAX<uint32>(aheadMs / 4, 1) * 1000, this, "MidiDriver_EmulatedRenderThread");
+		}
+	}
+
+	void remove(MidiDriver_Emulated *driver) {
+		bool empty;
+		{
+			// The timer thread holds _mutex while rendering, so the driver
+			// is not in use anymore once this returns.
+			Common::StackLock lock(_mutex);
+			for (uint i = 0; i < _drivers.size(); ++i) {
+				if (_drivers[i] == driver) {
+					_drivers.remove_at(i);
+					break;
+				}
+			}
+			empty = _drivers.empty();
+		}
+
+		if (empty && _timerInstalled) {
+			_timerInstalled = false;
+			g_system->getTimerManager()->removeTimerProc(&timerProc);
+		}
+	}
+
+private:
+	static void timerProc(void *refCon) {
+		MidiDriver_EmulatedRenderThread *thread = (MidiDriver_EmulatedRenderThread *)refCon;
+
+		Common::StackLock lock(thread->_mutex);
+		for (uint i = 0; i < thread->_drivers.size(); ++i)
+			thread->_drivers[i]->renderAhead(thread->_drivers[i]->_ringFrames);
+	}
+
+	Common::Mutex _mutex;
+	Common::Array<MidiDriver_Emulated *> _drivers;
+	bool _timerInstalled;
+};
+
+namespace Common {
+DECLARE_SINGLETON(MidiDriver_EmulatedRenderThread);
+}
+
+MidiDriver_Emulated::~MidiDriver_Emulated() {
+	stopRenderAhead();
+}
+
+void MidiDriver_Emulated::startRenderAhead() {
+	if (_ring || !supportsEventQueue() || !ConfMan.hasKey("midi_render_ahead"))
+		return;
+
+	const int aheadMs = ConfMan.getInt("midi_render_ahead");
+	if (aheadMs <= 0)
+		return;
+
+	const int stereoFactor = isStereo() ? 2 : 1;
+	_ringFrames = MAX<uint32>((uint32)getRate() * aheadMs / 1000, 1);
+	_ring = new int16[_ringFrames * stereoFactor];
+	_writePos = _readPos;
+	_renderNextTick = _nextTick;
+
+	// Start with a full ring, so that the first mixer callbacks do not
+	// have to render synchronously
+	renderAhead(_ringFrames);
+
+	MidiDriver_EmulatedRenderThread::instance().add(this, aheadMs);
+}
+
+void MidiDriver_Emulated::stopRenderAhead() {
+	if (_ring)
+		MidiDriver_EmulatedRenderThread::instance().remove(this);
+
+	Common::StackLock renderLock(_renderMutex);
+	Common::StackLock eventLock(_eventMutex);
+	_events.clear();
+	delete[] _ring;
+	_ring = nullptr;
+	_ringFrames = 0;
+}
+
+void MidiDriver_Emulated::pushEvent(QueuedEvent &event, uint32 delay) {
+	uint32 readPos;
+	{
+		Common::StackLock ringLock(_ringMutex);
+		readPos = _readPos;
+	}
+
+	// When rendering ahead, delay all events by the render-ahead time
+	event.timestamp = readPos + _ringFrames + (uint32)((uint64)delay * getRate() / 1000000);
+	_events.push(event, delay != 0);
+}
+
+bool MidiDriver_Emulated::queueEvent(uint32 b) {
+	// Without rendering ahead, undelayed events are only queued behind
+	// delayed ones, which they must not overtake
+	Common::StackLock lock(_eventMutex);
+	if (!_ring && _events.empty())
+		return false;
+
+	QueuedEvent event;
+	event.msg = b;
+	pushEvent(event, 0);
+	return true;
+}
+
+bool MidiDriver_Emulated::queueSysEx(const byte *msg, uint16 length) {
+	Common::StackLock lock(_eventMutex);
+	if (!_ring && _events.empty())
+		return false;
+
+	QueuedEvent event;
+	event.msg = 0xF0;
+	event.sysEx.resize(length);
+	if (length)
+		memcpy(&event.sysEx[0], msg, length);
+	pushEvent(event, 0);
+	return true;
+}
+
+void MidiDriver_Emulated::sendDelayed(int8 source, uint32 b, uint32 delay) {
+	if (!delay || !supportsEventQueue()) {
+		MidiDriver::sendDelayed(source, b, delay);
+		return;
+	}
+
+	if (!_isOpen)
+		return;
+
+	midiDriverCommonSend(b);
+
+	Common::StackLock lock(_eventMutex);
+	QueuedEvent event;
+	event.msg = b;
+	pushEvent(event, delay);
+}
+
+uint16 MidiDriver_Emulated::sysExDelayed(const byte *msg, uint16 length, uint32 delay) {
+	if (!delay || !supportsEventQueue())
+		return MidiDriver::sysExDelayed(msg, length, delay);
+
+	if (!_isOpen)
+		return 0;
+
+	midiDriverCommonSysEx(msg, length);
+
+	Common::StackLock lock(_eventMutex);
+	QueuedEvent event;
+	event.msg = 0xF0;
+	event.sysEx.resize(length);
+	if (length)
+		memcpy(&event.sysEx[0], msg, length);
+	pushEvent(event, delay);
+
+	// The delay needed by the device is already included in the samples
+	// synthesized for the SysEx
+	return 0;
+}
+
+void MidiDriver_Emulated::playDueEvents(uint32 frame) {
+	Common::StackLock lock(_eventMutex);
+
+	QueuedEvent event;
+	while (_events.popDue(frame, event)) {
+		if (event.msg == 0xF0)
+			playSysEx(event.sysEx.empty() ? nullptr : &event.sysEx[0], event.sysEx.size());
+		else
+			playEvent(event.msg);
+	}
+}
+
+uint32 MidiDriver_Emulated::framesUntilNextEvent(uint32 frame, uint32 maxFrames) {
+	Common::StackLock lock(_eventMutex);
+	return _events.framesUntilNext(frame, maxFrames);
+}
+
+void MidiDriver_Emulated::renderAhead(uint32 frames) {
+	Common::StackLock renderLock(_renderMutex);
+	if (!_ring)
+		return;
+
+	const int stereoFactor = isStereo() ? 2 : 1;
+	frames = MIN(frames, _ringFrames);
+
+	for (;;) {
+		uint32 readPos;
+		{
+			Common::StackLock ringLock(_ringMutex);
+			readPos = _readPos;
+		}
+
+		// Only this function moves _writePos
+		const uint32 writePos = _writePos;
+		const uint32 fill = writePos - readPos;
+		if (fill >= frames)
+			break;
+
+		const uint32 ringOffset = writePos % _ringFrames;
+
+		// Play the events which are due and stop at the next one
+		playDueEvents(writePos);
+		const uint32 len = framesUntilNextEvent(writePos, MIN(frames - fill, _ringFrames - ringOffset));
+
+		const uint32 step = MIN<uint32>(len, _renderNextTick >> FIXP_SHIFT);
+		if (step) {
+			generateSamples(_ring + ringOffset * stereoFactor, step);
+			_renderNextTick -= step << FIXP_SHIFT;
+
+			Common::StackLock ringLock(_ringMutex);
+			_writePos = writePos + step;
+		}
+
+		if (!(_renderNextTick >> FIXP_SHIFT)) {
+			onTimer();
+			_renderNextTick += _samplesPerTick;
+		}
+	}
+}
+
+int MidiDriver_Emulated::readBuffer(int16 *data, const int numSamples) {
+	const int stereoFactor = isStereo() ? 2 : 1;
+	const bool eventQueue = supportsEventQueue();
+	int len = numSamples / stereoFactor;
+	int step;
+
+	if (!_ring) {
+		do {
+			step = len;
+			if (step > (_nextTick >> FIXP_SHIFT))
+				step = (_nextTick >> FIXP_SHIFT);
+
+			// Split the samples at scheduled events
+			if (eventQueue) {
+				playDueEvents(_readPos);
+				step = framesUntilNextEvent(_readPos, step);
+			}
+
+			generateSamples(data, step);
+
+			if (eventQueue) {
+				Common::StackLock ringLock(_ringMutex);
+				_readPos += step;
+			}
+
+			_nextTick -= step << FIXP_SHIFT;
+			if (!(_nextTick >> FIXP_SHIFT)) {
+				if (_timerProc)
+					(*_timerProc)(_timerParam);
+
+				onTimer();
+
+				_nextTick += _samplesPerTick;
+			}
+
+			data += step * stereoFactor;
+			len -= step;
+		} while (len);
+
+		return numSamples;
+	}
+
+	// Rendering ahead: the player callback still runs at the playback
+	// position, so that the events it sends get queued for the right frame.
+	// The driver's own onTimer() runs on the rendering side instead.
+	do {
+		step = MIN<int>(len, _nextTick >> FIXP_SHIFT);
+		step = MIN<int>(step, _ringFrames);
+
+		if (step) {
+			uint32 readPos, writePos;
+			{
+				Common::StackLock ringLock(_ringMutex);
+				readPos = _readPos;
+				writePos = _writePos;
+			}
+
+			// The render thread fell behind, so synthesize right here
+			if (writePos - readPos < (uint32)step)
+				renderAhead(step);
+
+			const uint32 ringOffset = readPos % _ringFrames;
+			const uint32 first = MIN<uint32>(step, _ringFrames - ringOffset);
+			memcpy(data, _ring + ringOffset * stereoFactor, first * stereoFactor * sizeof(int16));
+			if (first < (uint32)step)
+				memcpy(data + first * stereoFactor, _ring, (step - first) * stereoFactor * sizeof(int16));
+
+			Common::StackLock ringLock(_ringMutex);
+			_readPos = readPos + step;
+		}
+
+		_nextTick -= step << FIXP_SHIFT;
+		if (!(_nextTick >> FIXP_SHIFT)) {
+			if (_timerProc)
+				(*_timerProc)(_timerParam);
+
+			_nextTick += _samplesPerTick;
+		}
+
+		data += step * stereoFactor;
+		len -= step;
+	} while (len);
+
+	return numSamples;
+}
@@ -25,7 +25,30 @@
 #include "audio/audiostream.h"
 #include "audio/mididrv.h"
 #include "audio/mixer.h"
+#include "audio/softsynth/emumidi_queue.h"
+#include "common/array.h"
+#include "common/list.h"
+#include "common/mutex.h"
 
+/**
+ * Base class for MIDI drivers synthesizing their output in software.
+ *
+ * The samples are normally generated in the mixer callback, which also
+ * runs the timer callback of the player. Drivers supporting an event queue
+ * additionally get:
+ *
+ * - Scheduled events: events passed to sendDelayed() or sysExDelayed() are
+ *   queued with the sample at which they are due, and generateSamples() is
+ *   split at that sample. A parser can thus hand over all events of a
+ *   timer tick at once without them being quantized to the tick.
+ *
+ * - Rendering ahead: when the "midi_render_ahead" config key is set to a
+ *   number of milliseconds, a timer thread synthesizes that much audio in
+ *   advance into a ring buffer, from which the mixer callback only copies.
+ *   All events are then queued with the sample at which they would have
+ *   been played without rendering ahead, delayed by the render-ahead time,
+ *   so their relative timing stays sample-accurate.
+ */
 class MidiDriver_Emulated : public Audio::AudioStream, public MidiDriver {
 protected:
 	bool _isOpen;
@@ -43,12 +66,77 @@ private:
 	int _nextTick;
 	int _samplesPerTick;
 
+	typedef EmulatedMidiEventQueue::Event QueuedEvent;
+
+	// _readPos is the absolute frame count of the stream, so it may wrap
+	// around. When rendering ahead, the ring holds the frames from
+	// _readPos up to _writePos.
+	int16 *_ring;
+	uint32 _ringFrames;
+	uint32 _readPos;
+	uint32 _writePos;
+	int _renderNextTick;
+	EmulatedMidiEventQueue _events;
+
+	Common::Mutex _ringMutex;     ///< guards _readPos and _writePos
+	Common::Mutex _renderMutex;   ///< held while synthesizing ahead
+	Common::Mutex _eventMutex;    ///< guards the event queue
+
+	void renderAhead(uint32 frames);
+	/** Queue an event, with _eventMutex held. */
+	void pushEvent(QueuedEvent &event, uint32 delay);
+	void playDueEvents(uint32 frame);
+	uint32 framesUntilNextEvent(uint32 frame, uint32 maxFrames);
+
+	friend class MidiDriver_EmulatedRenderThread;
+
 protected:
 	int _baseFreq;
 
 	virtual void generateSamples(int16 *buf, int len) = 0;
 	virtual void onTimer() {}
 
+	/**
+	 * Whether the driver supports queued events. Such drivers call
+	 * queueEvent() and queueSysEx() at the start of send() and sysEx() and
+	 * implement playEvent() and playSysEx().
+	 */
+	virtual bool supportsEventQueue() const { return false; }
+
+	/**
+	 * Start rendering ahead if the event queue is supported and rendering
+	 * ahead is enabled. Called by open().
+	 */
+	void startRenderAhead();
+
+	/**
+	 * Stop rendering ahead and drop all queued events. Drivers have to call
+	 * this in close(), after stopping the mixer stream and before shutting
+	 * down their synthesizer.
+	 */
+	void stopRenderAhead();
+
+	bool isRenderingAhead() const { return _ring != nullptr; }
+
+	/**
+	 * Queue the event for playback at the current playback position when
+	 * rendering ahead, or when delayed events are still queued. In the
+	 * latter case, the event is played right after them.
+	 *
+	 * @return true if the event was queued, false if the caller has to
+	 *         play it right away
+	 */
+	bool queueEvent(uint32 b);
+	bool queueSysEx(const byte *msg, uint16 length);
+
+	/**
+	 * Play a queued event. Called on the rendering thread, between the
+	 * generateSamples() calls for the samples before and after the event.
+	 * No other events are played while this runs.
+	 */
+	virtual void playEvent(uint32 b) {}
+	virtual void playSysEx(const byte *msg, uint16 length) {}
+
 public:
 	MidiDriver_Emulated(Audio::Mixer *mixer) :
 		_mixer(mixer),
@@ -57,9 +145,16 @@ public:
 		_timerParam(0),
 		_nextTick(0),
 		_samplesPerTick(0),
+		_ring(nullptr),
+		_ringFrames(0),
+		_readPos(0),
+		_writePos(0),
+		_renderNextTick(0),
 		_baseFreq(250) {
 	}
 
+	virtual ~MidiDriver_Emulated();
+
 	// MidiDriver API
 	virtual int open() {
 		_isOpen = true;
@@ -72,6 +167,8 @@ public:
 
 		_samplesPerTick = (d << FIXP_SHIFT) + (r << FIXP_SHIFT) / _baseFreq;
 
+		startRenderAhead();
+
 		return 0;
 	}
 
@@ -86,35 +183,11 @@ public:
 		return 1000000 / _baseFreq;
 	}
 
-	// AudioStream API
-	virtual int readBuffer(int16 *data, const int numSamples) {
-		const int stereoFactor = isStereo() ? 2 : 1;
-		int len = numSamples / stereoFactor;
-		int step;
-
-		do {
-			step = len;
-			if (step > (_nextTick >> FIXP_SHIFT))
-				step = (_nextTick >> FIXP_SHIFT);
-
-			generateSamples(data, step);
-
-			_nextTick -= step << FIXP_SHIFT;
-			if (!(_nextTick >> FIXP_SHIFT)) {
-				if (_timerProc)
-					(*_timerProc)(_timerParam);
+	void sendDelayed(int8 source, uint32 b, uint32 delay) override;
+	uint16 sysExDelayed(const byte *msg, uint16 length, uint32 delay) override;
 
-				onTimer();
-
-				_nextTick += _samplesPerTick;
-			}
-
-			data += step * stereoFactor;
-			len -= step;
-		} while (len);
-
-		return numSamples;
-	}
+	// AudioStream API
+	virtual int readBuffer(int16 *data, const int numSamples);
 
 	virtual bool endOfData() const {
 		return false;
@@ -0,0 +1,55 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/softsynth/emumidi_queue.h"
+
+#include "common/util.h"
+
+void EmulatedMidiEventQueue::push(Event &event, bool delayed) {
+	if (!delayed && !_events.empty() && (int32)(_events.back().timestamp - event.timestamp) > 0)
+		event.timestamp = _events.back().timestamp;
+
+	// Events are mostly sent in order, so search from the back
+	Common::List<Event>::iterator i = _events.end();
+	while (i != _events.begin()) {
+		Common::List<Event>::iterator prev = i;
+		--prev;
+		if ((int32)(prev->timestamp - event.timestamp) <= 0)
+			break;
+		i = prev;
+	}
+	_events.insert(i, event);
+}
+
+bool EmulatedMidiEventQueue::popDue(uint32 frame, Event &event) {
+	if (_events.empty() || (int32)(_events.front().timestamp - frame) > 0)
+		return false;
+
+	event = _events.front();
+	_events.pop_front();
+	return true;
+}
+
+uint32 EmulatedMidiEventQueue::framesUntilNext(uint32 frame, uint32 maxFrames) const {
+	if (_events.empty())
+		return maxFrames;
+	return MIN(maxFrames, _events.front().timestamp - frame);
+}
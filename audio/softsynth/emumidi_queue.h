@@ -0,0 +1,64 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_SOFTSYNTH_EMUMIDI_QUEUE_H
+#define AUDIO_SOFTSYNTH_EMUMIDI_QUEUE_H
+
+#include "common/array.h"
+#include "common/list.h"
+
+/**
+ * The events scheduled by MidiDriver_Emulated, sorted by the frame at
+ * which they are played. Not thread-safe; the driver guards it.
+ */
+class EmulatedMidiEventQueue {
+public:
+	struct Event {
+		uint32 timestamp;             ///< frame at which the event is played
+		uint32 msg;
+		Common::Array<byte> sysEx;    ///< data of SysEx events, without framing
+	};
+
+	/**
+	 * Queue an event. Events with the same timestamp keep the order they
+	 * were pushed in.
+	 *
+	 * @param delayed  false if the event was sent without a delay. It is
+	 *                 then played no earlier than the events queued before
+	 *                 it, so that e.g. an all notes off can not overtake a
+	 *                 delayed note on and leave the note hanging.
+	 */
+	void push(Event &event, bool delayed);
+
+	/** Take the first event if it is due at @p frame. */
+	bool popDue(uint32 frame, Event &event);
+
+	/** Return the frames from @p frame to the next event, at most @p maxFrames. */
+	uint32 framesUntilNext(uint32 frame, uint32 maxFrames) const;
+
+	bool empty() const { return _events.empty(); }
+	void clear() { _events.clear(); }
+
+private:
+	Common::List<Event> _events;
+};
+
+#endif
@@ -111,6 +111,9 @@ protected:
 
 	void generateSamples(int16 *buf, int len) override;
 
+	bool supportsEventQueue() const override { return true; }
+	void playEvent(uint32 b) override;
+
 public:
 	MidiDriver_FluidSynth(Audio::Mixer *mixer);
 
@@ -470,6 +473,7 @@ void MidiDriver_FluidSynth::close() {
 	_isOpen = false;
 
 	_mixer->stopHandle(_mixerSoundHandle);
+	stopRenderAhead();
 
 	if (_soundFont != -1)
 		fluid_synth_sfunload(_synth, _soundFont, 1);
@@ -484,6 +488,11 @@ void MidiDriver_FluidSynth::send(uint32 b) {
 
 	midiDriverCommonSend(b);
 
+	if (!queueEvent(b))
+		playEvent(b);
+}
+
+void MidiDriver_FluidSynth::playEvent(uint32 b) {
 	//byte param3 = (byte) ((b >> 24) & 0xFF);
 	uint param2 = (byte) ((b >> 16) & 0xFF);
 	uint param1 = (byte) ((b >>  8) & 0xFF);
@@ -23,10 +23,20 @@
 #define BACKENDS_GRAPHICS_NULL_H
 
 #include "backends/graphics/graphics.h"
+#include "graphics/surface.h"
 
+/**
+ * Graphics manager which displays nothing. The screen contents are kept,
+ * so that they can be read back for screenshots and checksums.
+ */
 class NullGraphicsManager : public GraphicsManager {
 public:
-	virtual ~NullGraphicsManager() {}
+	NullGraphicsManager() : _width(0), _height(0), _overlayVisible(false) {
+		memset(_palette, 0, sizeof(_palette));
+	}
+	virtual ~NullGraphicsManager() {
+		_screen.free();
+	}
 
 	bool hasFeature(OSystem::Feature f) const override { return false; }
 	void setFeatureState(OSystem::Feature f, bool enable) override {}
@@ -53,6 +63,7 @@ public:
 		_width = width;
 		_height = height;
 		_format = format ? *format : Graphics::PixelFormat::createFormatCLUT8();
+		_screen.create(width, height, _format);
 	}
 
 	int getScreenChangeID() const override { return 0; }
@@ -62,13 +73,15 @@ public:
 
 	int16 getHeight() const override { return _height; }
 	int16 getWidth() const override { return _width; }
-	void setPalette(const byte *colors, uint start, uint num) override {}
-	void grabPalette(byte *colors, uint start, uint num) const override {}
-	void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) override {}
-	Graphics::Surface *lockScreen() override { return NULL; }
+	void setPalette(const byte *colors, uint start, uint num) override { memcpy(_palette + start * 3, colors, num * 3); }
+	void grabPalette(byte *colors, uint start, uint num) const override { memcpy(colors, _palette + start * 3, num * 3); }
+	void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) override {
+		_screen.copyRectToSurface(buf, pitch, x, y, w, h);
+	}
+	Graphics::Surface *lockScreen() override { return _screen.getPixels() ? &_screen : NULL; }
 	void unlockScreen() override {}
-	void fillScreen(uint32 col) override {}
-	void fillScreen(const Common::Rect &r, uint32 col) override {}
+	void fillScreen(uint32 col) override { _screen.fillRect(Common::Rect(_screen.w, _screen.h), col); }
+	void fillScreen(const Common::Rect &r, uint32 col) override { _screen.fillRect(r, col); }
 	void updateScreen() override {}
 	void setShakePos(int shakeXOffset, int shakeYOffset) override {}
 	void setFocusRectangle(const Common::Rect& rect) override {}
@@ -92,6 +105,8 @@ public:
 private:
 	uint _width, _height;
 	Graphics::PixelFormat _format;
+	Graphics::Surface _screen;
+	byte _palette[256 * 3];
 	bool _overlayVisible;
 };
 
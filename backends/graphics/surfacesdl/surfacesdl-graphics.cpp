@@ -31,6 +31,7 @@
 #include "common/util.h"
 #include "common/file.h"
 #include "common/frac.h"
+#include "common/profiler.h"
 #ifdef USE_RGB_COLOR
 #include "common/list.h"
 #endif
@@ -1372,6 +1373,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 				if (_videoMode.aspectRatioCorrection && !_overlayInGUI)
 					dst_y = real2Aspect(dst_y);
 
+				PROFILE_SCOPE("Scaler");
 				_scaler->scale((byte *)srcSurf->pixels + (src_x + _maxExtraPixels) * bpp + (src_y + _maxExtraPixels) * srcPitch, srcPitch,
 						(byte *)_hwScreen->pixels + dst_x * bpp + dst_y * dstPitch, dstPitch, dst_w, dst_h, src_x, src_y);
 
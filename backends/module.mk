@@ -179,6 +179,7 @@ MODULE_OBJS += \
 	graphics/surfacesdl/surfacesdl-graphics.o \
 	mixer/sdl/sdl-mixer.o \
 	mutex/sdl/sdl-mutex.o \
+	threads/sdl/sdl-threads.o \
 	timer/sdl/sdl-timer.o
 
 ifndef RISCOS
@@ -413,6 +414,11 @@ endif
 ifeq ($(BACKEND),null)
 MODULE_OBJS += \
 	mixer/null/null-mixer.o
+ifdef HAS_PTHREADS
+MODULE_OBJS += \
+	mutex/pthread/pthread-mutex.o \
+	threads/pthread/pthread-threads.o
+endif
 endif
 
 ifdef MIYOO
@@ -20,6 +20,8 @@
  */
 
 #include <time.h>
+#include <stdlib.h>
+#include <new>
 #ifdef POSIX
 #include <sys/time.h>
 #include <unistd.h>
@@ -49,6 +51,11 @@ typedef void (*sighandler_t)(int);
 #if defined(USE_NULL_DRIVER)
 #include "backends/modular-backend.h"
 #include "backends/mutex/null/null-mutex.h"
+#ifdef HAS_PTHREADS
+#include "backends/mutex/pthread/pthread-mutex.h"
+#include "backends/threads/pthread/pthread-threads.h"
+#endif
+#include "backends/graphics/null/null-graphics.h"
 #include "base/main.h"
 
 #ifndef NULL_DRIVER_USE_FOR_TEST
@@ -56,8 +63,17 @@ typedef void (*sighandler_t)(int);
 #include "backends/timer/default/default-timer.h"
 #include "backends/events/default/default-events.h"
 #include "backends/mixer/null/null-mixer.h"
-#include "backends/graphics/null/null-graphics.h"
 #include "gui/debugger.h"
+
+#ifdef ENABLE_EVENTRECORDER
+#define NULL_DRIVER_USE_EVENTRECORDER
+#include "gui/EventRecorder.h"
+
+// Replacing the global allocator is only wanted in benchmark builds
+#ifdef USE_ALLOCATION_COUNTER
+#define NULL_DRIVER_COUNT_ALLOCATIONS
+#endif
+#endif
 #endif
 
 /*
@@ -85,10 +101,22 @@ public:
 	virtual bool pollEvent(Common::Event &event);
 
 	virtual Common::MutexInternal *createMutex();
+#ifdef HAS_PTHREADS
+	virtual uint getCPUCount();
+	virtual Common::ThreadInternal *createThread(void (*proc)(void *param), void *param);
+	virtual Common::SemaphoreInternal *createSemaphore();
+#endif
 	virtual uint32 getMillis(bool skipRecord = false);
+	virtual uint64 getMicros();
 	virtual void delayMillis(uint msecs);
 	virtual void getTimeAndDate(TimeDate &td, bool skipRecord = false) const;
 
+#ifdef NULL_DRIVER_USE_EVENTRECORDER
+	virtual MixerManager *getMixerManager();
+	virtual Common::TimerManager *getTimerManager();
+	virtual Common::SaveFileManager *getSavefileManager();
+#endif
+
 	virtual void quit();
 
 	virtual void logMessage(LogMessageType::Type type, const char *message);
@@ -117,11 +145,79 @@ OSystem_NULL::OSystem_NULL() {
 	#else
 		#error Unknown and unsupported FS backend
 	#endif
+
+#ifdef NULL_DRIVER_USE_FOR_TEST
+	// Tests do not call initBackend(), but video decoders ask for the
+	// screen format
+	_graphicsManager = new NullGraphicsManager();
+#endif
 }
 
 OSystem_NULL::~OSystem_NULL() {
+#ifdef NULL_DRIVER_USE_EVENTRECORDER
+	// The event recorder owns the timer manager, as with SDL
+	delete g_eventRec.getTimerManager();
+	g_eventRec.registerTimerManager(nullptr);
+#endif
+}
+
+#ifdef NULL_DRIVER_COUNT_ALLOCATIONS
+// Every allocation with new is counted, so that event recorder benchmarks
+// can report the allocations of each frame. Only the plain and nothrow
+// forms are replaced; the aligned forms of C++17 are not counted.
+static volatile uint32 allocationCount = 0;
+
+static void *countedAlloc(size_t size) {
+	// Allocations happen on worker threads too
+#if defined(__GNUC__)
+	__atomic_fetch_add(&allocationCount, 1, __ATOMIC_RELAXED);
+#elif defined(WIN32)
+	InterlockedIncrement((volatile LONG *)&allocationCount);
+#else
+#error No atomic increment for counting allocations
+#endif
+	return malloc(size ? size : 1);
 }
 
+void *operator new(size_t size) {
+	void *ptr = countedAlloc(size);
+	if (!ptr) {
+		// error() would allocate, and exceptions are disabled
+		fputs("Out of memory\n", stderr);
+		exit(1);
+	}
+	return ptr;
+}
+
+void *operator new[](size_t size) {
+	return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+	return countedAlloc(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+	return countedAlloc(size);
+}
+
+void operator delete(void *ptr) noexcept {
+	free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+	free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+	free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+	free(ptr);
+}
+#endif
+
 #if defined(POSIX) && !defined(NULL_DRIVER_USE_FOR_TEST)
 static volatile bool intReceived = false;
 
@@ -145,13 +241,22 @@ void OSystem_NULL::initBackend() {
 	last_handler = signal(SIGINT, intHandler);
 #endif
 
-	_timerManager = new DefaultTimerManager();
 	_eventManager = new DefaultEventManager(this);
 	_savefileManager = new DefaultSaveFileManager();
 	_graphicsManager = new NullGraphicsManager();
 	_mixerManager = new NullMixerManager();
 	// Setup and start mixer
 	_mixerManager->init();
+
+#ifdef NULL_DRIVER_USE_EVENTRECORDER
+	g_eventRec.registerMixerManager(_mixerManager);
+	g_eventRec.registerTimerManager(new DefaultTimerManager());
+#ifdef NULL_DRIVER_COUNT_ALLOCATIONS
+	g_eventRec.registerAllocationCounter(&allocationCount);
+#endif
+#else
+	_timerManager = new DefaultTimerManager();
+#endif
 #endif
 
 	BaseBackend::initBackend();
@@ -159,7 +264,11 @@ void OSystem_NULL::initBackend() {
 
 bool OSystem_NULL::pollEvent(Common::Event &event) {
 #ifndef NULL_DRIVER_USE_FOR_TEST
-	((DefaultTimerManager *)getTimerManager())->checkTimers();
+#ifdef NULL_DRIVER_USE_EVENTRECORDER
+	// While recording or playing back, the event recorder runs the timers
+	if (g_eventRec.getRecordMode() == GUI::EventRecorder::kPassthrough)
+#endif
+		((DefaultTimerManager *)getTimerManager())->checkTimers();
 	((NullMixerManager *)_mixerManager)->update(1);
 
 #ifdef POSIX
@@ -185,25 +294,66 @@ bool OSystem_NULL::pollEvent(Common::Event &event) {
 }
 
 Common::MutexInternal *OSystem_NULL::createMutex() {
+#ifdef HAS_PTHREADS
+	return createPthreadMutexInternal();
+#else
 	return new NullMutexInternal();
+#endif
+}
+
+#ifdef HAS_PTHREADS
+uint OSystem_NULL::getCPUCount() {
+	return getPthreadCPUCount();
 }
 
+Common::ThreadInternal *OSystem_NULL::createThread(void (*proc)(void *param), void *param) {
+	return createPthreadThreadInternal(proc, param);
+}
+
+Common::SemaphoreInternal *OSystem_NULL::createSemaphore() {
+	return createPthreadSemaphoreInternal();
+}
+#endif
+
 uint32 OSystem_NULL::getMillis(bool skipRecord) {
 #ifdef POSIX
 	timeval curTime;
 
 	gettimeofday(&curTime, 0);
 
-	return (uint32)(((curTime.tv_sec - _startTime.tv_sec) * 1000) +
+	uint32 millis = (uint32)(((curTime.tv_sec - _startTime.tv_sec) * 1000) +
 			((curTime.tv_usec - _startTime.tv_usec) / 1000));
 #elif defined(WIN32)
-	return GetTickCount() - _startTime;
+	uint32 millis = GetTickCount() - _startTime;
+#else
+	uint32 millis = 0;
+#endif
+
+#ifdef NULL_DRIVER_USE_EVENTRECORDER
+	g_eventRec.processMillis(millis, skipRecord);
+#endif
+
+	return millis;
+}
+
+uint64 OSystem_NULL::getMicros() {
+#ifdef POSIX
+	timeval curTime;
+
+	gettimeofday(&curTime, 0);
+
+	return (uint64)(curTime.tv_sec - _startTime.tv_sec) * 1000000 + (curTime.tv_usec - _startTime.tv_usec);
 #else
-	return 0;
+	return (uint64)getMillis(true) * 1000;
 #endif
 }
 
 void OSystem_NULL::delayMillis(uint msecs) {
+#ifdef NULL_DRIVER_USE_EVENTRECORDER
+	if (g_eventRec.processDelayMillis())
+		return;
+#endif
+
 #ifdef POSIX
 	usleep(msecs * 1000);
 #elif defined(WIN32)
@@ -221,8 +371,26 @@ void OSystem_NULL::getTimeAndDate(TimeDate &td, bool skipRecord) const {
 	td.tm_mon = t.tm_mon;
 	td.tm_year = t.tm_year;
 	td.tm_wday = t.tm_wday;
+
+#ifdef NULL_DRIVER_USE_EVENTRECORDER
+	g_eventRec.processTimeAndDate(td, skipRecord);
+#endif
 }
 
+#ifdef NULL_DRIVER_USE_EVENTRECORDER
+MixerManager *OSystem_NULL::getMixerManager() {
+	return g_eventRec.getMixerManager();
+}
+
+Common::TimerManager *OSystem_NULL::getTimerManager() {
+	return g_eventRec.getTimerManager();
+}
+
+Common::SaveFileManager *OSystem_NULL::getSavefileManager() {
+	return g_eventRec.getSaveManager(_savefileManager);
+}
+#endif
+
 void OSystem_NULL::quit() {
 	exit(0);
 }
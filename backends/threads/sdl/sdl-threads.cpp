@@ -0,0 +1,100 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#if defined(SDL_BACKEND)
+
+#include "backends/threads/sdl/sdl-threads.h"
+#include "backends/platform/sdl/sdl-sys.h"
+
+/**
+ * SDL thread
+ */
+class SdlThreadInternal final : public Common::ThreadInternal {
+public:
+	SdlThreadInternal(void (*proc)(void *param), void *param) : _proc(proc), _param(param) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		_thread = SDL_CreateThread(&threadProc, "ScummVM worker", this);
+#else
+		_thread = SDL_CreateThread(&threadProc, this);
+#endif
+	}
+	~SdlThreadInternal() override {
+		if (_thread)
+			SDL_WaitThread(_thread, nullptr);
+	}
+
+	bool isValid() const { return _thread != nullptr; }
+
+private:
+	static int SDLCALL threadProc(void *data) {
+		SdlThreadInternal *thread = (SdlThreadInternal *)data;
+		thread->_proc(thread->_param);
+		return 0;
+	}
+
+	SDL_Thread *_thread;
+	void (*_proc)(void *param);
+	void *_param;
+};
+
+/**
+ * SDL semaphore
+ */
+class SdlSemaphoreInternal final : public Common::SemaphoreInternal {
+public:
+	SdlSemaphoreInternal(SDL_sem *sem) : _sem(sem) {}
+	~SdlSemaphoreInternal() override { SDL_DestroySemaphore(_sem); }
+
+	void post() override { SDL_SemPost(_sem); }
+	void wait() override { SDL_SemWait(_sem); }
+
+private:
+	SDL_sem *_sem;
+};
+
+uint getSdlCPUCount() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	return MAX(SDL_GetCPUCount(), 1);
+#else
+	return 1;
+#endif
+}
+
+Common::ThreadInternal *createSdlThreadInternal(void (*proc)(void *param), void *param) {
+	SdlThreadInternal *thread = new SdlThreadInternal(proc, param);
+	if (!thread->isValid()) {
+		delete thread;
+		return nullptr;
+	}
+	return thread;
+}
+
+Common::SemaphoreInternal *createSdlSemaphoreInternal() {
+	SDL_sem *sem = SDL_CreateSemaphore(0);
+	if (!sem)
+		return nullptr;
+	return new SdlSemaphoreInternal(sem);
+}
+
+#endif
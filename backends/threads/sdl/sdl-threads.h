@@ -19,46 +19,14 @@
  *
  */
 
-#ifndef BLADERUNNER_AUDIO_CACHE_H
-#define BLADERUNNER_AUDIO_CACHE_H
 
-#include "common/array.h"
-#include "common/mutex.h"
+#ifndef BACKENDS_THREADS_SDL_H
+#define BACKENDS_THREADS_SDL_H
 
-namespace BladeRunner {
+#include "common/thread.h"
 
-/*
- * This is a poor imitation of Bladerunner's resource cache
- */
-class AudioCache {
-	struct cacheItem {
-		int32   hash;
-		int     refs;
-		uint    lastAccess;
-		byte   *data;
-		uint32  size;
-	};
-
-	Common::Mutex            _mutex;
-	Common::Array<cacheItem> _cacheItems;
-
-	uint32 _totalSize;
-	uint32 _maxSize;
-	uint32 _accessCounter;
-
-public:
-	AudioCache();
-	~AudioCache();
-
-	bool  canAllocate(uint32 size) const;
-	bool  dropOldest();
-	byte *findByHash(int32 hash);
-	void  storeByHash(int32 hash, Common::SeekableReadStream *stream);
-
-	void  incRef(int32 hash);
-	void  decRef(int32 hash);
-};
-
-} // End of namespace BladeRunner
+uint getSdlCPUCount();
+Common::ThreadInternal *createSdlThreadInternal(void (*proc)(void *param), void *param);
+Common::SemaphoreInternal *createSdlSemaphoreInternal();
 
 #endif
@@ -0,0 +1,639 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_FLATHASHMAP_H
+#define COMMON_FLATHASHMAP_H
+
+#include "common/hashmap.h"
+#include "common/util.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_flathashmap Flat hash table (FlatHashMap)
+ * @ingroup common
+ *
+ * @brief API for operations on an open-addressing hash table.
+ *
+ * @{
+ */
+
+/**
+ * FlatHashMap<Key,Val> is a drop-in alternative to HashMap<Key,Val> which
+ * stores its keys and values inline in a single contiguous array, instead of
+ * allocating every node separately. Collisions are resolved by linear
+ * probing. Next to every slot, a control byte records whether the slot is
+ * empty, erased, or holds 7 bits of the hash of its key, so most mismatching
+ * slots are skipped without calling the equality functor.
+ *
+ * If @p CacheHashes is true, the full hash of every key is stored as well.
+ * This costs an extra size_type per slot, but avoids calling the hash
+ * function when the table grows and further reduces key comparisons, which
+ * pays off for expensive keys like strings.
+ *
+ * Unlike with HashMap, the address of a value is not stable: inserting a new
+ * key may move all entries. Erasing an entry does not invalidate iterators
+ * to other entries.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key>, bool CacheHashes = false>
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+	struct Node {
+		Val _value;
+		const Key _key;
+		explicit Node(const Key &key) : _value(), _key(key) {}
+		explicit Node(Key &&key) : _value(), _key(Common::move(key)) {}
+	};
+
+private:
+
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes> HM_t;
+
+	enum {
+		FLATHASHMAP_MIN_CAPACITY = 16,
+
+		// The quotient of the next two constants controls how much the
+		// internal storage may fill up, counting erased slots, before it
+		// is rehashed.
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 3,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 4
+	};
+
+	enum {
+		/** Control byte of an unused slot. Used slots have the top bit clear. */
+		kSlotEmpty = 0x80,
+		/** Control byte of an erased slot, which must not stop a probe sequence. */
+		kSlotDeleted = 0xFE
+	};
+
+	/** Default value, returned by the const getVal. */
+	Val _defaultVal;
+
+	byte *_block;           ///< single allocation holding _hashes, _nodes and _ctrl
+	size_type *_hashes;     ///< full key hashes if CacheHashes is set, otherwise nullptr
+	Node *_nodes;           ///< slot array of size _mask + 1, only used slots are constructed
+	byte *_ctrl;            ///< control byte of every slot
+	size_type _mask;        ///< Capacity minus one; capacity is a power of two
+	size_type _shift;       ///< 32 - log2(capacity), used to compute the home slot
+	size_type _size;
+	size_type _deleted;     ///< Number of erased slots
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	static byte hashTag(size_type hash) {
+		return (byte)((hash ^ (hash >> 7) ^ (hash >> 14) ^ (hash >> 21)) & 0x7F);
+	}
+
+	size_type homeSlot(size_type hash) const {
+		// Fibonacci hashing, so that keys with poor low bits (e.g. pointers)
+		// are still spread over the table.
+		return (size_type)(hash * 0x9E3779B1U) >> _shift;
+	}
+
+	bool isUsed(size_type idx) const {
+		return !(_ctrl[idx] & 0x80);
+	}
+
+	void allocStorage(size_type capacity);
+	void freeStorage();
+	void assign(const HM_t &map);
+	size_type lookup(const Key &key) const;
+	size_type lookupAndCreateIfMissing(const Key &key);
+	void rehash(size_type newCapacity);
+	void eraseSlot(size_type idx);
+
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+	protected:
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != nullptr);
+			assert(_idx <= _hashmap->_mask);
+			assert(_hashmap->isUsed(_idx));
+			return &_hashmap->_nodes[_idx];
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(nullptr) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			do {
+				_idx++;
+			} while (_idx <= _hashmap->_mask && !_hashmap->isUsed(_idx));
+			if (_idx > _hashmap->_mask)
+				_idx = (size_type)-1;
+
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const HM_t &map);
+	~FlatHashMap();
+
+	HM_t &operator=(const HM_t &map) {
+		if (this == &map)
+			return *this;
+
+		// Remove the previous content and ...
+		clear();
+		freeStorage();
+		// ... copy the new stuff.
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const;
+
+	Val &operator[](const Key &key);
+	const Val &operator[](const Key &key) const;
+
+	Val &getOrCreateVal(const Key &key);
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getValOrDefault(const Key &key) const;
+	const Val &getValOrDefault(const Key &key, const Val &defaultVal) const;
+	bool tryGetVal(const Key &key, Val &out) const;
+	void setVal(const Key &key, const Val &val);
+
+	void clear(bool shrinkArray = 0);
+
+	/**
+	 * Make room for at least @p count entries, so that inserting them does
+	 * not rehash the table.
+	 */
+	void reserve(size_type count);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	size_type size() const { return _size; }
+
+	iterator	begin() {
+		// Find and return the first used slot
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (isUsed(ctr))
+				return iterator(ctr, this);
+		}
+		return end();
+	}
+	iterator	end() {
+		return iterator((size_type)-1, this);
+	}
+
+	const_iterator	begin() const {
+		// Find and return the first used slot
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (isUsed(ctr))
+				return const_iterator(ctr, this);
+		}
+		return end();
+	}
+	const_iterator	end() const {
+		return const_iterator((size_type)-1, this);
+	}
+
+	iterator	find(const Key &key) {
+		size_type ctr = lookup(key);
+		if (ctr <= _mask)
+			return iterator(ctr, this);
+		return end();
+	}
+
+	const_iterator	find(const Key &key) const {
+		size_type ctr = lookup(key);
+		if (ctr <= _mask)
+			return const_iterator(ctr, this);
+		return end();
+	}
+
+	/** Return true if hashmap is empty. */
+	bool empty() const {
+		return (_size == 0);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+/**
+ * Base constructor, creates an empty hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc, bool CacheHashes>
+FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::FlatHashMap() : _defaultVal() {
+	allocStorage(FLATHASHMAP_MIN_CAPACITY);
+	_size = 0;
+	_deleted = 0;
+}
+
+/**
+ * Copy constructor, creates a full copy of the given hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc, bool CacheHashes>
+FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::FlatHashMap(const HM_t &map) :
+	_defaultVal() {
+	assign(map);
+}
+
+/**
+ * Destructor, frees all used memory.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc, bool CacheHashes>
+FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::~FlatHashMap() {
+	clear();
+	freeStorage();
+}
+
+/**
+ * Internal method allocating empty storage for @p capacity slots. The slot
+ * array is placed after the hash array, which keeps both aligned as the
+ * capacity is a power of two of at least FLATHASHMAP_MIN_CAPACITY.
+ *
+ * @note The previous storage is *not* deallocated here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc, bool CacheHashes>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::allocStorage(size_type capacity) {
+	assert(capacity >= FLATHASHMAP_MIN_CAPACITY && (capacity & (capacity - 1)) == 0);
+
+	const size_t hashBytes = CacheHashes ? capacity * sizeof(size_type) : 0;
+	const size_t totalBytes = hashBytes + capacity * sizeof(Node) + capacity;
+	_block = (byte *)malloc(totalBytes);
+	if (!_block)
+		::error("Common::FlatHashMap: failure to allocate %u bytes", (uint)totalBytes);
+
+	_hashes = CacheHashes ? (size_type *)_block : nullptr;
+	_nodes = (Node *)(_block + hashBytes);
+	_ctrl = _block + hashBytes + capacity * sizeof(Node);
+	memset(_ctrl, kSlotEmpty, capacity);
+
+	_mask = capacity - 1;
+	_shift = 32;
+	for (size_type c = capacity; c > 1; c >>= 1)
+		_shift--;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc, bool CacheHashes>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::freeStorage() {
+	free(_block);
+	_block = nullptr;
+	_hashes = nullptr;
+	_nodes = nullptr;
+	_ctrl = nullptr;
+}
+
+/**
+ * Internal method for assigning the content of another FlatHashMap
+ * to this one. The slot layout is copied verbatim.
+ *
+ * @note The previous storage here is *not* deallocated here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc, bool CacheHashes>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::assign(const HM_t &map) {
+	allocStorage(map._mask + 1);
+	memcpy(_ctrl, map._ctrl, _mask + 1);
+	if (CacheHashes)
+		memcpy(_hashes, map._hashes, (_mask + 1) * sizeof(size_type));
+
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (isUsed(ctr)) {
+			new ((void *)&_nodes[ctr]) Node(map._nodes[ctr]._key);
+			_nodes[ctr]._value = map._nodes[ctr]._value;
+		}
+	}
+	_size = map._size;
+	_deleted = map._deleted;
+}
+
+/**
+ * Clear all values in the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc, bool CacheHashes>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::clear(bool shrinkArray) {
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (isUsed(ctr))
+			_nodes[ctr].~Node();
+	}
+
+	if (shrinkArray && _mask >= FLATHASHMAP_MIN_CAPACITY) {
+		freeStorage();
+		allocStorage(FLATHASHMAP_MIN_CAPACITY);
+	} else {
+		memset(_ctrl, kSlotEmpty, _mask + 1);
+	}
+
+	_size = 0;
+	_deleted = 0;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc, bool CacheHashes>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::reserve(size_type count) {
+	size_type capacity = _mask + 1;
+	while (count * FLATHASHMAP_LOADFACTOR_DENOMINATOR > capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR)
+		capacity *= 2;
+	if (capacity > _mask + 1)
+		rehash(capacity);
+}
+
+/**
+ * Move all entries into new storage of @p newCapacity slots. This also drops
+ * all erased slots, so it is used with the current capacity to clean up
+ * tables that have seen many erasures.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc, bool CacheHashes>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::rehash(size_type newCapacity) {
+	assert(newCapacity * FLATHASHMAP_LOADFACTOR_NUMERATOR >= _size * FLATHASHMAP_LOADFACTOR_DENOMINATOR);
+
+	byte *oldBlock = _block;
+	size_type *oldHashes = _hashes;
+	Node *oldNodes = _nodes;
+	byte *oldCtrl = _ctrl;
+	const size_type oldMask = _mask;
+
+	allocStorage(newCapacity);
+
+	for (size_type ctr = 0; ctr <= oldMask; ++ctr) {
+		if (oldCtrl[ctr] & 0x80)
+			continue;
+
+		// Since we know that no key exists twice in the old table and the
+		// new table has no erased slots, the first empty slot is the one.
+		Node &oldNode = oldNodes[ctr];
+		const size_type hash = CacheHashes ? oldHashes[ctr] : _hash(oldNode._key);
+		size_type idx = homeSlot(hash);
+		while (isUsed(idx))
+			idx = (idx + 1) & _mask;
+
+		// The old node is destroyed right after, so its key can be moved.
+		new ((void *)&_nodes[idx]) Node(Common::move(const_cast<Key &>(oldNode._key)));
+		_nodes[idx]._value = Common::move(oldNode._value);
+		oldNode.~Node();
+		_ctrl[idx] = oldCtrl[ctr];
+		if (CacheHashes)
+			_hashes[idx] = hash;
+	}
+
+	_deleted = 0;
+	free(oldBlock);
+}
+
+/**
+ * Return the slot holding @p key, or _mask + 1 if it is not present.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc, bool CacheHashes>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::lookup(const Key &key) const {
+	const size_type hash = _hash(key);
+	const byte tag = hashTag(hash);
+
+	// The load factor guarantees there is always an empty slot to stop at.
+	for (size_type ctr = homeSlot(hash); ; ctr = (ctr + 1) & _mask) {
+		const byte c = _ctrl[ctr];
+		if (c == kSlotEmpty)
+			return _mask + 1;
+		if (c == tag && (!CacheHashes || _hashes[ctr] == hash) && _equal(_nodes[ctr]._key, key))
+			return ctr;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc, bool CacheHashes>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::lookupAndCreateIfMissing(const Key &key) {
+	const size_type hash = _hash(key);
+	const byte tag = hashTag(hash);
+	const size_type NONE_FOUND = _mask + 1;
+	size_type firstFree = NONE_FOUND;
+	size_type ctr;
+
+	for (ctr = homeSlot(hash); ; ctr = (ctr + 1) & _mask) {
+		const byte c = _ctrl[ctr];
+		if (c == kSlotEmpty)
+			break;
+		if (c == kSlotDeleted) {
+			if (firstFree == NONE_FOUND)
+				firstFree = ctr;
+		} else if (c == tag && (!CacheHashes || _hashes[ctr] == hash) && _equal(_nodes[ctr]._key, key)) {
+			return ctr;
+		}
+	}
+
+	if (firstFree != NONE_FOUND) {
+		// Reusing an erased slot does not change the load.
+		ctr = firstFree;
+		_deleted--;
+	} else if ((_size + _deleted + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR > (_mask + 1) * FLATHASHMAP_LOADFACTOR_NUMERATOR) {
+		// Keep the load factor below a certain threshold. If erased slots
+		// make up a large part of the load, rehashing at the same capacity
+		// is enough.
+		size_type capacity = _mask + 1;
+		if ((_size + 1) * 2 * FLATHASHMAP_LOADFACTOR_DENOMINATOR > capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR)
+			capacity *= 2;
+		rehash(capacity);
+
+		for (ctr = homeSlot(hash); isUsed(ctr); ctr = (ctr + 1) & _mask)
+			;
+	}
+
+	new ((void *)&_nodes[ctr]) Node(key);
+	_ctrl[ctr] = tag;
+	if (CacheHashes)
+		_hashes[ctr] = hash;
+	_size++;
+
+	return ctr;
+}
+
+/**
+ * Internal method to erase the entry stored in slot @p idx.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc, bool CacheHashes>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::eraseSlot(size_type idx) {
+	assert(idx <= _mask && isUsed(idx));
+
+	_nodes[idx].~Node();
+	_size--;
+
+	// If the next slot is empty, no probe sequence continues past this slot,
+	// so it can become empty as well instead of leaving an erased marker.
+	if (_ctrl[(idx + 1) & _mask] == kSlotEmpty) {
+		_ctrl[idx] = kSlotEmpty;
+	} else {
+		_ctrl[idx] = kSlotDeleted;
+		_deleted++;
+	}
+}
+
+/**
+ * Check whether the hashmap contains the given key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc, bool CacheHashes>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::contains(const Key &key) const {
+	return lookup(key) <= _mask;
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc, bool CacheHashes>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::operator[](const Key &key) {
+	return getOrCreateVal(key);
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc, bool CacheHashes>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::operator[](const Key &key) const {
+	return getVal(key);
+}
+
+/**
+ * Get a value from the hashmap, creating it if it is missing.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc, bool CacheHashes>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::getOrCreateVal(const Key &key) {
+	size_type ctr = lookupAndCreateIfMissing(key);
+	return _nodes[ctr]._value;
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc, bool CacheHashes>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::getVal(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr <= _mask)
+		return _nodes[ctr]._value;
+	else
+		// See the comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc, bool CacheHashes>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::getVal(const Key &key) const {
+	size_type ctr = lookup(key);
+	if (ctr <= _mask)
+		return _nodes[ctr]._value;
+	else
+		// See the comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc, bool CacheHashes>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::getValOrDefault(const Key &key) const {
+	return getValOrDefault(key, _defaultVal);
+}
+
+/**
+ * Get a value from the hashmap. If the key is not present, then return @p defaultVal.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc, bool CacheHashes>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::getValOrDefault(const Key &key, const Val &defaultVal) const {
+	size_type ctr = lookup(key);
+	if (ctr <= _mask)
+		return _nodes[ctr]._value;
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc, bool CacheHashes>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::tryGetVal(const Key &key, Val &out) const {
+	size_type ctr = lookup(key);
+	if (ctr <= _mask) {
+		out = _nodes[ctr]._value;
+		return true;
+	} else {
+		return false;
+	}
+}
+
+/**
+ * Assign an element specified by @p key to a value @p val.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc, bool CacheHashes>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::setVal(const Key &key, const Val &val) {
+	size_type ctr = lookupAndCreateIfMissing(key);
+	_nodes[ctr]._value = val;
+}
+
+/**
+ * Erase an element referred to by an iterator.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc, bool CacheHashes>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	eraseSlot(entry._idx);
+}
+
+/**
+ * Erase an element specified by a key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc, bool CacheHashes>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc, CacheHashes>::erase(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr <= _mask)
+		eraseSlot(ctr);
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
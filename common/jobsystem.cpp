@@ -0,0 +1,500 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/jobsystem.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+#include "common/thread.h"
+
+namespace Common {
+
+DECLARE_SINGLETON(JobSystem);
+
+enum {
+	kScratchAlignment = 16,
+	kScratchInitialSize = 16 * 1024,
+	kPiecesPerWorker = 4		///< Pieces a loop is split into per worker, so that idle workers can steal some
+};
+
+ScratchArena::ScratchArena() : _block(nullptr), _blockSize(0), _used(0), _overflowSize(0) {
+}
+
+ScratchArena::~ScratchArena() {
+	for (uint i = 0; i < _overflow.size(); i++)
+		free(_overflow[i]);
+	free(_block);
+}
+
+void *ScratchArena::allocate(uint32 size) {
+	size = (size + kScratchAlignment - 1) & ~(kScratchAlignment - 1);
+
+	if (!_block) {
+		_blockSize = MAX<uint32>(kScratchInitialSize, size);
+		_block = (byte *)malloc(_blockSize);
+	}
+
+	if (_blockSize - _used >= size) {
+		byte *result = _block + _used;
+		_used += size;
+		return result;
+	}
+
+	// Earlier allocations must stay where they are, so allocate separately
+	// until the next reset grows the block
+	byte *result = (byte *)malloc(size);
+	_overflow.push_back(result);
+	_overflowSize += size;
+	return result;
+}
+
+void ScratchArena::reset() {
+	rewind(0, 0);
+}
+
+void ScratchArena::rewind(uint32 used, uint overflow) {
+	while (_overflow.size() > overflow) {
+		free(_overflow.back());
+		_overflow.pop_back();
+	}
+	_used = used;
+
+	if (!used && !overflow && _overflowSize) {
+		free(_block);
+		_blockSize += _overflowSize;
+		_block = (byte *)malloc(_blockSize);
+		_overflowSize = 0;
+	}
+}
+
+TaskGroup::TaskGroup() : _pending(0), _waiting(false), _done(nullptr) {
+}
+
+TaskGroup::~TaskGroup() {
+	wait();
+	delete _done;
+}
+
+void TaskGroup::run(TaskProc proc, void *param, uint worker) {
+	JobSystem &system = JobSystem::instance();
+	system.ensureStarted();
+
+	if (!system.isThreaded()) {
+		system.runInline(proc, param, worker);
+		return;
+	}
+
+	{
+		StackLock lock(system._mutex);
+		_pending++;
+	}
+
+	JobSystem::Task task;
+	task.proc = proc;
+	task.param = param;
+	task.group = this;
+	system.push(task, worker);
+}
+
+void TaskGroup::wait(uint worker) {
+	JobSystem::instance().waitFor(this, worker);
+}
+
+JobSystem::Worker::Worker(JobSystem *s, uint i) : jobSystem(s), index(i), head(0) {
+	memset(&stats, 0, sizeof(stats));
+}
+
+JobSystem::JobSystem() : _started(false), _quit(false), _nextQueue(0), _helping(false), _threadCount(0), _wake(nullptr), _statsStart(0) {
+}
+
+JobSystem::~JobSystem() {
+	stop();
+}
+
+void JobSystem::setThreadCount(uint count) {
+	stop();
+	_threadCount = count;
+}
+
+void JobSystem::ensureStarted() {
+	StackLock lock(_mutex);
+	if (!_started)
+		start();
+}
+
+void JobSystem::start() {
+	_started = true;
+	_statsStart = g_system->getMillis();
+	_workers.push_back(new Worker(this, 0));
+
+	// Leave one core for the calling thread, and some for the rest of
+	// the system on large machines
+	const uint threads = (_threadCount ? _threadCount : MIN<uint>(g_system->getCPUCount(), 8)) - 1;
+	if (!threads)
+		return;
+
+	_wake = g_system->createSemaphore();
+	if (!_wake)
+		return;
+
+	// All queues must exist before the first thread steals. The threads
+	// only look at the queues once _wake is posted, so the queues of
+	// threads which failed to start can be dropped again.
+	for (uint i = 1; i <= threads; i++)
+		_workers.push_back(new Worker(this, i));
+
+	for (uint i = 1; i <= threads; i++) {
+		ThreadInternal *thread = g_system->createThread(&workerProc, _workers[i]);
+		if (!thread)
+			break;
+		_threads.push_back(thread);
+	}
+
+	while (_workers.size() > _threads.size() + 1) {
+		delete _workers.back();
+		_workers.pop_back();
+	}
+}
+
+void JobSystem::stop() {
+	{
+		StackLock lock(_mutex);
+		_quit = true;
+	}
+
+	for (uint i = 0; i < _threads.size(); i++)
+		_wake->post();
+
+	// Deleting a thread waits for it to return
+	for (uint i = 0; i < _threads.size(); i++)
+		delete _threads[i];
+	_threads.clear();
+
+	delete _wake;
+	_wake = nullptr;
+
+	for (uint i = 0; i < _workers.size(); i++)
+		delete _workers[i];
+	_workers.clear();
+
+	StackLock lock(_mutex);
+	_started = false;
+	_quit = false;
+	_nextQueue = 0;
+}
+
+uint JobSystem::getWorkerCount() {
+	ensureStarted();
+	return _workers.size();
+}
+
+ScratchArena &JobSystem::getScratch(uint worker) {
+	if (worker >= _workers.size())
+		error("JobSystem::getScratch(): Invalid worker %u", worker);
+
+	return _workers[worker]->scratch;
+}
+
+JobSystemStats JobSystem::getStats(bool reset) {
+	ensureStarted();
+
+	JobSystemStats stats;
+	const uint32 now = g_system->getMillis();
+	{
+		StackLock lock(_mutex);
+		stats.elapsedTime = now - _statsStart;
+		if (reset)
+			_statsStart = now;
+	}
+
+	for (uint i = 0; i < _workers.size(); i++) {
+		Worker &worker = *_workers[i];
+		StackLock lock(worker.mutex);
+		stats.workers.push_back(worker.stats);
+		if (reset)
+			memset(&worker.stats, 0, sizeof(worker.stats));
+	}
+
+	return stats;
+}
+
+void JobSystem::parallelFor(uint begin, uint end, uint grain, RangeProc proc, void *param, uint worker) {
+	if (begin >= end)
+		return;
+
+	ensureStarted();
+
+	Loop loop;
+	loop.jobSystem = this;
+	loop.proc = proc;
+	loop.param = param;
+	loop.next = begin;
+	loop.end = end;
+
+	if (!isThreaded()) {
+		loop.pieceSize = end - begin;
+		runInline(&loopProc, &loop, worker);
+		return;
+	}
+
+	// Split into pieces of at least grain indices, but enough of them to
+	// keep all workers busy when the pieces take different times
+	const uint count = end - begin;
+	const uint pieces = _workers.size() * kPiecesPerWorker;
+	loop.pieceSize = MAX<uint>(MAX<uint>(grain, 1), (count + pieces - 1) / pieces);
+
+	// Every task takes pieces until none are left, so one task per worker
+	// is enough
+	const uint tasks = MIN<uint>(_workers.size(), (count + loop.pieceSize - 1) / loop.pieceSize);
+
+	TaskGroup group;
+	for (uint i = 0; i < tasks; i++)
+		group.run(&loopProc, &loop, worker);
+	group.wait(worker);
+}
+
+void JobSystem::loopProc(void *param, uint worker) {
+	Loop *loop = (Loop *)param;
+	JobSystem *system = loop->jobSystem;
+	ScratchArena &scratch = system->getScratch(worker);
+
+	for (;;) {
+		uint begin, end;
+		{
+			StackLock lock(system->_mutex);
+			if (loop->next >= loop->end)
+				return;
+			begin = loop->next;
+			end = begin + MIN(loop->pieceSize, loop->end - begin);
+			loop->next = end;
+		}
+
+		// Free what the piece allocated before the next one
+		const uint32 used = scratch._used;
+		const uint overflow = scratch._overflow.size();
+		loop->proc(loop->param, begin, end, worker);
+		scratch.rewind(used, overflow);
+	}
+}
+
+void JobSystem::push(const Task &task, uint worker) {
+	uint queue = worker;
+	if (worker == kJobNoWorker) {
+		StackLock lock(_mutex);
+		queue = _nextQueue;
+		_nextQueue = (_nextQueue + 1) % _workers.size();
+	}
+
+	{
+		Worker &target = *_workers[queue];
+		StackLock lock(target.mutex);
+		target.tasks.push_back(task);
+	}
+
+	_wake->post();
+}
+
+bool JobSystem::pop(uint worker, Task &task) {
+	Worker &owner = *_workers[worker];
+	StackLock lock(owner.mutex);
+	if (owner.head >= owner.tasks.size())
+		return false;
+
+	// The most recently queued task is most likely to find its data in the cache
+	task = owner.tasks.back();
+	owner.tasks.pop_back();
+	if (owner.head == owner.tasks.size()) {
+		owner.tasks.resize(0);
+		owner.head = 0;
+	}
+	return true;
+}
+
+bool JobSystem::steal(uint thief, Task &task) {
+	for (uint i = 1; i < _workers.size(); i++) {
+		Worker &victim = *_workers[(thief + i) % _workers.size()];
+		StackLock lock(victim.mutex);
+		if (victim.head >= victim.tasks.size())
+			continue;
+
+		// Take the oldest task, which is usually the largest remaining one
+		task = victim.tasks[victim.head++];
+
+		// Move the remaining tasks to the front once half of the array is unused
+		if (victim.head * 2 >= victim.tasks.size()) {
+			const uint remaining = victim.tasks.size() - victim.head;
+			for (uint j = 0; j < remaining; j++)
+				victim.tasks[j] = victim.tasks[victim.head + j];
+			victim.tasks.resize(remaining);
+			victim.head = 0;
+		}
+		return true;
+	}
+
+	return false;
+}
+
+bool JobSystem::runOne(uint worker) {
+	Task task;
+	if (pop(worker, task))
+		runTask(task, worker, false);
+	else if (steal(worker, task))
+		runTask(task, worker, true);
+	else
+		return false;
+
+	return true;
+}
+
+void JobSystem::runTask(const Task &task, uint worker, bool stolen) {
+	Worker &runner = *_workers[worker];
+
+	// Tasks may run other tasks while they wait, so only free what this
+	// task allocated
+	const uint32 used = runner.scratch._used;
+	const uint overflow = runner.scratch._overflow.size();
+	task.proc(task.param, worker);
+	runner.scratch.rewind(used, overflow);
+
+	{
+		StackLock lock(runner.mutex);
+		runner.stats.tasks++;
+		if (stolen)
+			runner.stats.steals++;
+	}
+
+	if (task.group)
+		finish(task.group);
+}
+
+void JobSystem::runInline(TaskGroup::TaskProc proc, void *param, uint worker) {
+	Task task;
+	task.proc = proc;
+	task.param = param;
+	task.group = nullptr;
+
+	if (worker != kJobNoWorker) {
+		runTask(task, worker, false);
+		return;
+	}
+
+	// Threads outside of the pool share worker 0, so they take turns
+	StackLock lock(_serialMutex);
+	const uint32 start = g_system->getMillis();
+	runTask(task, 0, false);
+	addBusyTime(0, start);
+}
+
+void JobSystem::waitFor(TaskGroup *group, uint worker) {
+	// A thread outside of the pool helps as worker 0, unless another one
+	// already does
+	bool helping = false;
+	if (worker == kJobNoWorker) {
+		StackLock lock(_mutex);
+		if (!group->_pending)
+			return;
+		if (!_helping) {
+			_helping = true;
+			helping = true;
+			worker = 0;
+		}
+	}
+
+	for (;;) {
+		{
+			StackLock lock(_mutex);
+			if (!group->_pending)
+				break;
+		}
+
+		if (worker != kJobNoWorker) {
+			const uint32 start = g_system->getMillis();
+			const bool ran = runOne(worker);
+			// Tasks run by a worker thread count towards its busy time already
+			if (helping)
+				addBusyTime(0, start);
+			if (ran)
+				continue;
+		}
+
+		// Nothing is queued, so the remaining tasks of the group are
+		// running on other threads
+		{
+			StackLock lock(_mutex);
+			if (!group->_pending)
+				break;
+			if (!group->_done)
+				group->_done = g_system->createSemaphore();
+			group->_waiting = true;
+		}
+
+		group->_done->wait();
+
+		// finish() posts with _mutex held, so taking it here makes sure it
+		// does not use the group anymore
+		StackLock lock(_mutex);
+		group->_waiting = false;
+	}
+
+	if (helping) {
+		StackLock lock(_mutex);
+		_helping = false;
+	}
+}
+
+void JobSystem::finish(TaskGroup *group) {
+	StackLock lock(_mutex);
+	if (--group->_pending == 0 && group->_waiting)
+		group->_done->post();
+}
+
+void JobSystem::addBusyTime(uint worker, uint32 start) {
+	const uint32 busy = g_system->getMillis() - start;
+
+	Worker &owner = *_workers[worker];
+	StackLock lock(owner.mutex);
+	owner.stats.busyTime += busy;
+}
+
+void JobSystem::workerProc(void *param) {
+	Worker *worker = (Worker *)param;
+	JobSystem *system = worker->jobSystem;
+
+	for (;;) {
+		system->_wake->wait();
+
+		{
+			StackLock lock(system->_mutex);
+			if (system->_quit)
+				return;
+		}
+
+		for (;;) {
+			const uint32 start = g_system->getMillis();
+			const bool ran = system->runOne(worker->index);
+			system->addBusyTime(worker->index, start);
+			if (!ran)
+				break;
+		}
+	}
+}
+
+} // End of namespace Common
@@ -0,0 +1,250 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef COMMON_JOBSYSTEM_H
+#define COMMON_JOBSYSTEM_H
+
+#include "common/array.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+
+namespace Common {
+
+class JobSystem;
+class SemaphoreInternal;
+class ThreadInternal;
+
+/**
+ * @defgroup common_jobsystem Job system
+ * @ingroup common
+ *
+ * @brief Runs tasks and loops on several CPU cores.
+ * @{
+ */
+
+enum {
+	/**
+	 * The worker index passed by threads which are not running a task.
+	 * Tasks must pass the index they were called with instead.
+	 */
+	kJobNoWorker = 0xFFFFFFFF
+};
+
+/**
+ * Memory for temporary data of a task. Allocations stay valid until the
+ * task returns, and the memory is reused by the next task on the same
+ * worker, so tasks do not need to allocate from the heap.
+ */
+class ScratchArena {
+public:
+	ScratchArena();
+	~ScratchArena();
+
+	/** Return @p size bytes, aligned for any type. */
+	void *allocate(uint32 size);
+
+	/** Free all allocations. */
+	void reset();
+
+private:
+	friend class JobSystem;
+
+	/** Free the allocations made since _used and _overflow had the given sizes. */
+	void rewind(uint32 used, uint overflow);
+
+	byte *_block;
+	uint32 _blockSize;
+	uint32 _used;
+	uint32 _overflowSize;		///< Bytes in _overflow, which the next reset() merges into _block
+	Array<byte *> _overflow;
+};
+
+/** Statistics of one thread of the job system. */
+struct JobWorkerStats {
+	uint32 tasks;		///< Tasks run
+	uint32 steals;		///< Tasks taken from the queue of another thread
+	uint32 busyTime;	///< Milliseconds spent running tasks
+};
+
+/** Statistics of the job system, as returned by JobSystem::getStats(). */
+struct JobSystemStats {
+	uint32 elapsedTime;				///< Milliseconds since the statistics were reset
+	Array<JobWorkerStats> workers;	///< Entry 0 is the threads which wait for tasks, the others are the workers
+};
+
+/**
+ * A set of tasks which can be waited for. The group must stay alive until
+ * wait() returns; the destructor waits for the tasks.
+ */
+class TaskGroup {
+public:
+	/**
+	 * A task. @p worker is the index of the thread running it, for
+	 * JobSystem::getScratch().
+	 */
+	typedef void (*TaskProc)(void *param, uint worker);
+
+	TaskGroup();
+	~TaskGroup();
+
+	/**
+	 * Queue a task. @p worker is the index of the calling thread if it is
+	 * a task itself, so that the task goes to the queue of the same
+	 * worker.
+	 */
+	void run(TaskProc proc, void *param, uint worker = kJobNoWorker);
+
+	/** Run queued tasks until all tasks of the group have returned. */
+	void wait(uint worker = kJobNoWorker);
+
+private:
+	friend class JobSystem;
+
+	uint _pending;					///< Tasks which did not return yet
+	bool _waiting;
+	SemaphoreInternal *_done;		///< Posted when the last task returns while _waiting is set
+};
+
+/**
+ * A pool of worker threads running tasks and parallel loops.
+ *
+ * Every thread has a queue of tasks. Threads take tasks from the back of
+ * their own queue, and idle threads steal from the front of the queues of
+ * the others. Threads waiting for a group or loop run queued tasks rather
+ * than block, so tasks may start and wait for more tasks.
+ *
+ * The workers are started on first use. Without thread support in the
+ * backend, all tasks run on the calling thread when they are queued, so
+ * callers must produce the same result either way.
+ */
+class JobSystem : public Singleton<JobSystem> {
+public:
+	/** The body of a parallel loop, called for the indices [begin, end). */
+	typedef void (*RangeProc)(void *param, uint begin, uint end, uint worker);
+
+	JobSystem();
+	~JobSystem();
+
+	/**
+	 * Call @p proc for the range [begin, end) split into pieces of at least
+	 * @p grain indices, and return once all calls have returned.
+	 *
+	 * @param worker  The index of the calling thread, see TaskGroup::run().
+	 */
+	void parallelFor(uint begin, uint end, uint grain, RangeProc proc, void *param, uint worker = kJobNoWorker);
+
+	/**
+	 * Return the number of threads tasks are spread over, including the
+	 * threads waiting for them.
+	 */
+	uint getWorkerCount();
+
+	/**
+	 * Return the scratch memory of a worker. It must only be used by the
+	 * task running on that worker, and is cleared after every task.
+	 */
+	ScratchArena &getScratch(uint worker);
+
+	/** Return the statistics, and optionally start counting anew. */
+	JobSystemStats getStats(bool reset);
+
+	/**
+	 * Spread tasks over @p count threads, including the threads waiting
+	 * for them, whatever the number of CPU cores. A count of 0 goes back
+	 * to the default. This restarts the workers, so no tasks may be
+	 * running. Tests and benchmarks use it to compare the results and
+	 * timings for different thread counts.
+	 */
+	void setThreadCount(uint count);
+
+private:
+	friend class TaskGroup;
+
+	struct Task {
+		TaskGroup::TaskProc proc;
+		void *param;
+		TaskGroup *group;
+	};
+
+	/** The queue and state of a thread. Entry 0 belongs to threads outside of the pool. */
+	struct Worker {
+		Worker(JobSystem *s, uint i);
+
+		JobSystem *jobSystem;
+		uint index;
+		Mutex mutex;			///< Guards tasks, head and stats
+		Array<Task> tasks;
+		uint head;				///< Index of the first task, which thieves take
+		ScratchArena scratch;
+		JobWorkerStats stats;
+	};
+
+	/** The state of a parallelFor() call, shared by its tasks. */
+	struct Loop {
+		JobSystem *jobSystem;
+		RangeProc proc;
+		void *param;
+		uint next;				///< First index of the next piece
+		uint end;
+		uint pieceSize;
+	};
+
+	static void workerProc(void *param);
+	static void loopProc(void *param, uint worker);
+
+	void ensureStarted();
+	void start();
+	void stop();
+	bool isThreaded() const { return _workers.size() > 1; }
+
+	void push(const Task &task, uint worker);
+	bool pop(uint worker, Task &task);
+	bool steal(uint thief, Task &task);
+	/** Run one queued task, preferring the queue of @p worker. */
+	bool runOne(uint worker);
+	void runTask(const Task &task, uint worker, bool stolen);
+	/** Run a task right away, for backends without threads. */
+	void runInline(TaskGroup::TaskProc proc, void *param, uint worker);
+	void waitFor(TaskGroup *group, uint worker);
+	void finish(TaskGroup *group);
+	void addBusyTime(uint worker, uint32 start);
+
+	Mutex _mutex;				///< Guards the pool state and the groups
+	Mutex _serialMutex;			///< Held by the thread outside of the pool using worker 0, without threads
+	bool _started;
+	bool _quit;
+	uint _nextQueue;			///< Round robin queue for tasks from outside of the pool
+	bool _helping;				///< Whether a thread outside of the pool is using worker 0, with threads
+	uint _threadCount;			///< Set by setThreadCount(), or 0
+
+	Array<Worker *> _workers;
+	Array<ThreadInternal *> _threads;
+	SemaphoreInternal *_wake;	///< Posted once for every queued task
+
+	uint32 _statsStart;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
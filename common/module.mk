@@ -22,6 +22,7 @@ MODULE_OBJS := \
 	osd_message_queue.o \
 	path.o \
 	platform.o \
+	profiler.o \
 	punycode.o \
 	random.o \
 	rational.o \
@@ -40,6 +41,7 @@ MODULE_OBJS := \
 	unicode-bidi.o \
 	ustr.o \
 	util.o \
+	jobsystem.o \
 	xpfloat.o \
 	zip-set.o
 
@@ -0,0 +1,162 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/profiler.h"
+#include "common/stream.h"
+#include "common/str.h"
+#include "common/system.h"
+
+namespace Common {
+
+DECLARE_SINGLETON(Profiler);
+
+volatile bool Profiler::_recording = false;
+
+static const char *const trackNames[kProfilerTrackCount] = {
+	"Main",
+	"Audio",
+	"Timer"
+};
+
+Profiler::Profiler() : _next(0), _count(0), _dropped(0) {
+}
+
+Profiler::~Profiler() {
+	StackLock lock(_mutex);
+	_recording = false;
+}
+
+void Profiler::start(uint capacity) {
+	StackLock lock(_mutex);
+
+	_events.clear();
+	_events.resize(MAX<uint>(capacity, 1));
+	_next = 0;
+	_count = 0;
+	_dropped = 0;
+	_recording = true;
+}
+
+void Profiler::stop() {
+	StackLock lock(_mutex);
+	_recording = false;
+}
+
+uint64 Profiler::getTime() {
+	return g_system->getMicros();
+}
+
+void Profiler::addZone(const char *name, ProfilerTrack track, uint64 start, uint64 end) {
+	ProfilerEvent event;
+	event.name = name;
+	event.time = start;
+	event.duration = (uint32)MIN<uint64>(end - start, 0xFFFFFFFF);
+	event.value = 0;
+	event.track = track;
+	event.type = ProfilerEvent::kTypeZone;
+	add(event);
+}
+
+void Profiler::addCounter(const char *name, ProfilerTrack track, int32 value) {
+	ProfilerEvent event;
+	event.name = name;
+	event.time = getTime();
+	event.duration = 0;
+	event.value = value;
+	event.track = track;
+	event.type = ProfilerEvent::kTypeCounter;
+	add(event);
+}
+
+void Profiler::add(const ProfilerEvent &event) {
+	StackLock lock(_mutex);
+
+	// The flag is checked without the lock before, so check it again
+	if (!_recording)
+		return;
+
+	_events[_next] = event;
+	_next = (_next + 1) % _events.size();
+	if (_count < _events.size())
+		_count++;
+	else
+		_dropped++;
+}
+
+uint Profiler::getEventCount() const {
+	StackLock lock(_mutex);
+	return _count;
+}
+
+uint32 Profiler::getDroppedCount() const {
+	StackLock lock(_mutex);
+	return _dropped;
+}
+
+static String escapeJSON(const char *str) {
+	String result;
+	for (; *str; str++) {
+		if (*str == '"' || *str == '\\')
+			result += '\\';
+		if ((byte)*str < 0x20)
+			result += String::format("\\u%04x", (byte)*str);
+		else
+			result += *str;
+	}
+	return result;
+}
+
+void Profiler::writeTrace(WriteStream &stream) const {
+	// Copy the events, so that the threads adding events are not blocked
+	// while writing
+	Array<ProfilerEvent> events;
+	{
+		StackLock lock(_mutex);
+		events.reserve(_count);
+		const uint first = _count < _events.size() ? 0 : _next;
+		for (uint i = 0; i < _count; i++)
+			events.push_back(_events[(first + i) % _events.size()]);
+	}
+
+	stream.writeString("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+	for (uint i = 0; i < kProfilerTrackCount; i++)
+		stream.writeString(String::format("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}},\n", i, trackNames[i]));
+
+	for (uint i = 0; i < events.size(); i++) {
+		const ProfilerEvent &event = events[i];
+		const String name = escapeJSON(event.name);
+
+		if (event.type == ProfilerEvent::kTypeZone) {
+			stream.writeString(String::format("{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%llu,\"dur\":%u},\n",
+				name.c_str(), event.track, (unsigned long long)event.time, event.duration));
+		} else {
+			stream.writeString(String::format("{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"tid\":%u,\"ts\":%llu,\"args\":{\"value\":%d}},\n",
+				name.c_str(), event.track, (unsigned long long)event.time, event.value));
+		}
+	}
+
+	// JSON does not allow a comma after the last element
+	stream.writeString("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"ScummVM\"}}\n]}\n");
+}
+
+} // End of namespace Common
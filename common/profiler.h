@@ -0,0 +1,185 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef COMMON_PROFILER_H
+#define COMMON_PROFILER_H
+
+#include "common/array.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+
+namespace Common {
+
+class WriteStream;
+
+/**
+ * @defgroup common_profiler Profiler
+ * @ingroup common
+ *
+ * @brief Records timed zones and counters, and writes them as a trace.
+ *
+ * Code is instrumented with the PROFILE_SCOPE() and PROFILE_COUNTER()
+ * macros, which compile to nothing unless ScummVM is configured with
+ * --enable-profiler. Recording is started and the trace written from the
+ * "profile" debugger command. The trace can be loaded in chrome://tracing
+ * or https://ui.perfetto.dev.
+ * @{
+ */
+
+/**
+ * The row a zone or counter is shown in. Zones on the same track must not
+ * run at the same time unless they are nested, so every thread which is
+ * instrumented has a track of its own.
+ */
+enum ProfilerTrack {
+	kProfilerTrackMain,		///< The thread running the engine
+	kProfilerTrackAudio,	///< The mixer callback
+	kProfilerTrackTimer,	///< The timer callbacks
+	kProfilerTrackCount
+};
+
+/** A recorded zone or counter value. */
+struct ProfilerEvent {
+	enum Type {
+		kTypeZone,
+		kTypeCounter
+	};
+
+	const char *name;	///< Must stay valid until the trace is written, so usually a literal
+	uint64 time;		///< Start of the zone or time of the value, in microseconds
+	uint32 duration;	///< Length of the zone, in microseconds
+	int32 value;		///< The counter value
+	byte track;
+	byte type;
+};
+
+/**
+ * Keeps the most recent zones and counter values in a ring buffer. The
+ * buffer only exists while recording, so the profiler costs a flag check
+ * per zone otherwise. Zones and counters may be added from any thread.
+ */
+class Profiler : public Singleton<Profiler> {
+public:
+	enum {
+		kDefaultCapacity = 256 * 1024	///< Events kept by default, about 8 MB
+	};
+
+	Profiler();
+	~Profiler();
+
+	/** Drop the recorded events and start recording, keeping at most @p capacity events. */
+	void start(uint capacity = kDefaultCapacity);
+
+	/** Stop recording. The events are kept until the next start(). */
+	void stop();
+
+	/**
+	 * Return whether events are recorded. This is read from any thread
+	 * without locking, so a zone ending while recording starts or stops may
+	 * be dropped. add() checks the flag again under the lock, so events are
+	 * never added to a buffer being replaced.
+	 */
+	static bool isRecording() { return _recording; }
+
+	/** Return the time used for zones, in microseconds. */
+	static uint64 getTime();
+
+	void addZone(const char *name, ProfilerTrack track, uint64 start, uint64 end);
+	void addCounter(const char *name, ProfilerTrack track, int32 value);
+
+	/** Return the number of events kept. */
+	uint getEventCount() const;
+
+	/** Return the number of events which were overwritten by newer ones. */
+	uint32 getDroppedCount() const;
+
+	/** Write the kept events as Chrome trace event JSON. */
+	void writeTrace(WriteStream &stream) const;
+
+private:
+	void add(const ProfilerEvent &event);
+
+	static volatile bool _recording;	///< Only written with _mutex held
+
+	mutable Mutex _mutex;
+	Array<ProfilerEvent> _events;	///< Ring buffer, oldest event at _next once full
+	uint _next;
+	uint _count;
+	uint32 _dropped;
+};
+
+/** Records the time from its construction to its destruction as a zone. */
+class ProfilerZone {
+public:
+	ProfilerZone(const char *name, ProfilerTrack track) : _name(name), _track(track), _active(Profiler::isRecording()), _start(0) {
+		if (_active)
+			_start = Profiler::getTime();
+	}
+
+	~ProfilerZone() {
+		if (_active && Profiler::isRecording())
+			Profiler::instance().addZone(_name, _track, _start, Profiler::getTime());
+	}
+
+private:
+	const char *_name;
+	ProfilerTrack _track;
+	bool _active;
+	uint64 _start;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+#ifdef USE_PROFILER
+
+/** Record the rest of the enclosing block as a zone on the main track. */
+#define PROFILE_SCOPE(name) \
+	Common::ProfilerZone PROFILE_CONCAT(profilerZone, __LINE__)(name, Common::kProfilerTrackMain)
+
+/** Record the rest of the enclosing block as a zone on the given track. */
+#define PROFILE_SCOPE_ON(track, name) \
+	Common::ProfilerZone PROFILE_CONCAT(profilerZone, __LINE__)(name, track)
+
+/** Record a counter value on the given track. @p value is only evaluated while recording. */
+#define PROFILE_COUNTER_ON(track, name, value) \
+	do { \
+		if (Common::Profiler::isRecording()) \
+			Common::Profiler::instance().addCounter(name, track, value); \
+	} while (0)
+
+#else
+
+#define PROFILE_SCOPE(name) do {} while (0)
+#define PROFILE_SCOPE_ON(track, name) do {} while (0)
+#define PROFILE_COUNTER_ON(track, name, value) do { (void)sizeof(value); } while (0)
+
+#endif
+
+/** Record a counter value on the main track. */
+#define PROFILE_COUNTER(name, value) PROFILE_COUNTER_ON(Common::kProfilerTrackMain, name, value)
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -329,6 +329,21 @@ public:
 		_tracker = new BasePtrTrackerImpl<T>(ptr);
 	}
 
+	/**
+	 * Take ownership of an object whose reference tracker was supplied by
+	 * the caller, for example one allocated from a pool together with the
+	 * object. The tracker must be new, so that it holds just the reference
+	 * returned here. It is destroyed with delete after the last reference
+	 * is gone, so a tracker not allocated with new must provide its own
+	 * operator delete.
+	 */
+	static SharedPtr<T> adopt(T *pointer, BasePtrTrackerInternal *tracker) {
+		SharedPtr<T> result;
+		result._pointer = pointer;
+		result._tracker = tracker;
+		return result;
+	}
+
 	/**
 	 * Performs the equivalent of static_cast to a new pointer type
 	 */
@@ -798,8 +798,10 @@ void PlaybackFile::checkRecordedMD5() {
 	if (memcmp(savedMD5, currentMD5, 16) != 0) {
 		debugC(1, kDebugLevelEventRec, "playback:action=\"Check screenshot\" time=%s result = fail", screenTime.c_str());
 		warning("Recorded and current screenshots are different");
+		g_eventRec.processScreenshotCheck(false);
 	} else {
 		debugC(1, kDebugLevelEventRec, "playback:action=\"Check screenshot\" time=%s result = success", screenTime.c_str());
+		g_eventRec.processScreenshotCheck(true);
 	}
 	Graphics::saveThumbnail(*_screenshotsFile, screen);
 	screen.free();
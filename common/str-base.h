@@ -31,8 +31,6 @@ namespace Common {
 template<class T>
 class BaseString {
 public:
-	static void releaseMemoryPoolMutex();
-
 	static const uint32 npos = 0xFFFFFFFF;
 	typedef T          value_type;
 	typedef T *        iterator;
@@ -66,8 +64,9 @@ protected:
 		 */
 		value_type _storage[_builtinCapacity];
 		/**
-		 * External string storage data -- the refcounter, and the
-		 * capacity of the string _str points to.
+		 * External string storage data -- the refcounter, which is stored
+		 * in the same heap block right before _str, and the capacity of
+		 * the string _str points to.
 		 */
 		struct {
 			mutable int *_refCount;
@@ -49,6 +49,8 @@ class OptionsContainerWidget;
 namespace Common {
 class EventManager;
 class MutexInternal;
+class SemaphoreInternal;
+class ThreadInternal;
 struct Rect;
 class SaveFileManager;
 class SearchSet;
@@ -1450,6 +1452,14 @@ public:
 	 */
 	virtual uint32 getMillis(bool skipRecord = false) = 0;
 
+	/**
+	 * Get the number of microseconds since the program was started, for
+	 * measuring short durations. The value is not recorded by the event
+	 * recorder. The default implementation only has the resolution of
+	 * getMillis().
+	 */
+	virtual uint64 getMicros() { return (uint64)getMillis(true) * 1000; }
+
 	/** Delay/sleep for the specified amount of milliseconds. */
 	virtual void delayMillis(uint msecs) = 0;
 
@@ -1538,6 +1548,40 @@ public:
 	/** @} */
 
 
+	/**
+	 * @defgroup common_system_threads Worker threads
+	 * @ingroup common_system
+	 * @{
+	 *
+	 * Optional support for worker threads, which Common::JobSystem uses to
+	 * spread independent computations over several CPU cores. Nothing may
+	 * rely on these: backends without thread support keep the default
+	 * implementations, and all work then runs on the calling thread.
+	 */
+
+	/**
+	 * Return the number of CPU cores available for running threads.
+	 */
+	virtual uint getCPUCount() { return 1; }
+
+	/**
+	 * Start a new thread running the given function.
+	 *
+	 * @return The new thread, which is waited for when it is deleted, or 0
+	 *         if threads are not supported.
+	 */
+	virtual Common::ThreadInternal *createThread(void (*proc)(void *param), void *param) { return nullptr; }
+
+	/**
+	 * Create a new counting semaphore, with a count of zero.
+	 *
+	 * @return The newly created semaphore, or 0 if threads are not supported.
+	 */
+	virtual Common::SemaphoreInternal *createSemaphore() { return nullptr; }
+
+	/** @} */
+
+
 
 	/** @defgroup common_system_sound Sound
 	 *  @ingroup common_system
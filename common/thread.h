@@ -0,0 +1,67 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_THREAD_H
+#define COMMON_THREAD_H
+
+#include "common/scummsys.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_thread Threads
+ * @ingroup common
+ *
+ * @brief Backend interfaces for worker threads.
+ *
+ * See OSystem::createThread() and OSystem::createSemaphore(). Code should
+ * use Common::JobSystem for computations rather than creating threads
+ * itself. Only work which blocks, such as reading ahead from files, needs
+ * a thread of its own.
+ * @{
+ */
+
+/**
+ * A running thread. Deleting it waits for the thread function to return.
+ */
+class ThreadInternal {
+public:
+	virtual ~ThreadInternal() {}
+};
+
+/**
+ * A counting semaphore.
+ */
+class SemaphoreInternal {
+public:
+	virtual ~SemaphoreInternal() {}
+
+	/** Increment the count, waking up a waiting thread. */
+	virtual void post() = 0;
+	/** Wait until the count is above zero, then decrement it. */
+	virtual void wait() = 0;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
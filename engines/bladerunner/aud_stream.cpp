@@ -21,32 +21,16 @@
 
 #include "bladerunner/aud_stream.h"
 
-#include "bladerunner/audio_cache.h"
-
 #include "common/util.h"
 
 namespace BladeRunner {
 
 AudStream::AudStream(byte *data, int overrideFrequency) {
-	_hash  = 0;
-	_cache = nullptr;
 	_overrideFrequency = overrideFrequency;
 
 	init(data);
 }
 
-AudStream::AudStream(AudioCache *cache, int32 hash, int overrideFrequency) {
-	assert(cache != nullptr);
-
-	_cache = cache;
-	_hash  = hash;
-	_overrideFrequency = overrideFrequency;
-
-	_cache->incRef(_hash);
-
-	init(_cache->findByHash(_hash));
-}
-
 void AudStream::init(byte *data) {
 	_data = data;
 	_frequency = READ_LE_UINT16(_data);
@@ -62,12 +46,6 @@ void AudStream::init(byte *data) {
 	_p = _data + 12;
 }
 
-AudStream::~AudStream() {
-	if (_cache) {
-		_cache->decRef(_hash);
-	}
-}
-
 int AudStream::readBuffer(int16 *buffer, const int numSamples) {
 	int samplesRead = 0;
 
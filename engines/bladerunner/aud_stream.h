@@ -30,14 +30,10 @@
 
 namespace BladeRunner {
 
-class AudioCache;
-
 class AudStream : public Audio::RewindableAudioStream {
 	byte       *_data;
 	byte       *_p;
 	byte       *_end;
-	AudioCache *_cache;
-	int32       _hash;
 	uint16      _deafBlockRemain;
 	uint16      _frequency;
 	uint32      _size;
@@ -52,8 +48,6 @@ class AudStream : public Audio::RewindableAudioStream {
 
 public:
 	AudStream(byte *data, int overrideFrequency = -1);
-	AudStream(AudioCache *cache, int32 hash, int overrideFrequency = -1);
-	~AudStream() override;
 
 	int readBuffer(int16 *buffer, const int numSamples) override;
 	bool isStereo() const override { return false; }
@@ -23,10 +23,10 @@
 
 #include "bladerunner/archive.h"
 #include "bladerunner/aud_stream.h"
-#include "bladerunner/audio_cache.h"
 #include "bladerunner/audio_mixer.h"
 #include "bladerunner/bladerunner.h"
 
+#include "common/config-manager.h"
 #include "common/debug.h"
 #include "common/stream.h"
 #include "common/random.h"
@@ -211,29 +211,17 @@ int AudioPlayer::playAud(const Common::String &name, int volume, int panStart, i
 		trackSlotToAssign = lowestPriorityTrackSlot;
 	}
 
-	// Load audio resource and store in cache. Playback will happen directly from there.
-	int32 hash = MIXArchive::getHash(name);
-	if (!_vm->_audioCache->findByHash(hash)) {
-		Common::SeekableReadStream *r = _vm->getResourceStream(_vm->_enhancedEdition ? ("audio/" + name) : name);
-		if (!r) {
-			//debug("Could not get stream for %s %d - giving up", name.c_str(), priority);
+	// Reuse the decoded samples if the sound was played recently. The cache
+	// is shared with other games, so the key includes the target.
+	const Audio::PCMCacheKey key(ConfMan.getActiveDomainName() + "/" + name, 0, MKTAG('A', 'U', 'D', ' '), _vm->_enhancedEdition);
+	Audio::SeekableAudioStream *audioStream = Audio::PCMCache::instance().find(key);
+	if (!audioStream) {
+		audioStream = loadAud(name, key);
+		if (!audioStream) {
 			return -1;
 		}
-
-		int32 size = r->size();
-		while (!_vm->_audioCache->canAllocate(size)) {
-			if (!_vm->_audioCache->dropOldest()) {
-				delete r;
-				//debug("No available mem in cache for %s %d - giving up", name.c_str(), priority);
-				return -1;
-			}
-		}
-		_vm->_audioCache->storeByHash(hash, r);
-		delete r;
 	}
 
-	AudStream *audioStream = new AudStream(_vm->_audioCache, hash);
-
 	int actualVolume = volume;
 	if (!(flags & kAudioPlayerOverrideVolume)) {
 		actualVolume = (actualVolume * _sfxVolumeFactorOriginalEngine) / 100;
@@ -247,7 +235,7 @@ int AudioPlayer::playAud(const Common::String &name, int volume, int panStart, i
 	                                     panStart,
 	                                     mixerChannelEnded,
 	                                     this,
-	                                     audioStream->getLength());
+	                                     audioStream->getLength().msecs());
 
 	if (channel == -1) {
 		delete audioStream;
@@ -256,7 +244,7 @@ int AudioPlayer::playAud(const Common::String &name, int volume, int panStart, i
 	}
 
 	if (panStart != panEnd) {
-		_vm->_audioMixer->adjustPan(channel, panEnd, (60u * audioStream->getLength()) / 1000u);
+		_vm->_audioMixer->adjustPan(channel, panEnd, (60u * audioStream->getLength().msecs()) / 1000u);
 	}
 
 	_tracks[trackSlotToAssign].isActive = true;
@@ -268,6 +256,25 @@ int AudioPlayer::playAud(const Common::String &name, int volume, int panStart, i
 	return trackSlotToAssign;
 }
 
+Audio::SeekableAudioStream *AudioPlayer::loadAud(const Common::String &name, const Audio::PCMCacheKey &key) {
+	// Only the decoded samples are kept, so the resource is read into a
+	// temporary buffer which is freed once it has been decoded
+	Common::SeekableReadStream *r = _vm->getResourceStream(_vm->_enhancedEdition ? ("audio/" + name) : name);
+	if (!r) {
+		//debug("Could not get stream for %s", name.c_str());
+		return nullptr;
+	}
+
+	uint32 size = r->size();
+	byte *data = (byte *)malloc(size);
+	r->read(data, size);
+	delete r;
+
+	Audio::SeekableAudioStream *audioStream = Audio::PCMCache::instance().insert(key, new AudStream(data), DisposeAfterUse::YES);
+	free(data);
+	return audioStream;
+}
+
 bool AudioPlayer::isActive(int track) const {
 	Common::StackLock lock(_mutex);
 	if (track < 0 || track >= kTracks) {
@@ -286,7 +293,7 @@ uint32 AudioPlayer::getLength(int track) const {
 		return 0;
 	}
 
-	return _tracks[track].stream->getLength();
+	return _tracks[track].stream->getLength().msecs();
 }
 
 void AudioPlayer::stop(int track, bool immediately) {
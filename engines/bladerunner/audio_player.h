@@ -28,13 +28,13 @@
 
 #include "audio/audiostream.h"
 #include "audio/mixer.h"
+#include "audio/pcmcache.h"
 
 #include "bladerunner/bladerunner.h" // For BLADERUNNER_ORIGINAL_BUGS and BLADERUNNER_ORIGINAL_SETTINGS symbols
 
 namespace BladeRunner {
 
 class BladeRunnerEngine;
-class AudioCache;
 class AudStream;
 
 enum AudioPlayerFlags {
@@ -58,7 +58,7 @@ class AudioPlayer {
 		int                 priority;
 		int                 volume;   // should be in [0, 100]
 		int                 pan;      // should be in [-100, 100]
-		AudStream          *stream;
+		Audio::SeekableAudioStream *stream;
 	};
 
 	BladeRunnerEngine *_vm;
@@ -86,6 +86,7 @@ public:
 	void playSample();
 
 private:
+	Audio::SeekableAudioStream *loadAud(const Common::String &name, const Audio::PCMCacheKey &key);
 	void remove(int channel);
 	static void mixerChannelEnded(int channel, void *data);
 };
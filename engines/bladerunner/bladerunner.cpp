@@ -23,7 +23,6 @@
 #include "bladerunner/actor.h"
 #include "bladerunner/actor_dialogue_queue.h"
 #include "bladerunner/ambient_sounds.h"
-#include "bladerunner/audio_cache.h"
 #include "bladerunner/audio_mixer.h"
 #include "bladerunner/audio_player.h"
 #include "bladerunner/audio_speech.h"
@@ -82,6 +81,7 @@
 #include "common/config-manager.h"
 #include "common/error.h"
 #include "common/events.h"
+#include "common/profiler.h"
 #include "common/savefile.h"
 #include "common/system.h"
 #include "common/debug.h"
@@ -96,6 +96,7 @@
 
 #include "graphics/thumbnail.h"
 #include "audio/mididrv.h"
+#include "audio/pcmcache.h"
 
 namespace BladeRunner {
 
@@ -127,6 +128,7 @@ BladeRunnerEngine::BladeRunnerEngine(OSystem *syst, const ADGameDescription *des
 	_shortyMode                   = false;
 	_noDelayMillisFramelimiter    = false;
 	_framesPerSecondMax           = false;
+	_threadedRendering            = false;
 	_disableStaminaDrain          = false;
 	_spanishCreditsCorrection     = false;
 	_cutContent                   = Common::String(desc->gameId).contains("bladerunner-final");
@@ -197,7 +199,6 @@ BladeRunnerEngine::BladeRunnerEngine(OSystem *syst, const ADGameDescription *des
 	_sceneObjects            = nullptr;
 	_gameFlags               = nullptr;
 	_items                   = nullptr;
-	_audioCache              = nullptr;
 	_audioMixer              = nullptr;
 	_audioPlayer             = nullptr;
 	_music                   = nullptr;
@@ -583,9 +584,11 @@ bool BladeRunnerEngine::startup(bool hasSavegames) {
 	ConfMan.registerDefault("speech_mute", "false");
 	ConfMan.registerDefault("nodelaymillisfl", "false");
 	ConfMan.registerDefault("frames_per_secondfl", "false");
+	ConfMan.registerDefault("threaded_rendering", "false");
 
 	_noDelayMillisFramelimiter = ConfMan.getBool("nodelaymillisfl");
 	_framesPerSecondMax        = ConfMan.getBool("frames_per_secondfl");
+	_threadedRendering         = ConfMan.getBool("threaded_rendering");
 
 	// This is the original startup in the game
 	_surfaceFront.create(_system->getWidth(), _system->getHeight(), screenPixelFormat());
@@ -716,8 +719,6 @@ bool BladeRunnerEngine::startup(bool hasSavegames) {
 
 		_items = new Items(this);
 
-		_audioCache = new AudioCache();
-
 		_chapters = new Chapters(this);
 		if (!_chapters)
 			return false;
@@ -824,6 +825,10 @@ bool BladeRunnerEngine::startup(bool hasSavegames) {
 			return false;
 		}
 
+		if (ConfMan.hasKey("slice_page_budget")) {
+			_sliceAnimations->setPageBudget(MAX(ConfMan.getInt("slice_page_budget"), 0));
+		}
+
 		_sliceRenderer = new SliceRenderer(this);
 		_sliceRenderer->setScreenEffects(_screenEffects);
 
@@ -1029,8 +1034,8 @@ void BladeRunnerEngine::shutdown() {
 	delete _audioMixer;
 	_audioMixer = nullptr;
 
-	delete _audioCache;
-	_audioCache = nullptr;
+	// The decoded sound effects would otherwise outlive the engine
+	Audio::PCMCache::instance().clear();
 
 	delete _items;
 	_items = nullptr;
@@ -1157,12 +1162,16 @@ void BladeRunnerEngine::gameLoop() {
 }
 
 void BladeRunnerEngine::gameTick() {
+	PROFILE_SCOPE("BladeRunnerEngine::gameTick");
+
 	handleEvents();
 
 	if (!_gameIsRunning || !_windowIsActive) {
 		return;
 	}
 
+	_sliceAnimations->tick();
+
 	if (!_kia->isOpen() && !_sceneScript->isInsideScript() && !_aiScripts->isInsideScript()) {
 		if (!_settings->openNewScene()) {
 			Common::Error runtimeError = Common::Error(Common::kUnknownError, _("A required game resource was not found"));
@@ -66,7 +66,6 @@ class ActorDialogueQueue;
 class ScreenEffects;
 class AIScripts;
 class AmbientSounds;
-class AudioCache;
 class AudioMixer;
 class AudioPlayer;
 class AudioSpeech;
@@ -150,7 +149,6 @@ public:
 	ScreenEffects      *_screenEffects;
 	AIScripts          *_aiScripts;
 	AmbientSounds      *_ambientSounds;
-	AudioCache         *_audioCache;
 	AudioMixer         *_audioMixer;
 	AudioPlayer        *_audioPlayer;
 	AudioSpeech        *_audioSpeech;
@@ -239,6 +237,7 @@ public:
 	bool _shortyMode;
 	bool _noDelayMillisFramelimiter;
 	bool _framesPerSecondMax;
+	bool _threadedRendering;
 	bool _disableStaminaDrain;
 	bool _spanishCreditsCorrection;
 	bool _cutContent;
@@ -44,6 +44,7 @@
 #include "bladerunner/settings.h"
 #include "bladerunner/set.h"
 #include "bladerunner/set_effects.h"
+#include "bladerunner/slice_animations.h"
 #include "bladerunner/text_resource.h"
 #include "bladerunner/time.h"
 #include "bladerunner/vector.h"
@@ -142,6 +143,7 @@ Debugger::Debugger(BladeRunnerEngine *vm) : GUI::Debugger() {
 	registerCmd("difficulty", WRAP_METHOD(Debugger, cmdDifficulty));
 	registerCmd("outtake", WRAP_METHOD(Debugger, cmdOuttake));
 	registerCmd("playvqa", WRAP_METHOD(Debugger, cmdPlayVqa));
+	registerCmd("pages", WRAP_METHOD(Debugger, cmdPages));
 #if BLADERUNNER_ORIGINAL_BUGS
 #else
 	registerCmd("effect", WRAP_METHOD(Debugger, cmdEffect));
@@ -3106,4 +3108,31 @@ bool Debugger::cmdPlayVqa(int argc, const char** argv) {
 	return false;
 }
 
+/**
+* Show statistics of the animation page cache, or set its budget.
+*/
+bool Debugger::cmdPages(int argc, const char **argv) {
+	if (argc > 2) {
+		debugPrintf("Show statistics of the animation page cache, or set the maximum number of pages kept in memory (0 for no limit).\n");
+		debugPrintf("Usage: %s [<budget>]\n", argv[0]);
+		return true;
+	}
+
+	if (argc == 2) {
+		int budget = atoi(argv[1]);
+		if (budget < 0) {
+			debugPrintf("Budget must not be negative\n");
+			return true;
+		}
+		_vm->_sliceAnimations->setPageBudget(budget);
+	}
+
+	SlicePageStats stats = _vm->_sliceAnimations->getPageStats();
+	debugPrintf("Pages loaded: %u (budget: %s)\n", stats.loaded, stats.budget ? Common::String::format("%u", stats.budget).c_str() : "none");
+	debugPrintf("Page faults: %u, stalled for %u ms\n", stats.faults, stats.stallTime);
+	debugPrintf("Prefetched: %u, used: %u, queued: %u\n", stats.prefetched, stats.prefetchHits, stats.queued);
+	debugPrintf("Evictions: %u\n", stats.evictions);
+	return true;
+}
+
 } // End of namespace BladeRunner
@@ -134,6 +134,7 @@ public:
 	bool cmdDifficulty(int argc, const char **argv);
 	bool cmdOuttake(int argc, const char** argv);
 	bool cmdPlayVqa(int argc, const char** argv);
+	bool cmdPages(int argc, const char **argv);
 #if BLADERUNNER_ORIGINAL_BUGS
 #else
 	bool cmdEffect(int argc, const char **argv);
@@ -22,11 +22,11 @@
 #include "bladerunner/slice_animations.h"
 
 #include "bladerunner/bladerunner.h"
-#include "bladerunner/time.h"
 
 #include "common/debug.h"
 #include "common/file.h"
 #include "common/system.h"
+#include "common/thread.h"
 
 namespace BladeRunner {
 
@@ -84,6 +84,16 @@ bool SliceAnimations::open(const Common::String &name) {
 }
 
 SliceAnimations::~SliceAnimations() {
+	if (_prefetchThread) {
+		{
+			Common::StackLock lock(_mutex);
+			_prefetchQuit = true;
+		}
+		_prefetchSemaphore->post();
+		delete _prefetchThread;
+	}
+	delete _prefetchSemaphore;
+
 	for (uint32 i = 0; i != _pages.size(); ++i)
 		free(_pages[i]._data);
 
@@ -99,10 +109,13 @@ SliceAnimations::~SliceAnimations() {
 }
 
 bool SliceAnimations::openCoreAnim() {
+	Common::StackLock fileLock(_prefetchFileMutex);
 	return _coreAnimPageFile.open("COREANIM.DAT", 0);
 }
 
 bool SliceAnimations::openFrames(int fileNumber) {
+	// The loader thread may be reading from the frames files
+	Common::StackLock fileLock(_prefetchFileMutex);
 
 	if (_framesPageFile._fileNumber == -1) { // Running for the first time, need to probe
 		// First, try HDFRAMES.DAT
@@ -182,6 +195,8 @@ bool SliceAnimations::PageFile::open(const Common::String &name, int8 fileIdx) {
 	if (timestamp != _sliceAnimations->_timestamp)
 		return false;
 
+	_prefetchFiles[fileIdx].open(name);
+
 	if (!_sliceAnimations->_vm->_cutContent
 		|| (_pageOffsets.size() < _sliceAnimations->_pageCount) ) {
 		_pageOffsets.resize(_sliceAnimations->_pageCount);
@@ -213,10 +228,13 @@ void SliceAnimations::PageFile::close(int8 fileIdx) {
 		if (_files[fileIdx].isOpen()) {
 			_files[fileIdx].close();
 		}
+		if (_prefetchFiles[fileIdx].isOpen()) {
+			_prefetchFiles[fileIdx].close();
+		}
 	}
 }
 
-void *SliceAnimations::PageFile::loadPage(uint32 pageNumber) {
+void *SliceAnimations::PageFile::loadPage(uint32 pageNumber, bool prefetch) {
 	if (_pageOffsets.size() < _sliceAnimations->_pageCount
 	    || _pageOffsetsFileIdx.size() < _sliceAnimations->_pageCount
 	    || _pageOffsets[pageNumber] == -1
@@ -224,13 +242,16 @@ void *SliceAnimations::PageFile::loadPage(uint32 pageNumber) {
 		return nullptr;
 	}
 
-	uint32 pageSize = _sliceAnimations->_pageSize;
+	Common::File &file = prefetch ? _prefetchFiles[_pageOffsetsFileIdx[pageNumber]] : _files[_pageOffsetsFileIdx[pageNumber]];
+	if (!file.isOpen()) {
+		return nullptr;
+	}
 
-	// TODO: Retire oldest pages if we exceed some memory limit
+	uint32 pageSize = _sliceAnimations->_pageSize;
 
 	void *data = malloc(pageSize);
-	_files[_pageOffsetsFileIdx[pageNumber]].seek(_pageOffsets[pageNumber], SEEK_SET);
-	uint32 r = _files[_pageOffsetsFileIdx[pageNumber]].read(data, pageSize);
+	file.seek(_pageOffsets[pageNumber], SEEK_SET);
+	uint32 r = file.read(data, pageSize);
 	assert(r == pageSize);
 
 	return data;
@@ -264,23 +285,194 @@ void *SliceAnimations::getFramePtr(uint32 animation, uint32 frame) {
 	uint32 page        = frameOffset / _pageSize;
 	uint32 pageOffset  = frameOffset % _pageSize;
 
-	if (_pages[page]._data == nullptr) {                          // if not cached already
-		_pages[page]._data = _coreAnimPageFile.loadPage(page);    // look in COREANIM first
+	Common::StackLock lock(_mutex);
 
-		if (_pages[page]._data == nullptr) {                      // if not in COREAMIM
-			_pages[page]._data = _framesPageFile.loadPage(page);  // Look in CDFRAMES or HDFRAMES loaded data
+	if (_pages[page]._data == nullptr) { // if not cached already
+		uint32 startTime = g_system->getMillis();
+		_pages[page]._data = loadPage(page, false);
+		_stats.stallTime += g_system->getMillis() - startTime;
 
-			if (_pages[page]._data == nullptr) {
-				error("Unable to locate page %d for animation %d frame %d", page, animation, frame);
-			}
+		if (_pages[page]._data == nullptr) {
+			error("Unable to locate page %d for animation %d frame %d", page, animation, frame);
 		}
+		++_loadedPages;
+		++_stats.faults;
+	} else if (_pages[page]._prefetched) {
+		_pages[page]._prefetched = false;
+		++_stats.prefetchHits;
 	}
 
-	_pages[page]._lastAccess = _vm->_time->currentSystem();
+	_pages[page]._lastAccess = _tick;
+
+	// Animations are mostly played forward, so the pages of the next frames
+	// are likely to be needed soon
+	uint32 frameCount = _animations[animation].frameCount;
+	for (uint32 i = 1; i <= kPrefetchFrames && i < frameCount; ++i) {
+		uint32 nextFrame = (frame + i) % frameCount;
+		queuePage((_animations[animation].offset + nextFrame * _animations[animation].frameSize) / _pageSize);
+	}
 
 	return (byte *)_pages[page]._data + pageOffset;
 }
 
+void SliceAnimations::prefetchAnimation(uint32 animation) {
+	Common::StackLock lock(_mutex);
+
+	uint32 firstPage = _animations[animation].offset / _pageSize;
+	uint32 lastPage  = (_animations[animation].offset + _animations[animation].frameCount * _animations[animation].frameSize - 1) / _pageSize;
+	for (uint32 page = firstPage; page <= lastPage && page < _pageCount; ++page) {
+		queuePage(page);
+	}
+}
+
+void SliceAnimations::tick() {
+	{
+		Common::StackLock lock(_mutex);
+		++_tick;
+	}
+
+	if (!_prefetchThread) {
+		for (int i = 0; i < kPrefetchPagesPerTick && prefetchPage(); ++i)
+			;
+	}
+
+	evictPages();
+}
+
+void SliceAnimations::setPageBudget(uint32 pages) {
+	_pageBudget = pages;
+	evictPages();
+}
+
+SlicePageStats SliceAnimations::getPageStats() const {
+	Common::StackLock lock(_mutex);
+
+	SlicePageStats stats = _stats;
+	stats.queued = _prefetchQueue.size();
+	stats.loaded = _loadedPages;
+	stats.budget = _pageBudget;
+	return stats;
+}
+
+void *SliceAnimations::loadPage(uint32 page, bool prefetch) {
+	void *data = _coreAnimPageFile.loadPage(page, prefetch); // look in COREANIM first
+
+	if (data == nullptr) {                                   // if not in COREAMIM
+		data = _framesPageFile.loadPage(page, prefetch);     // Look in CDFRAMES or HDFRAMES loaded data
+	}
+	return data;
+}
+
+void SliceAnimations::queuePage(uint32 page) {
+	if (_pages[page]._data != nullptr || _pages[page]._queued) {
+		return;
+	}
+
+	_pages[page]._queued = true;
+	_prefetchQueue.push_back(page);
+
+	if (!_prefetchThreadStarted) {
+		_prefetchThreadStarted = true;
+		_prefetchSemaphore = g_system->createSemaphore();
+		if (_prefetchSemaphore) {
+			_prefetchThread = g_system->createThread(&prefetchProc, this);
+			if (!_prefetchThread) {
+				delete _prefetchSemaphore;
+				_prefetchSemaphore = nullptr;
+			}
+		}
+	}
+
+	if (_prefetchThread) {
+		_prefetchSemaphore->post();
+	}
+}
+
+bool SliceAnimations::prefetchPage() {
+	Common::StackLock fileLock(_prefetchFileMutex);
+
+	uint32 page;
+	{
+		Common::StackLock lock(_mutex);
+
+		if (_prefetchQueue.empty()) {
+			return false;
+		}
+
+		page = _prefetchQueue.front();
+		_prefetchQueue.pop_front();
+		_pages[page]._queued = false;
+
+		// Pages over the budget would only push out pages which are in use
+		if (_pages[page]._data != nullptr || (_pageBudget && _loadedPages >= _pageBudget)) {
+			return true;
+		}
+	}
+
+	// Read without holding _mutex, so getFramePtr() is not blocked meanwhile
+	void *data = loadPage(page, true);
+	if (data == nullptr) {
+		return true;
+	}
+
+	Common::StackLock lock(_mutex);
+
+	if (_pages[page]._data != nullptr) { // loaded by getFramePtr() in the meantime
+		free(data);
+		return true;
+	}
+
+	_pages[page]._data = data;
+	_pages[page]._lastAccess = _tick;
+	_pages[page]._prefetched = true;
+	++_loadedPages;
+	++_stats.prefetched;
+	return true;
+}
+
+void SliceAnimations::evictPages() {
+	if (!_pageBudget) {
+		return;
+	}
+
+	Common::StackLock lock(_mutex);
+
+	while (_loadedPages > _pageBudget) {
+		// Pages used in the last tick may still be referenced by the renderer
+		uint32 oldest = _pageCount;
+		for (uint32 i = 0; i != _pageCount; ++i) {
+			if (_pages[i]._data != nullptr && _pages[i]._lastAccess + 1 < _tick
+			    && (oldest == _pageCount || _pages[i]._lastAccess < _pages[oldest]._lastAccess)) {
+				oldest = i;
+			}
+		}
+		if (oldest == _pageCount) {
+			break;
+		}
+
+		free(_pages[oldest]._data);
+		_pages[oldest]._data = nullptr;
+		_pages[oldest]._prefetched = false;
+		--_loadedPages;
+		++_stats.evictions;
+	}
+}
+
+void SliceAnimations::prefetchProc(void *param) {
+	SliceAnimations *sliceAnimations = (SliceAnimations *)param;
+
+	for (;;) {
+		sliceAnimations->_prefetchSemaphore->wait();
+		{
+			Common::StackLock lock(sliceAnimations->_mutex);
+			if (sliceAnimations->_prefetchQuit) {
+				return;
+			}
+		}
+		sliceAnimations->prefetchPage();
+	}
+}
+
 Vector3 SliceAnimations::getPositionChange(int animation) const {
 	return _animations[animation].positionChange;
 }
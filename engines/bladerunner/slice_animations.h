@@ -24,17 +24,34 @@
 
 #include "common/array.h"
 #include "common/file.h"
+#include "common/list.h"
+#include "common/mutex.h"
 #include "common/str.h"
 #include "common/types.h"
 
 #include "bladerunner/color.h"
 #include "bladerunner/vector.h"
 
+namespace Common {
+class SemaphoreInternal;
+class ThreadInternal;
+}
 
 namespace BladeRunner {
 
 class BladeRunnerEngine;
 
+/** Statistics of the animation page cache, shown by the "pages" debugger command. */
+struct SlicePageStats {
+	uint32 faults;       ///< Pages loaded because a frame was needed right away
+	uint32 stallTime;    ///< Time spent loading pages on faults, in milliseconds
+	uint32 prefetched;   ///< Pages loaded ahead of time
+	uint32 prefetchHits; ///< Prefetched pages which were used afterwards
+	uint32 evictions;    ///< Pages freed to stay within the budget
+	uint32 queued;       ///< Pages waiting to be prefetched
+	uint32 loaded;       ///< Pages in memory
+	uint32 budget;       ///< Maximum number of pages in memory, or 0 for no limit
+};
 
 class SliceAnimations {
 	friend class SliceRenderer;
@@ -55,17 +72,25 @@ class SliceAnimations {
 	//	uint16 &operator[](size_t i) { return color555[i]; }
 	};
 
+	enum {
+		kPrefetchFrames       = 8, ///< Frames following the drawn one which are prefetched
+		kPrefetchPagesPerTick = 2  ///< Pages prefetched per tick when there is no loader thread
+	};
+
 	struct Page {
 		void   *_data;
-		uint32 _lastAccess;
+		uint32 _lastAccess; ///< Tick in which the page was last used
+		bool   _queued;
+		bool   _prefetched; ///< Loaded ahead of time and not used yet
 
-		Page() : _data(nullptr), _lastAccess(0) {}
+		Page() : _data(nullptr), _lastAccess(0), _queued(false), _prefetched(false) {}
 	};
 
 	struct PageFile {
 		int                  _fileNumber;
 		SliceAnimations     *_sliceAnimations;
 		Common::File         _files[5];
+		Common::File         _prefetchFiles[5]; ///< Handles used by the loader, which must not share _files
 		Common::Array<int32> _pageOffsets;
 		Common::Array<int8>  _pageOffsetsFileIdx;
 
@@ -73,7 +98,7 @@ class SliceAnimations {
 
 		bool  open(const Common::String &name, int8 fileIdx);
 		void  close(int8 fileIdx);
-		void *loadPage(uint32 page);
+		void *loadPage(uint32 page, bool prefetch);
 	};
 
 	BladeRunnerEngine *_vm;
@@ -90,6 +115,24 @@ class SliceAnimations {
 	PageFile _coreAnimPageFile;
 	PageFile _framesPageFile;
 
+	// Guards the pages and the prefetch queue, which are shared with the
+	// loader thread. It is never held while reading from disk.
+	mutable Common::Mutex _mutex;
+	// Held by the loader while it reads a page, and when the page files are
+	// opened or closed. Always taken before _mutex.
+	Common::Mutex _prefetchFileMutex;
+
+	Common::List<uint32>      _prefetchQueue;
+	Common::ThreadInternal    *_prefetchThread;
+	Common::SemaphoreInternal *_prefetchSemaphore;
+	bool                      _prefetchThreadStarted;
+	bool                      _prefetchQuit;
+
+	uint32         _tick;
+	uint32         _pageBudget;
+	uint32         _loadedPages;
+	SlicePageStats _stats;
+
 public:
 	SliceAnimations(BladeRunnerEngine *vm)
 		: _vm(vm)
@@ -98,7 +141,16 @@ public:
 		, _timestamp(0)
 		, _pageSize(0)
 		, _pageCount(0)
-		, _paletteCount(0) {}
+		, _paletteCount(0)
+		, _prefetchThread(nullptr)
+		, _prefetchSemaphore(nullptr)
+		, _prefetchThreadStarted(false)
+		, _prefetchQuit(false)
+		, _tick(0)
+		, _pageBudget(0)
+		, _loadedPages(0) {
+		memset(&_stats, 0, sizeof(_stats));
+	}
 	~SliceAnimations();
 
 	bool open(const Common::String &name);
@@ -114,6 +166,31 @@ public:
 
 	Vector3 getPositionChange(int animation) const;
 	float   getFacingChange(int animation) const;
+
+	/**
+	 * Queue the pages of an animation for loading in the background, for
+	 * example when an actor is about to enter the set.
+	 */
+	void prefetchAnimation(uint32 animation);
+
+	/**
+	 * Called once per game tick. Frees pages over the budget, and loads a
+	 * few queued pages when the backend does not support threads.
+	 */
+	void tick();
+
+	/** Set the maximum number of pages kept in memory, or 0 for no limit. */
+	void setPageBudget(uint32 pages);
+
+	SlicePageStats getPageStats() const;
+
+private:
+	void *loadPage(uint32 page, bool prefetch);
+	void  queuePage(uint32 page);
+	bool  prefetchPage();
+	void  evictPages();
+
+	static void prefetchProc(void *param);
 };
 
 } // End of namespace BladeRunner
@@ -30,6 +30,7 @@
 #include "common/memstream.h"
 #include "common/rect.h"
 #include "common/util.h"
+#include "common/jobsystem.h"
 
 namespace BladeRunner {
 
@@ -58,8 +59,6 @@ SliceRenderer::SliceRenderer(BladeRunnerEngine *vm) {
 	_frameSliceCount   = 0;
 	_startSlice        = 0.0f;
 	_endSlice          = 0.0f;
-	_m13               = 0;
-	_m23               = 0;
 
 	_shadowPolygonDefault[ 0] = Vector3( 16.0f,  96.0f, 0.0f);
 	_shadowPolygonDefault[ 1] = Vector3( 16.0f, 160.0f, 0.0f);
@@ -362,6 +361,13 @@ void SliceLineIterator::advance() {
 	_sliceMatrix._m[1][2] += _field_38 * 64.0f;
 }
 
+enum {
+	/**
+	 * The minimum number of lines drawn by each worker thread.
+	 */
+	kMinLinesPerBand = 16
+};
+
 static void setupLookupTable(int t[256], int inc) {
 	int v = 0;
 	for (int i = 0; i != 256; ++i) {
@@ -370,6 +376,13 @@ static void setupLookupTable(int t[256], int inc) {
 	}
 }
 
+struct SliceRenderer::DrawLinesJob {
+	const SliceRenderer *renderer;
+	Graphics::Surface *surface;
+	uint16 *zbuffer;
+	uint bandCount;
+};
+
 void SliceRenderer::drawInWorld(int animationId, int animationFrame, Vector3 position, float facing, float scale, Graphics::Surface &surface, uint16 *zbuffer) {
 	assert(_lights);
 	assert(_setEffects);
@@ -411,20 +424,10 @@ void SliceRenderer::drawInWorld(int animationId, int animationFrame, Vector3 pos
 		&setEffectsColorCoeficient,
 		&setEffectColor);
 
-	_lightsColor.r = setEffectsColorCoeficient * sliceRendererLights._finalColor.r * 65536.0f;
-	_lightsColor.g = setEffectsColorCoeficient * sliceRendererLights._finalColor.g * 65536.0f;
-	_lightsColor.b = setEffectsColorCoeficient * sliceRendererLights._finalColor.b * 65536.0f;
-
-	_setEffectColor.r = setEffectColor.r * 31.0f * 65536.0f;
-	_setEffectColor.g = setEffectColor.g * 31.0f * 65536.0f;
-	_setEffectColor.b = setEffectColor.b * 31.0f * 65536.0f;
-
 	setupLookupTable(_m12lookup, sliceLineIterator._sliceMatrix(0, 1));
 	setupLookupTable(_m11lookup, sliceLineIterator._sliceMatrix(0, 0));
-	_m13 = sliceLineIterator._sliceMatrix(0, 2);
 	setupLookupTable(_m21lookup, sliceLineIterator._sliceMatrix(1, 0));
 	setupLookupTable(_m22lookup, sliceLineIterator._sliceMatrix(1, 1));
-	_m23 = sliceLineIterator._sliceMatrix(1, 2);
 
 	if (_animationsShadowEnabled[_animation]) {
 		float coeficientShadow;
@@ -440,13 +443,16 @@ void SliceRenderer::drawInWorld(int animationId, int animationFrame, Vector3 pos
 		drawShadowInWorld(transparency, surface, zbuffer);
 	}
 
+	// The lighting of a line depends on the lines before it, so all lines are
+	// set up first. Drawing them only touches their own row of the surface
+	// and the z-buffer, so that can be split up between worker threads.
+	_lines.clear();
 	int frameY = sliceLineIterator._startY;
 
-	uint16 *zBufferLinePtr = zbuffer + BladeRunnerEngine::kOriginalGameWidth * frameY;
-
 	while (sliceLineIterator._currentY <= sliceLineIterator._endY) {
-		_m13 = sliceLineIterator._sliceMatrix(0, 2);
-		_m23 = sliceLineIterator._sliceMatrix(1, 2);
+		SliceLine line;
+		line.m13 = sliceLineIterator._sliceMatrix(0, 2);
+		line.m23 = sliceLineIterator._sliceMatrix(1, 2);
 		sliceLine = sliceLineIterator.line();
 
 		sliceRendererLights.calculateColorSlice(Vector3(_position.x, _position.y, _position.z + _frameBottomZ + sliceLine * _frameSliceHeight));
@@ -459,21 +465,50 @@ void SliceRenderer::drawInWorld(int animationId, int animationFrame, Vector3 pos
 				&setEffectColor);
 		}
 
-		_lightsColor.r = setEffectsColorCoeficient * sliceRendererLights._finalColor.r * 65536.0f;
-		_lightsColor.g = setEffectsColorCoeficient * sliceRendererLights._finalColor.g * 65536.0f;
-		_lightsColor.b = setEffectsColorCoeficient * sliceRendererLights._finalColor.b * 65536.0f;
+		line.lightsColor.r = setEffectsColorCoeficient * sliceRendererLights._finalColor.r * 65536.0f;
+		line.lightsColor.g = setEffectsColorCoeficient * sliceRendererLights._finalColor.g * 65536.0f;
+		line.lightsColor.b = setEffectsColorCoeficient * sliceRendererLights._finalColor.b * 65536.0f;
 
-		_setEffectColor.r = setEffectColor.r * 31.0f * 65536.0f;
-		_setEffectColor.g = setEffectColor.g * 31.0f * 65536.0f;
-		_setEffectColor.b = setEffectColor.b * 31.0f * 65536.0f;
+		line.setEffectColor.r = setEffectColor.r * 31.0f * 65536.0f;
+		line.setEffectColor.g = setEffectColor.g * 31.0f * 65536.0f;
+		line.setEffectColor.b = setEffectColor.b * 31.0f * 65536.0f;
 
 		if (frameY >= 0 && frameY < surface.h) {
-			drawSlice((int)sliceLine, true, frameY, surface, zBufferLinePtr);
+			line.slice = (int)sliceLine;
+			line.y = frameY;
+			_lines.push_back(line);
 		}
 
 		sliceLineIterator.advance();
 		++frameY;
-		zBufferLinePtr += BladeRunnerEngine::kOriginalGameWidth;
+	}
+
+	Common::JobSystem &jobSystem = Common::JobSystem::instance();
+	const uint bandCount = _vm->_threadedRendering ? MIN<uint>(jobSystem.getWorkerCount() * 2, _lines.size() / kMinLinesPerBand) : 1;
+	if (bandCount > 1) {
+		DrawLinesJob job;
+		job.renderer = this;
+		job.surface = &surface;
+		job.zbuffer = zbuffer;
+		job.bandCount = bandCount;
+		jobSystem.parallelFor(0, bandCount, 1, &drawLinesProc, &job);
+	} else {
+		drawLines(0, _lines.size(), surface, zbuffer);
+	}
+}
+
+void SliceRenderer::drawLinesProc(void *param, uint begin, uint end, uint worker) {
+	const DrawLinesJob &job = *(const DrawLinesJob *)param;
+	const uint lineCount = job.renderer->_lines.size();
+	const uint first = lineCount * begin / job.bandCount;
+	const uint last = lineCount * end / job.bandCount;
+	job.renderer->drawLines(first, last - first, *job.surface, job.zbuffer);
+}
+
+void SliceRenderer::drawLines(uint first, uint count, Graphics::Surface &surface, uint16 *zbuffer) const {
+	for (uint i = first; i < first + count; ++i) {
+		const SliceLine &line = _lines[i];
+		drawSlice(line, true, surface, zbuffer + BladeRunnerEngine::kOriginalGameWidth * line.y);
 	}
 }
 
@@ -514,10 +549,12 @@ void SliceRenderer::drawOnScreen(int animationId, int animationFrame, int screen
 
 	setupLookupTable(_m11lookup, m(0, 0));
 	setupLookupTable(_m12lookup, m(0, 1));
-	_m13 = m(0, 2);
 	setupLookupTable(_m21lookup, m(1, 0));
 	setupLookupTable(_m22lookup, m(1, 1));
-	_m23 = m(1, 2);
+
+	SliceLine line;
+	line.m13 = m(0, 2);
+	line.m23 = m(1, 2);
 
 	int frameY = screenY + (size / 2.0f * frameHeight);
 	int currentY = frameY;
@@ -530,14 +567,32 @@ void SliceRenderer::drawOnScreen(int animationId, int animationFrame, int screen
 	while (currentSlice < _frameSliceCount) {
 		if (currentY >= 0 && currentY < surface.h) {
 			memset(lineZbuffer, 0xFF, BladeRunnerEngine::kOriginalGameWidth * 2);
-			drawSlice(currentSlice, false, currentY, surface, lineZbuffer);
+			line.slice = currentSlice;
+			line.y = currentY;
+			drawSlice(line, false, surface, lineZbuffer);
 			currentSlice += sliceStep;
 			--currentY;
 		}
 	}
 }
 
-void SliceRenderer::drawSlice(int slice, bool advanced, int y, Graphics::Surface &surface, uint16 *zbufferLine) {
+/**
+ * Draws a span of pixels with the same depth and color, where they pass the
+ * z-buffer test. Written without branches, so that compilers can vectorize it.
+ */
+template<typename PixelType>
+static inline void drawSpan(PixelType *dst, uint16 *zbuffer, int count, uint16 z, PixelType color) {
+	for (int i = 0; i < count; ++i) {
+		const bool visible = z < zbuffer[i];
+		zbuffer[i] = visible ? z : zbuffer[i];
+		dst[i] = visible ? color : dst[i];
+	}
+}
+
+void SliceRenderer::drawSlice(const SliceLine &line, bool advanced, Graphics::Surface &surface, uint16 *zbufferLine) const {
+	const int slice = line.slice;
+	const int y = line.y;
+
 	if (slice < 0 || (uint32)slice >= _frameSliceCount) {
 		return;
 	}
@@ -561,15 +616,15 @@ void SliceRenderer::drawSlice(int slice, bool advanced, int y, Graphics::Surface
 			continue;
 
 		uint32 lastVertex = vertexCount - 1;
-		int lastVertexX = MAX((_m11lookup[p[3 * lastVertex]] + _m12lookup[p[3 * lastVertex + 1]] + _m13) / 65536, 0);
+		int lastVertexX = MAX((_m11lookup[p[3 * lastVertex]] + _m12lookup[p[3 * lastVertex + 1]] + line.m13) / 65536, 0);
 
 		int previousVertexX = lastVertexX;
 
 		while (vertexCount--) {
-			int vertexX = CLIP<int32>((_m11lookup[p[0]] + _m12lookup[p[1]] + _m13) / 65536, 0, BladeRunnerEngine::kOriginalGameWidth);
+			int vertexX = CLIP<int32>((_m11lookup[p[0]] + _m12lookup[p[1]] + line.m13) / 65536, 0, BladeRunnerEngine::kOriginalGameWidth);
 
 			if (vertexX > previousVertexX) {
-				int vertexZ = (_m21lookup[p[0]] + _m22lookup[p[1]] + _m23) / 64;
+				int vertexZ = (_m21lookup[p[0]] + _m22lookup[p[1]] + line.m23) / 64;
 
 				if (vertexZ >= 0 && vertexZ < 65536) {
 					uint32 outColor = palette.value[p[2]];
@@ -578,19 +633,28 @@ void SliceRenderer::drawSlice(int slice, bool advanced, int y, Graphics::Surface
 						_screenEffects->getColor(&aescColor, vertexX, y, vertexZ);
 
 						Color256 color = palette.color[p[2]];
-						color.r = ((int)(_setEffectColor.r + _lightsColor.r * color.r) / 65536) + aescColor.r;
-						color.g = ((int)(_setEffectColor.g + _lightsColor.g * color.g) / 65536) + aescColor.g;
-						color.b = ((int)(_setEffectColor.b + _lightsColor.b * color.b) / 65536) + aescColor.b;
+						color.r = ((int)(line.setEffectColor.r + line.lightsColor.r * color.r) / 65536) + aescColor.r;
+						color.g = ((int)(line.setEffectColor.g + line.lightsColor.g * color.g) / 65536) + aescColor.g;
+						color.b = ((int)(line.setEffectColor.b + line.lightsColor.b * color.b) / 65536) + aescColor.b;
 						// We need to convert from 5 bits per channel (r,g,b) to 8 bits
 						outColor = _pixelFormat.RGBToColor(Color::get8BitColorFrom5Bit(color.r), Color::get8BitColorFrom5Bit(color.g), Color::get8BitColorFrom5Bit(color.b));
 					}
 
-					for (int x = previousVertexX; x != vertexX; ++x) {
-						if (vertexZ < zbufferLine[x]) {
-							zbufferLine[x] = (uint16)vertexZ;
-
-							void *dstPtr = surface.getBasePtr(CLIP(x, 0, surface.w - 1), CLIP(y, 0, surface.h - 1));
-							drawPixel(surface, dstPtr, outColor);
+					// The span only needs clipping on surfaces narrower than
+					// the original game
+					void *spanPtr = surface.getBasePtr(previousVertexX, CLIP(y, 0, surface.h - 1));
+					if (vertexX <= surface.w && surface.format.bytesPerPixel == 2) {
+						drawSpan<uint16>((uint16 *)spanPtr, zbufferLine + previousVertexX, vertexX - previousVertexX, vertexZ, outColor);
+					} else if (vertexX <= surface.w && surface.format.bytesPerPixel == 4) {
+						drawSpan<uint32>((uint32 *)spanPtr, zbufferLine + previousVertexX, vertexX - previousVertexX, vertexZ, outColor);
+					} else {
+						for (int x = previousVertexX; x != vertexX; ++x) {
+							if (vertexZ < zbufferLine[x]) {
+								zbufferLine[x] = (uint16)vertexZ;
+
+								void *dstPtr = surface.getBasePtr(CLIP(x, 0, surface.w - 1), CLIP(y, 0, surface.h - 1));
+								drawPixel(surface, dstPtr, outColor);
+							}
 						}
 					}
 				}
@@ -746,10 +810,7 @@ void SliceRenderer::drawShadowPolygon(int transparency, Graphics::Surface &surfa
 }
 
 void SliceRenderer::preload(int animationId) {
-	int frameCount = _vm->_sliceAnimations->getFrameCount(animationId);
-	for (int i = 0; i < frameCount; ++i) {
-		_vm->_sliceAnimations->getFramePtr(animationId, i);
-	}
+	_vm->_sliceAnimations->prefetchAnimation(animationId);
 }
 
 void SliceRenderer::disableShadows(int animationsIdsList[], int listSize) {
@@ -27,6 +27,7 @@
 #include "bladerunner/view.h"
 #include "bladerunner/matrix.h"
 
+#include "common/array.h"
 #include "common/rect.h"
 
 #include "graphics/surface.h"
@@ -43,6 +44,21 @@ class Lights;
 class SetEffects;
 
 class SliceRenderer {
+	/**
+	 * Everything drawSlice() needs to know about one line of the screen,
+	 * besides what is constant for the whole frame.
+	 */
+	struct SliceLine {
+		int   slice;
+		int   y;
+		int   m13;
+		int   m23;
+		Color setEffectColor;
+		Color lightsColor;
+	};
+
+	struct DrawLinesJob;
+
 	BladeRunnerEngine *_vm;
 
 	int       _animation;
@@ -75,19 +91,19 @@ class SliceRenderer {
 
 	int _m11lookup[256];
 	int _m12lookup[256];
-	int _m13;
 	int _m21lookup[256];
 	int _m22lookup[256];
-	int _m23;
+
+	/**
+	 * The lines of the frame being drawn by drawInWorld().
+	 */
+	Common::Array<SliceLine> _lines;
 
 	bool _animationsShadowEnabled[997];
 
 	Vector3 _shadowPolygonDefault[12];
 	Vector3 _shadowPolygonCurrent[12];
 
-	Color _setEffectColor;
-	Color _lightsColor;
-
 	Graphics::PixelFormat _pixelFormat;
 
 public:
@@ -113,7 +129,9 @@ private:
 	Matrix3x2 calculateFacingRotationMatrix();
 	void loadFrame(int animation, int frame);
 
-	void drawSlice(int slice, bool advanced, int y, Graphics::Surface &surface, uint16 *zbufferLine);
+	void drawSlice(const SliceLine &line, bool advanced, Graphics::Surface &surface, uint16 *zbufferLine) const;
+	void drawLines(uint first, uint count, Graphics::Surface &surface, uint16 *zbuffer) const;
+	static void drawLinesProc(void *param, uint begin, uint end, uint worker);
 	void drawShadowInWorld(int transparency, Graphics::Surface &surface, uint16 *zbuffer);
 	void drawShadowPolygon(int transparency, Graphics::Surface &surface, uint16 *zbuffer);
 };
@@ -25,6 +25,7 @@
 #define GLK_GLULXE
 
 #include "common/scummsys.h"
+#include "common/hashmap.h"
 #include "common/random.h"
 #include "glk/glk_api.h"
 #include "glk/glulx/glulx_types.h"
@@ -182,6 +183,15 @@ private:
 	bool tablecache_valid;
 	cacheblock_t tablecache;
 
+	/**
+	 * Fully decoded compressed strings, keyed by address. Only strings stored in ROM and decoded
+	 * through a valid tablecache are kept here, so the cache only has to be dropped when the
+	 * string table changes. strcache_lru holds the cached addresses, most recently used first.
+	 */
+	Common::HashMap<uint, strcacheentry_t> strcache;
+	Common::List<uint> strcache_lru;
+	uint strcache_chars;
+
 	/* This misbehaves if a Glk function has more than one S argument. */
 #define STATIC_TEMP_BUFSIZE (127)
 	char temp_buf[STATIC_TEMP_BUFSIZE + 1];
@@ -391,6 +401,14 @@ protected:
 	void buildcache(cacheblock_t *cablist, uint nodeaddr, int depth, int mask);
 	void dumpcache(cacheblock_t *cablist, int count, int indent);
 
+	/**
+	 * Print a compressed string from the decoded-string cache, decoding and adding it first if
+	 * needed. Returns false if the string can't be cached, in which case nothing was printed.
+	 */
+	bool strcache_print(uint addr);
+	bool strcache_decode(uint addr, Common::Array<uint32> &text);
+	void strcache_drop();
+
 	/**@}*/
 public:
 	/**
@@ -23,6 +23,8 @@
 #define GLK_GLULXE_TYPES
 
 #include "common/scummsys.h"
+#include "common/array.h"
+#include "common/list.h"
 
 namespace Glk {
 namespace Glulx {
@@ -401,12 +403,29 @@ enum iosys {
 	iosys_Glk    = 2
 };
 
-#define CACHEBITS (4)
+/**
+ * Number of bits the string-decoding cache consumes per table lookup. This must not exceed 8,
+ * since the decoder reads ahead at most one byte.
+ */
+#define CACHEBITS (8)
 #define CACHESIZE (1 << CACHEBITS)
-#define CACHEMASK (15)
+#define CACHEMASK (CACHESIZE - 1)
+
+/**
+ * Maximum number of characters held by the decoded-string cache, summed over all cached strings.
+ * Strings longer than STRCACHE_MAXLEN characters are never cached.
+ */
+#define STRCACHE_MAXCHARS (65536)
+#define STRCACHE_MAXLEN (4096)
+
+/**
+ * Flag set on decoded-string cache characters that were encoded as Unicode (node type 0x04/0x05)
+ * rather than as 8-bit characters, so they are replayed through the same output function.
+ */
+#define STRCACHE_UNICHAR (0x80000000)
 
 struct cacheblock_struct {
-	int depth; /* 1 to 4 */
+	int depth; /* 1 to CACHEBITS */
 	int type;
 	union {
 		struct cacheblock_struct *branches;
@@ -417,6 +436,13 @@ struct cacheblock_struct {
 };
 typedef cacheblock_struct cacheblock_t;
 
+struct strcacheentry_struct {
+	bool valid; /* false if the string can't be cached */
+	Common::Array<uint32> text;
+	Common::List<uint>::iterator lru;
+};
+typedef strcacheentry_struct strcacheentry_t;
+
 } // End of namespace Glulx
 } // End of namespace Glk
 
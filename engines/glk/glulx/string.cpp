@@ -169,6 +169,12 @@ void Glulx::stream_string(uint addr, int inmiddle, int bitnum) {
 	if (!addr)
 		fatal_error("Called stream_string with null address.");
 
+	/* Compressed strings printed straight to Glk can be replayed from
+	   the decoded-string cache. */
+	if (!inmiddle && iosys_mode == iosys_Glk && tablecache_valid
+			&& Mem1(addr) == 0xE1 && strcache_print(addr))
+		return;
+
 	while (!alldone) {
 
 		if (inmiddle == 0) {
@@ -619,6 +625,7 @@ void Glulx::stream_set_table(uint addr) {
 		return;
 
 	/* Drop cache. */
+	strcache_drop();
 	if (tablecache_valid) {
 		if (tablecache.type == 0)
 			dropcache(tablecache.u.branches);
@@ -739,6 +746,145 @@ void Glulx::dropcache(cacheblock_t *cablist) {
 	glulx_free(cablist);
 }
 
+bool Glulx::strcache_print(uint addr) {
+	strcacheentry_t *entry;
+
+	if (addr >= ramstart)
+		return false;
+
+	if (strcache.contains(addr)) {
+		entry = &strcache[addr];
+		if (!entry->valid)
+			return false;
+		/* Move to the front of the LRU list. */
+		strcache_lru.erase(entry->lru);
+		strcache_lru.push_front(addr);
+		entry->lru = strcache_lru.begin();
+	} else {
+		Common::Array<uint32> text;
+		bool valid = strcache_decode(addr + 1, text);
+		if (!valid)
+			text.clear();
+
+		uint cost = text.size() + 1;
+		while (strcache_chars + cost > STRCACHE_MAXCHARS && !strcache_lru.empty()) {
+			uint oldaddr = strcache_lru.back();
+			strcache_lru.pop_back();
+			strcache_chars -= strcache[oldaddr].text.size() + 1;
+			strcache.erase(oldaddr);
+		}
+
+		strcache_lru.push_front(addr);
+		entry = &strcache[addr];
+		entry->valid = valid;
+		entry->text = Common::move(text);
+		entry->lru = strcache_lru.begin();
+		strcache_chars += cost;
+
+		/* Remember strings that can't be cached, so they aren't decoded twice on every print. */
+		if (!valid)
+			return false;
+	}
+
+	const Common::Array<uint32> &text = entry->text;
+	for (uint ix = 0; ix < text.size(); ix++) {
+		if (text[ix] & STRCACHE_UNICHAR)
+			(this->*glkio_unichar_han_ptr)(text[ix] & ~STRCACHE_UNICHAR);
+		else
+			glk_put_char(text[ix]);
+	}
+
+	return true;
+}
+
+bool Glulx::strcache_decode(uint addr, Common::Array<uint32> &text) {
+	int bits, numbits, bitnum;
+	int readahead;
+	uint tmpaddr, ival;
+	int ch;
+	cacheblock_t *cablist;
+
+	/* See stream_string(): a top-level leaf can only be a terminator. */
+	if (tablecache.type != 0)
+		return true;
+
+	bits = Mem1(addr);
+	numbits = 8;
+	bitnum = 0;
+	readahead = false;
+	cablist = tablecache.u.branches;
+
+	for (;;) {
+		cacheblock_t *cab;
+
+		if (numbits < CACHEBITS) {
+			int newbyte = Mem1(addr + 1);
+			bits |= (newbyte << numbits);
+			numbits += 8;
+			readahead = true;
+		}
+
+		cab = &(cablist[bits & CACHEMASK]);
+		numbits -= cab->depth;
+		bits >>= cab->depth;
+		bitnum += cab->depth;
+		if (bitnum >= 8) {
+			addr += 1;
+			bitnum -= 8;
+			/* Strings reaching into RAM may change, so they can't be cached. */
+			if (addr >= ramstart)
+				return false;
+			if (readahead) {
+				readahead = false;
+			} else {
+				int newbyte = Mem1(addr);
+				bits |= (newbyte << numbits);
+				numbits += 8;
+			}
+		}
+
+		switch (cab->type) {
+		case 0x00: /* non-leaf node */
+			cablist = cab->u.branches;
+			continue;
+		case 0x01: /* string terminator */
+			return true;
+		case 0x02: /* single character */
+			text.push_back(cab->u.ch);
+			break;
+		case 0x04: /* single Unicode character */
+			if (cab->u.uch & STRCACHE_UNICHAR)
+				return false;
+			text.push_back(cab->u.uch | STRCACHE_UNICHAR);
+			break;
+		case 0x03: /* C string */
+			for (tmpaddr = cab->u.addr; (ch = Mem1(tmpaddr)) != '\0'; tmpaddr++)
+				text.push_back(ch);
+			break;
+		case 0x05: /* C Unicode string */
+			for (tmpaddr = cab->u.addr; (ival = Mem4(tmpaddr)) != 0; tmpaddr += 4) {
+				if (ival & STRCACHE_UNICHAR)
+					return false;
+				text.push_back(ival | STRCACHE_UNICHAR);
+			}
+			break;
+		default:
+			/* Indirect references may call functions or print RAM contents. */
+			return false;
+		}
+
+		if (text.size() > STRCACHE_MAXLEN)
+			return false;
+		cablist = tablecache.u.branches;
+	}
+}
+
+void Glulx::strcache_drop() {
+	strcache.clear();
+	strcache_lru.clear();
+	strcache_chars = 0;
+}
+
 char *Glulx::make_temp_string(uint addr) {
 	int ix, len;
 	uint addr2;
@@ -1278,7 +1278,7 @@ Debugger::ToastNotification::ToastNotification() : dismissTime(0) {
 }
 
 
-Debugger::Debugger(Runtime *runtime) : _paused(false), _runtime(runtime) {
+Debugger::Debugger(Runtime *runtime) : _paused(false), _runtime(runtime), _shownMessages(0), _shownNewMessageSlots(0) {
 	refreshSceneStatus();
 
 	const Graphics::PixelFormat renderFmt = runtime->getRenderPixelFormat();
@@ -1355,6 +1355,10 @@ void Debugger::runFrame(uint32 msec) {
 			toolWindow->render();
 		}
 	}
+
+	const MessagePoolStats &messageStats = _runtime->getMessagePoolStats();
+	if (messageStats.messages != _shownMessages || messageStats.newSlots != _shownNewMessageSlots)
+		refreshMessageStats();
 }
 
 void Debugger::setPaused(bool paused) {
@@ -1440,9 +1444,14 @@ void Debugger::refreshSceneStatus() {
 	if (mainScene)
 		sceneStrs.push_back(Common::String("Main: ") + mainScene->debugGetName());
 
-	const uint horizPadding = 10;
-	const uint vertSpacing = 15;
-	int width = 0;
+	// The message statistics are the last line. It is redrawn in place when
+	// they change, so leave room for seven digit counts.
+	formatMessageStats();
+	sceneStrs.push_back(_messageStatsText);
+
+	const uint horizPadding = kSceneStatusHorizPadding;
+	const uint vertSpacing = kSceneStatusVertSpacing;
+	int width = font->getStringWidth("Msgs: 0000000/frame, 0000000 new slots, 0000000 pooled");
 	for (uint i = 0; i < sceneStrs.size(); i++) {
 		int lineWidth = font->getStringWidth(sceneStrs[i]);
 		if (lineWidth > width)
@@ -1470,6 +1479,34 @@ void Debugger::refreshSceneStatus() {
 		_toolsWindow->setPosition(0, _sceneStatusWindow->getHeight());
 }
 
+void Debugger::refreshMessageStats() {
+	if (!_sceneStatusWindow)
+		return;
+
+	// Only redraw the line, recreating the window would allocate in every frame
+	// that the statistics change
+	formatMessageStats();
+
+	const Graphics::Font *font = FontMan.getFontByUsage(Graphics::FontManager::kGUIFont);
+	const Graphics::PixelFormat pixelFmt = _runtime->getRenderPixelFormat();
+	Graphics::ManagedSurface *surface = _sceneStatusWindow->getSurface().get();
+
+	const int y = surface->h - kSceneStatusVertSpacing;
+	surface->fillRect(Common::Rect(0, y, surface->w, surface->h), 0);
+	font->drawString(surface, _messageStatsText, kSceneStatusHorizPadding, y + (kSceneStatusVertSpacing - font->getFontAscent()) / 2, surface->w - kSceneStatusHorizPadding * 2, Render::resolveRGB(255, 255, 255, pixelFmt));
+}
+
+void Debugger::formatMessageStats() {
+	const MessagePoolStats &messageStats = _runtime->getMessagePoolStats();
+	_shownMessages = messageStats.messages;
+	_shownNewMessageSlots = messageStats.newSlots;
+
+	// Formatting into the existing string reuses its storage
+	char text[64];
+	Common::sprintf_s(text, "Msgs: %u/frame, %u new slots, %u pooled", messageStats.messages, messageStats.newSlots, messageStats.slots);
+	_messageStatsText = text;
+}
+
 void Debugger::complainAboutUnfinished(Structural *structural) {
 	Common::HashMap<Common::String, SupportStatus> unfinishedModifiers;
 	Common::HashMap<Common::String, SupportStatus> unfinishedElements;
@@ -171,8 +171,16 @@ public:
 	const Common::SharedPtr<DebugInspector> &getInspector() const;
 
 private:
+	enum {
+		kSceneStatusHorizPadding = 10,
+		kSceneStatusVertSpacing = 15,
+	};
+
 	Debugger();
 
+	void refreshMessageStats();
+	void formatMessageStats();
+
 	static void scanStructuralStatus(Structural *structural, Common::HashMap<Common::String, SupportStatus> &unfinishedModifiers, Common::HashMap<Common::String, SupportStatus> &unfinishedElements);
 	static void scanModifierStatus(Modifier *modifier, Common::HashMap<Common::String, SupportStatus> &unfinishedModifiers, Common::HashMap<Common::String, SupportStatus> &unfinishedElements);
 	static void scanDebuggableStatus(IDebuggable *debuggable, Common::HashMap<Common::String, SupportStatus> &unfinished);
@@ -191,6 +199,11 @@ private:
 	Common::SharedPtr<DebugToolWindowBase> _toolWindows[kDebuggerToolCount];
 	Common::Array<ToastNotification> _toastNotifications;
 	Common::SharedPtr<DebugInspector> _inspector;
+
+	// Message pool statistics shown in the scene status
+	uint32 _shownMessages;
+	uint32 _shownNewMessageSlots;
+	Common::String _messageStatsText;
 };
 
 #else
@@ -565,14 +565,14 @@ VThreadState MovieElement::consumeCommand(Runtime *runtime, const Common::Shared
 		if (_paused)
 		{
 			_paused = false;
-			Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kUnpause, 0), DynamicValue(), getSelfReference()));
-			Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, this, false, true, false));
+			Common::SharedPtr<MessageProperties> msgProps(runtime->createMessageProperties(Event(EventIDs::kUnpause, 0), DynamicValue(), getSelfReference()));
+			Common::SharedPtr<MessageDispatch> dispatch(runtime->createMessageDispatch(msgProps, this, false, true, false));
 			runtime->sendMessageOnVThread(dispatch);
 		}
 
 		{
-			Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kPlay, 0), DynamicValue(), getSelfReference()));
-			Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, this, false, true, false));
+			Common::SharedPtr<MessageProperties> msgProps(runtime->createMessageProperties(Event(EventIDs::kPlay, 0), DynamicValue(), getSelfReference()));
+			Common::SharedPtr<MessageDispatch> dispatch(runtime->createMessageDispatch(msgProps, this, false, true, false));
 			runtime->sendMessageOnVThread(dispatch);
 		}
 
@@ -590,14 +590,14 @@ VThreadState MovieElement::consumeCommand(Runtime *runtime, const Common::Shared
 			stopSubtitles();
 
 			_paused = true;
-			Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kPause, 0), DynamicValue(), getSelfReference()));
-			Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, this, false, true, false));
+			Common::SharedPtr<MessageProperties> msgProps(runtime->createMessageProperties(Event(EventIDs::kPause, 0), DynamicValue(), getSelfReference()));
+			Common::SharedPtr<MessageDispatch> dispatch(runtime->createMessageDispatch(msgProps, this, false, true, false));
 			runtime->sendMessageOnVThread(dispatch);
 		}
 
 		{
-			Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kStop, 0), DynamicValue(), getSelfReference()));
-			Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, this, false, true, false));
+			Common::SharedPtr<MessageProperties> msgProps(runtime->createMessageProperties(Event(EventIDs::kStop, 0), DynamicValue(), getSelfReference()));
+			Common::SharedPtr<MessageDispatch> dispatch(runtime->createMessageDispatch(msgProps, this, false, true, false));
 			runtime->sendMessageOnVThread(dispatch);
 		}
 
@@ -720,8 +720,8 @@ bool MovieElement::canAutoPlay() const {
 void MovieElement::queueAutoPlayEvents(Runtime *runtime, bool isAutoPlaying) {
 	// At First Cel event fires even if the movie isn't playing, and it fires before Played
 	if (_visible) {
-		Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kAtFirstCel, 0), DynamicValue(), getSelfReference()));
-		Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, this, false, true, false));
+		Common::SharedPtr<MessageProperties> msgProps(runtime->createMessageProperties(Event(EventIDs::kAtFirstCel, 0), DynamicValue(), getSelfReference()));
+		Common::SharedPtr<MessageDispatch> dispatch(runtime->createMessageDispatch(msgProps, this, false, true, false));
 		runtime->queueMessage(dispatch);
 	}
 
@@ -884,15 +884,15 @@ void MovieElement::playMedia(Runtime *runtime, Project *project) {
 				_paused = true;
 				stopSubtitles();
 
-				Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kPause, 0), DynamicValue(), getSelfReference()));
-				Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, this, false, true, false));
+				Common::SharedPtr<MessageProperties> msgProps(runtime->createMessageProperties(Event(EventIDs::kPause, 0), DynamicValue(), getSelfReference()));
+				Common::SharedPtr<MessageDispatch> dispatch(runtime->createMessageDispatch(msgProps, this, false, true, false));
 				runtime->queueMessage(dispatch);
 
 				_currentPlayState = kMediaStateStopped;
 			}
 
-			Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kAtLastCel, 0), DynamicValue(), getSelfReference()));
-			Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, this, false, true, false));
+			Common::SharedPtr<MessageProperties> msgProps(runtime->createMessageProperties(Event(EventIDs::kAtLastCel, 0), DynamicValue(), getSelfReference()));
+			Common::SharedPtr<MessageDispatch> dispatch(runtime->createMessageDispatch(msgProps, this, false, true, false));
 			runtime->queueMessage(dispatch);
 
 			// For some reason, At First Cel isn't fired for movies, even when they loop or are set to timevalue 0
@@ -1557,14 +1557,14 @@ VThreadState MToonElement::startPlayingTask(const StartPlayingTaskData &taskData
 
 	// These send in reverse order
 	{
-		Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kAtFirstCel, 0), DynamicValue(), getSelfReference()));
-		Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, this, false, true, false));
+		Common::SharedPtr<MessageProperties> msgProps(taskData.runtime->createMessageProperties(Event(EventIDs::kAtFirstCel, 0), DynamicValue(), getSelfReference()));
+		Common::SharedPtr<MessageDispatch> dispatch(taskData.runtime->createMessageDispatch(msgProps, this, false, true, false));
 		taskData.runtime->sendMessageOnVThread(dispatch);
 	}
 
 	{
-		Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kPlay, 0), DynamicValue(), getSelfReference()));
-		Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, this, false, true, false));
+		Common::SharedPtr<MessageProperties> msgProps(taskData.runtime->createMessageProperties(Event(EventIDs::kPlay, 0), DynamicValue(), getSelfReference()));
+		Common::SharedPtr<MessageDispatch> dispatch(taskData.runtime->createMessageDispatch(msgProps, this, false, true, false));
 		taskData.runtime->sendMessageOnVThread(dispatch);
 	}
 
@@ -1578,8 +1578,8 @@ VThreadState MToonElement::stopPlayingTask(const StopPlayingTaskData &taskData)
 	if (!_isStopped) {
 		_isStopped = true;
 
-		Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kStop, 0), DynamicValue(), getSelfReference()));
-		Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, this, false, true, false));
+		Common::SharedPtr<MessageProperties> msgProps(taskData.runtime->createMessageProperties(Event(EventIDs::kStop, 0), DynamicValue(), getSelfReference()));
+		Common::SharedPtr<MessageDispatch> dispatch(taskData.runtime->createMessageDispatch(msgProps, this, false, true, false));
 		taskData.runtime->sendMessageOnVThread(dispatch);
 	}
 
@@ -1665,20 +1665,20 @@ void MToonElement::playMedia(Runtime *runtime, Project *project) {
 		bool atLastCel = (targetCel == (isReversed ? minCel : maxCel)) && !(ranPastEnd && alreadyAtLastCel);
 
 		if (atFirstCel) {
-			Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kAtFirstCel, 0), DynamicValue(), getSelfReference()));
-			Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, this, false, true, false));
+			Common::SharedPtr<MessageProperties> msgProps(runtime->createMessageProperties(Event(EventIDs::kAtFirstCel, 0), DynamicValue(), getSelfReference()));
+			Common::SharedPtr<MessageDispatch> dispatch(runtime->createMessageDispatch(msgProps, this, false, true, false));
 			runtime->queueMessage(dispatch);
 		} else if (atLastCel) {		// These can not fire from the same frame transition (see notes)
-			Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kAtLastCel, 0), DynamicValue(), getSelfReference()));
-			Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, this, false, true, false));
+			Common::SharedPtr<MessageProperties> msgProps(runtime->createMessageProperties(Event(EventIDs::kAtLastCel, 0), DynamicValue(), getSelfReference()));
+			Common::SharedPtr<MessageDispatch> dispatch(runtime->createMessageDispatch(msgProps, this, false, true, false));
 			runtime->queueMessage(dispatch);
 		}
 
 		if (ranPastEnd && !_loop) {
 			_paused = true;
 
-			Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kPause, 0), DynamicValue(), getSelfReference()));
-			Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, this, false, true, false));
+			Common::SharedPtr<MessageProperties> msgProps(runtime->createMessageProperties(Event(EventIDs::kPause, 0), DynamicValue(), getSelfReference()));
+			Common::SharedPtr<MessageDispatch> dispatch(runtime->createMessageDispatch(msgProps, this, false, true, false));
 			runtime->queueMessage(dispatch);
 		}
 
@@ -2426,8 +2426,8 @@ void SoundElement::playMedia(Runtime *runtime, Project *project) {
 				// to know that the handle is still here so we can actually stop it if the element is
 				// destroyed, since the stream is tied to the CachedAudio.
 
-				Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kStop, 0), DynamicValue(), getSelfReference()));
-				Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, this, false, true, false));
+				Common::SharedPtr<MessageProperties> msgProps(runtime->createMessageProperties(Event(EventIDs::kStop, 0), DynamicValue(), getSelfReference()));
+				Common::SharedPtr<MessageDispatch> dispatch(runtime->createMessageDispatch(msgProps, this, false, true, false));
 				runtime->queueMessage(dispatch);
 
 				_shouldPlayIfNotPaused = false;
@@ -2581,14 +2581,14 @@ void SoundElement::setBalance(int16 balance) {
 VThreadState SoundElement::startPlayingTask(const StartPlayingTaskData &taskData) {
 	// Pushed in reverse order, actual order is Unpaused -> Played
 	{
-		Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kPlay, 0), DynamicValue(), getSelfReference()));
-		Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, this, false, true, false));
+		Common::SharedPtr<MessageProperties> msgProps(taskData.runtime->createMessageProperties(Event(EventIDs::kPlay, 0), DynamicValue(), getSelfReference()));
+		Common::SharedPtr<MessageDispatch> dispatch(taskData.runtime->createMessageDispatch(msgProps, this, false, true, false));
 		taskData.runtime->sendMessageOnVThread(dispatch);
 	}
 
 	if (_paused) {
-		Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kUnpause, 0), DynamicValue(), getSelfReference()));
-		Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, this, false, true, false));
+		Common::SharedPtr<MessageProperties> msgProps(taskData.runtime->createMessageProperties(Event(EventIDs::kUnpause, 0), DynamicValue(), getSelfReference()));
+		Common::SharedPtr<MessageDispatch> dispatch(taskData.runtime->createMessageDispatch(msgProps, this, false, true, false));
 		taskData.runtime->sendMessageOnVThread(dispatch);
 
 		_paused = false;
@@ -2602,8 +2602,8 @@ VThreadState SoundElement::startPlayingTask(const StartPlayingTaskData &taskData
 
 VThreadState SoundElement::stopPlayingTask(const StartPlayingTaskData &taskData) {
 	if (_shouldPlayIfNotPaused) {
-		Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kStop, 0), DynamicValue(), getSelfReference()));
-		Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, this, false, true, false));
+		Common::SharedPtr<MessageProperties> msgProps(taskData.runtime->createMessageProperties(Event(EventIDs::kStop, 0), DynamicValue(), getSelfReference()));
+		Common::SharedPtr<MessageDispatch> dispatch(taskData.runtime->createMessageDispatch(msgProps, this, false, true, false));
 		taskData.runtime->sendMessageOnVThread(dispatch);
 
 		_shouldPlayIfNotPaused = false;
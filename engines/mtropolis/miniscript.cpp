@@ -23,6 +23,7 @@
 
 #include "common/random.h"
 #include "common/memstream.h"
+#include "common/system.h"
 
 #include "mtropolis/miniscript.h"
 
@@ -77,9 +78,17 @@ bool miniscriptEvaluateTruth(const DynamicValue &value) {
 IMiniscriptInstructionParserFeedback::~IMiniscriptInstructionParserFeedback() {
 }
 
+MiniscriptCompiledInstruction::MiniscriptCompiledInstruction() : op(kOpExecute), instr(nullptr) {
+	operand.f = 0.0;
+}
+
 MiniscriptInstruction::~MiniscriptInstruction() {
 }
 
+void MiniscriptInstruction::compile(MiniscriptCompiledInstruction &compiled, uint index) const {
+	compiled.op = MiniscriptCompiledInstruction::kOpExecute;
+}
+
 MiniscriptReferences::LocalRef::LocalRef() : guid(0) {
 }
 
@@ -144,8 +153,16 @@ Common::WeakPtr<RuntimeObject> MiniscriptReferences::getGlobalRefByIndex(uint in
 	
 }
 
+MiniscriptProgram::Stats::Stats() : runs(0), resumes(0), instructions(0), executeCalls(0), usec(0) {
+}
+
 MiniscriptProgram::MiniscriptProgram(const Common::SharedPtr<Common::Array<uint8> > &programData, const Common::Array<MiniscriptInstruction *> &instructions, const Common::Array<Attribute> &attributes)
 	: _programData(programData), _instructions(instructions), _attributes(attributes) {
+	_compiledInstructions.resize(_instructions.size());
+	for (uint i = 0; i < _instructions.size(); i++) {
+		_compiledInstructions[i].instr = _instructions[i];
+		_instructions[i]->compile(_compiledInstructions[i], i);
+	}
 }
 
 MiniscriptProgram::~MiniscriptProgram() {
@@ -158,10 +175,30 @@ const Common::Array<MiniscriptInstruction *> &MiniscriptProgram::getInstructions
 	return _instructions;
 }
 
+const Common::Array<MiniscriptCompiledInstruction> &MiniscriptProgram::getCompiledInstructions() const {
+	return _compiledInstructions;
+}
+
 const Common::Array<MiniscriptProgram::Attribute> &MiniscriptProgram::getAttributes() const {
 	return _attributes;
 }
 
+MiniscriptProgram::Stats &MiniscriptProgram::getStats() const {
+	return _stats;
+}
+
+#ifdef MTROPOLIS_DEBUG_ENABLE
+void MiniscriptProgram::debugInspectStats(IDebugInspectionReport *report) const {
+	if (report->declareStatic("instructions"))
+		report->declareStaticContents(Common::String::format("%u", _instructions.size()));
+
+	report->declareDynamic("runs", Common::String::format("%u", _stats.runs));
+	report->declareDynamic("resumes", Common::String::format("%u", _stats.resumes));
+	report->declareDynamic("executed", Common::String::format("%u (%u not flattened)", _stats.instructions, _stats.executeCalls));
+	report->declareDynamic("time", Common::String::format("%u.%03u ms", (uint)(_stats.usec / 1000), (uint)(_stats.usec % 1000)));
+}
+#endif
+
 template<class T>
 struct MiniscriptInstructionLoader {
 	static bool loadInstruction(void *dest, uint32 instrFlags, Data::DataReader &instrDataReader, IMiniscriptInstructionParserFeedback &feedback);
@@ -615,12 +652,14 @@ MiniscriptInstructionOutcome Send::execute(MiniscriptThread *thread) const {
 		return kMiniscriptInstructionOutcomeContinue;
 	}
 
-	Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(_evt, payloadValue, thread->getModifier()->getSelfReference()));
+	Runtime *runtime = thread->getRuntime();
+
+	Common::SharedPtr<MessageProperties> msgProps(runtime->createMessageProperties(_evt, payloadValue, thread->getModifier()->getSelfReference()));
 	Common::SharedPtr<MessageDispatch> dispatch;
 	if (obj->isModifier())
-		dispatch.reset(new MessageDispatch(msgProps, static_cast<Modifier *>(obj.get()), _messageFlags.cascade, _messageFlags.relay, true));
+		dispatch = runtime->createMessageDispatch(msgProps, static_cast<Modifier *>(obj.get()), _messageFlags.cascade, _messageFlags.relay, true);
 	else if (obj->isStructural())
-		dispatch.reset(new MessageDispatch(msgProps, static_cast<Structural *>(obj.get()), _messageFlags.cascade, _messageFlags.relay, true));
+		dispatch = runtime->createMessageDispatch(msgProps, static_cast<Structural *>(obj.get()), _messageFlags.cascade, _messageFlags.relay, true);
 	else {
 		warning("Invalid message destination (target object is not a modifier or structural object)");
 		return kMiniscriptInstructionOutcomeContinue;
@@ -629,10 +668,10 @@ MiniscriptInstructionOutcome Send::execute(MiniscriptThread *thread) const {
 	thread->popValues(2);
 
 	if (_messageFlags.immediate) {
-		thread->getRuntime()->sendMessageOnVThread(dispatch);
+		runtime->sendMessageOnVThread(dispatch);
 		return kMiniscriptInstructionOutcomeYieldToVThreadNoRetry;
 	} else {
-		thread->getRuntime()->queueMessage(dispatch);
+		runtime->queueMessage(dispatch);
 		return kMiniscriptInstructionOutcomeContinue;
 	}
 }
@@ -1744,6 +1783,33 @@ MiniscriptInstructionOutcome PushValue::execute(MiniscriptThread *thread) const
 	return kMiniscriptInstructionOutcomeContinue;
 }
 
+void PushValue::compile(MiniscriptCompiledInstruction &compiled, uint index) const {
+	switch (_dataType) {
+	case DataType::kDataTypeNull:
+		compiled.op = MiniscriptCompiledInstruction::kOpPushNull;
+		break;
+	case DataType::kDataTypeDouble:
+		compiled.op = MiniscriptCompiledInstruction::kOpPushFloat;
+		compiled.operand.f = _value.f;
+		break;
+	case DataType::kDataTypeBool:
+		compiled.op = MiniscriptCompiledInstruction::kOpPushBool;
+		compiled.operand.b = _value.b;
+		break;
+	case DataType::kDataTypeLocalRef:
+		compiled.op = MiniscriptCompiledInstruction::kOpPushLocalRef;
+		compiled.operand.refIndex = _value.ref;
+		break;
+	case DataType::kDataTypeGlobalRef:
+		compiled.op = MiniscriptCompiledInstruction::kOpPushGlobalRef;
+		compiled.operand.refIndex = _value.ref;
+		break;
+	default:
+		compiled.op = MiniscriptCompiledInstruction::kOpExecute;
+		break;
+	}
+}
+
 PushGlobal::PushGlobal(uint32 globalID, bool isLValue) : _globalID(globalID), _isLValue(isLValue) {
 }
 
@@ -1880,10 +1946,17 @@ MiniscriptInstructionOutcome Jump::execute(MiniscriptThread *thread) const {
 	return kMiniscriptInstructionOutcomeContinue;
 }
 
+void Jump::compile(MiniscriptCompiledInstruction &compiled, uint index) const {
+	// Offsets are relative to the jump itself and never 0, which the loader rejects
+	compiled.op = _isConditional ? MiniscriptCompiledInstruction::kOpJumpIfFalse : MiniscriptCompiledInstruction::kOpJump;
+	compiled.operand.target = index + _instrOffset;
+}
+
 } // End of namespace MiniscriptInstructions
 
 MiniscriptThread::MiniscriptThread(Runtime *runtime, const Common::SharedPtr<MessageProperties> &msgProps, const Common::SharedPtr<MiniscriptProgram> &program, const Common::SharedPtr<MiniscriptReferences> &refs, Modifier *modifier)
 	: _runtime(runtime), _msgProps(msgProps), _program(program), _refs(refs), _modifier(modifier), _currentInstruction(0), _failed(false) {
+	_program->getStats().runs++;
 }
 
 void MiniscriptThread::runOnVThread(VThread &vthread, const Common::SharedPtr<MiniscriptThread> &thread) {
@@ -2024,12 +2097,12 @@ VThreadState MiniscriptThread::resumeTask(const ResumeTaskData &data) {
 }
 
 VThreadState MiniscriptThread::resume(const ResumeTaskData &taskData) {
-	const Common::Array<MiniscriptInstruction *> &instrsArray = _program->getInstructions();
+	const Common::Array<MiniscriptCompiledInstruction> &instrsArray = _program->getCompiledInstructions();
 
 	if (instrsArray.size() == 0)
 		return kVThreadReturn;
 
-	MiniscriptInstruction *const *instrs = &instrsArray[0];
+	const MiniscriptCompiledInstruction *instrs = &instrsArray[0];
 	size_t numInstrs = instrsArray.size();
 
 	if (_currentInstruction >= numInstrs || _failed)
@@ -2041,29 +2114,86 @@ VThreadState MiniscriptThread::resume(const ResumeTaskData &taskData) {
 		requeueData->thread = taskData.thread;
 	}
 
+	MiniscriptProgram::Stats &stats = _program->getStats();
+	const uint64 startTime = g_system->getMicros();
+	stats.resumes++;
+
 	while (_currentInstruction < numInstrs && !_failed) {
 		size_t instrNum = _currentInstruction++;
-		MiniscriptInstruction *instr = instrs[instrNum];
+		const MiniscriptCompiledInstruction &instr = instrs[instrNum];
+
+		stats.instructions++;
+
+		MiniscriptInstructionOutcome outcome = kMiniscriptInstructionOutcomeContinue;
+		switch (instr.op) {
+		case MiniscriptCompiledInstruction::kOpPushNull:
+			_stack.push_back(MiniscriptStackValue());
+			break;
+		case MiniscriptCompiledInstruction::kOpPushFloat:
+			_stack.push_back(MiniscriptStackValue());
+			_stack.back().value.setFloat(instr.operand.f);
+			break;
+		case MiniscriptCompiledInstruction::kOpPushBool:
+			_stack.push_back(MiniscriptStackValue());
+			_stack.back().value.setBool(instr.operand.b);
+			break;
+		case MiniscriptCompiledInstruction::kOpPushLocalRef:
+			_stack.push_back(MiniscriptStackValue());
+			_stack.back().value.setObject(_refs->getRefByIndex(instr.operand.refIndex));
+			break;
+		case MiniscriptCompiledInstruction::kOpPushGlobalRef:
+			_stack.push_back(MiniscriptStackValue());
+			_stack.back().value.setObject(_refs->getGlobalRefByIndex(instr.operand.refIndex));
+			break;
+		case MiniscriptCompiledInstruction::kOpJump:
+			_currentInstruction = instr.operand.target;
+			break;
+		case MiniscriptCompiledInstruction::kOpJumpIfFalse:
+			outcome = executeJumpIfFalse(instr);
+			break;
+		default:
+			stats.executeCalls++;
+			outcome = instr.instr->execute(this);
+			break;
+		}
+
+		if (outcome == kMiniscriptInstructionOutcomeContinue)
+			continue;
 
-		MiniscriptInstructionOutcome outcome = instr->execute(this);
 		if (outcome == kMiniscriptInstructionOutcomeFailed) {
 			// Should this also interrupt the message dispatch?
 			_failed = true;
-			return kVThreadReturn;
-		}
-
-		if (outcome == kMiniscriptInstructionOutcomeYieldToVThreadAndRetry) {
+		} else if (outcome == kMiniscriptInstructionOutcomeYieldToVThreadAndRetry) {
 			_currentInstruction = instrNum;
-			return kVThreadReturn;
 		}
 
-		if (outcome == kMiniscriptInstructionOutcomeYieldToVThreadNoRetry)
-			return kVThreadReturn;
+		break;
 	}
 
+	stats.usec += g_system->getMicros() - startTime;
+
 	return kVThreadReturn;
 }
 
+MiniscriptInstructionOutcome MiniscriptThread::executeJumpIfFalse(const MiniscriptCompiledInstruction &instr) {
+	if (_stack.size() < 1) {
+		this->error("Stack underflow");
+		return kMiniscriptInstructionOutcomeFailed;
+	}
+
+	MiniscriptInstructionOutcome outcome = dereferenceRValue(0);
+	if (outcome != kMiniscriptInstructionOutcomeContinue)
+		return outcome;
+
+	bool isTrue = miniscriptEvaluateTruth(_stack.back().value);
+	_stack.pop_back();
+
+	if (!isTrue)
+		_currentInstruction = instr.operand.target;
+
+	return kMiniscriptInstructionOutcomeContinue;
+}
+
 MiniscriptInstructionOutcome MiniscriptThread::tryLoadVariable(MiniscriptStackValue &stackValue) {
 	if (stackValue.value.getType() == DynamicValueTypes::kObject) {
 		Common::SharedPtr<RuntimeObject> obj = stackValue.value.getObject().object.lock();
@@ -27,17 +27,49 @@
 
 namespace MTropolis {
 
+class MiniscriptInstruction;
 class MiniscriptThread;
 struct MiniscriptStackValue;
 struct SIMiniscriptInstructionFactory;
 
 bool miniscriptEvaluateTruth(const DynamicValue &value);
 
+// Flattened form of an instruction.  The interpreter runs the simple operations directly and calls
+// MiniscriptInstruction::execute for everything else.
+struct MiniscriptCompiledInstruction {
+	enum Op {
+		kOpExecute,
+		kOpPushNull,
+		kOpPushFloat,
+		kOpPushBool,
+		kOpPushLocalRef,
+		kOpPushGlobalRef,
+		kOpJump,
+		kOpJumpIfFalse,
+	};
+
+	union Operand {
+		double f;
+		bool b;
+		uint32 refIndex;
+		uint32 target;	// Absolute instruction index
+	};
+
+	MiniscriptCompiledInstruction();
+
+	Op op;
+	Operand operand;
+	const MiniscriptInstruction *instr;
+};
+
 class MiniscriptInstruction {
 public:
 	virtual ~MiniscriptInstruction();
 
 	virtual MiniscriptInstructionOutcome execute(MiniscriptThread *thread) const = 0;
+
+	// Fills in the flattened form of the instruction at the specified index
+	virtual void compile(MiniscriptCompiledInstruction &compiled, uint index) const;
 };
 
 class IMiniscriptInstructionParserFeedback {
@@ -85,16 +117,37 @@ public:
 		Common::String name;
 	};
 
+	struct Stats {
+		Stats();
+
+		uint32 runs;			// Threads started on the program
+		uint32 resumes;			// Times the program was entered, including after yielding to the VThread
+		uint32 instructions;	// Instructions executed
+		uint32 executeCalls;	// Instructions which were not flattened and ran through execute
+		uint64 usec;			// Time spent running the program; most resumes take well under a millisecond
+	};
+
 	MiniscriptProgram(const Common::SharedPtr<Common::Array<uint8> > &programData, const Common::Array<MiniscriptInstruction *> &instructions, const Common::Array<Attribute> &attributes);
 	~MiniscriptProgram();
 
 	const Common::Array<MiniscriptInstruction *> &getInstructions() const;
+	const Common::Array<MiniscriptCompiledInstruction> &getCompiledInstructions() const;
 	const Common::Array<Attribute> &getAttributes() const;
 
+	// Execution counters, shared by all modifiers using the program
+	Stats &getStats() const;
+
+#ifdef MTROPOLIS_DEBUG_ENABLE
+	void debugInspectStats(IDebugInspectionReport *report) const;
+#endif
+
 private:
 	Common::SharedPtr<Common::Array<uint8> > _programData;
 	Common::Array<MiniscriptInstruction *> _instructions;
+	Common::Array<MiniscriptCompiledInstruction> _compiledInstructions;
 	Common::Array<Attribute> _attributes;
+
+	mutable Stats _stats;
 };
 
 class MiniscriptParser {
@@ -349,6 +402,7 @@ namespace MiniscriptInstructions {
 
 	private:
 		MiniscriptInstructionOutcome execute(MiniscriptThread *thread) const override;
+		void compile(MiniscriptCompiledInstruction &compiled, uint index) const override;
 
 		union ValueUnion {
 			ValueUnion();
@@ -407,6 +461,7 @@ namespace MiniscriptInstructions {
 
 	private:
 		MiniscriptInstructionOutcome execute(MiniscriptThread *thread) const override;
+		void compile(MiniscriptCompiledInstruction &compiled, uint index) const override;
 
 		uint32 _instrOffset;
 		bool _isConditional;
@@ -459,6 +514,7 @@ private:
 	VThreadState resume(const ResumeTaskData &data);
 
 	MiniscriptInstructionOutcome tryLoadVariable(MiniscriptStackValue &stackValue);
+	MiniscriptInstructionOutcome executeJumpIfFalse(const MiniscriptCompiledInstruction &instr);
 
 	Common::SharedPtr<MiniscriptProgram> _program;
 	Common::SharedPtr<MiniscriptReferences> _refs;
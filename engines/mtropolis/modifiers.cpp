@@ -196,8 +196,8 @@ VThreadState BehaviorModifier::propagateTask(const PropagateTaskData &taskData)
 		propagateData->runtime = taskData.runtime;
 	}
 
-	Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(taskData.eventID, 0), DynamicValue(), this->getSelfReference()));
-	Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, _children[taskData.index].get(), true, true, false));
+	Common::SharedPtr<MessageProperties> msgProps(taskData.runtime->createMessageProperties(Event(taskData.eventID, 0), DynamicValue(), this->getSelfReference()));
+	Common::SharedPtr<MessageDispatch> dispatch(taskData.runtime->createMessageDispatch(msgProps, _children[taskData.index].get(), true, true, false));
 	taskData.runtime->sendMessageOnVThread(dispatch);
 
 	return kVThreadReturn;
@@ -237,6 +237,14 @@ bool MiniscriptModifier::load(ModifierLoaderContext &context, const Data::Minisc
 	return true;
 }
 
+#ifdef MTROPOLIS_DEBUG_ENABLE
+void MiniscriptModifier::debugInspect(IDebugInspectionReport *report) const {
+	Modifier::debugInspect(report);
+
+	_program->debugInspectStats(report);
+}
+#endif
+
 bool MiniscriptModifier::respondsToEvent(const Event &evt) const {
 	return _enableWhen.respondsTo(evt);
 }
@@ -1006,8 +1014,8 @@ VThreadState PathMotionModifier::sendMessageToParentTask(const SendMessageToPare
 	Structural *owner = this->findStructuralOwner();
 
 	if (owner) {
-		Common::SharedPtr<MessageProperties> props(new MessageProperties(Event(taskData.eventID, 0), DynamicValue(), this->getSelfReference()));
-		Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(props, owner, true, true, false));
+		Common::SharedPtr<MessageProperties> props(taskData.runtime->createMessageProperties(Event(taskData.eventID, 0), DynamicValue(), this->getSelfReference()));
+		Common::SharedPtr<MessageDispatch> dispatch(taskData.runtime->createMessageDispatch(props, owner, true, true, false));
 
 		// Send immediately
 		taskData.runtime->sendMessageOnVThread(dispatch);
@@ -1645,15 +1653,15 @@ VThreadState ElementTransitionModifier::consumeMessage(Runtime *runtime, const C
 
 		// Pushed tasks, so these are executed in reverse order (Show -> Transition Started)
 		{
-			Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kTransitionStarted, 0), DynamicValue(), getSelfReference()));
-			Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, findStructuralOwner(), false, true, false));
+			Common::SharedPtr<MessageProperties> msgProps(runtime->createMessageProperties(Event(EventIDs::kTransitionStarted, 0), DynamicValue(), getSelfReference()));
+			Common::SharedPtr<MessageDispatch> dispatch(runtime->createMessageDispatch(msgProps, findStructuralOwner(), false, true, false));
 			runtime->sendMessageOnVThread(dispatch);
 		}
 
 		if (_revealType == kRevealTypeReveal)
 		{
-			Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kElementShow, 0), DynamicValue(), getSelfReference()));
-			Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, findStructuralOwner(), false, false, true));
+			Common::SharedPtr<MessageProperties> msgProps(runtime->createMessageProperties(Event(EventIDs::kElementShow, 0), DynamicValue(), getSelfReference()));
+			Common::SharedPtr<MessageDispatch> dispatch(runtime->createMessageDispatch(msgProps, findStructuralOwner(), false, false, true));
 			runtime->sendMessageOnVThread(dispatch);
 		}
 
@@ -1712,14 +1720,14 @@ void ElementTransitionModifier::continueTransition(Runtime *runtime) {
 void ElementTransitionModifier::completeTransition(Runtime *runtime) {
 	// Pushed tasks, so these are executed in reverse order (Hide -> Transition Ended)
 	{
-		Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kTransitionEnded, 0), DynamicValue(), getSelfReference()));
-		Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, findStructuralOwner(), false, true, false));
+		Common::SharedPtr<MessageProperties> msgProps(runtime->createMessageProperties(Event(EventIDs::kTransitionEnded, 0), DynamicValue(), getSelfReference()));
+		Common::SharedPtr<MessageDispatch> dispatch(runtime->createMessageDispatch(msgProps, findStructuralOwner(), false, true, false));
 		runtime->sendMessageOnVThread(dispatch);
 	}
 
 	if (_revealType == kRevealTypeConceal) {
-		Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kElementHide, 0), DynamicValue(), getSelfReference()));
-		Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, findStructuralOwner(), false, false, true));
+		Common::SharedPtr<MessageProperties> msgProps(runtime->createMessageProperties(Event(EventIDs::kElementHide, 0), DynamicValue(), getSelfReference()));
+		Common::SharedPtr<MessageDispatch> dispatch(runtime->createMessageDispatch(msgProps, findStructuralOwner(), false, false, true));
 		runtime->sendMessageOnVThread(dispatch);
 	}
 
@@ -1831,6 +1839,14 @@ bool IfMessengerModifier::load(ModifierLoaderContext &context, const Data::IfMes
 	return true;
 }
 
+#ifdef MTROPOLIS_DEBUG_ENABLE
+void IfMessengerModifier::debugInspect(IDebugInspectionReport *report) const {
+	Modifier::debugInspect(report);
+
+	_program->debugInspectStats(report);
+}
+#endif
+
 bool IfMessengerModifier::respondsToEvent(const Event &evt) const {
 	return _when.respondsTo(evt);
 }
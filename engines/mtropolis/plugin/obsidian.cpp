@@ -190,8 +190,8 @@ void MovementModifier::triggerMove(Runtime *runtime) {
 	visual->setRelativeRect(relRect);
 
 	if (progression == 1.0) {
-		Common::SharedPtr<MessageProperties> props(new MessageProperties(_triggerEvent, DynamicValue(), visual->getSelfReference()));
-		Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(props, visual, true, true, false));
+		Common::SharedPtr<MessageProperties> props(runtime->createMessageProperties(_triggerEvent, DynamicValue(), visual->getSelfReference()));
+		Common::SharedPtr<MessageDispatch> dispatch(runtime->createMessageDispatch(props, visual, true, true, false));
 		runtime->sendMessageOnVThread(dispatch);
 	} else {
 		_moveEvent = runtime->getScheduler().scheduleMethod<MovementModifier, &MovementModifier::triggerMove>(runtime->getPlayTime() + 1, this);
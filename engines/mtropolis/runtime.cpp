@@ -21,6 +21,7 @@
 
 #include "common/debug.h"
 #include "common/file.h"
+#include "common/profiler.h"
 #include "common/random.h"
 #include "common/substream.h"
 #include "common/system.h"
@@ -2257,7 +2258,7 @@ void MessengerSendSpec::sendFromMessenger(Runtime *runtime, Modifier *sender, Ru
 }
 
 void MessengerSendSpec::sendFromMessengerWithCustomData(Runtime *runtime, Modifier *sender, RuntimeObject *triggerSource, const DynamicValue &data, RuntimeObject *customDestination) const {
-	Common::SharedPtr<MessageProperties> props(new MessageProperties(this->send, data, sender->getSelfReference()));
+	Common::SharedPtr<MessageProperties> props(runtime->createMessageProperties(this->send, data, sender->getSelfReference()));
 
 	Common::WeakPtr<Modifier> modifierDestRef;
 	Common::WeakPtr<Structural> structuralDestRef;
@@ -2269,9 +2270,9 @@ void MessengerSendSpec::sendFromMessengerWithCustomData(Runtime *runtime, Modifi
 
 	Common::SharedPtr<MessageDispatch> dispatch;
 	if (structuralDest)
-		dispatch.reset(new MessageDispatch(props, structuralDest.get(), messageFlags.cascade, messageFlags.relay, true));
+		dispatch = runtime->createMessageDispatch(props, structuralDest.get(), messageFlags.cascade, messageFlags.relay, true);
 	else if (modifierDest)
-		dispatch.reset(new MessageDispatch(props, modifierDest.get(), messageFlags.cascade, messageFlags.relay, true));
+		dispatch = runtime->createMessageDispatch(props, modifierDest.get(), messageFlags.cascade, messageFlags.relay, true);
 
 	if (dispatch) {
 		if (messageFlags.immediate)
@@ -2648,10 +2649,18 @@ MiniscriptInstructionOutcome RuntimeObject::writeRefAttributeIndexed(MiniscriptT
 	return kMiniscriptInstructionOutcomeFailed;
 }
 
+MessageProperties::MessageProperties() {
+}
+
 MessageProperties::MessageProperties(const Event &evt, const DynamicValue &value, const Common::WeakPtr<RuntimeObject> &source)
 	: _evt(evt), _value(value), _source(source) {
 }
 
+void MessageProperties::recycle() {
+	_value.clear();
+	_source.reset();
+}
+
 const Event &MessageProperties::getEvent() const {
 	return _evt;
 }
@@ -3410,8 +3419,8 @@ VThreadState Structural::consumeCommand(Runtime *runtime, const Common::SharedPt
 			onPauseStateChanged();
 		}
 
-		Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kUnpause, 0), DynamicValue(), getSelfReference()));
-		Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, this, false, true, false));
+		Common::SharedPtr<MessageProperties> msgProps(runtime->createMessageProperties(Event(EventIDs::kUnpause, 0), DynamicValue(), getSelfReference()));
+		Common::SharedPtr<MessageDispatch> dispatch(runtime->createMessageDispatch(msgProps, this, false, true, false));
 		runtime->sendMessageOnVThread(dispatch);
 
 		return kVThreadReturn;
@@ -3422,8 +3431,8 @@ VThreadState Structural::consumeCommand(Runtime *runtime, const Common::SharedPt
 			onPauseStateChanged();
 		}
 
-		Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kPause, 0), DynamicValue(), getSelfReference()));
-		Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, this, false, true, false));
+		Common::SharedPtr<MessageProperties> msgProps(runtime->createMessageProperties(Event(EventIDs::kPause, 0), DynamicValue(), getSelfReference()));
+		Common::SharedPtr<MessageDispatch> dispatch(runtime->createMessageDispatch(msgProps, this, false, true, false));
 		runtime->sendMessageOnVThread(dispatch);
 
 		return kVThreadReturn;
@@ -3568,8 +3577,8 @@ MiniscriptInstructionOutcome Structural::scriptSetPaused(MiniscriptThread *threa
 	//
 	// The event does, however, need to be sent immediately.
 	if (!thread->getRuntime()->isAwaitingSceneTransition()) {
-		Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(targetValue ? EventIDs::kPause : EventIDs::kUnpause, 0), DynamicValue(), getSelfReference()));
-		Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, this, false, true, false));
+		Common::SharedPtr<MessageProperties> msgProps(thread->getRuntime()->createMessageProperties(Event(targetValue ? EventIDs::kPause : EventIDs::kUnpause, 0), DynamicValue(), getSelfReference()));
+		Common::SharedPtr<MessageDispatch> dispatch(thread->getRuntime()->createMessageDispatch(msgProps, this, false, true, false));
 		thread->getRuntime()->sendMessageOnVThread(dispatch);
 	}
 
@@ -3715,8 +3724,26 @@ SceneTransitionEffect::SceneTransitionEffect()
 	: _duration(100000), _steps(64), _transitionType(SceneTransitionTypes::kNone), _transitionDirection(SceneTransitionDirections::kUp) {
 }
 
+MessageDispatch::MessageDispatch() : _cascade(false), _relay(false), _terminated(false), _isCommand(false) {
+}
+
 MessageDispatch::MessageDispatch(const Common::SharedPtr<MessageProperties> &msgProps, Structural *root, bool cascade, bool relay, bool couldBeCommand)
-	: _cascade(cascade), _relay(relay), _terminated(false), _msg(msgProps), _isCommand(false) {
+	: _cascade(false), _relay(false), _terminated(false), _isCommand(false) {
+	init(msgProps, root, cascade, relay, couldBeCommand);
+}
+
+MessageDispatch::MessageDispatch(const Common::SharedPtr<MessageProperties> &msgProps, Modifier *root, bool cascade, bool relay, bool couldBeCommand)
+	: _cascade(false), _relay(false), _terminated(false), _isCommand(false) {
+	init(msgProps, root, cascade, relay, couldBeCommand);
+}
+
+void MessageDispatch::init(const Common::SharedPtr<MessageProperties> &msgProps, Structural *root, bool cascade, bool relay, bool couldBeCommand) {
+	_cascade = cascade;
+	_relay = relay;
+	_terminated = false;
+	_msg = msgProps;
+	_isCommand = false;
+
 	if (couldBeCommand && EventIDs::isCommand(msgProps->getEvent().eventType)) {
 		_isCommand = true;
 
@@ -3738,8 +3765,11 @@ MessageDispatch::MessageDispatch(const Common::SharedPtr<MessageProperties> &msg
 	_root = root->getSelfReference();
 }
 
-MessageDispatch::MessageDispatch(const Common::SharedPtr<MessageProperties> &msgProps, Modifier *root, bool cascade, bool relay, bool couldBeCommand)
-	: _cascade(cascade), _relay(relay), _terminated(false), _msg(msgProps), _isCommand(false) {
+void MessageDispatch::init(const Common::SharedPtr<MessageProperties> &msgProps, Modifier *root, bool cascade, bool relay, bool couldBeCommand) {
+	_cascade = cascade;
+	_relay = relay;
+	_terminated = false;
+	_msg = msgProps;
 
 	// Apparently if a command message is sent to a modifier, it's handled as a message.
 	// SPQR depends on this to send "Element Select" messages to pick the palette.
@@ -3755,6 +3785,13 @@ MessageDispatch::MessageDispatch(const Common::SharedPtr<MessageProperties> &msg
 	_root = root->getSelfReference();
 }
 
+void MessageDispatch::recycle() {
+	// Keep the capacity of the propagation stack for the next message
+	_propagationStack.resize(0);
+	_msg.reset();
+	_root.reset();
+}
+
 bool MessageDispatch::isTerminated() const {
 	return _terminated;
 }
@@ -4251,6 +4288,147 @@ const byte *Palette::getPalette() const {
 	return _colors;
 }
 
+// Reference tracker of a pooled message.  It is placement-constructed behind the slot header, and deleting it
+// returns the slot to the pool.
+template<class T>
+class MessagePoolTracker : public Common::BasePtrTrackerInternal {
+public:
+	explicit MessagePoolTracker(T *object) : _object(object) {}
+
+	static void *operator new(size_t size, void *storage) {
+		return storage;
+	}
+
+	static void operator delete(void *storage, void *) {
+	}
+
+	static void operator delete(void *storage) {
+		MessagePool::releaseSlot<T>(static_cast<MessagePool::Slot *>(storage) - 1);
+	}
+
+protected:
+	void destructObject() override {
+		// Drop the references held by the object, but keep it constructed for reuse
+		_object->recycle();
+	}
+
+private:
+	T *_object;
+};
+
+MessagePoolStats::MessagePoolStats() : messages(0), newSlots(0), slots(0) {
+}
+
+MessagePool::MessagePool() : _freeProperties(nullptr), _freeDispatches(nullptr) {
+}
+
+MessagePool::~MessagePool() {
+	destroySlots<MessageProperties>(_propertySlots);
+	destroySlots<MessageDispatch>(_dispatchSlots);
+}
+
+Common::SharedPtr<MessageProperties> MessagePool::createProperties(const Event &evt, const DynamicValue &value, const Common::WeakPtr<RuntimeObject> &source) {
+	Slot *slot = allocateSlot<MessageProperties>(_freeProperties, _propertySlots);
+
+	MessageProperties *props = static_cast<MessageProperties *>(slot->object);
+	props->_evt = evt;
+	props->_value = value;
+	props->_source = source;
+
+	return adoptSlot<MessageProperties>(slot);
+}
+
+Common::SharedPtr<MessageDispatch> MessagePool::createDispatch(const Common::SharedPtr<MessageProperties> &msgProps, Structural *root, bool cascade, bool relay, bool couldBeCommand) {
+	Slot *slot = allocateSlot<MessageDispatch>(_freeDispatches, _dispatchSlots);
+	static_cast<MessageDispatch *>(slot->object)->init(msgProps, root, cascade, relay, couldBeCommand);
+
+	return adoptSlot<MessageDispatch>(slot);
+}
+
+Common::SharedPtr<MessageDispatch> MessagePool::createDispatch(const Common::SharedPtr<MessageProperties> &msgProps, Modifier *root, bool cascade, bool relay, bool couldBeCommand) {
+	Slot *slot = allocateSlot<MessageDispatch>(_freeDispatches, _dispatchSlots);
+	static_cast<MessageDispatch *>(slot->object)->init(msgProps, root, cascade, relay, couldBeCommand);
+
+	return adoptSlot<MessageDispatch>(slot);
+}
+
+void MessagePool::endFrame() {
+	_frameStats.slots = _propertySlots.size() + _dispatchSlots.size();
+	_lastFrameStats = _frameStats;
+	_frameStats = MessagePoolStats();
+}
+
+const MessagePoolStats &MessagePool::getLastFrameStats() const {
+	return _lastFrameStats;
+}
+
+template<class T>
+MessagePool::Slot *MessagePool::allocateSlot(Slot *&freeList, Common::Array<Slot *> &slots) {
+	_frameStats.messages++;
+
+	Slot *slot = freeList;
+	if (slot) {
+		freeList = slot->nextFree;
+	} else {
+		_frameStats.newSlots++;
+
+		// The tracker is placed right behind the header
+		slot = static_cast<Slot *>(malloc(sizeof(Slot) + sizeof(MessagePoolTracker<T>)));
+		if (!slot)
+			error("Out of memory allocating a message");
+
+		slot->pool = this;
+		slot->object = new T();
+		slots.push_back(slot);
+	}
+
+	slot->nextFree = nullptr;
+	slot->inUse = true;
+	return slot;
+}
+
+template<class T>
+Common::SharedPtr<T> MessagePool::adoptSlot(Slot *slot) {
+	T *object = static_cast<T *>(slot->object);
+	return Common::SharedPtr<T>::adopt(object, new (slot + 1) MessagePoolTracker<T>(object));
+}
+
+template<class T>
+void MessagePool::destroySlots(const Common::Array<Slot *> &slots) {
+	for (Slot *slot : slots) {
+		if (slot->inUse) {
+			// Still referenced, so the slot is freed along with its tracker
+			slot->pool = nullptr;
+		} else {
+			delete static_cast<T *>(slot->object);
+			free(slot);
+		}
+	}
+}
+
+template<class T>
+void MessagePool::releaseSlot(Slot *slot) {
+	MessagePool *pool = slot->pool;
+	if (!pool) {
+		delete static_cast<T *>(slot->object);
+		free(slot);
+		return;
+	}
+
+	Slot *&freeList = pool->getFreeList(static_cast<const T *>(nullptr));
+	slot->inUse = false;
+	slot->nextFree = freeList;
+	freeList = slot;
+}
+
+MessagePool::Slot *&MessagePool::getFreeList(const MessageProperties *) {
+	return _freeProperties;
+}
+
+MessagePool::Slot *&MessagePool::getFreeList(const MessageDispatch *) {
+	return _freeDispatches;
+}
+
 Runtime::Runtime(OSystem *system, Audio::Mixer *mixer, ISaveUIProvider *saveProvider, ILoadUIProvider *loadProvider, const Common::SharedPtr<SubtitleRenderer> &subRenderer)
 	: _system(system), _mixer(mixer), _saveProvider(saveProvider), _loadProvider(loadProvider),
 	  _nextRuntimeGUID(1), _realDisplayMode(kColorDepthModeInvalid), _fakeDisplayMode(kColorDepthModeInvalid),
@@ -4318,6 +4496,8 @@ Runtime::~Runtime() {
 }
 
 bool Runtime::runFrame() {
+	PROFILE_SCOPE("Runtime::runFrame");
+
 	uint32 timeMillis = _system->getMillis();
 
 	uint32 realMSec = timeMillis - _realTimeBase - _realTime;
@@ -4448,8 +4628,8 @@ bool Runtime::runFrame() {
 				error("Project has no subsections");
 			}
 
-			Common::SharedPtr<MessageProperties> psProps(new MessageProperties(Event(EventIDs::kProjectStarted, 0), DynamicValue(), _project->getSelfReference()));
-			Common::SharedPtr<MessageDispatch> psDispatch(new MessageDispatch(psProps, _project.get(), false, true, false));
+			Common::SharedPtr<MessageProperties> psProps(createMessageProperties(Event(EventIDs::kProjectStarted, 0), DynamicValue(), _project->getSelfReference()));
+			Common::SharedPtr<MessageDispatch> psDispatch(createMessageDispatch(psProps, _project.get(), false, true, false));
 			queueMessage(psDispatch);
 
 			_pendingSceneTransitions.push_back(HighLevelSceneTransition(firstSubsection->getChildren()[1], HighLevelSceneTransition::kTypeChangeToScene, false, false));
@@ -4600,6 +4780,9 @@ bool Runtime::runFrame() {
 		break;
 	}
 
+	_messagePool.endFrame();
+	PROFILE_COUNTER("Messages", _messagePool.getLastFrameStats().messages);
+
 #ifdef MTROPOLIS_DEBUG_ENABLE
 	if (_debugger)
 		_debugger->runFrame(realMSec);
@@ -5233,8 +5416,8 @@ void Runtime::recursiveFindMouseCollision(Structural *&bestResult, int32 &bestLa
 }
 
 void Runtime::queueEventAsLowLevelSceneStateTransitionAction(const Event &evt, Structural *root, bool cascade, bool relay) {
-	Common::SharedPtr<MessageProperties> props(new MessageProperties(evt, DynamicValue(), Common::WeakPtr<RuntimeObject>()));
-	Common::SharedPtr<MessageDispatch> msg(new MessageDispatch(props, root, cascade, relay, false));
+	Common::SharedPtr<MessageProperties> props(createMessageProperties(evt, DynamicValue(), Common::WeakPtr<RuntimeObject>()));
+	Common::SharedPtr<MessageDispatch> msg(createMessageDispatch(props, root, cascade, relay, false));
 	_pendingLowLevelTransitions.push_back(LowLevelSceneStateTransitionAction(msg));
 }
 
@@ -5267,6 +5450,22 @@ void Runtime::loadScene(const Common::SharedPtr<Structural>& scene) {
 	refreshPlayTime();
 }
 
+Common::SharedPtr<MessageProperties> Runtime::createMessageProperties(const Event &evt, const DynamicValue &value, const Common::WeakPtr<RuntimeObject> &source) {
+	return _messagePool.createProperties(evt, value, source);
+}
+
+Common::SharedPtr<MessageDispatch> Runtime::createMessageDispatch(const Common::SharedPtr<MessageProperties> &msgProps, Structural *root, bool cascade, bool relay, bool couldBeCommand) {
+	return _messagePool.createDispatch(msgProps, root, cascade, relay, couldBeCommand);
+}
+
+Common::SharedPtr<MessageDispatch> Runtime::createMessageDispatch(const Common::SharedPtr<MessageProperties> &msgProps, Modifier *root, bool cascade, bool relay, bool couldBeCommand) {
+	return _messagePool.createDispatch(msgProps, root, cascade, relay, couldBeCommand);
+}
+
+const MessagePoolStats &Runtime::getMessagePoolStats() const {
+	return _messagePool.getLastFrameStats();
+}
+
 void Runtime::sendMessageOnVThread(const Common::SharedPtr<MessageDispatch> &dispatch) {
 	EventIDs::EventID eventID = dispatch->getMsg()->getEvent().eventType;
 
@@ -5680,8 +5879,8 @@ VThreadState Runtime::updateMouseStateTask(const UpdateMouseStateTaskData &data)
 
 	for (size_t ri = 0; ri < messagesToSend.size(); ri++) {
 		const MessageToSend &msg = messagesToSend[messagesToSend.size() - 1 - ri];
-		Common::SharedPtr<MessageProperties> props(new MessageProperties(Event(msg.eventID, 0), mousePtValue, nullptr));
-		Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(props, msg.target, false, true, false));
+		Common::SharedPtr<MessageProperties> props(createMessageProperties(Event(msg.eventID, 0), mousePtValue, nullptr));
+		Common::SharedPtr<MessageDispatch> dispatch(createMessageDispatch(props, msg.target, false, true, false));
 		sendMessageOnVThread(dispatch);
 	}
 
@@ -5791,8 +5990,8 @@ VThreadState Runtime::updateMousePositionTask(const UpdateMousePositionTaskData
 
 	for (size_t ri = 0; ri < messagesToSend.size(); ri++) {
 		const MessageToSend &msg = messagesToSend[messagesToSend.size() - 1 - ri];
-		Common::SharedPtr<MessageProperties> props(new MessageProperties(Event(msg.eventID, 0), mousePtValue, nullptr));
-		Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(props, msg.target, false, true, false));
+		Common::SharedPtr<MessageProperties> props(createMessageProperties(Event(msg.eventID, 0), mousePtValue, nullptr));
+		Common::SharedPtr<MessageDispatch> dispatch(createMessageDispatch(props, msg.target, false, true, false));
 		sendMessageOnVThread(dispatch);
 	}
 
@@ -5823,8 +6022,8 @@ VThreadState Runtime::applyDefaultVisibility(const ApplyDefaultVisibilityTaskDat
 	}
 
 	// Visibility change events are sourced from the element
- 	Common::SharedPtr<MessageProperties> props(new MessageProperties(evt, DynamicValue(), data.element->getSelfReference()));
-	Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(props, data.element, false, false, true));
+ 	Common::SharedPtr<MessageProperties> props(createMessageProperties(evt, DynamicValue(), data.element->getSelfReference()));
+	Common::SharedPtr<MessageDispatch> dispatch(createMessageDispatch(props, data.element, false, false, true));
 
 	sendMessageOnVThread(dispatch);
 
@@ -7915,8 +8114,8 @@ bool Element::canAutoPlay() const {
 
 void Element::queueAutoPlayEvents(Runtime *runtime, bool isAutoPlaying) {
 	if (isAutoPlaying) {
-		Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kPlay, 0), DynamicValue(), getSelfReference()));
-		Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, this, false, false, true));
+		Common::SharedPtr<MessageProperties> msgProps(runtime->createMessageProperties(Event(EventIDs::kPlay, 0), DynamicValue(), getSelfReference()));
+		Common::SharedPtr<MessageDispatch> dispatch(runtime->createMessageDispatch(msgProps, this, false, false, true));
 		runtime->queueMessage(dispatch);
 	}
 }
@@ -8143,8 +8342,8 @@ VThreadState VisualElement::consumeCommand(Runtime *runtime, const Common::Share
 			runtime->setSceneGraphDirty();
 		}
 
-		Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kElementShow, 0), DynamicValue(), getSelfReference()));
-		Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, this, false, true, false));
+		Common::SharedPtr<MessageProperties> msgProps(runtime->createMessageProperties(Event(EventIDs::kElementShow, 0), DynamicValue(), getSelfReference()));
+		Common::SharedPtr<MessageDispatch> dispatch(runtime->createMessageDispatch(msgProps, this, false, true, false));
 		runtime->sendMessageOnVThread(dispatch);
 
 		return kVThreadReturn;
@@ -8160,8 +8359,8 @@ VThreadState VisualElement::consumeCommand(Runtime *runtime, const Common::Share
 			runtime->setSceneGraphDirty();
 		}
 
-		Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(EventIDs::kElementHide, 0), DynamicValue(), getSelfReference()));
-		Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, this, false, true, false));
+		Common::SharedPtr<MessageProperties> msgProps(runtime->createMessageProperties(Event(EventIDs::kElementHide, 0), DynamicValue(), getSelfReference()));
+		Common::SharedPtr<MessageDispatch> dispatch(runtime->createMessageDispatch(msgProps, this, false, true, false));
 		runtime->sendMessageOnVThread(dispatch);
 
 		return kVThreadReturn;
@@ -8828,8 +9027,8 @@ VThreadState VisualElement::changeVisibilityTask(const ChangeFlagTaskData &taskD
 	if (_visible != taskData.desiredFlag) {
 		setVisible(taskData.runtime, taskData.desiredFlag);
 
-		Common::SharedPtr<MessageProperties> msgProps(new MessageProperties(Event(taskData.desiredFlag ? EventIDs::kElementShow : EventIDs::kElementHide, 0), DynamicValue(), getSelfReference()));
-		Common::SharedPtr<MessageDispatch> dispatch(new MessageDispatch(msgProps, this, false, true, false));
+		Common::SharedPtr<MessageProperties> msgProps(taskData.runtime->createMessageProperties(Event(taskData.desiredFlag ? EventIDs::kElementShow : EventIDs::kElementHide, 0), DynamicValue(), getSelfReference()));
+		Common::SharedPtr<MessageDispatch> dispatch(taskData.runtime->createMessageDispatch(msgProps, this, false, true, false));
 		taskData.runtime->sendMessageOnVThread(dispatch);
 	}
 
@@ -1386,6 +1386,16 @@ public:
 	bool isRelay() const;
 
 private:
+	friend class MessagePool;
+	template<class T>
+	friend class MessagePoolTracker;
+
+	MessageDispatch();
+
+	void init(const Common::SharedPtr<MessageProperties> &msgProps, Structural *root, bool cascade, bool relay, bool couldBeCommand);
+	void init(const Common::SharedPtr<MessageProperties> &msgProps, Modifier *root, bool cascade, bool relay, bool couldBeCommand);
+	void recycle();
+
 	struct PropagationStack {
 		union Ptr {
 			Structural *structural;
@@ -1577,6 +1587,70 @@ private:
 	byte _colors[kNumColors * 3];
 };
 
+template<class T>
+class MessagePoolTracker;
+
+struct MessagePoolStats {
+	MessagePoolStats();
+
+	uint32 messages;	// Message properties and dispatches created in the frame
+	uint32 newSlots;	// Messages which needed a new slot, because none was free
+	uint32 slots;		// Slots owned by the pool, live or free
+};
+
+// Recycles the storage of message properties and dispatches.  Each slot keeps its object constructed and
+// holds the reference tracker of the SharedPtr, so creating a message from a free slot does not allocate.
+// A slot goes back to the pool once the last reference to its object is gone.
+//
+// The statistics only cover the slots.  Heap allocations made for the payload of a message (strings and
+// lists in its DynamicValue) or to grow the dispatch stack are not counted.
+class MessagePool {
+public:
+	MessagePool();
+	~MessagePool();
+
+	Common::SharedPtr<MessageProperties> createProperties(const Event &evt, const DynamicValue &value, const Common::WeakPtr<RuntimeObject> &source);
+	Common::SharedPtr<MessageDispatch> createDispatch(const Common::SharedPtr<MessageProperties> &msgProps, Structural *root, bool cascade, bool relay, bool couldBeCommand);
+	Common::SharedPtr<MessageDispatch> createDispatch(const Common::SharedPtr<MessageProperties> &msgProps, Modifier *root, bool cascade, bool relay, bool couldBeCommand);
+
+	void endFrame();
+	const MessagePoolStats &getLastFrameStats() const;
+
+private:
+	template<class T>
+	friend class MessagePoolTracker;
+
+	struct Slot {
+		MessagePool *pool;	// nullptr once the pool is destroyed
+		Slot *nextFree;
+		void *object;
+		bool inUse;
+	};
+
+	template<class T>
+	Slot *allocateSlot(Slot *&freeList, Common::Array<Slot *> &slots);
+
+	template<class T>
+	static Common::SharedPtr<T> adoptSlot(Slot *slot);
+
+	template<class T>
+	static void destroySlots(const Common::Array<Slot *> &slots);
+
+	template<class T>
+	static void releaseSlot(Slot *slot);
+
+	Slot *&getFreeList(const MessageProperties *);
+	Slot *&getFreeList(const MessageDispatch *);
+
+	Slot *_freeProperties;
+	Slot *_freeDispatches;
+	Common::Array<Slot *> _propertySlots;
+	Common::Array<Slot *> _dispatchSlots;
+
+	MessagePoolStats _frameStats;
+	MessagePoolStats _lastFrameStats;
+};
+
 class Runtime {
 public:
 	explicit Runtime(OSystem *system, Audio::Mixer *mixer, ISaveUIProvider *saveProvider, ILoadUIProvider *loadProvider, const Common::SharedPtr<SubtitleRenderer> &subRenderer);
@@ -1635,6 +1709,11 @@ public:
 
 	VThread &getVThread() const;
 
+	Common::SharedPtr<MessageProperties> createMessageProperties(const Event &evt, const DynamicValue &value, const Common::WeakPtr<RuntimeObject> &source);
+	Common::SharedPtr<MessageDispatch> createMessageDispatch(const Common::SharedPtr<MessageProperties> &msgProps, Structural *root, bool cascade, bool relay, bool couldBeCommand);
+	Common::SharedPtr<MessageDispatch> createMessageDispatch(const Common::SharedPtr<MessageProperties> &msgProps, Modifier *root, bool cascade, bool relay, bool couldBeCommand);
+	const MessagePoolStats &getMessagePoolStats() const;
+
 	// Sending a message on the VThread means "immediately"
 	void sendMessageOnVThread(const Common::SharedPtr<MessageDispatch> &dispatch);
 	void queueMessage(const Common::SharedPtr<MessageDispatch> &dispatch);
@@ -1986,6 +2065,8 @@ private:
 
 	Common::HashMap<uint32, Common::String> _getSetAttribIDsToAttribName;
 
+	MessagePool _messagePool;
+
 #ifdef MTROPOLIS_DEBUG_ENABLE
 	Common::SharedPtr<Debugger> _debugger;
 #endif
@@ -2053,6 +2134,14 @@ struct MessageProperties {
 	void setValue(const DynamicValue &value);
 
 private:
+	friend class MessagePool;
+	template<class T>
+	friend class MessagePoolTracker;
+
+	MessageProperties();
+
+	void recycle();
+
 	Event _evt;
 	DynamicValue _value;
 	Common::WeakPtr<RuntimeObject> _source;
@@ -214,10 +214,35 @@ public:
 
 	ADDetectedGame fallbackDetect(const FileMap &allFiles, const Common::FSList &fslist, ADDetectedGameExtraInfo **extra) const override;
 
+	DetectedGame toDetectedGame(const ADDetectedGame &adGame, ADDetectedGameExtraInfo *extraInfo) const override;
+
 private:
 	void addFileToDetectedGame(const Common::String &name, const FileMap &allFiles, MD5Properties md5Prop, ADDetectedGame &game) const;
 };
 
+DetectedGame SciMetaEngineDetection::toDetectedGame(const ADDetectedGame &adGame, ADDetectedGameExtraInfo *extraInfo) const {
+	DetectedGame game = AdvancedMetaEngineDetection::toDetectedGame(adGame, extraInfo);
+
+#ifdef ENABLE_SCI32
+	// Only SCI32 games draw their frames through GfxFrameout, which the
+	// threaded rendering option applies to. In s_sciGameTitles, they are
+	// the games from GK1 on.
+	bool isSci32 = false;
+	for (const PlainGameDescriptor *title = s_sciGameTitles; title->gameId; ++title) {
+		if (!strcmp(title->gameId, "gk1"))
+			isSci32 = true;
+
+		if (game.gameId == title->gameId) {
+			if (isSci32)
+				game.appendGUIOptions(GUIO1(GAMEOPTION_THREADED_RENDERING));
+			break;
+		}
+	}
+#endif
+
+	return game;
+}
+
 ADDetectedGame SciMetaEngineDetection::fallbackDetect(const FileMap &allFiles, const Common::FSList &fslist, ADDetectedGameExtraInfo **extra) const {
 	/**
 	 * Fallback detection for Sci heavily depends on engine resources, so it's not possible
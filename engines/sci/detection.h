@@ -43,6 +43,7 @@ namespace Sci {
 #define GAMEOPTION_PALETTE_MODS             GUIO_GAMEOPTIONS15
 #define GAMEOPTION_SQ1_BEARDED_MUSICIANS    GUIO_GAMEOPTIONS16
 #define GAMEOPTION_TTS                      GUIO_GAMEOPTIONS17
+#define GAMEOPTION_THREADED_RENDERING       GUIO_GAMEOPTIONS18
 
 enum SciGameId {
 	GID_ALL,
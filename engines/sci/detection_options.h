@@ -230,6 +230,20 @@ const ADExtraGuiOptionsMap optionsList[] = {
  	},
 #endif
 
+#ifdef ENABLE_SCI32
+	{
+		GAMEOPTION_THREADED_RENDERING,
+		{
+			_s("Use threaded rendering"),
+			_s("Draw the screen on multiple threads"),
+			"threaded_rendering",
+			false,
+			0,
+			0
+		}
+	},
+#endif
+
 	AD_EXTRA_GUI_OPTIONS_TERMINATOR
 };
 
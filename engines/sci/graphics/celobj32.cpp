@@ -84,13 +84,16 @@ const CelScalerTable &CelScaler::getScalerTable(const Ratio &scaleX, const Ratio
 #pragma mark -
 #pragma mark CelObj
 bool CelObj::_drawBlackLines = false;
+bool CelObj::_useLarryScale = false;
+bool CelObj::_drawingConcurrently = false;
 
 void CelObj::init() {
 	CelObj::deinit();
 	_drawBlackLines = false;
-	_nextCacheId = 1;
+	_drawingConcurrently = false;
+	updateSettings();
 	_scaler = new CelScaler();
-	_cache = new CelCache(100);
+	_cache = new CelCache();
 }
 
 void CelObj::deinit() {
@@ -100,6 +103,25 @@ void CelObj::deinit() {
 	_cache = nullptr;
 }
 
+void CelObj::updateSettings() {
+	_useLarryScale = Common::checkGameGUIOption(GAMEOPTION_LARRYSCALE, ConfMan.get("guioptions")) && ConfMan.getBool("enable_larryscale");
+}
+
+Resource *CelObj::findResource(const ResourceId &id) {
+	ResourceManager *resMan = g_sci->getResMan();
+	if (!_drawingConcurrently) {
+		return resMan->findResource(id, false);
+	}
+
+	// The resource map is only read here; the resource itself was locked on
+	// the main thread by GfxFrameout::drawListsConcurrently
+	Resource *resource = resMan->testResource(id);
+	if (resource && !resource->isLocked()) {
+		return nullptr;
+	}
+	return resource;
+}
+
 #pragma mark -
 #pragma mark CelObj - Scalers
 
@@ -162,8 +184,10 @@ struct SCALER_Scale {
 	// image and takes precedence over _reader.
 	Common::SharedPtr<Buffer> _sourceBuffer;
 	int16 _x;
-	static int16 _valuesX[kCelScalerTableSize];
-	static int16 _valuesY[kCelScalerTableSize];
+	// These are members rather than statics, as cels may be drawn from
+	// several threads at once
+	int16 _valuesX[kCelScalerTableSize];
+	int16 _valuesY[kCelScalerTableSize];
 
 	SCALER_Scale(const CelObj &celObj, const Common::Rect &targetRect, const Common::Point &scaledPosition, const Ratio scaleX, const Ratio scaleY) :
 	_row(nullptr),
@@ -202,10 +226,7 @@ struct SCALER_Scale {
 		// games which use global scaling are the ones that use low-resolution
 		// script coordinates too.
 
-		const CelScalerTable &table = CelObj::_scaler->getScalerTable(scaleX, scaleY);
-
-		const bool useLarryScale = Common::checkGameGUIOption(GAMEOPTION_LARRYSCALE, ConfMan.get("guioptions")) && ConfMan.getBool("enable_larryscale");
-		if (useLarryScale) {
+		if (CelObj::_useLarryScale) {
 			// LarryScale is an alternative, high-quality cel scaler implemented
 			// for ScummVM. Due to the nature of smooth upscaling, it does *not*
 			// respect the global scaling pattern. Instead, it simply scales the
@@ -255,6 +276,11 @@ struct SCALER_Scale {
 				_valuesY[y] = CLIP<int16>(unsafeValue, 0, scaledImageRect.height() - 1);
 			}
 		} else {
+			// The scaler tables are shared, and switching them must not
+			// happen while they are read
+			Common::StackLock lock(CelObj::_scaler->getMutex());
+			const CelScalerTable &table = CelObj::_scaler->getScalerTable(scaleX, scaleY);
+
 			const bool useGlobalScaling = g_sci->_gfxFrameout->getScriptWidth() == kLowResX;
 			if (useGlobalScaling) {
 				const int16 unscaledX = (scaledPosition.x / scaleX).toInt();
@@ -306,11 +332,6 @@ struct SCALER_Scale {
 	}
 };
 
-template<bool FLIP, typename READER>
-int16 SCALER_Scale<FLIP, READER>::_valuesX[kCelScalerTableSize];
-template<bool FLIP, typename READER>
-int16 SCALER_Scale<FLIP, READER>::_valuesY[kCelScalerTableSize];
-
 #pragma mark -
 #pragma mark CelObj - Resource readers
 
@@ -351,6 +372,9 @@ public:
 struct READER_Compressed {
 private:
 	const SciSpan<const byte> _resource;
+	// Not a SharedPtr: its reference count is not thread safe, and the cel
+	// keeps the buffer alive for as long as the reader exists
+	const Buffer *const _decompressedPixels;
 	byte _buffer[kCelScalerTableSize];
 	uint32 _controlOffset;
 	uint32 _dataOffset;
@@ -363,6 +387,7 @@ private:
 public:
 	READER_Compressed(const CelObj &celObj, const int16 maxWidth) :
 	_resource(celObj.getResPointer()),
+	_decompressedPixels(celObj._decompressedPixels.get()),
 	_y(-1),
 	_sourceHeight(celObj._height),
 	_skipColor(celObj._skipColor),
@@ -377,6 +402,10 @@ public:
 
 	inline const byte *getRow(const int16 y) {
 		assert(y >= 0 && y < _sourceHeight);
+		if (_decompressedPixels) {
+			return (const byte *)_decompressedPixels->getBasePtr(0, y);
+		}
+
 		if (y != _y) {
 			// compressed data segment for row
 			const uint32 rowOffset = _resource.getUint32SEAt(_controlOffset + y * sizeof(uint32));
@@ -444,8 +473,9 @@ public:
  * scripts are constant between versions. SSCI handles this with many Mac-only
  * translations throughout the interpreter. We use the PC palette and translate
  * the cel pixels here, similar to the SCI16 code in GfxView::unpackCel. The
- * difference is that in SCI32 we decompress while drawing, while in SCI16 cels
- * are unpacked to a buffer first, making that translation code simpler.
+ * difference is that in SCI32 we decompress while drawing (unless the cel cache
+ * kept the decompressed pixels), while in SCI16 cels are unpacked to a buffer
+ * first, making that translation code simpler.
  */
 inline byte translateMacColor(bool isMacSource, byte color) {
 	if (isMacSource) {
@@ -516,7 +546,11 @@ void CelObj::draw(Buffer &target, const ScreenItem &screenItem, const Common::Re
 	const Common::Point &scaledPosition = screenItem._scaledPosition;
 	const Ratio &scaleX = screenItem._ratioX;
 	const Ratio &scaleY = screenItem._ratioY;
-	_drawBlackLines = screenItem._drawBlackLines;
+	// _drawBlackLines is only written when black lines are drawn, so that
+	// GfxFrameout can draw other cels from several threads at once
+	if (screenItem._drawBlackLines) {
+		_drawBlackLines = true;
+	}
 
 	if (_remap) {
 		// In SSCI, this check was `g_Remap_numActiveRemaps && _remap`, but
@@ -599,7 +633,9 @@ void CelObj::draw(Buffer &target, const ScreenItem &screenItem, const Common::Re
 		}
 	}
 
-	_drawBlackLines = false;
+	if (screenItem._drawBlackLines) {
+		_drawBlackLines = false;
+	}
 }
 
 void CelObj::draw(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect, bool mirrorX) {
@@ -686,45 +722,149 @@ void CelObj::submitPalette() const {
 #pragma mark -
 #pragma mark CelObj - Caching
 
-int CelObj::_nextCacheId = 1;
 CelCache *CelObj::_cache = nullptr;
 
-int CelObj::searchCache(const CelInfo32 &celInfo, int *const nextInsertIndex) const {
-	*nextInsertIndex = -1;
-	int oldestId = _nextCacheId + 1;
-	int oldestIndex = 0;
+uint CelInfo32_Hash::operator()(const CelInfo32 &info) const {
+	// Like CelInfo32::operator==, this ignores the color
+	uint hash = info.type;
+	hash = hash * 31 + info.resourceId;
+	hash = hash * 31 + (uint16)info.loopNo;
+	hash = hash * 31 + (uint16)info.celNo;
+	hash = hash * 31 + info.bitmap.getSegment();
+	hash = hash * 31 + info.bitmap.getOffset();
+	return hash;
+}
 
-	for (int i = 0, len = _cache->size(); i < len; ++i) {
-		CelCacheEntry &entry = (*_cache)[i];
+CelCache::CelCache() :
+	_bytes(0),
+	_budget(kDefaultBudget),
+	_hits(0),
+	_misses(0),
+	_evictions(0),
+	_decompressions(0) {}
 
-		if (entry.celObj == nullptr) {
-			if (*nextInsertIndex == -1) {
-				*nextInsertIndex = i;
-			}
-		} else if (entry.celObj->_info == celInfo) {
-			entry.id = ++_nextCacheId;
-			return i;
-		} else if (oldestId > entry.id) {
-			oldestId = entry.id;
-			oldestIndex = i;
+CelCache::~CelCache() {
+	clear();
+}
+
+const CelObj *CelCache::find(const CelInfo32 &celInfo) {
+	EntryMap::iterator i = _map.find(celInfo);
+	if (i == _map.end()) {
+		++_misses;
+		return nullptr;
+	}
+
+	++_hits;
+
+	// Move the entry to the front of the LRU list
+	Entry entry = *i->_value;
+	_entries.erase(i->_value);
+	_entries.push_front(entry);
+	i->_value = _entries.begin();
+
+	Entry &front = _entries.front();
+	CelObj *const celObj = front.celObj;
+	if (++front.lookups == kHotLookups && celObj->_compressionType != kCelCompressionNone) {
+		const uint32 size = celObj->_width * celObj->_height;
+		if (size <= _budget / 8) {
+			debugC(5, kDebugLevelGraphics, "CelCache: Decompressing %s", celObj->_info.toString().c_str());
+
+			// Cels copied from this one from now on share the pixels
+			celObj->decompressPixels();
+			front.bytes += size;
+			_bytes += size;
+			++_decompressions;
+			evict(0, 0);
 		}
 	}
 
-	if (*nextInsertIndex == -1) {
-		*nextInsertIndex = oldestIndex;
+	return celObj;
+}
+
+void CelCache::insert(const CelObj &celObj) {
+	// A cel which was clamped to another loop or cel in its constructor has a
+	// different key than the one it was looked up with, and may be cached
+	// already
+	if (_map.contains(celObj._info)) {
+		return;
+	}
+
+	Entry entry;
+	entry.celObj = celObj.duplicate();
+	entry.lookups = 0;
+	entry.bytes = sizeof(*entry.celObj) + sizeof(Entry) + sizeof(CelInfo32);
+	if (entry.celObj->_decompressedPixels) {
+		entry.bytes += celObj._width * celObj._height;
+	}
+
+	evict(entry.bytes, 1);
+
+	_entries.push_front(entry);
+	_map[celObj._info] = _entries.begin();
+	_bytes += entry.bytes;
+}
+
+void CelCache::clear() {
+	for (EntryList::iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		delete i->celObj;
+	}
+	_entries.clear();
+	_map.clear();
+	_bytes = 0;
+}
+
+void CelCache::setBudget(uint32 bytes) {
+	_budget = bytes;
+	evict(0, 0);
+}
+
+CelCacheStats CelCache::getStats() const {
+	CelCacheStats stats;
+	stats.hits = _hits;
+	stats.misses = _misses;
+	stats.evictions = _evictions;
+	stats.decompressions = _decompressions;
+	stats.entries = _map.size();
+	stats.maxEntries = kMaxEntries;
+	stats.bytes = _bytes;
+	stats.budget = _budget;
+	return stats;
+}
+
+void CelCache::evict(uint32 bytes, uint entries) {
+	// The most recently used cel is never evicted, as it may have just been
+	// handed out by find()
+	while (_map.size() > 1 && (_bytes + bytes > _budget || _map.size() + entries > kMaxEntries)) {
+		const Entry &entry = _entries.back();
+		debugC(5, kDebugLevelGraphics, "CelCache: Evicting %s", entry.celObj->_info.toString().c_str());
+
+		_bytes -= entry.bytes;
+		++_evictions;
+		_map.erase(entry.celObj->_info);
+		delete entry.celObj;
+		_entries.pop_back();
+	}
+}
+
+void CelObj::decompressPixels() {
+	Common::SharedPtr<Buffer> pixels(new Buffer(), Graphics::SurfaceDeleter());
+	pixels->create(_width, _height, Graphics::PixelFormat::createFormatCLUT8());
+
+	READER_Compressed reader(*this, _width);
+	for (int16 y = 0; y < _height; ++y) {
+		memcpy(pixels->getBasePtr(0, y), reader.getRow(y), _width);
 	}
 
-	return -1;
+	_decompressedPixels = pixels;
 }
 
-void CelObj::putCopyInCache(const int cacheIndex) const {
-	if (cacheIndex == -1) {
-		error("Invalid cache index");
+CelCacheStats CelObj::getCacheStats() {
+	if (!_cache) {
+		CelCacheStats stats = {};
+		return stats;
 	}
 
-	CelCacheEntry &entry = (*_cache)[cacheIndex];
-	entry.celObj.reset(duplicate());
-	entry.id = ++_nextCacheId;
+	return _cache->getStats();
 }
 
 #pragma mark -
@@ -971,16 +1111,13 @@ CelObjView::CelObjView(const GuiResourceId viewId, const int16 loopNo, const int
 	_compressionType = kCelCompressionInvalid;
 	_transparent = true;
 
-	int cacheInsertIndex;
-	const int cacheIndex = searchCache(_info, &cacheInsertIndex);
-	if (cacheIndex != -1) {
-		CelCacheEntry &entry = (*_cache)[cacheIndex];
-		const CelObjView *const cachedCelObj = dynamic_cast<CelObjView *>(entry.celObj.get());
+	const CelObj *const cachedCel = _cache->find(_info);
+	if (cachedCel != nullptr) {
+		const CelObjView *const cachedCelObj = dynamic_cast<const CelObjView *>(cachedCel);
 		if (cachedCelObj == nullptr) {
-			error("Expected a CelObjView in cache slot %d", cacheIndex);
+			error("Expected a CelObjView in the cache for %s", _info.toString().c_str());
 		}
 		*this = *cachedCelObj;
-		entry.id = ++_nextCacheId;
 		return;
 	}
 
@@ -1078,7 +1215,7 @@ CelObjView::CelObjView(const GuiResourceId viewId, const int16 loopNo, const int
 		_remap = analyzeForRemap();
 	}
 
-	putCopyInCache(cacheInsertIndex);
+	_cache->insert(*this);
 }
 
 bool CelObjView::analyzeUncompressedForRemap() const {
@@ -1126,7 +1263,7 @@ CelObjView *CelObjView::duplicate() const {
 }
 
 const SciSpan<const byte> CelObjView::getResPointer() const {
-	Resource *const resource = g_sci->getResMan()->findResource(ResourceId(kResourceTypeView, _info.resourceId), false);
+	Resource *const resource = findResource(ResourceId(kResourceTypeView, _info.resourceId));
 	if (resource == nullptr) {
 		error("Failed to load view %d from resource manager", _info.resourceId);
 	}
@@ -1179,16 +1316,13 @@ CelObjPic::CelObjPic(const GuiResourceId picId, const int16 celNo) {
 	_transparent = true;
 	_remap = false;
 
-	int cacheInsertIndex;
-	const int cacheIndex = searchCache(_info, &cacheInsertIndex);
-	if (cacheIndex != -1) {
-		CelCacheEntry &entry = (*_cache)[cacheIndex];
-		const CelObjPic *const cachedCelObj = dynamic_cast<CelObjPic *>(entry.celObj.get());
+	const CelObj *const cachedCel = _cache->find(_info);
+	if (cachedCel != nullptr) {
+		const CelObjPic *const cachedCelObj = dynamic_cast<const CelObjPic *>(cachedCel);
 		if (cachedCelObj == nullptr) {
-			error("Expected a CelObjPic in cache slot %d", cacheIndex);
+			error("Expected a CelObjPic in the cache for %s", _info.toString().c_str());
 		}
 		*this = *cachedCelObj;
-		entry.id = ++_nextCacheId;
 		return;
 	}
 
@@ -1252,7 +1386,7 @@ CelObjPic::CelObjPic(const GuiResourceId picId, const int16 celNo) {
 		}
 	}
 
-	putCopyInCache(cacheInsertIndex);
+	_cache->insert(*this);
 }
 
 bool CelObjPic::analyzeUncompressedForSkip() const {
@@ -1286,7 +1420,7 @@ CelObjPic *CelObjPic::duplicate() const {
 }
 
 const SciSpan<const byte> CelObjPic::getResPointer() const {
-	const Resource *const resource = g_sci->getResMan()->findResource(ResourceId(kResourceTypePic, _info.resourceId), false);
+	const Resource *const resource = findResource(ResourceId(kResourceTypePic, _info.resourceId));
 	if (resource == nullptr) {
 		error("Failed to load pic %d from resource manager", _info.resourceId);
 	}
@@ -22,6 +22,10 @@
 #ifndef SCI_GRAPHICS_CELOBJ32_H
 #define SCI_GRAPHICS_CELOBJ32_H
 
+#include "common/hashmap.h"
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/ptr.h"
 #include "common/rational.h"
 #include "common/rect.h"
 #include "sci/resource/resource.h"
@@ -103,9 +107,9 @@ struct CelInfo32 {
 		bitmap(NULL_REG),
 		color(0) {}
 
-	// This is the equivalence criteria used by CelObj::searchCache in at least
+	// This is the equivalence criteria used by the cel cache in at least
 	// SSCI SQ6. Notably, it does not check the color field.
-	inline bool operator==(const CelInfo32 &other) {
+	inline bool operator==(const CelInfo32 &other) const {
 		return (
 			type == other.type &&
 			resourceId == other.resourceId &&
@@ -115,7 +119,7 @@ struct CelInfo32 {
 		);
 	}
 
-	inline bool operator!=(const CelInfo32 &other) {
+	inline bool operator!=(const CelInfo32 &other) const {
 		return !(*this == other);
 	}
 
@@ -138,18 +142,114 @@ struct CelInfo32 {
 	}
 };
 
+struct CelInfo32_Hash {
+	uint operator()(const CelInfo32 &info) const;
+};
+
+/**
+ * Statistics of the cel cache, as returned by CelCache::getStats().
+ */
+struct CelCacheStats {
+	uint32 hits;			///< Lookups which found the cel
+	uint32 misses;			///< Lookups which did not find the cel
+	uint32 evictions;		///< Cels dropped to stay within the budget
+	uint32 decompressions;	///< Cels whose decompressed pixels were kept
+	uint32 entries;			///< Cels in the cache
+	uint32 maxEntries;		///< Maximum number of cels in the cache
+	uint32 bytes;			///< Size of the cels in the cache
+	uint32 budget;			///< Maximum size of the cels in the cache
+};
+
 class CelObj;
-struct CelCacheEntry {
+
+/**
+ * A cache of cel objects used to avoid reinitialisation overhead for cels with
+ * the same CelInfo32. SSCI used a fixed array of 100 entries which was
+ * searched linearly; here cels are found through a hash map and evicted in
+ * least recently used order once the byte budget or the maximum number of
+ * cels is exceeded. Cels which are not decompressed take up little more than
+ * their CelObj, so the number of cels needs a limit of its own.
+ *
+ * Compressed cels which are looked up often also keep their decompressed
+ * pixels, which are shared with all copies of the cel object handed out
+ * afterwards. Drawing such a copy only needs to scale and map the pixels.
+ */
+class CelCache {
+public:
+	enum {
+		kDefaultBudget = 16 * 1024 * 1024,
+
+		/**
+		 * The maximum number of cels in the cache, ten times the size of
+		 * the SSCI cache.
+		 */
+		kMaxEntries = 1000,
+
+		/**
+		 * The number of lookups of a compressed cel after which its pixels
+		 * are decompressed and kept in the cache.
+		 */
+		kHotLookups = 3
+	};
+
+	CelCache();
+	~CelCache();
+
 	/**
-	 * A monotonically increasing cache ID used to identify the least recently
-	 * used item in the cache for replacement.
+	 * Searches the cache for a cel matching the given CelInfo32, and makes it
+	 * the most recently used one.
+	 *
+	 * @return The cached cel, or nullptr if it is not in the cache.
 	 */
-	int id;
-	Common::ScopedPtr<CelObj> celObj;
-	CelCacheEntry() : id(0) {}
-};
+	const CelObj *find(const CelInfo32 &celInfo);
+
+	/**
+	 * Puts a copy of the given cel into the cache.
+	 */
+	void insert(const CelObj &celObj);
+
+	/**
+	 * Drops all cels. Copies of them keep working.
+	 */
+	void clear();
+
+	/**
+	 * Sets the maximum size of the cels in the cache, and evicts cels to
+	 * stay within it.
+	 */
+	void setBudget(uint32 bytes);
+
+	CelCacheStats getStats() const;
+
+private:
+	struct Entry {
+		CelObj *celObj;
+		uint32 lookups;
+		uint32 bytes;
+	};
 
-typedef Common::Array<CelCacheEntry> CelCache;
+	typedef Common::List<Entry> EntryList;
+	typedef Common::HashMap<CelInfo32, EntryList::iterator, CelInfo32_Hash> EntryMap;
+
+	/**
+	 * Evicts the least recently used cels until the given number of bytes
+	 * and cels fit into the cache.
+	 */
+	void evict(uint32 bytes, uint entries);
+
+	/**
+	 * Cached cels, most recently used first.
+	 */
+	EntryList _entries;
+	EntryMap _map;
+	uint32 _bytes;
+	uint32 _budget;
+
+	uint32 _hits;
+	uint32 _misses;
+	uint32 _evictions;
+	uint32 _decompressions;
+};
 
 #pragma mark -
 #pragma mark CelScaler
@@ -212,6 +312,11 @@ class CelScaler {
 	 */
 	void buildLookupTable(int *table, const Ratio &ratio, const int size);
 
+	/**
+	 * Guards the scale tables, for cels drawn from several threads at once.
+	 */
+	Common::Mutex _mutex;
+
 public:
 	CelScaler() :
 		_scaleTables(),
@@ -232,6 +337,12 @@ public:
 	 * Retrieves scaler tables for the given X and Y ratios.
 	 */
 	const CelScalerTable &getScalerTable(const Ratio &scaleX, const Ratio &scaleY);
+
+	/**
+	 * Returns the mutex which must be held while retrieving and reading
+	 * scaler tables.
+	 */
+	Common::Mutex &getMutex() { return _mutex; }
 };
 
 #pragma mark -
@@ -265,6 +376,21 @@ protected:
 public:
 	static CelScaler *_scaler;
 
+	/**
+	 * Whether cels are scaled with LarryScale. Refreshed from the game
+	 * options by `updateSettings` on the main thread, since the scalers may
+	 * run on worker threads.
+	 */
+	static bool _useLarryScale;
+
+	/**
+	 * When true, cels are being drawn on worker threads and the resources of
+	 * every drawn cel have been locked beforehand. Resources are then looked
+	 * up without going through `ResourceManager::findResource`, which loads
+	 * and purges resources.
+	 */
+	static bool _drawingConcurrently;
+
 	/**
 	 * The basic identifying information for this cel. This information
 	 * effectively acts as a composite key for a cel object, and any cel object
@@ -341,6 +467,12 @@ public:
 	 */
 	bool _isMacSource;
 
+	/**
+	 * The pixels of a compressed cel, once the cel cache decided to keep them
+	 * decompressed. The buffer is shared by all copies of the cel object.
+	 */
+	Common::SharedPtr<Buffer> _decompressedPixels;
+
 	/**
 	 * Initialises static CelObj members.
 	 */
@@ -351,6 +483,11 @@ public:
 	 */
 	static void deinit();
 
+	/**
+	 * Re-reads the game options which affect how cels are drawn.
+	 */
+	static void updateSettings();
+
 	virtual ~CelObj() {};
 
 	/**
@@ -389,6 +526,13 @@ public:
 	 */
 	void drawTo(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition, const Ratio &scaleX, const Ratio &scaleY) const;
 
+	/**
+	 * Sets the mirroring used by the next call to draw without a mirror flag.
+	 * GfxFrameout uses this to prepare cels before drawing them from several
+	 * threads.
+	 */
+	void setDrawMirrored(const bool mirrorX) { _drawMirrored = mirrorX; }
+
 	/**
 	 * Creates a copy of this cel on the free store and returns a pointer to the
 	 * new object. The new cel will point to a shared copy of bitmap/resource
@@ -402,6 +546,16 @@ public:
 	 */
 	virtual const SciSpan<const byte> getResPointer() const = 0;
 
+protected:
+	/**
+	 * Finds the resource holding the data for this cel. While
+	 * `_drawingConcurrently` is set, only already locked resources are
+	 * returned.
+	 */
+	static Resource *findResource(const ResourceId &id);
+
+public:
+
 	/**
 	 * Reads the pixel at the given coordinates. This method is valid only for
 	 * CelObjView and CelObjPic.
@@ -452,31 +606,24 @@ private:
 
 #pragma mark -
 #pragma mark CelObj - Caching
-protected:
-	/**
-	 * A monotonically increasing cache ID used to identify the least recently
-	 * used item in the cache for replacement.
-	 */
-	static int _nextCacheId;
-
+public:
 	/**
-	 * A cache of cel objects used to avoid reinitialisation overhead for cels
-	 * with the same CelInfo32.
+	 * Decompresses all pixels of this cel into `_decompressedPixels`. Used by
+	 * the cel cache for compressed cels which are drawn often.
 	 */
-	static CelCache *_cache;
+	void decompressPixels();
 
 	/**
-	 * Searches the cel cache for a CelObj matching the provided CelInfo32. If
-	 * not found, -1 is returned. `nextInsertIndex` will receive the index of
-	 * the oldest item in the cache, which can be used to replace the oldest
-	 * item with a newer item.
+	 * Returns the statistics of the cel cache.
 	 */
-	int searchCache(const CelInfo32 &celInfo, int *nextInsertIndex) const;
+	static CelCacheStats getCacheStats();
 
+protected:
 	/**
-	 * Puts a copy of this CelObj into the cache at the given cache index.
+	 * A cache of cel objects used to avoid reinitialisation overhead for cels
+	 * with the same CelInfo32.
 	 */
-	void putCopyInCache(int index) const;
+	static CelCache *_cache;
 };
 
 #pragma mark -
@@ -24,9 +24,11 @@
 #include "common/events.h"
 #include "common/keyboard.h"
 #include "common/list.h"
+#include "common/profiler.h"
 #include "common/str.h"
 #include "common/system.h"
 #include "common/textconsole.h"
+#include "common/jobsystem.h"
 #include "engines/engine.h"
 #include "engines/util.h"
 #include "graphics/palette.h"
@@ -72,6 +74,10 @@ GfxFrameout::GfxFrameout(SegManager *segMan, GfxPalette32 *palette, GfxTransitio
 	_palMorphIsOn(false),
 	_lastScreenUpdateTick(0) {
 
+	// Drawing on worker threads gives the same output as drawing serially,
+	// but is only worth it for hi-res games with many screen items
+	_threadedRendering = ConfMan.getBool("threaded_rendering");
+
 	if (g_sci->getGameId() == GID_PHANTASMAGORIA) {
 		_currentBuffer.create(630, 450, Graphics::PixelFormat::createFormatCLUT8());
 	} else if (_isHiRes) {
@@ -470,6 +476,8 @@ void GfxFrameout::kernelAddPicAt(const reg_t planeObject, const GuiResourceId pi
 #pragma mark Rendering
 
 void GfxFrameout::frameOut(const bool shouldShowBits, const Common::Rect &eraseRect) {
+	PROFILE_SCOPE("GfxFrameout::frameOut");
+
 	updateMousePositionForRendering();
 
 	RobotDecoder &robotPlayer = g_sci->_video32->getRobotPlayer();
@@ -505,10 +513,7 @@ void GfxFrameout::frameOut(const bool shouldShowBits, const Common::Rect &eraseR
 
 	_remapOccurred = _palette->updateForFrame();
 
-	for (PlaneList::size_type i = 0; i < _planes.size(); ++i) {
-		drawEraseList(eraseLists[i], *_planes[i]);
-		drawScreenItemList(screenItemLists[i]);
-	}
+	drawLists(eraseLists, screenItemLists);
 
 	if (robotIsActive) {
 		robotPlayer.frameAlmostVisible();
@@ -562,10 +567,7 @@ void GfxFrameout::palMorphFrameOut(const int8 *styleRanges, PlaneShowStyle *show
 
 	_remapOccurred = _palette->updateForFrame();
 
-	for (PlaneList::size_type i = 0; i < _planes.size(); ++i) {
-		drawEraseList(eraseLists[i], *_planes[i]);
-		drawScreenItemList(screenItemLists[i]);
-	}
+	drawLists(eraseLists, screenItemLists);
 
 	Palette nextPalette(_palette->getNextPalette());
 
@@ -617,10 +619,7 @@ void GfxFrameout::palMorphFrameOut(const int8 *styleRanges, PlaneShowStyle *show
 
 	_remapOccurred = _palette->updateForFrame();
 
-	for (PlaneList::size_type i = 0; i < _planes.size(); ++i) {
-		drawEraseList(eraseLists[i], *_planes[i]);
-		drawScreenItemList(screenItemLists[i]);
-	}
+	drawLists(eraseLists, screenItemLists);
 
 	_palette->submit(nextPalette);
 	_palette->updateFFrame();
@@ -1009,6 +1008,166 @@ void GfxFrameout::drawScreenItemList(const DrawList &screenItemList) {
 	}
 }
 
+void GfxFrameout::drawLists(const EraseListList &eraseLists, const ScreenItemListList &screenItemLists) {
+	// Game options are read here on the main thread rather than by the
+	// scalers, which may be running on worker threads
+	CelObj::updateSettings();
+
+	if (_threadedRendering && drawListsConcurrently(eraseLists, screenItemLists)) {
+		return;
+	}
+
+	for (PlaneList::size_type i = 0; i < _planes.size(); ++i) {
+		drawEraseList(eraseLists[i], *_planes[i]);
+		drawScreenItemList(screenItemLists[i]);
+	}
+}
+
+struct GfxFrameout::DrawBandJob {
+	Buffer *target;
+	const PlaneList *planes;
+	const EraseListList *eraseLists;
+	const ScreenItemListList *screenItemLists;
+	int16 bandHeight;
+};
+
+enum {
+	/**
+	 * The number of pixels which must be drawn in a frame before it is worth
+	 * drawing them on worker threads.
+	 */
+	kMinConcurrentDrawArea = 64 * 1024,
+
+	/**
+	 * The minimum height of a band drawn by a worker thread.
+	 */
+	kMinDrawBandHeight = 16
+};
+
+bool GfxFrameout::drawListsConcurrently(const EraseListList &eraseLists, const ScreenItemListList &screenItemLists) {
+	Common::JobSystem &jobSystem = Common::JobSystem::instance();
+	const uint threadCount = jobSystem.getWorkerCount();
+	if (threadCount < 2) {
+		return false;
+	}
+
+	uint32 area = 0;
+	for (PlaneList::size_type i = 0; i < _planes.size(); ++i) {
+		if (_planes[i]->_type == kPlaneTypeColored) {
+			const RectList &eraseList = eraseLists[i];
+			for (RectList::size_type j = 0; j < eraseList.size(); ++j) {
+				area += eraseList[j]->width() * eraseList[j]->height();
+			}
+		}
+
+		const DrawList &drawList = screenItemLists[i];
+		for (DrawList::size_type j = 0; j < drawList.size(); ++j) {
+			// Black lines are drawn on every other row of the drawn rect, which
+			// does not survive splitting the rect into bands
+			if (drawList[j]->screenItem->_drawBlackLines) {
+				return false;
+			}
+			area += drawList[j]->rect.width() * drawList[j]->rect.height();
+		}
+	}
+
+	if (area < kMinConcurrentDrawArea) {
+		return false;
+	}
+
+	// Everything which touches shared state is done up front: merging the show
+	// list, setting the mirroring of cels, and locking their resources so that
+	// looking them up while drawing neither loads nor purges anything. Game
+	// options were already read by drawLists
+	ResourceManager *resMan = g_sci->getResMan();
+	Common::Array<Resource *> lockedResources;
+	for (PlaneList::size_type i = 0; i < _planes.size(); ++i) {
+		if (_planes[i]->_type == kPlaneTypeColored) {
+			const RectList &eraseList = eraseLists[i];
+			for (RectList::size_type j = 0; j < eraseList.size(); ++j) {
+				mergeToShowList(*eraseList[j], _showList, _overdrawThreshold);
+			}
+		}
+
+		const DrawList &drawList = screenItemLists[i];
+		for (DrawList::size_type j = 0; j < drawList.size(); ++j) {
+			const DrawItem &drawItem = *drawList[j];
+			mergeToShowList(drawItem.rect, _showList, _overdrawThreshold);
+
+			const ScreenItem &screenItem = *drawItem.screenItem;
+			CelObj &celObj = *screenItem._celObj;
+			celObj.setDrawMirrored(screenItem._mirrorX ^ celObj._mirrorX);
+
+			const CelType type = celObj._info.type;
+			if (type == kCelTypeView || type == kCelTypePic) {
+				const ResourceType resourceType = type == kCelTypeView ? kResourceTypeView : kResourceTypePic;
+				Resource *resource = resMan->findResource(ResourceId(resourceType, celObj._info.resourceId), true);
+				if (resource) {
+					lockedResources.push_back(resource);
+				}
+			}
+		}
+	}
+
+	const uint bandCount = MIN<uint>(threadCount * 2, MAX<uint>(_currentBuffer.h / kMinDrawBandHeight, 1));
+
+	DrawBandJob job;
+	job.target = &_currentBuffer;
+	job.planes = &_planes;
+	job.eraseLists = &eraseLists;
+	job.screenItemLists = &screenItemLists;
+	job.bandHeight = (_currentBuffer.h + bandCount - 1) / bandCount;
+	CelObj::_drawingConcurrently = true;
+	jobSystem.parallelFor(0, bandCount, 1, &drawBandProc, &job);
+	CelObj::_drawingConcurrently = false;
+
+	for (uint i = 0; i < lockedResources.size(); ++i) {
+		resMan->unlockResource(lockedResources[i]);
+	}
+
+	return true;
+}
+
+void GfxFrameout::drawBandProc(void *param, uint begin, uint end, uint worker) {
+	const DrawBandJob &job = *(const DrawBandJob *)param;
+	Buffer &target = *job.target;
+	const Common::Rect band(0, begin * job.bandHeight, target.w, MIN<int>(end * job.bandHeight, target.h));
+
+	for (PlaneList::size_type i = 0; i < job.planes->size(); ++i) {
+		const Plane &plane = *(*job.planes)[i];
+		if (plane._type == kPlaneTypeColored) {
+			const RectList &eraseList = (*job.eraseLists)[i];
+			for (RectList::size_type j = 0; j < eraseList.size(); ++j) {
+				Common::Rect rect(*eraseList[j]);
+				rect.clip(band);
+				if (!rect.isEmpty()) {
+					target.fillRect(rect, plane._back);
+				}
+			}
+		}
+
+		const DrawList &drawList = (*job.screenItemLists)[i];
+		for (DrawList::size_type j = 0; j < drawList.size(); ++j) {
+			const DrawItem &drawItem = *drawList[j];
+			Common::Rect rect(drawItem.rect);
+			rect.clip(band);
+			if (rect.isEmpty()) {
+				continue;
+			}
+
+			// Same as CelObj::draw with a mirror flag, minus setting the
+			// mirroring, which drawListsConcurrently did already
+			const ScreenItem &screenItem = *drawItem.screenItem;
+			const CelObj &celObj = *screenItem._celObj;
+			if (celObj._info.type == kCelTypeColor) {
+				static_cast<const CelObjColor &>(celObj).draw(target, rect);
+			} else {
+				celObj.draw(target, screenItem, rect);
+			}
+		}
+	}
+}
+
 void GfxFrameout::mergeToShowList(const Common::Rect &drawRect, RectList &showList, const int overdrawThreshold) {
 	RectList mergeList;
 	Common::Rect merged;
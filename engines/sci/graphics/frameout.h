@@ -368,6 +368,36 @@ private:
 	 */
 	void drawScreenItemList(const DrawList &screenItemList);
 
+	/**
+	 * Draws the erase and draw lists of all planes to the visible screen
+	 * buffer, using `drawEraseList` and `drawScreenItemList` or, when
+	 * threaded rendering is enabled, `drawListsConcurrently`.
+	 */
+	void drawLists(const EraseListList &eraseLists, const ScreenItemListList &screenItemLists);
+
+	/**
+	 * Draws the erase and draw lists of all planes in horizontal bands of the
+	 * screen, each of which is drawn on a worker thread. Every band replays
+	 * all lists in order, clipped to the band, so the result is the same as
+	 * drawing them serially.
+	 *
+	 * @returns false, without drawing anything, if the lists should be drawn
+	 * serially instead.
+	 */
+	bool drawListsConcurrently(const EraseListList &eraseLists, const ScreenItemListList &screenItemLists);
+
+	struct DrawBandJob;
+
+	/**
+	 * Draws one band of the screen for `drawListsConcurrently`.
+	 */
+	static void drawBandProc(void *param, uint begin, uint end, uint worker);
+
+	/**
+	 * When true, the draw lists are drawn on worker threads.
+	 */
+	bool _threadedRendering;
+
 	/**
 	 * Adds a new rectangle to the list of regions to write out to the hardware.
 	 * The provided rect may be merged into an existing rectangle to reduce the
@@ -19,7 +19,10 @@
  *
  */
 
+#include "common/config-manager.h"
 #include "common/file.h"
+#include "common/system.h"
+#include "common/thread.h"
 #include "image/png.h"
 #include "graphics/surface.h"
 #include "graphics/managed_surface.h"
@@ -28,10 +31,12 @@
 
 namespace Tetraedge {
 
-TeImagesSequence::TeImagesSequence() : _width(0), _height(0), _curFrame(0), _frameRate(0) {
+TeImagesSequence::TeImagesSequence() : _width(0), _height(0), _curFrame(0), _frameRate(0),
+_nextDecode(0), _quit(false), _decodeThread(nullptr), _decodeSemaphore(nullptr) {
 }
 
 TeImagesSequence::~TeImagesSequence() {
+	stopDecodeAhead();
 	for (auto surf : _cachedSurfaces) {
 		if (surf)
 			delete surf;
@@ -114,50 +119,195 @@ bool TeImagesSequence::load(const Common::FSNode &directory) {
 		delete stream;
 	}
 
+	// Small frames are all cached above, large ones are decoded ahead
+	if (_width >= 100 || _height >= 100) {
+		int frames = kDefaultDecodeAhead;
+		if (ConfMan.hasKey("image_sequence_decode_ahead"))
+			frames = ConfMan.getInt("image_sequence_decode_ahead");
+		if (frames > 0 && _files.size() > 1)
+			startDecodeAhead(MIN<uint>(frames, _files.size() - 1));
+	}
+
 	return true;
 }
 
+void TeImagesSequence::startDecodeAhead(uint frames) {
+	_decodeSemaphore = g_system->createSemaphore();
+	if (!_decodeSemaphore)
+		return;
 
-bool TeImagesSequence::update(uint i, TeImage &imgout) {
-	_curFrame = i;
+	_ring.resize(frames);
+	_decodeThread = g_system->createThread(&decodeAheadProc, this);
+	if (!_decodeThread) {
+		// No threads, decode each frame when it is shown
+		_ring.clear();
+		delete _decodeSemaphore;
+		_decodeSemaphore = nullptr;
+		return;
+	}
 
-	if (i >= _files.size())
-		return false;
+	// Start with the first frames
+	_decodeSemaphore->post();
+}
 
-	if (_cachedSurfaces[i] == nullptr) {
-		Common::SeekableReadStream *stream = _files[i].createReadStream();
-		if (!stream)
-			error("Open %s failed.. it was ok before?", _files[i].getName().c_str());
+void TeImagesSequence::stopDecodeAhead() {
+	if (_decodeThread) {
+		{
+			Common::StackLock lock(_mutex);
+			_quit = true;
+		}
+		_decodeSemaphore->post();
+		delete _decodeThread;
+		_decodeThread = nullptr;
+	}
+	delete _decodeSemaphore;
+	_decodeSemaphore = nullptr;
 
-		Image::PNGDecoder png;
-		if (!png.loadStream(*stream)) {
-			warning("Image sequence failed to load png %s", _files[i].getName().c_str());
-			delete stream;
+	for (auto &decoded : _ring)
+		delete decoded._surface;
+	_ring.clear();
+}
+
+bool TeImagesSequence::isAhead(uint frame, uint current) const {
+	// Sequences loop, so the frames after the last one are the first ones
+	const uint n = _files.size();
+	return (frame + n - current - 1) % n < _ring.size();
+}
+
+bool TeImagesSequence::decodeNextFrame() {
+	DecodedFrame *decoded = nullptr;
+	uint frame;
+	{
+		Common::StackLock lock(_mutex);
+		if (_quit)
 			return false;
-		}
 
-		const Graphics::Surface *surf = png.getSurface();
-		assert(surf);
+		// Do not decode further ahead than the ring holds
+		if (!isAhead(_nextDecode, _curFrame))
+			return false;
 
-		imgout.setAccessName(_files[i].getPath());
+		for (auto &d : _ring) {
+			if (d._state == DecodedFrame::kReady && d._frame == _nextDecode) {
+				// Already decoded before a seek
+				_nextDecode = (_nextDecode + 1) % _files.size();
+				return true;
+			}
+			if (d._state == DecodedFrame::kFree)
+				decoded = &d;
+		}
+		if (!decoded)
+			return false;
+
+		frame = _nextDecode;
+		decoded->_state = DecodedFrame::kDecoding;
+		decoded->_frame = frame;
+		_nextDecode = (_nextDecode + 1) % _files.size();
+	}
 
-		if (imgout.w == surf->w && imgout.h == surf->h && imgout.format == surf->format) {
-			imgout.copyFrom(*surf);
-			delete stream;
-			return true;
+	// Decode without the lock, so that update() can go on with other frames
+	bool success = false;
+	Common::SeekableReadStream *stream = _files[frame].createReadStream();
+	if (stream) {
+		Image::PNGDecoder png;
+		if (png.loadStream(*stream)) {
+			if (!decoded->_surface)
+				decoded->_surface = new Graphics::ManagedSurface();
+			decoded->_surface->copyFrom(*png.getSurface());
+			success = true;
 		}
-	} else {
-		const Graphics::ManagedSurface *surf = _cachedSurfaces[i];
-		if (imgout.w == surf->w && imgout.h == surf->h && imgout.format == surf->format) {
-			imgout.setAccessName(_files[i].getPath());
-			imgout.copyFrom(*surf);
-			return true;
+		delete stream;
+	}
+
+	Common::StackLock lock(_mutex);
+	// On failure, update() decodes the frame itself and reports the error
+	decoded->_state = success ? DecodedFrame::kReady : DecodedFrame::kFree;
+	return true;
+}
+
+/*static*/
+void TeImagesSequence::decodeAheadProc(void *param) {
+	TeImagesSequence *sequence = (TeImagesSequence *)param;
+
+	for (;;) {
+		sequence->_decodeSemaphore->wait();
+		{
+			Common::StackLock lock(sequence->_mutex);
+			if (sequence->_quit)
+				return;
 		}
+		while (sequence->decodeNextFrame())
+			;
+	}
+}
+
+bool TeImagesSequence::copyToImage(uint i, const Graphics::Surface &surf, TeImage &imgout) {
+	if (imgout.w == surf.w && imgout.h == surf.h && imgout.format == surf.format) {
+		imgout.setAccessName(_files[i].getPath());
+		imgout.copyFrom(surf);
+		return true;
 	}
 
 	error("TODO: Implement TeImagesSequence::update for different sizes");
 }
 
+
+bool TeImagesSequence::update(uint i, TeImage &imgout) {
+	{
+		Common::StackLock lock(_mutex);
+		_curFrame = i;
+	}
+
+	if (i >= _files.size())
+		return false;
+
+	if (_cachedSurfaces[i] != nullptr)
+		return copyToImage(i, _cachedSurfaces[i]->rawSurface(), imgout);
+
+	if (_decodeThread) {
+		bool found = false;
+		bool result = false;
+		{
+			Common::StackLock lock(_mutex);
+			for (auto &decoded : _ring) {
+				if (decoded._state != DecodedFrame::kReady)
+					continue;
+				if (decoded._frame == i) {
+					result = copyToImage(i, decoded._surface->rawSurface(), imgout);
+					found = true;
+					decoded._state = DecodedFrame::kFree;
+				} else if (!isAhead(decoded._frame, i)) {
+					// Skipped or seeked over
+					decoded._state = DecodedFrame::kFree;
+				}
+			}
+
+			// After a seek, continue decoding from the new position
+			if (!isAhead(_nextDecode, i))
+				_nextDecode = (i + 1) % _files.size();
+		}
+		_decodeSemaphore->post();
+
+		if (found)
+			return result;
+	}
+
+	Common::SeekableReadStream *stream = _files[i].createReadStream();
+	if (!stream)
+		error("Open %s failed.. it was ok before?", _files[i].getName().c_str());
+
+	Image::PNGDecoder png;
+	if (!png.loadStream(*stream)) {
+		warning("Image sequence failed to load png %s", _files[i].getName().c_str());
+		delete stream;
+		return false;
+	}
+	delete stream;
+
+	const Graphics::Surface *surf = png.getSurface();
+	assert(surf);
+	return copyToImage(i, *surf, imgout);
+}
+
 bool TeImagesSequence::isAtEnd() {
 	return _curFrame >= _files.size();
 }
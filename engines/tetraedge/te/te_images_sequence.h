@@ -22,9 +22,15 @@
 #ifndef TETRAEDGE_TE_TE_IMAGES_SEQUENCE_H
 #define TETRAEDGE_TE_TE_IMAGES_SEQUENCE_H
 
+#include "common/mutex.h"
 #include "common/str.h"
 #include "tetraedge/te/te_i_codec.h"
 
+namespace Common {
+class SemaphoreInternal;
+class ThreadInternal;
+}
+
 namespace Graphics {
 struct Surface;
 class ManagedSurface;
@@ -60,12 +66,47 @@ public:
 	static bool matchExtension(const Common::String &extn);
 
 private:
+	enum {
+		kDefaultDecodeAhead = 4
+	};
+
+	/** A frame decoded ahead of time by the decoder thread. */
+	struct DecodedFrame {
+		enum State {
+			kFree,
+			kDecoding,
+			kReady
+		};
+
+		State _state;
+		uint _frame;
+		Graphics::ManagedSurface *_surface;
+
+		DecodedFrame() : _state(kFree), _frame(0), _surface(nullptr) {}
+	};
+
+	bool copyToImage(uint i, const Graphics::Surface &surf, TeImage &imgout);
+	bool isAhead(uint frame, uint current) const;
+	void startDecodeAhead(uint frames);
+	void stopDecodeAhead();
+	bool decodeNextFrame();
+	static void decodeAheadProc(void *param);
+
 	float _frameRate;
 	uint _width;
 	uint _height;
 	Common::Array<Common::FSNode> _files;
 	Common::Array<Graphics::ManagedSurface *> _cachedSurfaces;
 	uint _curFrame;
+
+	// Frames following the current one are decoded on a thread of their own.
+	// _mutex guards the ring and _nextDecode.
+	Common::Mutex _mutex;
+	Common::Array<DecodedFrame> _ring;
+	uint _nextDecode;
+	bool _quit;
+	Common::ThreadInternal *_decodeThread;
+	Common::SemaphoreInternal *_decodeSemaphore;
 };
 
 } // end namespace Tetraedge
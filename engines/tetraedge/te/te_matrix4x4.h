@@ -65,6 +65,29 @@ public:
 	TeVector3f32 mult3x3(const TeVector3f32 &vec) const;
 	TeVector3f32 mult4x3(const TeVector3f32 &vec) const;
 
+	/**
+	 * Add (*this * vertex) * weight to vertexSum and mult3x3(normal) * weight
+	 * to normalSum, with the same operations in the same order as these
+	 * operators, but on plain floats so that the compiler can keep
+	 * everything in vector registers when skinning. The results are the
+	 * same, unless the compiler contracts multiplications and additions
+	 * into fused multiply-adds, which it may do differently here.
+	 */
+	void addWeighted(float weight, float x, float y, float z, float nx, float ny, float nz, float *vertexSum, float *normalSum) const {
+		const float *d = _data;
+		float w = d[3] * x + d[7] * y + d[11] * z + d[15];
+		if (w == 0.0f)
+			w = 1e-09f;
+
+		vertexSum[0] = vertexSum[0] + ((d[0] * x + d[4] * y + d[8] * z + d[12]) / w) * weight;
+		vertexSum[1] = vertexSum[1] + ((d[1] * x + d[5] * y + d[9] * z + d[13]) / w) * weight;
+		vertexSum[2] = vertexSum[2] + ((d[2] * x + d[6] * y + d[10] * z + d[14]) / w) * weight;
+
+		normalSum[0] = normalSum[0] + (d[0] * nx + d[4] * ny + d[8] * nz) * weight;
+		normalSum[1] = normalSum[1] + (d[1] * nx + d[5] * ny + d[9] * nz) * weight;
+		normalSum[2] = normalSum[2] + (d[2] * nx + d[6] * ny + d[10] * nz) * weight;
+	}
+
 	Common::String toString() const;
 	Math::Matrix<4, 4> toScummVMMatrix() const;
 
@@ -22,6 +22,7 @@
 #include "common/file.h"
 #include "common/util.h"
 #include "common/substream.h"
+#include "common/jobsystem.h"
 #include "common/compression/zlib.h"
 
 #include "tetraedge/tetraedge.h"
@@ -81,6 +82,9 @@ void TeModel::create() {
 
 void TeModel::destroy() {
 	_weightElements.clear();
+	_weightOffsets.clear();
+	_weightBones.clear();
+	_weightValues.clear();
 	_lerpedElements.clear();
 	_meshes.clear();
 	_bones.clear();
@@ -183,6 +187,23 @@ void TeModel::setColor(const TeColor &col) {
 }
 
 void TeModel::update() {
+	Common::Array<SkinJob> jobs;
+	updateBones(jobs);
+	skinMeshes(jobs);
+}
+
+/*static*/
+void TeModel::updateModels(Common::Array<TeIntrusivePtr<TeModel>> &models) {
+	// Bones are updated in order, as they call back into the game, then the
+	// meshes of all models are skinned together
+	Common::Array<SkinJob> jobs;
+	for (auto &m : models) {
+		m->updateBones(jobs);
+	}
+	skinMeshes(jobs);
+}
+
+void TeModel::updateBones(Common::Array<SkinJob> &jobs) {
 	//if (name().contains("Kate"))
 	//	debug("TeModel::update model %s", name().c_str());
 	if (_bones.size()) {
@@ -261,43 +282,14 @@ void TeModel::update() {
 				}
 				mesh.update(&_boneMatricies, &_lerpedElements);
 			} else {
+				// Skinned later, possibly on another thread
 				mesh.resizeUpdatedTables(mesh.numVerticies());
-				Common::Array<TeVector3f32> verticies;
+				SkinJob job;
+				job._model = this;
+				job._mesh = &mesh;
 				if (_modelVertexAnim && mesh.name() == _modelVertexAnim->head())
-					verticies = _modelVertexAnim->getVertices();
-
-				for (uint i = 0; i < mesh.numVerticies(); i++) {
-					TeVector3f32 vertex;
-					if (verticies.empty()) {
-						vertex = mesh.preUpdatedVertex(i);
-					} else {
-						if (i < verticies.size())
-							vertex = verticies[i];
-					}
-					TeVector3f32 normal = mesh.preUpdatedNormal(i);
-					int idx = (int)mesh.matrixIndex(i);
-
-					TeVector3f32 updatedvertex;
-					TeVector3f32 updatednormal;
-
-					if (idx < (int)_bones.size()) {
-						updatedvertex = vertex;
-						if (verticies.empty())
-							updatedvertex = _boneMatricies[idx] * updatedvertex;
-						updatednormal = _boneMatricies[idx].mult3x3(normal);
-					} else {
-						idx -= _bones.size();
-						for (uint w = 0; w < _weightElements[idx].size(); w++) {
-							const TeMatrix4x4 &wmatrix = _boneMatricies[_weightElements[idx][w]._x];
-							float weight = _weightElements[idx][w]._weight;
-							updatedvertex = updatedvertex + ((wmatrix * vertex) * weight);
-							updatednormal = updatednormal + (wmatrix.mult3x3(normal) * weight);
-						}
-					}
-
-					mesh.setUpdatedVertex(i, updatedvertex);
-					mesh.setUpdatedNormal(i, updatednormal);
-				}
+					job._animVerticies = _modelVertexAnim->getVertices();
+				jobs.push_back(job);
 			}
 
 			for (MeshBlender *mb : _meshBlenders) {
@@ -325,6 +317,71 @@ void TeModel::update() {
 	}
 }
 
+void TeModel::flattenWeights() {
+	_weightOffsets.resize(_weightElements.size() + 1);
+	_weightBones.clear();
+	_weightValues.clear();
+	for (uint i = 0; i < _weightElements.size(); i++) {
+		_weightOffsets[i] = _weightBones.size();
+		for (const auto &weight : _weightElements[i]) {
+			_weightBones.push_back(weight._x);
+			_weightValues.push_back(weight._weight);
+		}
+	}
+	_weightOffsets[_weightElements.size()] = _weightBones.size();
+}
+
+/*static*/
+void TeModel::skinMeshes(Common::Array<SkinJob> &jobs) {
+	if (jobs.size() == 1)
+		skinMeshProc(&jobs, 0, 1, Common::kJobNoWorker);
+	else if (!jobs.empty())
+		Common::JobSystem::instance().parallelFor(0, jobs.size(), 1, &skinMeshProc, &jobs);
+}
+
+/*static*/
+void TeModel::skinMeshProc(void *param, uint begin, uint end, uint worker) {
+	Common::Array<SkinJob> &jobs = *(Common::Array<SkinJob> *)param;
+	for (uint i = begin; i < end; i++)
+		jobs[i]._model->skinMesh(*jobs[i]._mesh, jobs[i]._animVerticies);
+}
+
+void TeModel::skinMesh(TeMesh &mesh, const Common::Array<TeVector3f32> &animVerticies) const {
+	const uint numBones = _bones.size();
+	const uint numVerticies = mesh.numVerticies();
+	const TeVector3f32 zero;
+
+	for (uint i = 0; i < numVerticies; i++) {
+		const TeVector3f32 *vertex = &zero;
+		if (animVerticies.empty())
+			vertex = &mesh.preUpdatedVertex(i);
+		else if (i < animVerticies.size())
+			vertex = &animVerticies[i];
+		const TeVector3f32 &normal = mesh.preUpdatedNormal(i);
+		uint idx = mesh.matrixIndex(i);
+
+		if (idx < numBones) {
+			const TeMatrix4x4 &matrix = _boneMatricies[idx];
+			mesh.setUpdatedVertex(i, animVerticies.empty() ? matrix * *vertex : *vertex);
+			mesh.setUpdatedNormal(i, matrix.mult3x3(normal));
+			continue;
+		}
+
+		idx -= numBones;
+		float updatedVertex[3] = { 0.0f, 0.0f, 0.0f };
+		float updatedNormal[3] = { 0.0f, 0.0f, 0.0f };
+		const float x = vertex->x(), y = vertex->y(), z = vertex->z();
+		const float nx = normal.x(), ny = normal.y(), nz = normal.z();
+		const uint32 last = _weightOffsets[idx + 1];
+		for (uint32 w = _weightOffsets[idx]; w < last; w++) {
+			_boneMatricies[_weightBones[w]].addWeighted(_weightValues[w], x, y, z, nx, ny, nz, updatedVertex, updatedNormal);
+		}
+
+		mesh.setUpdatedVertex(i, TeVector3f32(updatedVertex[0], updatedVertex[1], updatedVertex[2]));
+		mesh.setUpdatedNormal(i, TeVector3f32(updatedNormal[0], updatedNormal[1], updatedNormal[2]));
+	}
+}
+
 TeModel::MeshBlender::MeshBlender(const Common::String &name, const Common::String &meshName, float amount, TeModel *model) :
 _name(name), _amount(amount) {
 	const auto &meshes = model->_meshes;
@@ -413,6 +470,7 @@ bool TeModel::load(Common::SeekableReadStream &stream) {
 	for (uint i = 0; i < _weightElements.size(); i++) {
 		loadWeights(stream, _weightElements[i]);
 	}
+	flattenWeights();
 
 	if (_bones.empty())
 		_bones.resize(1);
@@ -113,6 +113,12 @@ public:
 	void removeAnim();
 	void update();
 
+	/**
+	 * Update all given models. Same as calling update() on each, but the
+	 * meshes of all models are skinned in parallel.
+	 */
+	static void updateModels(Common::Array<TeIntrusivePtr<TeModel>> &models);
+
 	void saveBone(Common::SeekableWriteStream &stream, uint boneno);
 	void saveMesh(Common::SeekableWriteStream &stream, const TeMesh &mesh);
 	void saveModel(Common::SeekableWriteStream &stream, uint num);
@@ -138,9 +144,22 @@ public:
 	void setMeshCount(uint count);
 
 protected:
+	/** A mesh whose vertices are blended from several bones, see skinMesh(). */
+	struct SkinJob {
+		TeModel *_model;
+		TeMesh *_mesh;
+		Common::Array<TeVector3f32> _animVerticies;
+	};
+
 	TeMatrix4x4 lerpElementsMatrix(uint weightNum, const Common::Array<TeMatrix4x4> &matricies);
 	void optimize();
 
+	void flattenWeights();
+	void updateBones(Common::Array<SkinJob> &jobs);
+	void skinMesh(TeMesh &mesh, const Common::Array<TeVector3f32> &animVerticies) const;
+	static void skinMeshes(Common::Array<SkinJob> &jobs);
+	static void skinMeshProc(void *param, uint begin, uint end, uint worker);
+
 	Common::String _texturePath;
 	TeIntrusivePtr<TeTiledTexture> _tiledTexture;
 
@@ -156,6 +175,11 @@ protected:
 	Common::Array<TeMatrix4x4> _boneMatricies;
 	Common::Array<TeMatrix4x4> _lerpedElements;
 	Common::Array<Common::Array<weightElement>> _weightElements;
+	// _weightElements laid out contiguously for skinning: the weights of
+	// element i are at [_weightOffsets[i], _weightOffsets[i + 1])
+	Common::Array<uint32> _weightOffsets;
+	Common::Array<uint16> _weightBones;
+	Common::Array<float> _weightValues;
 	Common::Array<Common::SharedPtr<TeMesh>> _meshes;
 
 	TeQuaternion _boneRotation;
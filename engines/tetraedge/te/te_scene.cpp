@@ -101,9 +101,7 @@ void TeScene::setCurrentCamera(const Common::String &cname) {
 }
 
 void TeScene::update() {
-	for (auto &m : _models) {
-		m->update();
-	}
+	TeModel::updateModels(_models);
 }
 
 } // end namespace Tetraedge
@@ -27,6 +27,9 @@ namespace TwinE {
 
 void BodyData::reset() {
 	_vertices.clear();
+	_vertexComponents.x.clear();
+	_vertexComponents.y.clear();
+	_vertexComponents.z.clear();
 	_bones.clear();
 	_normals.clear();
 	_polygons.clear();
@@ -40,12 +43,18 @@ void BodyData::loadVertices(Common::SeekableReadStream &stream) {
 		return;
 
 	_vertices.reserve(numVertices);
+	_vertexComponents.x.resize(numVertices);
+	_vertexComponents.y.resize(numVertices);
+	_vertexComponents.z.resize(numVertices);
 	for (uint16 i = 0U; i < numVertices; ++i) {
 		const int16 x = stream.readSint16LE();
 		const int16 y = stream.readSint16LE();
 		const int16 z = stream.readSint16LE();
 		const uint16 bone = 0;
 		_vertices.push_back({x, y, z, bone});
+		_vertexComponents.x[i] = x;
+		_vertexComponents.y[i] = y;
+		_vertexComponents.z[i] = z;
 	}
 }
 
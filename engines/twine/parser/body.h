@@ -43,6 +43,7 @@ private:
 
 	Common::Array<BodyPolygon> _polygons;
 	Common::Array<BodyVertex> _vertices;
+	BodyVertexComponents _vertexComponents;
 	Common::Array<BodySphere> _spheres;
 	Common::Array<BodyNormal> _normals;
 	Common::Array<BodyLine> _lines;
@@ -87,6 +88,10 @@ public:
 		return _vertices;
 	}
 
+	const BodyVertexComponents &getVertexComponents() const {
+		return _vertexComponents;
+	}
+
 	const Common::Array<BodySphere> &getSpheres() const {
 		return _spheres;
 	}
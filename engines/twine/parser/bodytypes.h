@@ -35,6 +35,16 @@ struct BodyVertex {
 	uint16 bone;
 };
 
+/**
+ * The vertex coordinates of a body split by component, so that the renderer
+ * can transform the vertices of a bone in one batch
+ */
+struct BodyVertexComponents {
+	Common::Array<int16> x;
+	Common::Array<int16> y;
+	Common::Array<int16> z;
+};
+
 struct BodyLine {
 	// fill byte here
 	uint8 color;
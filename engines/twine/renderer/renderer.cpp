@@ -304,19 +304,33 @@ bool isPolygonVisible(const ComputedVertex *vertices) { // TestVuePoly
 	return true;
 }
 
-void Renderer::rotList(const Common::Array<BodyVertex> &vertices, int32 firstPoint, int32 numPoints, I16Vec3 *destPoints, const IMatrix3x3 *rotationMatrix, const IVec3 &destPos) {
-	for (int32 i = 0; i < numPoints; ++i) {
-		const BodyVertex &vertex = vertices[i + firstPoint];
-		destPoints->x = (int16)(((rotationMatrix->row1.x * vertex.x + rotationMatrix->row1.y * vertex.y + rotationMatrix->row1.z * vertex.z) / SCENE_SIZE_HALF) + destPos.x);
-		destPoints->y = (int16)(((rotationMatrix->row2.x * vertex.x + rotationMatrix->row2.y * vertex.y + rotationMatrix->row2.z * vertex.z) / SCENE_SIZE_HALF) + destPos.y);
-		destPoints->z = (int16)(((rotationMatrix->row3.x * vertex.x + rotationMatrix->row3.y * vertex.y + rotationMatrix->row3.z * vertex.z) / SCENE_SIZE_HALF) + destPos.z);
+void Renderer::rotList(const BodyVertexComponents &vertices, int32 firstPoint, int32 numPoints, I16Vec3 *destPoints, const IMatrix3x3 *rotationMatrix, const IVec3 &destPos) {
+	if (numPoints <= 0) {
+		return;
+	}
 
-		destPoints++;
+	// Copy everything the loop needs to locals, so that the compiler knows
+	// the stores to destPoints do not change them and can vectorize the loop
+	const int16 *vertexX = &vertices.x[firstPoint];
+	const int16 *vertexY = &vertices.y[firstPoint];
+	const int16 *vertexZ = &vertices.z[firstPoint];
+	const int32 m11 = rotationMatrix->row1.x, m12 = rotationMatrix->row1.y, m13 = rotationMatrix->row1.z;
+	const int32 m21 = rotationMatrix->row2.x, m22 = rotationMatrix->row2.y, m23 = rotationMatrix->row2.z;
+	const int32 m31 = rotationMatrix->row3.x, m32 = rotationMatrix->row3.y, m33 = rotationMatrix->row3.z;
+	const int32 posX = destPos.x, posY = destPos.y, posZ = destPos.z;
+
+	for (int32 i = 0; i < numPoints; ++i) {
+		const int32 x = vertexX[i];
+		const int32 y = vertexY[i];
+		const int32 z = vertexZ[i];
+		destPoints[i].x = (int16)(((m11 * x + m12 * y + m13 * z) / SCENE_SIZE_HALF) + posX);
+		destPoints[i].y = (int16)(((m21 * x + m22 * y + m23 * z) / SCENE_SIZE_HALF) + posY);
+		destPoints[i].z = (int16)(((m31 * x + m32 * y + m33 * z) / SCENE_SIZE_HALF) + posZ);
 	}
 }
 
 // RotateGroupe
-void Renderer::processRotatedElement(IMatrix3x3 *targetMatrix, const Common::Array<BodyVertex> &vertices, int32 alpha, int32 beta, int32 gamma, const BodyBone &bone, ModelData *modelData) {
+void Renderer::processRotatedElement(IMatrix3x3 *targetMatrix, const BodyVertexComponents &vertices, int32 alpha, int32 beta, int32 gamma, const BodyBone &bone, ModelData *modelData) {
 	const int32 firstPoint = bone.firstVertex;
 	const int32 numOfPoints = bone.numVertices;
 	const IVec3 renderAngle(alpha, beta, gamma);
@@ -344,23 +358,32 @@ void Renderer::processRotatedElement(IMatrix3x3 *targetMatrix, const Common::Arr
 	rotList(vertices, firstPoint, numOfPoints, &modelData->computedPoints[firstPoint], targetMatrix, destPos);
 }
 
-void Renderer::transRotList(const Common::Array<BodyVertex> &vertices, int32 firstPoint, int32 numPoints, I16Vec3 *destPoints, const IMatrix3x3 *translationMatrix, const IVec3 &angleVec, const IVec3 &destPos) {
-	for (int32 i = 0; i < numPoints; ++i) {
-		const BodyVertex &vertex = vertices[i + firstPoint];
-		const int16 tmpX = (int16)(vertex.x + angleVec.x);
-		const int16 tmpY = (int16)(vertex.y + angleVec.y);
-		const int16 tmpZ = (int16)(vertex.z + angleVec.z);
+void Renderer::transRotList(const BodyVertexComponents &vertices, int32 firstPoint, int32 numPoints, I16Vec3 *destPoints, const IMatrix3x3 *translationMatrix, const IVec3 &angleVec, const IVec3 &destPos) {
+	if (numPoints <= 0) {
+		return;
+	}
 
-		destPoints->x = ((translationMatrix->row1.x * tmpX + translationMatrix->row1.y * tmpY + translationMatrix->row1.z * tmpZ) / SCENE_SIZE_HALF) + destPos.x;
-		destPoints->y = ((translationMatrix->row2.x * tmpX + translationMatrix->row2.y * tmpY + translationMatrix->row2.z * tmpZ) / SCENE_SIZE_HALF) + destPos.y;
-		destPoints->z = ((translationMatrix->row3.x * tmpX + translationMatrix->row3.y * tmpY + translationMatrix->row3.z * tmpZ) / SCENE_SIZE_HALF) + destPos.z;
+	const int16 *vertexX = &vertices.x[firstPoint];
+	const int16 *vertexY = &vertices.y[firstPoint];
+	const int16 *vertexZ = &vertices.z[firstPoint];
+	const int32 m11 = translationMatrix->row1.x, m12 = translationMatrix->row1.y, m13 = translationMatrix->row1.z;
+	const int32 m21 = translationMatrix->row2.x, m22 = translationMatrix->row2.y, m23 = translationMatrix->row2.z;
+	const int32 m31 = translationMatrix->row3.x, m32 = translationMatrix->row3.y, m33 = translationMatrix->row3.z;
+	const int32 transX = angleVec.x, transY = angleVec.y, transZ = angleVec.z;
+	const int32 posX = destPos.x, posY = destPos.y, posZ = destPos.z;
 
-		destPoints++;
+	for (int32 i = 0; i < numPoints; ++i) {
+		const int32 x = (int16)(vertexX[i] + transX);
+		const int32 y = (int16)(vertexY[i] + transY);
+		const int32 z = (int16)(vertexZ[i] + transZ);
+		destPoints[i].x = (int16)(((m11 * x + m12 * y + m13 * z) / SCENE_SIZE_HALF) + posX);
+		destPoints[i].y = (int16)(((m21 * x + m22 * y + m23 * z) / SCENE_SIZE_HALF) + posY);
+		destPoints[i].z = (int16)(((m31 * x + m32 * y + m33 * z) / SCENE_SIZE_HALF) + posZ);
 	}
 }
 
 // TranslateGroupe
-void Renderer::translateGroup(IMatrix3x3 *targetMatrix, const Common::Array<BodyVertex> &vertices, int32 rotX, int32 rotY, int32 rotZ, const BodyBone &bone, ModelData *modelData) {
+void Renderer::translateGroup(IMatrix3x3 *targetMatrix, const BodyVertexComponents &vertices, int32 rotX, int32 rotY, int32 rotZ, const BodyBone &bone, ModelData *modelData) {
 	IVec3 renderAngle;
 	renderAngle.x = rotX;
 	renderAngle.y = rotY;
@@ -828,7 +851,6 @@ void Renderer::svgaPolyCopper(int16 vtop, int16 Ymax, uint16 color) const {
 	int16 xMin, xMax;
 	int16 y = vtop;
 	byte *pDestLine = (uint8 *)_engine->_frontVideoBuffer.getBasePtr(0, y);
-	byte *pDest;
 	int16 *pVerticG = &_tabVerticG[y];
 	int16 *pVerticD = &_tabVerticD[y];
 	int32 sens = 1;
@@ -836,10 +858,9 @@ void Renderer::svgaPolyCopper(int16 vtop, int16 Ymax, uint16 color) const {
 	for (; y <= Ymax; y++) {
 		xMin = *pVerticG++;
 		xMax = *pVerticD++;
-		pDest = pDestLine + xMin;
 
-		for (; xMin <= xMax; xMin++) {
-			*pDest++ = (byte)color;
+		if (xMin <= xMax) {
+			memset(pDestLine + xMin, (byte)color, xMax - xMin + 1);
 		}
 
 		color += sens;
@@ -859,7 +880,6 @@ void Renderer::svgaPolyBopper(int16 vtop, int16 Ymax, uint16 color) const {
 	int16 xMin, xMax;
 	int16 y = vtop;
 	byte *pDestLine = (uint8 *)_engine->_frontVideoBuffer.getBasePtr(0, y);
-	byte *pDest;
 	int16 *pVerticG = &_tabVerticG[y];
 	int16 *pVerticD = &_tabVerticD[y];
 	int32 sens = 1;
@@ -868,10 +888,9 @@ void Renderer::svgaPolyBopper(int16 vtop, int16 Ymax, uint16 color) const {
 	for (; y <= Ymax; y++) {
 		xMin = *pVerticG++;
 		xMax = *pVerticD++;
-		pDest = pDestLine + xMin;
 
-		for (; xMin <= xMax; xMin++) {
-			*pDest++ = (byte)color;
+		if (xMin <= xMax) {
+			memset(pDestLine + xMin, (byte)color, xMax - xMin + 1);
 		}
 
 		line--;
@@ -895,17 +914,15 @@ void Renderer::svgaPolyTriste(int16 vtop, int16 Ymax, uint16 color) const {
 	int16 xMin, xMax;
 	int16 y = vtop;
 	byte *pDestLine = (uint8 *)_engine->_frontVideoBuffer.getBasePtr(0, vtop);
-	byte *pDest;
 	int16 *pVerticG = &_tabVerticG[y];
 	int16 *pVerticD = &_tabVerticD[y];
 
 	for (; y <= Ymax; y++) {
 		xMin = *pVerticG++;
 		xMax = *pVerticD++;
-		pDest = pDestLine + xMin;
 
-		for (; xMin <= xMax; xMin++) {
-			*pDest++ = (byte)color;
+		if (xMin <= xMax) {
+			memset(pDestLine + xMin, (byte)color, xMax - xMin + 1);
 		}
 
 		pDestLine += screenWidth;
@@ -961,9 +978,9 @@ void Renderer::svgaPolyTrans(int16 vtop, int16 Ymax, uint16 color) const {
 		xMax = *pVerticD++;
 		pDest = pDestLine + xMin;
 
-		for (; xMin <= xMax; xMin++) {
-			*pDest = (byte)color | (*pDest & 0x0F);
-			pDest++;
+		const int32 width = xMax - xMin + 1;
+		for (int32 x = 0; x < width; x++) {
+			pDest[x] = (byte)color | (pDest[x] & 0x0F);
 		}
 
 		pDestLine += screenWidth;
@@ -1035,9 +1052,11 @@ void Renderer::svgaPolyGouraud(int16 vtop, int16 Ymax) const {
 		} else {
 			step = (end - start) / xMax;
 
-			for (; xMax >= 0; xMax--) {
-				*pDest++ = (byte)(start >> 8);
-				start += step;
+			// The colour wraps around like the 16 bit accumulator of the
+			// original, but each pixel is computed on its own, so that the
+			// loop can be vectorized
+			for (int32 x = 0; x <= xMax; x++) {
+				pDest[x] = (byte)((uint16)(start + x * step) >> 8);
 			}
 		}
 
@@ -1145,11 +1164,9 @@ void Renderer::svgaPolyMarbre(int16 vtop, int16 Ymax, uint16 color) const {
 			*pDest++ = (byte)(end >> 8);
 		} else if (dc > 0) {
 			step = delta / (dc + 1);
-			color = start;
 
-			for (; xMin <= xMax; xMin++) {
-				*pDest++ = (byte)(color >> 8);
-				color += step;
+			for (int32 x = 0; x <= dc; x++) {
+				pDest[x] = (byte)((uint16)(start + x * step) >> 8);
 			}
 		}
 
@@ -1162,7 +1179,6 @@ void Renderer::svgaPolyTriche(int16 vtop, int16 Ymax, uint16 color) const {
 	int16 xMin, xMax;
 	int16 y = vtop;
 	byte *pDestLine = (uint8 *)_engine->_frontVideoBuffer.getBasePtr(0, y);
-	byte *pDest;
 	int16 *pVerticG = &_tabVerticG[y];
 	int16 *pVerticD = &_tabVerticD[y];
 	int16 *pCoulG = &_tabCoulG[y];
@@ -1170,11 +1186,10 @@ void Renderer::svgaPolyTriche(int16 vtop, int16 Ymax, uint16 color) const {
 	for (; y <= Ymax; y++) {
 		xMin = *pVerticG++;
 		xMax = *pVerticD++;
-		pDest = pDestLine + xMin;
 
 		color = (*pCoulG++) >> 8;
-		for (; xMin <= xMax; xMin++) {
-			*pDest++ = (byte)color;
+		if (xMin <= xMax) {
+			memset(pDestLine + xMin, (byte)color, xMax - xMin + 1);
 		}
 
 		pDestLine += screenWidth;
@@ -1541,7 +1556,7 @@ void Renderer::animModel(ModelData *modelData, const BodyData &bodyData, RenderC
 	const int32 numVertices = bodyData.getNumVertices();
 	const int32 numBones = bodyData.getNumBones();
 
-	const Common::Array<BodyVertex> &vertices = bodyData.getVertices();
+	const BodyVertexComponents &vertices = bodyData.getVertexComponents();
 
 	IMatrix3x3 *modelMatrix = &_matricesTable[0];
 
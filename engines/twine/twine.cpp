@@ -25,6 +25,7 @@
 #include "common/error.h"
 #include "common/events.h"
 #include "common/keyboard.h"
+#include "common/profiler.h"
 #include "common/savefile.h"
 #include "common/scummsys.h"
 #include "common/str.h"
@@ -804,6 +805,7 @@ void TwinEEngine::processOptionsMenu() {
 }
 
 bool TwinEEngine::runGameEngine() { // mainLoopInteration
+	PROFILE_SCOPE("TwinEEngine::runGameEngine");
 	g_system->delayMillis(2);
 
 	FrameMarker frame(this, 60);
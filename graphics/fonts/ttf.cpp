@@ -38,6 +38,7 @@
 #include "common/stream.h"
 #include "common/memstream.h"
 #include "common/hashmap.h"
+#include "common/mutex.h"
 #include "common/ptr.h"
 #include "common/compression/unzip.h"
 
@@ -106,10 +107,6 @@ private:
 	bool _initialized;
 };
 
-void shutdownTTF() {
-	TTFLibrary::destroy();
-}
-
 #define g_ttf ::Graphics::TTFLibrary::instance()
 
 TTFLibrary::TTFLibrary() : _library(), _initialized(false) {
@@ -136,6 +133,291 @@ void TTFLibrary::closeFont(FT_Face &face) {
 	FT_Done_Face(face);
 }
 
+/**
+ * Glyph bitmaps of all TTF fonts, packed into shared atlas pages.
+ *
+ * Glyphs are keyed by face and code point, where the face id identifies the
+ * font data together with every setting affecting rasterization (size,
+ * render mode, fake styles, ...). Fonts loaded several times with the same
+ * settings thus share their glyphs. When the pages would exceed the byte
+ * budget, the least recently used page is dropped with all its glyphs.
+ *
+ * Fonts may be used from several threads. Callers hold the mutex returned by
+ * getMutex() while they use the cache and the glyphs returned from it.
+ */
+class TTFGlyphCache : public Common::Singleton<TTFGlyphCache> {
+public:
+	struct Glyph {
+		int xOffset, yOffset;
+		int advance;
+		FT_UInt slot;
+
+		int page;       ///< atlas page holding the bitmap, -1 for empty bitmaps
+		int x, y;       ///< position of the bitmap in the page
+		int w, h;       ///< size of the bitmap
+	};
+
+	TTFGlyphCache();
+	~TTFGlyphCache();
+
+	/**
+	 * Return the face id for the given face description, allocating a new
+	 * one for descriptions not seen before.
+	 */
+	uint32 getFaceId(const Common::String &description);
+
+	/**
+	 * Look up a glyph. The returned pointer stays valid until the next call
+	 * to allocate().
+	 */
+	const Glyph *find(uint32 face, uint32 chr);
+
+	/**
+	 * Reserve atlas space for a bitmap of the given size. The position is
+	 * stored in @p glyph, and the pixels, initialized to 0, are returned
+	 * together with their pitch. Returns nullptr for empty bitmaps.
+	 */
+	byte *allocate(int w, int h, Glyph &glyph, int &pitch);
+
+	const Glyph *add(uint32 face, uint32 chr, const Glyph &glyph);
+
+	const Surface &getPage(int page) const { return _pages[page].surface; }
+
+	void getStats(TTFGlyphCacheStats &stats) const;
+	void setBudget(uint32 bytes);
+
+	Common::Mutex &getMutex() { return _mutex; }
+
+private:
+	enum {
+		kPageSize = 256,
+		kDefaultBudget = 4 * 1024 * 1024
+	};
+
+	struct GlyphKey {
+		uint32 face;
+		uint32 chr;
+
+		GlyphKey() : face(0), chr(0) {}
+		GlyphKey(uint32 f, uint32 c) : face(f), chr(c) {}
+		bool operator==(const GlyphKey &key) const { return face == key.face && chr == key.chr; }
+	};
+
+	struct GlyphKey_Hash {
+		uint operator()(const GlyphKey &key) const { return (key.face * 0x9E3779B1U) ^ key.chr; }
+	};
+
+	/** A row of glyphs in a page, all at most as high as the row. */
+	struct Shelf {
+		int y, h;
+		int x;          ///< first free column
+	};
+
+	struct Page {
+		Surface surface;
+		uint32 lastUse;
+		int nextShelfY;
+		Common::Array<Shelf> shelves;
+		Common::Array<GlyphKey> glyphs;
+	};
+
+	bool place(Page &page, int w, int h, int &x, int &y);
+	void evictPage(int page);
+	void trim(uint32 extraBytes);
+
+	typedef Common::HashMap<GlyphKey, Glyph, GlyphKey_Hash> GlyphMap;
+	GlyphMap _glyphs;
+	Common::HashMap<Common::String, uint32> _faceIds;
+	Common::Array<Page> _pages;
+
+	uint32 _budget;
+	uint32 _bytes;
+	uint32 _useCounter;
+
+	uint32 _hits;
+	uint32 _misses;
+	uint32 _evictedPages;
+
+	Common::Mutex _mutex;
+};
+
+#define g_ttfGlyphCache ::Graphics::TTFGlyphCache::instance()
+
+TTFGlyphCache::TTFGlyphCache() : _budget(kDefaultBudget), _bytes(0), _useCounter(0),
+	_hits(0), _misses(0), _evictedPages(0) {
+}
+
+TTFGlyphCache::~TTFGlyphCache() {
+	for (uint i = 0; i < _pages.size(); ++i)
+		_pages[i].surface.free();
+}
+
+uint32 TTFGlyphCache::getFaceId(const Common::String &description) {
+	uint32 id;
+	if (!_faceIds.tryGetVal(description, id)) {
+		id = _faceIds.size() + 1;
+		_faceIds[description] = id;
+	}
+	return id;
+}
+
+const TTFGlyphCache::Glyph *TTFGlyphCache::find(uint32 face, uint32 chr) {
+	GlyphMap::const_iterator i = _glyphs.find(GlyphKey(face, chr));
+	if (i == _glyphs.end()) {
+		++_misses;
+		return nullptr;
+	}
+
+	++_hits;
+	const Glyph &glyph = i->_value;
+	if (glyph.page >= 0)
+		_pages[glyph.page].lastUse = ++_useCounter;
+	return &glyph;
+}
+
+bool TTFGlyphCache::place(Page &page, int w, int h, int &x, int &y) {
+	if (w > page.surface.w)
+		return false;
+
+	// Use the first shelf that fits without wasting too much height
+	for (uint i = 0; i < page.shelves.size(); ++i) {
+		Shelf &shelf = page.shelves[i];
+		if (h <= shelf.h && h * 4 >= shelf.h * 3 && shelf.x + w <= page.surface.w) {
+			x = shelf.x;
+			y = shelf.y;
+			shelf.x += w;
+			return true;
+		}
+	}
+
+	// Open a new shelf, rounding its height up so that similar glyphs fit
+	int shelfH = MIN<int>((h + 3) & ~3, page.surface.h - page.nextShelfY);
+	if (shelfH < h)
+		return false;
+
+	Shelf shelf;
+	shelf.y = page.nextShelfY;
+	shelf.h = shelfH;
+	shelf.x = w;
+	page.shelves.push_back(shelf);
+	page.nextShelfY += shelfH;
+
+	x = 0;
+	y = shelf.y;
+	return true;
+}
+
+void TTFGlyphCache::evictPage(int page) {
+	Page &p = _pages[page];
+	for (uint i = 0; i < p.glyphs.size(); ++i)
+		_glyphs.erase(p.glyphs[i]);
+
+	_bytes -= p.surface.w * p.surface.h;
+	p.surface.free();
+	p.shelves.clear();
+	p.glyphs.clear();
+	p.nextShelfY = 0;
+	++_evictedPages;
+}
+
+void TTFGlyphCache::trim(uint32 extraBytes) {
+	while (_bytes + extraBytes > _budget) {
+		int oldest = -1;
+		for (uint i = 0; i < _pages.size(); ++i) {
+			if (_pages[i].surface.getPixels() && (oldest < 0 || _pages[i].lastUse < _pages[oldest].lastUse))
+				oldest = i;
+		}
+		if (oldest < 0)
+			break;
+		evictPage(oldest);
+	}
+}
+
+byte *TTFGlyphCache::allocate(int w, int h, Glyph &glyph, int &pitch) {
+	glyph.page = -1;
+	glyph.x = glyph.y = 0;
+	glyph.w = w;
+	glyph.h = h;
+	if (w <= 0 || h <= 0)
+		return nullptr;
+
+	int page = -1;
+	for (uint i = 0; i < _pages.size() && page < 0; ++i) {
+		if (_pages[i].surface.getPixels() && place(_pages[i], w, h, glyph.x, glyph.y))
+			page = i;
+	}
+
+	if (page < 0) {
+		// Glyphs too big for a regular page get a page of their own
+		const int pageW = MAX<int>(w, kPageSize);
+		const int pageH = MAX<int>(h, kPageSize);
+		trim(pageW * pageH);
+
+		for (uint i = 0; i < _pages.size() && page < 0; ++i) {
+			if (!_pages[i].surface.getPixels())
+				page = i;
+		}
+		if (page < 0) {
+			page = _pages.size();
+			_pages.resize(page + 1);
+		}
+
+		Page &p = _pages[page];
+		p.surface.create(pageW, pageH, PixelFormat::createFormatCLUT8());
+		p.nextShelfY = 0;
+		_bytes += pageW * pageH;
+
+		bool placed = place(p, w, h, glyph.x, glyph.y);
+		assert(placed);
+		(void)placed;
+	}
+
+	Page &p = _pages[page];
+	p.lastUse = ++_useCounter;
+	glyph.page = page;
+	pitch = p.surface.pitch;
+	return (byte *)p.surface.getBasePtr(glyph.x, glyph.y);
+}
+
+const TTFGlyphCache::Glyph *TTFGlyphCache::add(uint32 face, uint32 chr, const Glyph &glyph) {
+	const GlyphKey key(face, chr);
+	if (glyph.page >= 0)
+		_pages[glyph.page].glyphs.push_back(key);
+
+	Glyph &entry = _glyphs[key];
+	entry = glyph;
+	return &entry;
+}
+
+void TTFGlyphCache::getStats(TTFGlyphCacheStats &stats) const {
+	stats.hits = _hits;
+	stats.misses = _misses;
+	stats.evictedPages = _evictedPages;
+	stats.glyphs = _glyphs.size();
+	stats.bytes = _bytes;
+	stats.budget = _budget;
+}
+
+void TTFGlyphCache::setBudget(uint32 bytes) {
+	_budget = bytes;
+	trim(0);
+}
+
+void getTTFGlyphCacheStats(TTFGlyphCacheStats &stats) {
+	Common::StackLock lock(g_ttfGlyphCache.getMutex());
+	g_ttfGlyphCache.getStats(stats);
+}
+
+void setTTFGlyphCacheBudget(uint32 bytes) {
+	Common::StackLock lock(g_ttfGlyphCache.getMutex());
+	g_ttfGlyphCache.setBudget(bytes);
+}
+
+void shutdownTTF() {
+	TTFGlyphCache::destroy();
+	TTFLibrary::destroy();
+}
+
 class TTFFont : public Font {
 public:
 	TTFFont();
@@ -171,18 +453,16 @@ private:
 	int _width, _height;
 	int _ascent, _descent;
 
-	struct Glyph {
-		Surface image;
-		int xOffset, yOffset;
-		int advance;
-		FT_UInt slot;
-	};
+	typedef TTFGlyphCache::Glyph Glyph;
 
-	bool cacheGlyph(Glyph &glyph, uint32 chr) const;
-	typedef Common::HashMap<uint32, Glyph> GlyphCache;
-	mutable GlyphCache _glyphs;
-	bool _allowLateCaching;
-	void assureCached(uint32 chr) const;
+	/** Id of this face and its rendering settings in the glyph cache */
+	uint32 _faceId;
+	/** Code points of characters 0-255 if a mapping was given, otherwise empty */
+	Common::Array<uint32> _mapping;
+
+	// Callers hold the mutex of the glyph cache
+	const Glyph *getGlyph(uint32 chr) const;
+	const Glyph *cacheGlyph(uint32 chr) const;
 
 	Common::SeekableReadStream *readTTFTable(FT_ULong tag) const;
 
@@ -202,8 +482,8 @@ private:
 
 TTFFont::TTFFont()
 	: _initialized(false), _face(), _ttfFile(0), _size(0), _width(0), _height(0), _ascent(0),
-	  _descent(0), _glyphs(), _loadFlags(FT_LOAD_TARGET_NORMAL), _renderMode(FT_RENDER_MODE_NORMAL),
-	  _hasKerning(false), _allowLateCaching(false), _fakeBold(false), _fakeItalic(false) {
+	  _descent(0), _faceId(0), _loadFlags(FT_LOAD_TARGET_NORMAL), _renderMode(FT_RENDER_MODE_NORMAL),
+	  _hasKerning(false), _fakeBold(false), _fakeItalic(false) {
 }
 
 TTFFont::~TTFFont() {
@@ -213,9 +493,6 @@ TTFFont::~TTFFont() {
 		delete[] _ttfFile;
 		_ttfFile = 0;
 
-		for (GlyphCache::iterator i = _glyphs.begin(), end = _glyphs.end(); i != end; ++i)
-			i->_value.image.free();
-
 		_initialized = false;
 	}
 }
@@ -367,40 +644,48 @@ bool TTFFont::load(uint8 *ttfFile, uint32 sizeFile, int32 faceIndex, bool bold,
 		_loadFlags |= FT_LOAD_NO_BITMAP;
 	}
 
-	if (!mapping) {
-		// Allow loading of all unicode characters.
-		_allowLateCaching = true;
+	Common::StackLock lock(g_ttfGlyphCache.getMutex());
+
+	// Everything which influences the rendered glyphs has to be part of
+	// the face description, so that only identical glyphs are shared.
+	const TT_Header *head = (const TT_Header *)FT_Get_Sfnt_Table(_face, ft_sfnt_head);
+	_faceId = g_ttfGlyphCache.getFaceId(Common::String::format("%s|%s|%u|%d|%ld|%lx|%ld|%ld|%d|%d|%d|%d|%d|%d|%d",
+		_face->family_name ? _face->family_name : "", _face->style_name ? _face->style_name : "",
+		sizeFile, faceIndex, (long)_face->num_glyphs, head ? (unsigned long)head->CheckSum_Adjust : 0UL,
+		(long)_face->size->metrics.x_scale, (long)_face->size->metrics.y_scale,
+		_face->size->metrics.x_ppem, _face->size->metrics.y_ppem, (int)_loadFlags, (int)_renderMode,
+		_fakeBold, _fakeItalic, stemDarkening));
 
-		// Load all ISO-8859-1 characters.
+	uint numGlyphs = 0;
+	if (!mapping) {
+		// All unicode characters can be loaded, check the ISO-8859-1 ones.
 		for (uint i = 0; i < 256; ++i) {
-			if (!cacheGlyph(_glyphs[i], i)) {
-				_glyphs.erase(i);
-			}
+			if (getGlyph(i))
+				++numGlyphs;
 		}
 	} else {
 		// We have a fixed map of characters do not load more later.
-		_allowLateCaching = false;
+		_mapping.resize(256);
 
 		for (uint i = 0; i < 256; ++i) {
-			const uint32 unicode = mapping[i] & 0x7FFFFFFF;
+			_mapping[i] = mapping[i] & 0x7FFFFFFF;
 			const bool isRequired = (mapping[i] & 0x80000000) != 0;
 			// Check whether loading an important glyph fails and error out if
 			// that is the case.
-			if (!cacheGlyph(_glyphs[i], unicode)) {
-				_glyphs.erase(i);
-				if (isRequired) {
-					g_ttf.closeFont(_face);
+			if (getGlyph(i)) {
+				++numGlyphs;
+			} else if (isRequired) {
+				g_ttf.closeFont(_face);
 
-					// Don't delete ttfFile as we return fail
-					_ttfFile = 0;
+				// Don't delete ttfFile as we return fail
+				_ttfFile = 0;
 
-					return false;
-				}
+				return false;
 			}
 		}
 	}
 
-	if (_glyphs.size() == 0) {
+	if (numGlyphs == 0) {
 		g_ttf.closeFont(_face);
 
 		// Don't delete ttfFile as we return fail
@@ -553,34 +838,34 @@ int TTFFont::getMaxCharWidth() const {
 }
 
 int TTFFont::getCharWidth(uint32 chr) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end())
+	Common::StackLock lock(g_ttfGlyphCache.getMutex());
+	const Glyph *glyph = getGlyph(chr);
+	if (!glyph)
 		return 0;
 	else
-		return glyphEntry->_value.advance;
+		return glyph->advance;
 }
 
 int TTFFont::getKerningOffset(uint32 left, uint32 right) const {
 	if (!_hasKerning)
 		return 0;
 
-	assureCached(left);
-	assureCached(right);
+	Common::StackLock lock(g_ttfGlyphCache.getMutex());
 
 	FT_UInt leftGlyph, rightGlyph;
-	GlyphCache::const_iterator glyphEntry;
+	const Glyph *glyph;
 
-	glyphEntry = _glyphs.find(left);
-	if (glyphEntry != _glyphs.end()) {
-		leftGlyph = glyphEntry->_value.slot;
+	// Looking up the right glyph may evict the left one, so keep its slot only
+	glyph = getGlyph(left);
+	if (glyph) {
+		leftGlyph = glyph->slot;
 	} else {
 		return 0;
 	}
 
-	glyphEntry = _glyphs.find(right);
-	if (glyphEntry != _glyphs.end()) {
-		rightGlyph = glyphEntry->_value.slot;
+	glyph = getGlyph(right);
+	if (glyph) {
+		rightGlyph = glyph->slot;
 	} else {
 		return 0;
 	}
@@ -594,15 +879,12 @@ int TTFFont::getKerningOffset(uint32 left, uint32 right) const {
 }
 
 Common::Rect TTFFont::getBoundingBox(uint32 chr) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end()) {
+	Common::StackLock lock(g_ttfGlyphCache.getMutex());
+	const Glyph *glyph = getGlyph(chr);
+	if (!glyph) {
 		return Common::Rect();
 	} else {
-		const int xOffset = glyphEntry->_value.xOffset;
-		const int yOffset = glyphEntry->_value.yOffset;
-		const Graphics::Surface &image = glyphEntry->_value.image;
-		return Common::Rect(xOffset, yOffset, xOffset + image.w, yOffset + image.h);
+		return Common::Rect(glyph->xOffset, glyph->yOffset, glyph->xOffset + glyph->w, glyph->yOffset + glyph->h);
 	}
 }
 
@@ -674,25 +956,27 @@ void TTFFont::drawChar(ManagedSurface *dst, uint32 chr, int x, int y, uint32 col
 
 void TTFFont::drawChar(Surface * dst, uint32 chr, int x, int y, uint32 color,
 		const uint32 *transparentColor) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end())
-		return;
+	// The atlas page may be dropped by other threads once the lock is released
+	Common::StackLock lock(g_ttfGlyphCache.getMutex());
 
-	const Glyph &glyph = glyphEntry->_value;
+	const Glyph *glyph = getGlyph(chr);
+	if (!glyph || glyph->page < 0)
+		return;
 
-	x += glyph.xOffset;
-	y += glyph.yOffset;
+	x += glyph->xOffset;
+	y += glyph->yOffset;
 
 	if (x > dst->w)
 		return;
 	if (y > dst->h)
 		return;
 
-	int w = glyph.image.w;
-	int h = glyph.image.h;
+	int w = glyph->w;
+	int h = glyph->h;
 
-	const uint8 *srcPos = (const uint8 *)glyph.image.getPixels();
+	const Surface &atlas = g_ttfGlyphCache.getPage(glyph->page);
+	const uint8 *srcPos = (const uint8 *)atlas.getBasePtr(glyph->x, glyph->y);
+	const int srcPitch = atlas.pitch;
 
 	// Make sure we are not drawing outside the screen bounds
 	if (x < 0) {
@@ -708,7 +992,7 @@ void TTFFont::drawChar(Surface * dst, uint32 chr, int x, int y, uint32 color,
 		return;
 
 	if (y < 0) {
-		srcPos -= y * glyph.image.pitch;
+		srcPos -= y * srcPitch;
 		h += y;
 		y = 0;
 	}
@@ -737,21 +1021,35 @@ void TTFFont::drawChar(Surface * dst, uint32 chr, int x, int y, uint32 color,
 			}
 
 			dstPos += dst->pitch;
-			srcPos += glyph.image.pitch;
+			srcPos += srcPitch;
 		}
 	} else if (dst->format.bytesPerPixel == 1) {
-		renderGlyph<uint8>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format, transparentColor);
+		renderGlyph<uint8>(dstPos, dst->pitch, srcPos, srcPitch, w, h, color, dst->format, transparentColor);
 	} else if (dst->format.bytesPerPixel == 2) {
-		renderGlyph<uint16>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format, transparentColor);
+		renderGlyph<uint16>(dstPos, dst->pitch, srcPos, srcPitch, w, h, color, dst->format, transparentColor);
 	} else if (dst->format.bytesPerPixel == 4) {
-		renderGlyph<uint32>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format, transparentColor);
+		renderGlyph<uint32>(dstPos, dst->pitch, srcPos, srcPitch, w, h, color, dst->format, transparentColor);
 	}
 }
 
-bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
+const TTFFont::Glyph *TTFFont::getGlyph(uint32 chr) const {
+	if (!_mapping.empty()) {
+		if (chr >= _mapping.size())
+			return nullptr;
+		chr = _mapping[chr];
+	}
+
+	const Glyph *glyph = g_ttfGlyphCache.find(_faceId, chr);
+	if (!glyph)
+		glyph = cacheGlyph(chr);
+	return glyph;
+}
+
+const TTFFont::Glyph *TTFFont::cacheGlyph(uint32 chr) const {
+	Glyph glyph;
 	FT_UInt slot = FT_Get_Char_Index(_face, chr);
 	if (!slot)
-		return false;
+		return nullptr;
 
 	glyph.slot = slot;
 
@@ -759,13 +1057,13 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	// glyphs. It is most noticeable in FreeSansBold.ttf, where otherwise the
 	// 't' glyph looks like it is cut off on the right side.
 	if (FT_Load_Glyph(_face, slot, _loadFlags))
-		return false;
+		return nullptr;
 
 	if (FT_Render_Glyph(_face->glyph, _renderMode))
-		return false;
+		return nullptr;
 
 	if (_face->glyph->format != FT_GLYPH_FORMAT_BITMAP)
-		return false;
+		return nullptr;
 
 	glyph.xOffset = _face->glyph->bitmap_left;
 	glyph.yOffset = _ascent - _face->glyph->bitmap_top;
@@ -783,25 +1081,25 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 		glyph.advance += 1;
 
 		if (FT_GlyphSlot_Own_Bitmap(_face->glyph))
-			return false;
+			return nullptr;
 
 		// That's 26.6 fixed-point units
 		if (FT_Bitmap_Embolden(_face->glyph->library, &_face->glyph->bitmap, 1 << 6, 0))
-			return false;
+			return nullptr;
 
 		bitmap = &_face->glyph->bitmap;
 #elif FAKE_BOLD >= 1
 		FT_Bitmap_New(&ownBitmap);
 
 		if (FT_Bitmap_Copy(_face->glyph->library, &_face->glyph->bitmap, &ownBitmap))
-			return false;
+			return nullptr;
 
 		// Embolden by 1 pixel in x and 0 in y
 		glyph.advance += 1;
 
 		// That's 26.6 fixed-point units
 		if (FT_Bitmap_Embolden(_face->glyph->library, &ownBitmap, 1 << 6, 0))
-			return false;
+			return nullptr;
 
 		bitmap = &ownBitmap;
 #else
@@ -813,7 +1111,17 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	}
 
 
-	glyph.image.create(bitmap->width, bitmap->rows, PixelFormat::createFormatCLUT8());
+	if (bitmap->pixel_mode != FT_PIXEL_MODE_MONO && bitmap->pixel_mode != FT_PIXEL_MODE_GRAY) {
+		warning("TTFFont::cacheGlyph: Unsupported pixel mode %d", bitmap->pixel_mode);
+#if FAKE_BOLD == 1
+		if (_fakeBold)
+			FT_Bitmap_Done(_face->glyph->library, &ownBitmap);
+#endif
+		return nullptr;
+	}
+
+	int dstPitch = 0;
+	uint8 *dst = g_ttfGlyphCache.allocate(bitmap->width, bitmap->rows, glyph, dstPitch);
 
 	const uint8 *src = bitmap->buffer;
 	int srcPitch = bitmap->pitch;
@@ -822,8 +1130,6 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 		srcPitch = -srcPitch;
 	}
 
-	uint8 *dst = (uint8 *)glyph.image.getPixels();
-
 	switch (bitmap->pixel_mode) {
 	case FT_PIXEL_MODE_MONO:
 		for (int y = 0; y < (int)bitmap->rows; ++y) {
@@ -835,12 +1141,12 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 					mask = *curSrc++;
 
 				if (mask & 0x80)
-					*dst = 255;
+					dst[x] = 255;
 
 				mask <<= 1;
-				++dst;
 			}
 
+			dst += dstPitch;
 			src += srcPitch;
 		}
 		break;
@@ -848,15 +1154,13 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	case FT_PIXEL_MODE_GRAY:
 		for (int y = 0; y < (int)bitmap->rows; ++y) {
 			memcpy(dst, src, bitmap->width);
-			dst += glyph.image.pitch;
+			dst += dstPitch;
 			src += srcPitch;
 		}
 		break;
 
 	default:
-		warning("TTFFont::cacheGlyph: Unsupported pixel mode %d", bitmap->pixel_mode);
-		glyph.image.free();
-		return false;
+		break;
 	}
 
 #if FAKE_BOLD == 1
@@ -865,18 +1169,7 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	}
 #endif
 
-	return true;
-}
-
-void TTFFont::assureCached(uint32 chr) const {
-	if (!chr || !_allowLateCaching || _glyphs.contains(chr)) {
-		return;
-	}
-
-	Glyph newGlyph;
-	if (cacheGlyph(newGlyph, chr)) {
-		_glyphs[chr] = newGlyph;
-	}
+	return g_ttfGlyphCache.add(_faceId, chr, glyph);
 }
 
 Font *loadTTFFont(Common::SeekableReadStream &stream, int size, TTFSizeMode sizeMode, uint dpi, TTFRenderMode renderMode, const uint32 *mapping, bool stemDarkening) {
@@ -1084,6 +1377,7 @@ Font *findTTFace(const Common::Array<Common::String> &files, const Common::U32St
 
 namespace Common {
 DECLARE_SINGLETON(Graphics::TTFLibrary);
+DECLARE_SINGLETON(Graphics::TTFGlyphCache);
 } // End of namespace Common
 
 #endif
@@ -140,6 +140,26 @@ Font *findTTFace(const Common::Array<Common::String> &files, const Common::U32St
 
 void shutdownTTF();
 
+/**
+ * Usage statistics of the glyph cache shared by all TTF fonts.
+ */
+struct TTFGlyphCacheStats {
+	uint32 hits;          ///< glyph lookups served from the cache
+	uint32 misses;        ///< glyph lookups which required rendering
+	uint32 evictedPages;  ///< atlas pages dropped to stay within the budget
+	uint32 glyphs;        ///< glyphs currently cached
+	uint32 bytes;         ///< memory used by the atlas pages
+	uint32 budget;        ///< maximum memory for the atlas pages
+};
+
+void getTTFGlyphCacheStats(TTFGlyphCacheStats &stats);
+
+/**
+ * Set the maximum amount of memory used for cached glyph bitmaps. Glyphs
+ * in the least recently used atlas pages are dropped to honor it.
+ */
+void setTTFGlyphCacheBudget(uint32 bytes);
+
 } // End of namespace Graphics
 
 #endif
@@ -190,6 +190,7 @@ void MacText::init() {
 	_fullRefresh = true;
 
 	_textMaxWidth = 0;
+	_textMaxWidthLine = -1;
 	_textMaxHeight = 0;
 	_surface = nullptr;
 	_shadowSurface = nullptr;
@@ -885,8 +886,14 @@ void MacText::reallocSurface() {
 	}
 
 	if (_surface->w < _maxWidth || _surface->h < _textMaxHeight) {
+		// Grow the height geometrically, so that texts which are appended
+		// to line by line do not get copied over for every new line
+		int newHeight = _textMaxHeight;
+		if (_surface->h < _textMaxHeight)
+			newHeight = MAX<int>(newHeight, _surface->h + _surface->h / 2);
+
 		// realloc surface and copy old content
-		ManagedSurface *n = new ManagedSurface(_maxWidth, _textMaxHeight, _wm->_pixelformat);
+		ManagedSurface *n = new ManagedSurface(_maxWidth, newHeight, _wm->_pixelformat);
 		n->clear(_bgcolor);
 		n->blitFrom(*_surface, Common::Point(0, 0));
 
@@ -895,7 +902,7 @@ void MacText::reallocSurface() {
 
 		// same as shadow surface
 		if (_textShadow) {
-			ManagedSurface *newShadowSurface = new ManagedSurface(_maxWidth, _textMaxHeight, _wm->_pixelformat);
+			ManagedSurface *newShadowSurface = new ManagedSurface(_maxWidth, newHeight, _wm->_pixelformat);
 			newShadowSurface->clear(_bgcolor);
 			newShadowSurface->blitFrom(*_shadowSurface, Common::Point(0, 0));
 
@@ -993,7 +1000,10 @@ void MacText::render(int from, int to) {
 
 	render(from, to, 0);
 
-	for (uint i = 0; i < _textLines.size(); i++) {
+	if (gDebugLevel < 9)
+		return;
+
+	for (int i = from; i <= to; i++) {
 		debugN(9, "MacText::render: %2d ", i);
 
 		for (uint j = 0; j < _textLines[i].chunks.size(); j++)
@@ -1096,13 +1106,18 @@ void MacText::recalcDims() {
 
 	int y = 0;
 	_textMaxWidth = 0;
+	_textMaxWidthLine = -1;
 
 	for (uint i = 0; i < _textLines.size(); i++) {
 		_textLines[i].y = y;
 
 		// We must calculate width first, because it enforces
 		// the computation. Calling Height() will return cached value!
-		_textMaxWidth = MAX(_textMaxWidth, getLineWidth(i, true));
+		int width = getLineWidth(i, true);
+		if (_textMaxWidthLine == -1 || width > _textMaxWidth) {
+			_textMaxWidth = width;
+			_textMaxWidthLine = i;
+		}
 		y += MAX(getLineHeight(i), _interLinear);
 	}
 
@@ -1125,6 +1140,97 @@ void MacText::recalcDims() {
 	}
 }
 
+void MacText::relayoutLines(int from, int to) {
+	if (_textLines.empty()) {
+		recalcDims();
+		return;
+	}
+
+	const int lastLine = _textLines.size() - 1;
+	from = CLIP(from, 0, lastLine);
+	to = CLIP(to, from, lastLine);
+
+	// The lines below the changed ones still have their old positions
+	const int oldBottom = to < lastLine ? _textLines[to + 1].y : _textMaxHeight;
+	const int oldHeight = _textMaxHeight;
+
+	int y = 0;
+	if (from > 0)
+		y = _textLines[from - 1].y + MAX(getLineHeight(from - 1), _interLinear);
+
+	// The widest line has to be searched again only if it was changed or moved
+	bool rescanWidth = _textMaxWidthLine < 0 || _textMaxWidthLine >= from;
+
+	for (int i = from; i <= to; i++) {
+		_textLines[i].y = y;
+
+		int width = getLineWidth(i, true);
+		if (!rescanWidth && width > _textMaxWidth) {
+			_textMaxWidth = width;
+			_textMaxWidthLine = i;
+		}
+		y += MAX(getLineHeight(i), _interLinear);
+	}
+
+	const int dy = y - oldBottom;
+	if (dy) {
+		for (int i = to + 1; i <= lastLine; i++)
+			_textLines[i].y += dy;
+	}
+	_textMaxHeight += dy;
+
+	if (rescanWidth) {
+		// The cached widths are up to date, so this does not measure anything
+		_textMaxWidth = 0;
+		_textMaxWidthLine = -1;
+		for (int i = 0; i <= lastLine; i++) {
+			int width = getLineWidth(i);
+			if (_textMaxWidthLine == -1 || width > _textMaxWidth) {
+				_textMaxWidth = width;
+				_textMaxWidthLine = i;
+			}
+		}
+	}
+
+	if (!_fixedDims) {
+		int newBottom = _dims.top + _textMaxHeight + (2 * _border) + _gutter + _shadow;
+		if (newBottom > _dims.bottom) {
+			_dims.bottom = newBottom;
+			delete _composeSurface;
+			_composeSurface = new ManagedSurface(_dims.width(), _dims.height(), _wm->_pixelformat);
+		}
+	}
+
+	reallocSurface();
+	if (_fullRefresh) {
+		// Everything gets rendered anyway
+		render();
+	} else {
+		if (dy)
+			scrollSurface(oldBottom, oldHeight, dy);
+		render(from, to);
+	}
+
+	_contentIsDirty = true;
+}
+
+void MacText::scrollSurface(int fromY, int toY, int dy) {
+	// Move the rendered rows fromY..toY by dy, rather than rendering them
+	// again. The surface was already grown to hold the moved rows.
+	for (int s = 0; s < 2; s++) {
+		ManagedSurface *surface = s ? _shadowSurface : _surface;
+		if (!surface)
+			continue;
+
+		int rows = MIN<int>(toY, surface->h - MAX(0, dy)) - fromY;
+		if (rows > 0)
+			memmove(surface->getBasePtr(0, fromY + dy), surface->getBasePtr(0, fromY), rows * surface->pitch);
+
+		if (dy < 0)
+			surface->fillRect(Common::Rect(0, toY + dy, surface->w, MIN<int>(toY, surface->h)), _bgcolor);
+	}
+}
+
 void MacText::setAlignOffset(TextAlign align) {
 	if (_textAlignment == align)
 		return;
@@ -1257,12 +1363,11 @@ void MacText::appendText(const Common::U32String &str, const Font *font, uint16
 }
 
 void MacText::appendText_(const Common::U32String &strWithFont, uint oldLen) {
-	splitString(strWithFont);
-	recalcDims();
+	// Lines may have been removed before appending
+	oldLen = MIN<uint>(oldLen, _textLines.size());
 
-	render(oldLen - 1, _textLines.size());
-
-	_contentIsDirty = true;
+	splitString(strWithFont);
+	relayoutLines((int)oldLen - 1, _textLines.size() - 1);
 
 	if (_editable) {
 		_scrollPos = MAX<int>(0, getTextHeight() - getDimensions().height());
@@ -1284,9 +1389,7 @@ void MacText::appendTextDefault(const Common::U32String &str, bool skipAdd) {
 		_str += strWithFont;
 	}
 	splitString(strWithFont);
-	recalcDims();
-
-	render(oldLen - 1, _textLines.size());
+	relayoutLines((int)oldLen - 1, _textLines.size() - 1);
 }
 
 void MacText::appendTextDefault(const Common::String &str, bool skipAdd) {
@@ -1317,6 +1420,9 @@ void MacText::removeLastLine() {
 
 	_textLines.pop_back();
 	_textMaxHeight -= h;
+
+	if (_textMaxWidthLine >= (int)_textLines.size())
+		_textMaxWidthLine = -1;
 }
 
 void MacText::draw(ManagedSurface *g, int x, int y, int w, int h, int xoff, int yoff) {
@@ -2339,13 +2445,11 @@ void MacText::insertChar(byte c, int *row, int *col) {
 	(*col)++;
 
 	if (getLineWidth(*row) - oldw + chunkw > _maxWidth) { // Needs reshuffle
-		reshuffleParagraph(row, col);
-		_fullRefresh = true;
-		recalcDims();
-		render();
+		int start, end;
+		reshuffleParagraph(row, col, &start, &end);
+		relayoutLines(start, end);
 	} else {
-		recalcDims();
-		render(*row, *row);
+		relayoutLines(*row, *row);
 	}
 	for (int i = 0; i < (int)_textLines.size(); i++) {
 		D(9, "**insertChar line %d isEnd %d", i, _textLines[i].paragraphEnd);
@@ -2379,11 +2483,9 @@ void MacText::deleteSelection() {
 		deletePreviousCharInternal(&row, &col);
 	}
 
-	reshuffleParagraph(&row, &col);
-
-	_fullRefresh = true;
-	recalcDims();
-	render();
+	int start, end;
+	reshuffleParagraph(&row, &col, &start, &end);
+	relayoutLines(start, end);
 
 	// update cursor position
 	_cursorRow = row;
@@ -2439,11 +2541,9 @@ void MacText::deletePreviousChar(int *row, int *col) {
 	}
 	D(9, "**deleteChar cursor row %d col %d", _cursorRow, _cursorCol);
 
-	reshuffleParagraph(row, col);
-
-	_fullRefresh = true;
-	recalcDims();
-	render();
+	int start, end;
+	reshuffleParagraph(row, col, &start, &end);
+	relayoutLines(start, end);
 }
 
 void MacText::addNewLine(int *row, int *col) {
@@ -2483,7 +2583,10 @@ void MacText::addNewLine(int *row, int *col) {
 	(*row)++;
 	*col = 0;
 
-	reshuffleParagraph(row, col);
+	// The line which got split ends right before the reshuffled paragraph
+	const int splitRow = *row - 1;
+	int end;
+	reshuffleParagraph(row, col, nullptr, &end);
 
 	for (int i = 0; i < (int)_textLines.size(); i++) {
 		D(9, "** addNewLine line %d", i);
@@ -2493,12 +2596,10 @@ void MacText::addNewLine(int *row, int *col) {
 	}
 	D(9, "** addNewLine cursor row %d col %d", _cursorRow, _cursorCol);
 
-	_fullRefresh = true;
-	recalcDims();
-	render();
+	relayoutLines(splitRow, end);
 }
 
-void MacText::reshuffleParagraph(int *row, int *col) {
+void MacText::reshuffleParagraph(int *row, int *col, int *paragraphStart, int *paragraphEnd) {
 	// First, we looking for the paragraph start and end
 	int start = *row, end = *row;
 
@@ -2520,6 +2621,7 @@ void MacText::reshuffleParagraph(int *row, int *col) {
 	Common::U32String paragraph = getTextChunk(start, 0, end, getLineCharWidth(end, true), true, true);
 
 	// Remove it from the text
+	const uint oldSize = _textLines.size();
 	for (int i = start; i <= end; i++) {
 		_textLines.remove_at(start);
 	}
@@ -2528,6 +2630,14 @@ void MacText::reshuffleParagraph(int *row, int *col) {
 	D(9, "start %d end %d", start, end);
 	splitString(paragraph, start);
 
+	// Lines below the paragraph may have moved
+	_textMaxWidthLine = -1;
+
+	if (paragraphStart)
+		*paragraphStart = start;
+	if (paragraphEnd)
+		*paragraphEnd = end + (int)_textLines.size() - (int)oldSize;
+
 	// Find new pos within paragraph after reshuffling
 	*row = start;
 
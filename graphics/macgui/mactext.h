@@ -309,15 +309,24 @@ private:
 	 * Rewraps paragraph containing given text row.
 	 * When text is modified, we redo whole thing again without touching
 	 * other paragraphs. Also, cursor position is returned in the arguments
+	 * and the rows of the rewrapped paragraph in start and end, if given.
 	 */
-	void reshuffleParagraph(int *row, int *col);
+	void reshuffleParagraph(int *row, int *col, int *start = nullptr, int *end = nullptr);
 
 	void chopChunk(const Common::U32String &str, int *curLine);
 	void splitString(const Common::U32String &str, int curLine = -1);
 	void render(int from, int to, int shadow);
 	void render(int from, int to);
 	void recalcDims();
+
+	/**
+	 * Lays out and renders the lines from..to after their contents changed,
+	 * without touching the other lines. The lines below are moved along
+	 * with their already rendered pixels.
+	 */
+	void relayoutLines(int from, int to);
 	void reallocSurface();
+	void scrollSurface(int fromY, int toY, int dy);
 
 	void drawSelection(int xoff, int yoff);
 	void updateCursorPos();
@@ -353,6 +362,7 @@ protected:
 	int _selStart;
 
 	int _textMaxWidth;
+	int _textMaxWidthLine; ///< line defining _textMaxWidth, -1 when unknown
 	int _textMaxHeight;
 
 	ManagedSurface *_surface;
@@ -29,9 +29,10 @@ DECLARE_SINGLETON(GUI::EventRecorder);
 }
 
 #include "common/debug-channels.h"
-#include "backends/timer/sdl/sdl-timer.h"
 #include "backends/mixer/mixer.h"
 #include "common/config-manager.h"
+#include "common/file.h"
+#include "common/formats/json.h"
 #include "common/md5.h"
 #include "gui/gui-manager.h"
 #include "gui/widget.h"
@@ -39,6 +40,7 @@ DECLARE_SINGLETON(GUI::EventRecorder);
 #include "common/random.h"
 #include "common/savefile.h"
 #include "common/textconsole.h"
+#include "graphics/palette.h"
 #include "graphics/thumbnail.h"
 #include "graphics/surface.h"
 #include "graphics/scaler.h"
@@ -78,6 +80,13 @@ EventRecorder::EventRecorder() {
 	_screenshotPeriod = 0;
 	_playbackFile = nullptr;
 	_recordFile = nullptr;
+	_benchmark = false;
+	_benchmarkQuit = false;
+	_benchmarkFrameStart = 0;
+	_benchmarkAllocations = 0;
+	_allocationCounter = nullptr;
+	_screenshotsChecked = 0;
+	_screenshotsDifferent = 0;
 }
 
 EventRecorder::~EventRecorder() {
@@ -89,6 +98,11 @@ void EventRecorder::deinit() {
 		return;
 	}
 	setFileHeader();
+	if (_benchmark) {
+		writeBenchmarkReport();
+		_benchmark = false;
+		_benchmarkFrames.clear();
+	}
 	_needRedraw = false;
 	_initialized = false;
 	_recordMode = kPassthrough;
@@ -255,19 +269,18 @@ void EventRecorder::processScreenUpdate() {
 		_timerManager->handler();
 		break;
 	case kRecorderUpdate: // fallthrough
-	case kRecorderPlayback:
+	case kRecorderPlayback: {
 		// if the next event isn't a screen update, fast forward until we find one.
-		if (_nextEvent.recordedtype != Common::kRecorderEventTypeScreenUpdate) {
-			int numSkipped = 0;
-			while (true) {
-				_nextEvent = _playbackFile->getNextEvent();
-				numSkipped += 1;
-				if (_nextEvent.recordedtype == Common::kRecorderEventTypeScreenUpdate) {
-					warning("Skipped %d events to get to the next screen update at %d", numSkipped, _nextEvent.time);
-					break;
-				}
-			}
+		int numSkipped = 0;
+		while (_nextEvent.recordedtype != Common::kRecorderEventTypeScreenUpdate && !isPlaybackFinished()) {
+			_nextEvent = _playbackFile->getNextEvent();
+			numSkipped += 1;
 		}
+		// keep the time where the recording ended
+		if (isPlaybackFinished())
+			break;
+		if (numSkipped > 0)
+			warning("Skipped %d events to get to the next screen update at %d", numSkipped, _nextEvent.time);
 		_processingMillis = true;
 		_fakeTimer = _nextEvent.time;
 		updateSubsystems();
@@ -280,14 +293,124 @@ void EventRecorder::processScreenUpdate() {
 			takeScreenshot();
 		}
 		_timerManager->handler();
+		if (_benchmark)
+			addBenchmarkFrame();
 		_controlPanel->setReplayedTime(_fakeTimer);
 		_processingMillis = false;
 		break;
+	}
 	default:
 		break;
 	}
 }
 
+bool EventRecorder::isPlaybackFinished() const {
+	// Reading past the end of the recording yields empty events
+	return _nextEvent.recordedtype == Common::kRecorderEventTypeNormal && _nextEvent.type == Common::EVENT_INVALID;
+}
+
+void EventRecorder::startBenchmark(const Common::String &reportFileName) {
+	assert(_recordMode == kRecorderPlayback);
+	_benchmark = true;
+	_benchmarkQuit = false;
+	_benchmarkReportFileName = reportFileName;
+	_benchmarkFrames.clear();
+	_screenshotsChecked = 0;
+	_screenshotsDifferent = 0;
+	_fastPlayback = true;
+	if (_allocationCounter)
+		_benchmarkAllocations = *_allocationCounter;
+	// the first frame includes the start of the engine
+	_benchmarkFrameStart = g_system->getMicros();
+}
+
+void EventRecorder::addBenchmarkFrame() {
+	BenchmarkFrame frame;
+	frame.time = _fakeTimer;
+	frame.cpuTime = (uint32)(g_system->getMicros() - _benchmarkFrameStart);
+	frame.allocations = _allocationCounter ? *_allocationCounter - _benchmarkAllocations : 0;
+
+	// Computing the checksum is not counted as part of the frame. The screen
+	// is hashed as it is, since converting it as for recorded screenshots
+	// would take longer than most frames
+	Graphics::Surface *screen = g_system->lockScreen();
+	frame.hasMD5 = (screen != nullptr);
+	if (screen) {
+		const bool hasPalette = (screen->format.bytesPerPixel == 1);
+		Common::MemoryReadStream pixelStream((const byte *)screen->getPixels(), screen->pitch * screen->h);
+		Common::computeStreamMD5(pixelStream, frame.md5);
+		g_system->unlockScreen();
+
+		if (hasPalette) {
+			byte data[256 * 3 + 16];
+			g_system->getPaletteManager()->grabPalette(data, 0, 256);
+			memcpy(data + 256 * 3, frame.md5, 16);
+			Common::MemoryReadStream paletteStream(data, sizeof(data));
+			Common::computeStreamMD5(paletteStream, frame.md5);
+		}
+	}
+	_benchmarkFrames.push_back(frame);
+
+	if (_allocationCounter)
+		_benchmarkAllocations = *_allocationCounter;
+	_benchmarkFrameStart = g_system->getMicros();
+}
+
+void EventRecorder::writeBenchmarkReport() {
+	Common::DumpFile report;
+	if (!report.open(_benchmarkReportFileName)) {
+		warning("Can't write benchmark report to %s", _benchmarkReportFileName.c_str());
+		return;
+	}
+
+	uint64 cpuTime = 0;
+	uint64 allocations = 0;
+	for (uint i = 0; i < _benchmarkFrames.size(); i++) {
+		cpuTime += _benchmarkFrames[i].cpuTime;
+		allocations += _benchmarkFrames[i].allocations;
+	}
+
+	report.writeString("{\n");
+	report.writeString(Common::String::format("\t\"recording\": %s,\n", Common::JSONValue(_playbackFile->getHeader().fileName).stringify().c_str()));
+	report.writeString(Common::String::format("\t\"target\": %s,\n", Common::JSONValue(ConfMan.getActiveDomainName()).stringify().c_str()));
+	report.writeString(Common::String::format("\t\"frameCount\": %u,\n", _benchmarkFrames.size()));
+	report.writeString(Common::String::format("\t\"replayedTime\": %u,\n", _benchmarkFrames.empty() ? 0 : _benchmarkFrames.back().time));
+	report.writeString(Common::String::format("\t\"cpuTime\": %llu,\n", (unsigned long long)cpuTime));
+	if (_allocationCounter)
+		report.writeString(Common::String::format("\t\"allocations\": %llu,\n", (unsigned long long)allocations));
+	report.writeString(Common::String::format("\t\"screenshotsChecked\": %u,\n", _screenshotsChecked));
+	report.writeString(Common::String::format("\t\"screenshotsDifferent\": %u,\n", _screenshotsDifferent));
+	report.writeString("\t\"frames\": [");
+
+	for (uint i = 0; i < _benchmarkFrames.size(); i++) {
+		const BenchmarkFrame &frame = _benchmarkFrames[i];
+		Common::String line = Common::String::format("%s\n\t\t{\"time\": %u, \"cpuTime\": %u", i ? "," : "", frame.time, frame.cpuTime);
+		if (_allocationCounter)
+			line += Common::String::format(", \"allocations\": %u", frame.allocations);
+		if (frame.hasMD5) {
+			line += ", \"md5\": \"";
+			for (uint j = 0; j < 16; j++)
+				line += Common::String::format("%02x", frame.md5[j]);
+			line += "\"";
+		} else {
+			line += ", \"md5\": null";
+		}
+		line += "}";
+		report.writeString(line);
+	}
+
+	report.writeString("\n\t]\n}\n");
+	report.finalize();
+	report.close();
+	debugC(1, kDebugLevelEventRec, "playback:action=\"Write benchmark report\" filename=%s frames=%u", _benchmarkReportFileName.c_str(), _benchmarkFrames.size());
+}
+
+void EventRecorder::processScreenshotCheck(bool equal) {
+	_screenshotsChecked++;
+	if (!equal)
+		_screenshotsDifferent++;
+}
+
 void EventRecorder::checkForKeyCode(const Common::Event &event) {
 	if ((event.type == Common::EVENT_KEYDOWN) && (event.kbd.flags & Common::KBD_CTRL) && (event.kbd.keycode == Common::KEYCODE_p) && (!event.kbdRepeat)) {
 		togglePause();
@@ -300,6 +423,14 @@ bool EventRecorder::pollEvent(Common::Event &ev) {
 		!_initialized)
 		return false;
 
+	if (_benchmark && isPlaybackFinished()) {
+		if (_benchmarkQuit)
+			return false;
+		_benchmarkQuit = true;
+		ev.type = Common::EVENT_QUIT;
+		return true;
+	}
+
 	if (_nextEvent.recordedtype == Common::kRecorderEventTypeTimer
 	 || _nextEvent.recordedtype == Common::kRecorderEventTypeTimeDate
 	 || _nextEvent.recordedtype == Common::kRecorderEventTypeScreenUpdate
@@ -488,6 +619,10 @@ void EventRecorder::registerMixerManager(MixerManager *mixerManager) {
 	_realMixerManager = mixerManager;
 }
 
+void EventRecorder::registerAllocationCounter(const volatile uint32 *counter) {
+	_allocationCounter = counter;
+}
+
 void EventRecorder::switchMixer() {
 	if (_recordMode == kPassthrough) {
 		_realMixerManager->resumeAudio();
@@ -559,7 +694,11 @@ void EventRecorder::registerTimerManager(DefaultTimerManager *timerManager) {
 void EventRecorder::switchTimerManagers() {
 	delete _timerManager;
 	if (_recordMode == kPassthrough) {
+#ifdef SDL_BACKEND
 		_timerManager = new SdlTimerManager();
+#else
+		_timerManager = new DefaultTimerManager();
+#endif
 	} else {
 		_timerManager = new DefaultTimerManager();
 	}
@@ -699,6 +838,9 @@ Common::SaveFileManager *EventRecorder::getSaveManager(Common::SaveFileManager *
 }
 
 void EventRecorder::preDrawOverlayGui() {
+	// the benchmark has no one to show the control panel to
+	if (_benchmark)
+		return;
 	if ((_initialized) || (_needRedraw)) {
 		RecordMode oldMode = _recordMode;
 		_recordMode = kPassthrough;
@@ -716,6 +858,8 @@ void EventRecorder::preDrawOverlayGui() {
 }
 
 void EventRecorder::postDrawOverlayGui() {
+	if (_benchmark)
+		return;
 	if ((_initialized) || (_needRedraw)) {
 		RecordMode oldMode = _recordMode;
 		_recordMode = kPassthrough;
@@ -756,10 +900,12 @@ void EventRecorder::setFileHeader() {
 	_recordFile->getHeader().name = _name;
 }
 
+#ifdef SDL_BACKEND
 SDL_Surface *EventRecorder::getSurface(int width, int height) {
 	// Create a RGB565 surface of the requested dimensions.
 	return SDL_CreateRGBSurface(SDL_SWSURFACE, width, height, 16, 0xF800, 0x07E0, 0x001F, 0x0000);
 }
+#endif
 
 bool EventRecorder::switchMode() {
 	const Plugin *plugin = EngineMan.findPlugin(ConfMan.get("engineid"));
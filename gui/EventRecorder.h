@@ -38,7 +38,11 @@
 #include "backends/mixer/mixer.h"
 #include "common/hashmap.h"
 #include "common/hash-str.h"
+#ifdef SDL_BACKEND
 #include "backends/timer/sdl/sdl-timer.h"
+#else
+#include "backends/timer/default/default-timer.h"
+#endif
 #include "common/config-manager.h"
 #include "common/recorderfile.h"
 #include "backends/saves/recorder/recorder-saves.h"
@@ -147,6 +151,12 @@ public:
 	void registerMixerManager(MixerManager *mixerManager);
 	void registerTimerManager(DefaultTimerManager *timerManager);
 
+	/**
+	 * Register a counter which the backend increments on every heap
+	 * allocation, so that benchmarks can report allocations per frame.
+	 */
+	void registerAllocationCounter(const volatile uint32 *counter);
+
 	MixerManager *getMixerManager();
 	DefaultTimerManager *getTimerManager();
 
@@ -177,12 +187,24 @@ public:
 	Common::String generateRecordFileName(const Common::String &target);
 
 	Common::SaveFileManager *getSaveManager(Common::SaveFileManager *realSaveManager);
+#ifdef SDL_BACKEND
 	SDL_Surface *getSurface(int width, int height);
+#endif
 	void RegisterEventSource();
 
 	/** Retrieve game screenshot and compute its checksum for comparison */
 	bool grabScreenAndComputeMD5(Graphics::Surface &screen, uint8 md5[16]);
 
+	/** Count a recorded screenshot which was compared with the screen during playback */
+	void processScreenshotCheck(bool equal);
+
+	/**
+	 * Replay the recording without waiting, and quit once it ends. The CPU
+	 * time, allocations and screen checksum of every frame are written to
+	 * @p reportFileName as JSON. Must be called after init() in playback mode.
+	 */
+	void startBenchmark(const Common::String &reportFileName);
+
 	void updateSubsystems();
 	bool switchMode();
 	void switchFastMode();
@@ -223,6 +245,19 @@ private:
 
 	void takeScreenshot();
 
+	/** Statistics of one replayed screen update, for the benchmark report */
+	struct BenchmarkFrame {
+		uint32 time;		///< Replayed time of the screen update, in milliseconds
+		uint32 cpuTime;		///< Time spent since the previous screen update, in microseconds
+		uint32 allocations;	///< Allocations since the previous screen update
+		bool hasMD5;
+		uint8 md5[16];		///< Checksum of the screen pixels, and of the palette in 8bpp modes
+	};
+
+	bool isPlaybackFinished() const;
+	void addBenchmarkFrame();
+	void writeBenchmarkReport();
+
 	bool openRecordFile(const Common::String &fileName);
 
 	bool checkGameHash(const ADGameDescription *desc);
@@ -249,6 +284,16 @@ private:
 	bool _fastPlayback;
 	bool _needRedraw;
 	bool _processingMillis;
+
+	bool _benchmark;
+	bool _benchmarkQuit;
+	Common::String _benchmarkReportFileName;
+	Common::Array<BenchmarkFrame> _benchmarkFrames;
+	uint64 _benchmarkFrameStart;
+	uint32 _benchmarkAllocations;
+	const volatile uint32 *_allocationCounter;
+	uint32 _screenshotsChecked;
+	uint32 _screenshotsDifferent;
 };
 
 } // End of namespace GUI
@@ -87,6 +87,10 @@ struct WidgetDrawData {
 	uint16 _backgroundOffset;
 	uint16 _shadowOffset;
 
+	/** Whether the steps only draw inside the area covered by the offsets above,
+	    so that the result can be kept in the draw cache */
+	bool _cacheable;
+
 	DrawLayer _layer;
 
 
@@ -96,10 +100,141 @@ struct WidgetDrawData {
 	 * called in order to calculate if such draw steps would be drawn outside of
 	 * the actual widget drawing zone (e.g. shadows). If this is the case, a constant
 	 * value will be added when restoring the background of the widget.
+	 * It also decides whether the item can be cached.
 	 */
 	void calcBackgroundOffset();
 };
 
+/**
+ * Identifies the pixels drawn by the steps of a DrawData item. The steps
+ * blend with the pixels below, so a checksum of these is part of the key.
+ */
+struct DrawDataCacheKey {
+	DrawData type;
+	uint32 dynamic;
+	int16 width, height;	///< Size of the area covered by the steps
+	int16 areaX, areaY;		///< Position of the widget inside that area
+	int16 areaW, areaH;		///< Size of the widget
+	byte parity;			///< Screen position parity, for dithered gradients
+	uint64 background;		///< Checksum of the pixels below
+
+	bool operator==(const DrawDataCacheKey &key) const {
+		return type == key.type && dynamic == key.dynamic && width == key.width && height == key.height &&
+			areaX == key.areaX && areaY == key.areaY && areaW == key.areaW && areaH == key.areaH &&
+			parity == key.parity && background == key.background;
+	}
+};
+
+struct DrawDataCacheKey_Hash {
+	uint operator()(const DrawDataCacheKey &key) const {
+		uint hash = (uint)(key.background ^ (key.background >> 32));
+		hash = hash * 31 + key.type;
+		hash = hash * 31 + key.dynamic;
+		hash = hash * 31 + (key.width << 16 | key.height);
+		return hash;
+	}
+};
+
+/**
+ * Keeps the pixels drawn by recently drawn DrawData items, so that a widget
+ * which is drawn again over the same background is blitted instead of being
+ * rendered step by step. Entries are evicted in least recently used order
+ * once the byte budget is exceeded.
+ */
+class DrawDataCache {
+public:
+	DrawDataCache() : _bytes(0) {
+		memset(&_stats, 0, sizeof(_stats));
+		_stats.budget = kBudget;
+	}
+
+	~DrawDataCache() {
+		clear();
+	}
+
+	const Graphics::Surface *find(const DrawDataCacheKey &key) {
+		EntryMap::iterator i = _map.find(key);
+		if (i == _map.end()) {
+			_stats.misses++;
+			return nullptr;
+		}
+
+		_stats.hits++;
+
+		// Move the entry to the front of the LRU list. Surfaces do not own
+		// their pixels, so the copy keeps using them.
+		const Entry entry = *i->_value;
+		_entries.erase(i->_value);
+		_entries.push_front(entry);
+		i->_value = _entries.begin();
+		return &i->_value->surface;
+	}
+
+	void insert(const DrawDataCacheKey &key, const Graphics::Surface &src, const Common::Rect &r) {
+		const uint32 bytes = r.width() * r.height() * src.format.bytesPerPixel;
+		if (bytes > kBudget / 8 || _map.contains(key)) {
+			_stats.uncached++;
+			return;
+		}
+
+		while (!_entries.empty() && _bytes + bytes > kBudget) {
+			Entry &entry = _entries.back();
+			_bytes -= entry.surface.pitch * entry.surface.h;
+			_stats.evictions++;
+			_map.erase(entry.key);
+			entry.surface.free();
+			_entries.pop_back();
+		}
+
+		Entry entry;
+		entry.key = key;
+		_entries.push_front(entry);
+
+		Graphics::Surface &surface = _entries.front().surface;
+		surface.create(r.width(), r.height(), src.format);
+		surface.copyRectToSurface(src, 0, 0, r);
+
+		_map[key] = _entries.begin();
+		_bytes += bytes;
+	}
+
+	void clear() {
+		if (_stats.hits || _stats.misses)
+			debug(3, "ThemeEngine: Draw cache had %u hits and %u misses", _stats.hits, _stats.misses);
+
+		for (EntryList::iterator i = _entries.begin(); i != _entries.end(); ++i)
+			i->surface.free();
+		_entries.clear();
+		_map.clear();
+		_bytes = 0;
+	}
+
+	ThemeEngine::DrawCacheStats getStats() const {
+		ThemeEngine::DrawCacheStats stats = _stats;
+		stats.entries = _map.size();
+		stats.bytes = _bytes;
+		return stats;
+	}
+
+private:
+	enum {
+		kBudget = 16 * 1024 * 1024
+	};
+
+	struct Entry {
+		DrawDataCacheKey key;
+		Graphics::Surface surface;
+	};
+
+	typedef Common::List<Entry> EntryList;
+	typedef Common::HashMap<DrawDataCacheKey, EntryList::iterator, DrawDataCacheKey_Hash> EntryMap;
+
+	EntryList _entries;	///< Most recently used first
+	EntryMap _map;
+	uint32 _bytes;
+	ThemeEngine::DrawCacheStats _stats;
+};
+
 /**********************************************************
  *  Data definitions for theme engine elements
  *********************************************************/
@@ -192,7 +327,7 @@ static const DrawDataInfo kDrawDataDefaults[] = {
 ThemeEngine::ThemeEngine(Common::String id, GraphicsMode mode) :
 	_system(nullptr), _vectorRenderer(nullptr),
 	_layerToDraw(kDrawLayerBackground), _bytesPerPixel(0),  _graphicsMode(kGfxDisabled),
-	_font(nullptr), _initOk(false), _themeOk(false), _enabled(false), _themeFiles(),
+	_font(nullptr), _initOk(false), _themeOk(false), _enabled(false), _themeFiles(), _drawCache(nullptr),
 	_cursor(nullptr), _scaleFactor(1.0f) {
 
 	_baseWidth = 640;	// Default sane values
@@ -200,6 +335,7 @@ ThemeEngine::ThemeEngine(Common::String id, GraphicsMode mode) :
 
 	_system = g_system;
 	_parser = new ThemeParser(this);
+	_drawCache = new DrawDataCache();
 	_themeEval = new GUI::ThemeEval();
 	_themeEval->setScaleFactor(_scaleFactor);
 
@@ -264,6 +400,7 @@ ThemeEngine::~ThemeEngine() {
 
 	delete _parser;
 	delete _themeEval;
+	delete _drawCache;
 	delete[] _cursor;
 }
 
@@ -470,10 +607,14 @@ void ThemeEngine::setGraphicsMode(GraphicsMode mode) {
 	// list. Clearing it avoids invalid overlay writes when the backend
 	// resizes the overlay.
 	_dirtyScreen.clear();
+
+	// The new renderer may draw differently
+	_drawCache->clear();
 }
 
 void WidgetDrawData::calcBackgroundOffset() {
 	uint maxShadow = 0, maxBevel = 0;
+	_cacheable = true;
 	for (Common::List<Graphics::DrawStep>::const_iterator step = _steps.begin();
 	        step != _steps.end(); ++step) {
 		if ((step->autoWidth || step->autoHeight) && step->shadow > maxShadow)
@@ -481,12 +622,34 @@ void WidgetDrawData::calcBackgroundOffset() {
 
 		if (step->drawingCall == &Graphics::VectorRenderer::drawCallback_BEVELSQ && step->bevel > maxBevel)
 			maxBevel = step->bevel;
+
+		// Surface fills, bitmaps and shadows not accounted for above may
+		// draw outside of the area captured by the draw cache
+		if (step->drawingCall == &Graphics::VectorRenderer::drawCallback_FILLSURFACE ||
+				step->drawingCall == &Graphics::VectorRenderer::drawCallback_BITMAP ||
+				(step->shadow && !step->autoWidth && !step->autoHeight))
+			_cacheable = false;
 	}
 
 	_backgroundOffset = maxBevel;
 	_shadowOffset = maxShadow;
 }
 
+// Checksum of the pixels in an area, used as part of the draw cache keys.
+static uint64 checksumArea(const Graphics::Surface &surface, const Common::Rect &r) {
+	uint64 hash = 0xCBF29CE484222325ULL;
+	const uint bytes = r.width() * surface.format.bytesPerPixel;
+	for (int y = r.top; y < r.bottom; y++) {
+		const byte *src = (const byte *)surface.getBasePtr(r.left, y);
+		uint i = 0;
+		for (; i + 4 <= bytes; i += 4)
+			hash = (hash ^ READ_UINT32(src + i)) * 0x100000001B3ULL;
+		for (; i < bytes; i++)
+			hash = (hash ^ src[i]) * 0x100000001B3ULL;
+	}
+	return hash;
+}
+
 void ThemeEngine::restoreBackground(Common::Rect r) {
 	if (_vectorRenderer->getActiveSurface() == &_backBuffer) {
 		// Only restore the background when drawing to the screen surface
@@ -788,6 +951,8 @@ void ThemeEngine::unloadTheme() {
 	if (!_themeOk)
 		return;
 
+	_drawCache->clear();
+
 	for (int i = 0; i < kDrawDataMAX; ++i) {
 		delete _widgets[i];
 		_widgets[i] = nullptr;
@@ -934,6 +1099,10 @@ void ThemeEngine::drawDD(DrawData type, const Common::Rect &r, uint32 dynamic, b
 		extendedRect.bottom += drawData->_shadowOffset - drawData->_backgroundOffset;
 	}
 
+	// Only fully visible widgets are cached
+	const bool cacheable = drawData->_cacheable && area == r && Common::Rect(_screen.w, _screen.h).contains(extendedRect) &&
+		(_clip.isEmpty() || _clip.contains(extendedRect));
+
 	if (!_clip.isEmpty()) {
 		extendedRect.clip(_clip);
 	}
@@ -947,15 +1116,46 @@ void ThemeEngine::drawDD(DrawData type, const Common::Rect &r, uint32 dynamic, b
 		restoreBackground(extendedRect);
 
 	if (drawData->_layer == _layerToDraw) {
+		Graphics::ManagedSurface *surface = _vectorRenderer->getActiveSurface();
+
+		// Widgets drawn before over the same background are blitted from the draw cache
+		DrawDataCacheKey key;
+		if (cacheable) {
+			key.type = type;
+			key.dynamic = dynamic;
+			key.width = extendedRect.width();
+			key.height = extendedRect.height();
+			key.areaX = area.left - extendedRect.left;
+			key.areaY = area.top - extendedRect.top;
+			key.areaW = area.width();
+			key.areaH = area.height();
+			key.parity = (area.left & 1) | (area.top & 1) << 1;
+			key.background = checksumArea(surface->rawSurface(), extendedRect);
+
+			const Graphics::Surface *cached = _drawCache->find(key);
+			if (cached) {
+				surface->copyRectToSurface(cached->getPixels(), cached->pitch, extendedRect.left, extendedRect.top, cached->w, cached->h);
+				addDirtyRect(extendedRect);
+				return;
+			}
+		}
+
 		Common::List<Graphics::DrawStep>::const_iterator step;
 		for (step = drawData->_steps.begin(); step != drawData->_steps.end(); ++step) {
 			_vectorRenderer->drawStep(area, _clip, *step, dynamic);
 		}
 
+		if (cacheable)
+			_drawCache->insert(key, surface->rawSurface(), extendedRect);
+
 		addDirtyRect(extendedRect);
 	}
 }
 
+ThemeEngine::DrawCacheStats ThemeEngine::getDrawCacheStats() const {
+	return _drawCache->getStats();
+}
+
 void ThemeEngine::drawDDText(TextData type, TextColor color, const Common::Rect &r, const Common::U32String &text,
 	bool restoreBg, bool ellipsis, Graphics::TextAlign alignH, TextAlignVertical alignV,
 	int deltax, const Common::Rect &drawableTextArea) {
@@ -48,6 +48,7 @@ class VectorRenderer;
 namespace GUI {
 
 struct WidgetDrawData;
+class DrawDataCache;
 struct TextDrawData;
 struct TextColorData;
 class Dialog;
@@ -376,6 +377,23 @@ public:
 	 */
 	const Graphics::PixelFormat getPixelFormat() const { return _overlayFormat; }
 
+	/** Statistics of the draw cache, as returned by getDrawCacheStats(). */
+	struct DrawCacheStats {
+		uint32 hits;		///< DrawData items blitted from the cache
+		uint32 misses;		///< DrawData items which had to be rendered
+		uint32 evictions;	///< Items dropped to stay within the budget
+		uint32 uncached;	///< Items rendered but too large to be cached
+		uint32 entries;		///< Items in the cache
+		uint32 bytes;		///< Size of the pixels in the cache
+		uint32 budget;		///< Maximum size of the pixels in the cache
+	};
+
+	/**
+	 * Return the statistics of the draw cache. The cache keeps the pixels
+	 * drawn for DrawData items, keyed by item, size and the pixels below.
+	 */
+	DrawCacheStats getDrawCacheStats() const;
+
 	/**
 	 * Draw full screen shading with the supplied style
 	 *
@@ -783,6 +801,9 @@ protected:
 	 */
 	WidgetDrawData *_widgets[kDrawDataMAX];
 
+	/** Cache of the pixels drawn by recently used DrawData items. */
+	DrawDataCache *_drawCache;
+
 	/** Array of all the text fonts that can be drawn. */
 	TextDrawData *_texts[kTextDataMAX];
 
@@ -25,6 +25,8 @@
 #include "common/file.h"
 #include "common/debug.h"
 #include "common/debug-channels.h"
+#include "common/jobsystem.h"
+#include "common/profiler.h"
 #include "common/system.h"
 
 #ifndef DISABLE_MD5
@@ -79,6 +81,9 @@ Debugger::Debugger() {
 	registerCmd("debugflag_list",		WRAP_METHOD(Debugger, cmdDebugFlagsList));
 	registerCmd("debugflag_enable",	WRAP_METHOD(Debugger, cmdDebugFlagEnable));
 	registerCmd("debugflag_disable",	WRAP_METHOD(Debugger, cmdDebugFlagDisable));
+
+	registerCmd("jobs",				WRAP_METHOD(Debugger, cmdJobs));
+	registerCmd("profile",			WRAP_METHOD(Debugger, cmdProfile));
 }
 
 Debugger::~Debugger() {
@@ -846,6 +851,65 @@ bool Debugger::cmdDebugFlagDisable(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::cmdJobs(int argc, const char **argv) {
+	const bool reset = argc > 1 && !strcmp(argv[1], "reset");
+	if (argc > 1 && !reset) {
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	const Common::JobSystemStats stats = Common::JobSystem::instance().getStats(reset);
+	debugPrintf("Job system workers: %u, statistics over %u ms\n", stats.workers.size(), stats.elapsedTime);
+	for (uint i = 0; i < stats.workers.size(); i++) {
+		const Common::JobWorkerStats &worker = stats.workers[i];
+		const uint utilization = stats.elapsedTime ? (uint)((uint64)worker.busyTime * 100 / stats.elapsedTime) : 0;
+		debugPrintf("  %s %u: %u tasks, %u stolen, %u%% busy\n", i ? "Worker" : "Caller", i, worker.tasks, worker.steals, utilization);
+	}
+
+	if (reset)
+		debugPrintf("Statistics reset\n");
+
+	return true;
+}
+
+bool Debugger::cmdProfile(int argc, const char **argv) {
+#ifdef USE_PROFILER
+	Common::Profiler &profiler = Common::Profiler::instance();
+
+	if (argc >= 2 && !strcmp(argv[1], "start")) {
+		const int capacity = argc >= 3 ? atoi(argv[2]) : (int)Common::Profiler::kDefaultCapacity;
+		if (capacity <= 0) {
+			debugPrintf("Invalid event count\n");
+			return true;
+		}
+		profiler.start(capacity);
+		debugPrintf("Recording the last %d events\n", capacity);
+	} else if (argc == 2 && !strcmp(argv[1], "stop")) {
+		profiler.stop();
+		debugPrintf("Recording stopped, %u events kept\n", profiler.getEventCount());
+	} else if (argc == 3 && !strcmp(argv[1], "dump")) {
+		Common::DumpFile out;
+		if (!out.open(Common::Path(argv[2]))) {
+			debugPrintf("Could not open %s\n", argv[2]);
+			return true;
+		}
+		profiler.writeTrace(out);
+		out.finalize();
+		debugPrintf("Wrote %u events to %s\n", profiler.getEventCount(), argv[2]);
+	} else if (argc == 1) {
+		debugPrintf("Profiler %s, %u events kept, %u dropped\n", Common::Profiler::isRecording() ? "recording" : "stopped",
+			profiler.getEventCount(), profiler.getDroppedCount());
+		debugPrintf("Usage: %s [start [<events>] | stop | dump <file>]\n", argv[0]);
+	} else {
+		debugPrintf("Usage: %s [start [<events>] | stop | dump <file>]\n", argv[0]);
+	}
+#else
+	debugPrintf("Profiling is not available, configure with --enable-profiler\n");
+#endif
+
+	return true;
+}
+
 // Console handler
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 bool Debugger::debuggerInputCallback(GUI::ConsoleDialog *console, const char *input, void *refCon) {
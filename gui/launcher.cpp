@@ -962,6 +962,7 @@ public:
 
 	void handleCommand(CommandSender *sender, uint32 cmd, uint32 data) override;
 	void handleKeyDown(Common::KeyState state) override;
+	void handleTickle() override;
 
 	LauncherDisplayType getType() const override { return kLauncherDisplayGrid; }
 
@@ -1490,6 +1491,15 @@ void LauncherGrid::handleCommand(CommandSender *sender, uint32 cmd, uint32 data)
 	}
 }
 
+void LauncherGrid::handleTickle() {
+	LauncherDialog::handleTickle();
+
+	// The grid loads its thumbnails in its tickle, which the dialog only
+	// sends to the focused widget
+	if (getFocusWidget() != _grid)
+		_grid->handleTickle();
+}
+
 void LauncherGrid::updateListing() {
 	// Retrieve a list of all games defined in the config file
 	_domains.clear();
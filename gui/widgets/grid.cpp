@@ -20,12 +20,20 @@
  */
 
 #include "common/system.h"
+#include "common/algorithm.h"
+#include "common/config-manager.h"
+#include "common/crc.h"
 #include "common/file.h"
+#include "common/fs.h"
 #include "common/language.h"
+#include "common/memstream.h"
 #include "common/platform.h"
+#include "common/ptr.h"
 #include "common/tokenizer.h"
 #include "common/translation.h"
 
+#include "base/version.h"
+
 #include "gui/gui-manager.h"
 #include "gui/widgets/grid.h"
 
@@ -341,56 +349,224 @@ void GridItemTray::handleMouseMoved(int x, int y, int button) {
 
 #pragma mark -
 
-// Load an image file by String name, provide additional render dimensions for SVG images.
+// Read an image file from the icons set into memory. The returned data must be freed with free().
+byte *readIconFile(const Common::String &name, uint32 &size) {
+	byte *data = nullptr;
+	g_gui.lockIconsSet();
+	if (g_gui.getIconsSet().hasFile(name)) {
+		Common::SeekableReadStream *file = g_gui.getIconsSet().createReadStreamForMember(name);
+		if (file) {
+			size = file->size();
+			data = (byte *)malloc(MAX<uint32>(size, 1));
+			file->read(data, size);
+			delete file;
+		}
+	} else {
+		debug(5, "GridWidget: Cannot read file '%s'", name.c_str());
+	}
+	g_gui.unlockIconsSet();
+	return data;
+}
+
+// Decode an image file by String name, provide additional render dimensions for SVG images.
 // TODO: Add BMP support, and add scaling of non-vector images.
-Graphics::ManagedSurface *loadSurfaceFromFile(const Common::String &name, int renderWidth = 0, int renderHeight = 0) {
+Graphics::ManagedSurface *decodeSurface(const Common::String &name, Common::SeekableReadStream &stream, int renderWidth = 0, int renderHeight = 0) {
 	Graphics::ManagedSurface *surf = nullptr;
 	if (name.hasSuffix(".png")) {
 #ifdef USE_PNG
-		const Graphics::Surface *srcSurface = nullptr;
 		Image::PNGDecoder decoder;
-		g_gui.lockIconsSet();
-		if (g_gui.getIconsSet().hasFile(name)) {
-			Common::SeekableReadStream *stream = g_gui.getIconsSet().createReadStreamForMember(name);
-			if (!decoder.loadStream(*stream)) {
-				g_gui.unlockIconsSet();
-				warning("Error decoding PNG");
-				return surf;
-			}
+		if (!decoder.loadStream(stream)) {
+			warning("Error decoding PNG");
+			return surf;
+		}
 
-			srcSurface = decoder.getSurface();
-			delete stream;
-			if (!srcSurface) {
-				warning("Failed to load surface : %s", name.c_str());
-			} else if (srcSurface->format.bytesPerPixel != 1) {
-				surf = new Graphics::ManagedSurface(srcSurface);
-			}
-		} else {
-			debug(5, "GridWidget: Cannot read file '%s'", name.c_str());
+		const Graphics::Surface *srcSurface = decoder.getSurface();
+		if (!srcSurface) {
+			warning("Failed to load surface : %s", name.c_str());
+		} else if (srcSurface->format.bytesPerPixel != 1) {
+			surf = new Graphics::ManagedSurface(srcSurface);
 		}
-		g_gui.unlockIconsSet();
 #else
 		error("No PNG support compiled");
 #endif
 	} else if (name.hasSuffix(".svg")) {
-		g_gui.lockIconsSet();
-		if (g_gui.getIconsSet().hasFile(name)) {
-			Common::SeekableReadStream *stream = g_gui.getIconsSet().createReadStreamForMember(name);
-			surf = new Graphics::SVGBitmap(stream, renderWidth, renderHeight);
-			delete stream;
-		} else {
-			debug(5, "GridWidget: Cannot read file '%s'", name.c_str());
+		surf = new Graphics::SVGBitmap(&stream, renderWidth, renderHeight);
+	}
+	return surf;
+}
+
+// Load an image file by String name, provide additional render dimensions for SVG images.
+Graphics::ManagedSurface *loadSurfaceFromFile(const Common::String &name, int renderWidth = 0, int renderHeight = 0) {
+	uint32 size;
+	byte *data = readIconFile(name, size);
+	if (!data)
+		return nullptr;
+
+	Common::MemoryReadStream stream(data, size, DisposeAfterUse::YES);
+	return decodeSurface(name, stream, renderWidth, renderHeight);
+}
+
+#pragma mark -
+
+enum {
+	kThumbnailCacheVersion = 2
+};
+
+// Return a stamp which changes whenever the icons set may have changed. The
+// icons live in zip packs whose members have no usable modification time,
+// so the names and sizes of the packs and the ScummVM version, which selects
+// the default pack, stand in for it.
+uint32 iconsSetStamp() {
+	Common::String packsList(gScummVMVersion);
+
+	if (ConfMan.hasKey("iconspath") && !ConfMan.get("iconspath").empty()) {
+		Common::FSDirectory iconDir(ConfMan.get("iconspath"));
+		Common::ArchiveMemberList packs;
+		iconDir.listMatchingMembers(packs, "gui-icons*.dat");
+		Common::sort(packs.begin(), packs.end(), Common::ArchiveMemberListComparator());
+
+		for (Common::ArchiveMemberList::iterator i = packs.begin(); i != packs.end(); ++i) {
+			Common::ScopedPtr<Common::SeekableReadStream> pack((*i)->createReadStream());
+			packsList += Common::String::format("|%s:%d", (*i)->getName().c_str(), pack ? (int)pack->size() : -1);
 		}
-		g_gui.unlockIconsSet();
 	}
+
+	return Common::CRC32().crcFast((const byte *)packsList.c_str(), packsList.size());
+}
+
+// Return the directory of the scaled thumbnail cache, which lives next to the
+// downloaded icon packs.
+Common::FSNode thumbnailCacheDir() {
+	if (!ConfMan.hasKey("iconspath") || ConfMan.get("iconspath").empty())
+		return Common::FSNode();
+
+	return Common::FSNode(ConfMan.get("iconspath")).getChild("thumbnails");
+}
+
+// The cache file of a thumbnail. There is one file per image, holding the
+// last size it was scaled to, so a stale or resized thumbnail replaces the
+// old file and the cache never holds more files than there are icons.
+Common::String thumbnailCacheName(const Common::String &name) {
+	return Common::String::format("%08x.thb", (uint32)Common::hashit(name.c_str()));
+}
+
+Graphics::ManagedSurface *loadCachedThumbnail(const Common::String &name, uint32 stamp, int width, int height) {
+	Common::FSNode dir = thumbnailCacheDir();
+	if (!dir.exists())
+		return nullptr;
+
+	Common::FSNode node = dir.getChild(thumbnailCacheName(name));
+	if (!node.exists())
+		return nullptr;
+
+	Common::File file;
+	if (!file.open(node))
+		return nullptr;
+
+	if (file.readUint32BE() != MKTAG('G', 'T', 'H', 'B') || file.readUint32LE() != kThumbnailCacheVersion ||
+			file.readUint32LE() != stamp || file.readUint16LE() != width || file.readUint16LE() != height)
+		return nullptr;
+
+	// Different images may share a file name
+	if (file.readString() != name)
+		return nullptr;
+
+	const uint16 w = file.readUint16LE();
+	const uint16 h = file.readUint16LE();
+
+	Graphics::PixelFormat format;
+	format.bytesPerPixel = file.readByte();
+	format.rLoss = file.readByte();
+	format.gLoss = file.readByte();
+	format.bLoss = file.readByte();
+	format.aLoss = file.readByte();
+	format.rShift = file.readByte();
+	format.gShift = file.readByte();
+	format.bShift = file.readByte();
+	format.aShift = file.readByte();
+
+	if (!w || !h || w > width || h > height || (format.bytesPerPixel != 2 && format.bytesPerPixel != 4))
+		return nullptr;
+
+	Graphics::ManagedSurface *surf = new Graphics::ManagedSurface(w, h, format);
+	for (int y = 0; y < h; y++)
+		file.read(surf->getBasePtr(0, y), w * format.bytesPerPixel);
+
+	if (file.err() || file.eos()) {
+		delete surf;
+		return nullptr;
+	}
+
 	return surf;
 }
 
+void saveCachedThumbnail(const Common::String &name, uint32 stamp, int width, int height, const Graphics::ManagedSurface &surf) {
+	Common::FSNode dir = thumbnailCacheDir();
+	if (!dir.exists() && !dir.createDirectory())
+		return;
+
+	Common::DumpFile file;
+	if (!file.open(dir.getChild(thumbnailCacheName(name))))
+		return;
+
+	const Graphics::PixelFormat &format = surf.format;
+
+	file.writeUint32BE(MKTAG('G', 'T', 'H', 'B'));
+	file.writeUint32LE(kThumbnailCacheVersion);
+	file.writeUint32LE(stamp);
+	file.writeUint16LE(width);
+	file.writeUint16LE(height);
+	file.writeString(name);
+	file.writeByte(0);
+	file.writeUint16LE(surf.w);
+	file.writeUint16LE(surf.h);
+	file.writeByte(format.bytesPerPixel);
+	file.writeByte(format.rLoss);
+	file.writeByte(format.gLoss);
+	file.writeByte(format.bLoss);
+	file.writeByte(format.aLoss);
+	file.writeByte(format.rShift);
+	file.writeByte(format.gShift);
+	file.writeByte(format.bShift);
+	file.writeByte(format.aShift);
+
+	for (int y = 0; y < surf.h; y++)
+		file.write(surf.getBasePtr(0, y), surf.w * format.bytesPerPixel);
+
+	if (!file.flush() || file.err())
+		warning("GridWidget: Failed to write the cached thumbnail of '%s'", name.c_str());
+}
+
+// Load a thumbnail scaled to fit in width x height, preferably from the
+// thumbnail cache, in which case the image itself is not read.
+const Graphics::ManagedSurface *loadThumbnail(const Common::String &name, uint32 stamp, int width, int height) {
+	const Graphics::ManagedSurface *scSurf = loadCachedThumbnail(name, stamp, width, height);
+	if (scSurf)
+		return scSurf;
+
+	Graphics::ManagedSurface *surf = loadSurfaceFromFile(name);
+	if (!surf)
+		return nullptr;
+
+	scSurf = scaleGfx(surf, width, height, true);
+	if (surf != scSurf) {
+		surf->free();
+		delete surf;
+	}
+
+	if (scSurf->format.bytesPerPixel == 2 || scSurf->format.bytesPerPixel == 4)
+		saveCachedThumbnail(name, stamp, width, height, *scSurf);
+
+	return scSurf;
+}
+
 #pragma mark -
 
 GridWidget::GridWidget(GuiObject *boss, const Common::String &name)
 	: ContainerWidget(boss, name), CommandSender(boss) {
 
+	setFlags(WIDGET_WANT_TICKLE);
+
 	_thumbnailHeight = 0;
 	_thumbnailWidth = 0;
 	_flagIconHeight = 0;
@@ -433,6 +609,9 @@ GridWidget::GridWidget(GuiObject *boss, const Common::String &name)
 
 	_selectedEntry = nullptr;
 	_isGridInvalid = true;
+
+	// The launcher is rebuilt when the icons set changes
+	_iconsStamp = iconsSetStamp();
 }
 
 GridWidget::~GridWidget() {
@@ -459,7 +638,8 @@ void GridWidget::unloadSurfaces(Common::HashMap<T, const Graphics::ManagedSurfac
 const Graphics::ManagedSurface *GridWidget::filenameToSurface(const Common::String &name) {
 	if (name.empty())
 		return nullptr;
-	return _loadedSurfaces[name];
+	// Thumbnails which are not loaded yet show the title as a placeholder
+	return _loadedSurfaces.getValOrDefault(name, nullptr);
 }
 
 const Graphics::ManagedSurface *GridWidget::languageToSurface(Common::Language languageCode) {
@@ -682,41 +862,61 @@ void GridWidget::setGroupHeaderFormat(const Common::U32String &prefix, const Com
 }
 
 void GridWidget::reloadThumbnails() {
+	// Only queue the thumbnails here, handleTickle() loads them a few at a
+	// time, so that the GUI stays responsive with large game libraries.
+	// They are queued in reverse, so that the first one is at the back.
+	_pendingThumbnails.clear();
+	for (uint i = _visibleEntryList.size(); i > 0; --i) {
+		GridItemInfo *entry = _visibleEntryList[i - 1];
+		if (entry->thumbPath.empty() || _loadedSurfaces.contains(entry->thumbPath))
+			continue;
+
+		PendingThumbnail pending;
+		pending.thumbPath = entry->thumbPath;
+		pending.engineid = entry->engineid;
+		_pendingThumbnails.push_back(pending);
+	}
+}
+
+void GridWidget::loadPendingThumbnail(const PendingThumbnail &pending) {
+	if (_loadedSurfaces.contains(pending.thumbPath))
+		return;
+
 	const int thumbnailWidth = MAX(_thumbnailWidth - 2 * _thumbnailMargin, 0);
 	const int thumbnailHeight = MAX(_thumbnailHeight - 2 * _thumbnailMargin, 0);
-	for (Common::Array<GridItemInfo *>::iterator iter = _visibleEntryList.begin(); iter != _visibleEntryList.end(); ++iter) {
-		GridItemInfo *entry = *iter;
-		if (entry->thumbPath.empty())
-			continue;
 
-		if (!_loadedSurfaces.contains(entry->thumbPath)) {
-			_loadedSurfaces[entry->thumbPath] = nullptr;
-			Common::String path = Common::String::format("icons/%s-%s.png", entry->engineid.c_str(), entry->gameid.c_str());
-			Graphics::ManagedSurface *surf = loadSurfaceFromFile(path);
-			if (!surf) {
-				path = Common::String::format("icons/%s.png", entry->engineid.c_str());
-				if (!_loadedSurfaces.contains(path)) {
-					surf = loadSurfaceFromFile(path);
-				} else {
-					const Graphics::ManagedSurface *scSurf = _loadedSurfaces[path];
-					_loadedSurfaces[entry->thumbPath] = new Graphics::ManagedSurface(*scSurf);
-				}
-			}
+	const Graphics::ManagedSurface *scSurf = loadThumbnail(pending.thumbPath, _iconsStamp, thumbnailWidth, thumbnailHeight);
+	if (scSurf) {
+		_loadedSurfaces[pending.thumbPath] = scSurf;
+		return;
+	}
 
-			if (surf) {
-				const Graphics::ManagedSurface *scSurf(scaleGfx(surf, thumbnailWidth, thumbnailHeight, true));
-				_loadedSurfaces[entry->thumbPath] = scSurf;
+	// Fall back to the icon of the engine
+	Common::String path = Common::String::format("icons/%s.png", pending.engineid.c_str());
+	if (!_loadedSurfaces.contains(path))
+		_loadedSurfaces[path] = loadThumbnail(path, _iconsStamp, thumbnailWidth, thumbnailHeight);
 
-				if (path != entry->thumbPath) {
-					_loadedSurfaces[path] = new Graphics::ManagedSurface(*scSurf);
-				}
+	scSurf = _loadedSurfaces[path];
+	_loadedSurfaces[pending.thumbPath] = scSurf ? new Graphics::ManagedSurface(*scSurf) : nullptr;
+}
 
-				if (surf != scSurf) {
-					surf->free();
-					delete surf;
-				}
-			}
-		}
+void GridWidget::handleTickle() {
+	if (_pendingThumbnails.empty())
+		return;
+
+	const uint32 start = g_system->getMillis();
+	Common::StringArray loaded;
+	do {
+		loadPendingThumbnail(_pendingThumbnails.back());
+		loaded.push_back(_pendingThumbnails.back().thumbPath);
+		_pendingThumbnails.pop_back();
+	} while (!_pendingThumbnails.empty() && g_system->getMillis() - start < kThumbnailLoadTime);
+
+	// Replace the placeholders of the loaded thumbnails
+	for (uint k = 0; k < _gridItems.size(); ++k) {
+		const GridItemInfo *entry = _gridItems[k]->getActiveEntry();
+		if (_gridItems[k]->isVisible() && entry && Common::find(loaded.begin(), loaded.end(), entry->thumbPath) != loaded.end())
+			_gridItems[k]->update();
 	}
 }
 
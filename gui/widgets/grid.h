@@ -105,6 +105,21 @@ protected:
 	// Images are mapped by filename -> surface.
 	Common::HashMap<Common::String, const Graphics::ManagedSurface *> _loadedSurfaces;
 
+	enum {
+		kThumbnailLoadTime = 15	///< Time in ms to spend on loading thumbnails per tickle
+	};
+
+	struct PendingThumbnail {
+		Common::String thumbPath;
+		Common::String engineid;
+	};
+
+	// Thumbnails of visible entries which are not loaded yet, last to load first, see handleTickle().
+	Common::Array<PendingThumbnail> _pendingThumbnails;
+	uint32 _iconsStamp;	///< Identifies the icons set in the thumbnail cache
+
+	void loadPendingThumbnail(const PendingThumbnail &pending);
+
 	Common::Array<GridItemInfo>			_dataEntryList;
 	Common::Array<GridItemInfo>			_headerEntryList;
 	Common::Array<GridItemInfo *>		_sortedEntryList;
@@ -213,6 +228,7 @@ public:
 
 	void handleMouseWheel(int x, int y, int direction) override;
 	void handleCommand(CommandSender *sender, uint32 cmd, uint32 data) override;
+	void handleTickle() override;
 	void reflowLayout() override;
 
 	bool wantsFocus() override { return true; }
@@ -241,6 +257,7 @@ public:
 	void update();
 	void updateThumb();
 	void setActiveEntry(GridItemInfo &entry);
+	const GridItemInfo *getActiveEntry() const { return _activeEntry; }
 
 	void drawWidget() override;
 
@@ -0,0 +1,153 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/softsynth/emumidi.h"
+#include "common/config-manager.h"
+
+#include "../null_osystem.h"
+
+/**
+ * An emulated MIDI driver which records the frame at which each event is
+ * played, instead of synthesizing anything.
+ */
+class EmulatedMidiTestDriver : public MidiDriver_Emulated {
+public:
+	struct PlayedEvent {
+		uint32 msg;
+		uint32 frame;
+	};
+
+	EmulatedMidiTestDriver() : MidiDriver_Emulated(nullptr), _frames(0) {}
+	~EmulatedMidiTestDriver() override { close(); }
+
+	void close() override {
+		_isOpen = false;
+		stopRenderAhead();
+	}
+
+	void send(uint32 b) override {
+		midiDriverCommonSend(b);
+
+		if (!queueEvent(b))
+			playEvent(b);
+	}
+
+	MidiChannel *allocateChannel() override { return nullptr; }
+	MidiChannel *getPercussionChannel() override { return nullptr; }
+
+	bool isStereo() const override { return false; }
+	int getRate() const override { return 22050; }
+
+	bool renderingAhead() const { return isRenderingAhead(); }
+
+	void render(uint frames) {
+		Common::Array<int16> buffer(frames);
+		readBuffer(&buffer[0], frames);
+	}
+
+	/** Return the number of notes sounding after playing all events. */
+	uint countSounding() const {
+		bool sounding[16][128];
+		memset(sounding, 0, sizeof(sounding));
+
+		for (uint i = 0; i < _played.size(); i++) {
+			const uint32 b = _played[i].msg;
+			const byte channel = b & 0x0F;
+			const byte note = (b >> 8) & 0x7F;
+			if ((b & 0xF0) == 0x80 || ((b & 0xF0) == 0x90 && !(b >> 16)))
+				sounding[channel][note] = false;
+			else if ((b & 0xF0) == 0x90)
+				sounding[channel][note] = true;
+			else if ((b & 0xF0) == 0xB0 && note == 0x7B)
+				memset(sounding[channel], 0, sizeof(sounding[channel]));
+		}
+
+		uint count = 0;
+		for (uint i = 0; i < 16; i++)
+			for (uint j = 0; j < 128; j++)
+				count += sounding[i][j];
+		return count;
+	}
+
+	Common::Array<PlayedEvent> _played;
+
+protected:
+	void generateSamples(int16 *buf, int len) override {
+		memset(buf, 0, len * sizeof(int16));
+		_frames += len;
+	}
+
+	bool supportsEventQueue() const override { return true; }
+
+	void playEvent(uint32 b) override {
+		PlayedEvent event;
+		event.msg = b;
+		event.frame = _frames;
+		_played.push_back(event);
+	}
+
+private:
+	uint32 _frames;
+};
+
+class EmulatedMidiDriverTestSuite : public CxxTest::TestSuite
+{
+	enum {
+		kNoteOn = 0x7F3C90,
+		kNoteOff = 0x003C80,
+		kAllNotesOff = 0x007BB0
+	};
+
+	// A delayed note on followed by an undelayed note off and all notes off
+	static void checkNoHangingNote(uint32 delayedFrame) {
+		EmulatedMidiTestDriver driver;
+		driver.open();
+
+		// 10 ms is 220 frames at 22050 Hz
+		driver.sendDelayed(0, kNoteOn, 10000);
+		driver.send(kNoteOff);
+		driver.send(kAllNotesOff);
+
+		// Nothing may be played before the note on
+		TS_ASSERT(driver._played.empty());
+
+		driver.render(2048);
+
+		TS_ASSERT_EQUALS(driver._played.size(), 3U);
+		if (driver._played.size() == 3) {
+			TS_ASSERT_EQUALS(driver._played[0].msg, (uint32)kNoteOn);
+			TS_ASSERT_EQUALS(driver._played[0].frame, delayedFrame);
+			TS_ASSERT_EQUALS(driver._played[1].msg, (uint32)kNoteOff);
+			TS_ASSERT_EQUALS(driver._played[1].frame, delayedFrame);
+			TS_ASSERT_EQUALS(driver._played[2].msg, (uint32)kAllNotesOff);
+			TS_ASSERT_EQUALS(driver._played[2].frame, delayedFrame);
+		}
+		TS_ASSERT_EQUALS(driver.countSounding(), 0U);
+
+		// Once the queue is empty, events are played right away again
+		driver._played.clear();
+		driver.send(kNoteOn);
+		TS_ASSERT_EQUALS(driver._played.size(), driver.renderingAhead() ? 0U : 1U);
+	}
+
+public:
+	void test_undelayed_events_keep_order() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		// Without rendering ahead, the delayed event is played 220 frames
+		// into the stream
+		checkNoHangingNote(220);
+#endif
+	}
+
+	void test_undelayed_events_keep_order_rendering_ahead() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		// Rendering 20 ms ahead delays all events by 441 frames
+		ConfMan.set("midi_render_ahead", "20", Common::ConfigManager::kTransientDomain);
+		checkNoHangingNote(441 + 220);
+		ConfMan.removeKey("midi_render_ahead", Common::ConfigManager::kTransientDomain);
+#endif
+	}
+};
@@ -0,0 +1,107 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/softsynth/emumidi_queue.h"
+
+class EmulatedMidiEventQueueTestSuite : public CxxTest::TestSuite
+{
+	// Plays the events due at each frame up to @p end and tracks which
+	// notes are sounding, the way a driver would
+	struct Player {
+		bool sounding[16][128];
+
+		Player() {
+			memset(sounding, 0, sizeof(sounding));
+		}
+
+		void run(EmulatedMidiEventQueue &queue, uint32 begin, uint32 end) {
+			for (uint32 frame = begin; frame < end; frame++) {
+				EmulatedMidiEventQueue::Event event;
+				while (queue.popDue(frame, event))
+					play(event.msg);
+			}
+		}
+
+		void play(uint32 b) {
+			const byte channel = b & 0x0F;
+			const byte note = (b >> 8) & 0x7F;
+			switch (b & 0xF0) {
+			case 0x80:
+				sounding[channel][note] = false;
+				break;
+			case 0x90:
+				sounding[channel][note] = ((b >> 16) & 0x7F) != 0;
+				break;
+			case 0xB0:
+				// All notes off
+				if (note == 0x7B)
+					memset(sounding[channel], 0, sizeof(sounding[channel]));
+				break;
+			default:
+				break;
+			}
+		}
+
+		uint countSounding() const {
+			uint count = 0;
+			for (uint i = 0; i < 16; i++)
+				for (uint j = 0; j < 128; j++)
+					count += sounding[i][j];
+			return count;
+		}
+	};
+
+	static void push(EmulatedMidiEventQueue &queue, uint32 msg, uint32 timestamp, bool delayed) {
+		EmulatedMidiEventQueue::Event event;
+		event.msg = msg;
+		event.timestamp = timestamp;
+		queue.push(event, delayed);
+	}
+
+public:
+	void test_delayed_note_on_then_all_notes_off() {
+		EmulatedMidiEventQueue queue;
+		Player player;
+
+		// A note on 100 frames ahead, then all notes off right away
+		push(queue, 0x7F3C90, 100, true);
+		push(queue, 0x007BB0, 0, false);
+
+		player.run(queue, 0, 1000);
+		TS_ASSERT_EQUALS(player.countSounding(), 0U);
+		TS_ASSERT(queue.empty());
+	}
+
+	void test_order() {
+		EmulatedMidiEventQueue queue;
+
+		push(queue, 1, 50, true);
+		push(queue, 2, 10, true);
+		push(queue, 3, 50, true);
+		push(queue, 4, 20, true);
+
+		TS_ASSERT_EQUALS(queue.framesUntilNext(0, 1000), 10U);
+		TS_ASSERT_EQUALS(queue.framesUntilNext(0, 5), 5U);
+
+		EmulatedMidiEventQueue::Event event;
+		TS_ASSERT(!queue.popDue(9, event));
+
+		// Delayed events are sorted, and keep their order when due at the same frame
+		const uint32 expected[] = { 2, 4, 1, 3 };
+		for (uint i = 0; i < ARRAYSIZE(expected); i++) {
+			TS_ASSERT(queue.popDue(50, event));
+			TS_ASSERT_EQUALS(event.msg, expected[i]);
+		}
+		TS_ASSERT(queue.empty());
+	}
+
+	void test_undelayed_event_due_now() {
+		EmulatedMidiEventQueue queue;
+
+		// Without pending delayed events, an event keeps its own timestamp
+		push(queue, 1, 30, false);
+
+		EmulatedMidiEventQueue::Event event;
+		TS_ASSERT(queue.popDue(30, event));
+		TS_ASSERT_EQUALS(event.msg, 1U);
+	}
+};
@@ -0,0 +1,128 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "audio/audiostream.h"
+#include "audio/decoders/mp3.h"
+
+#include "common/array.h"
+#include "common/config-manager.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
+
+class MP3StreamSeekTestSuite : public CxxTest::TestSuite
+{
+#ifdef USE_MAD
+	enum {
+		kFrames = 100,
+		kRate = 32000,
+		kSamplesPerFrame = 384,	// Layer I
+		kFrameSize = 192		// 128 kbit/s at 32 kHz
+	};
+
+	/**
+	 * Build a mono MPEG-1 Layer I stream whose frames all sound different,
+	 * so that a seek landing on the wrong frame is noticed. Only the lowest
+	 * subband is allocated.
+	 */
+	static byte *makeStream(uint32 &size) {
+		size = kFrames * kFrameSize;
+		byte *data = (byte *)calloc(size, 1);
+
+		for (uint32 frame = 0; frame < kFrames; frame++) {
+			byte *p = data + frame * kFrameSize;
+			uint32 bit = 0;
+			putBits(p, bit, 0xFFF, 12);	// sync
+			putBits(p, bit, 1, 1);		// MPEG-1
+			putBits(p, bit, 3, 2);		// Layer I
+			putBits(p, bit, 1, 1);		// no CRC
+			putBits(p, bit, 4, 4);		// 128 kbit/s
+			putBits(p, bit, 2, 2);		// 32 kHz
+			putBits(p, bit, 0, 2);		// no padding, private bit
+			putBits(p, bit, 3, 2);		// single channel
+			putBits(p, bit, 0, 6);		// mode extension, copyright, original, emphasis
+
+			// 4 bit samples in subband 0, nothing in the other subbands
+			putBits(p, bit, 3, 4);
+			bit += 31 * 4;
+			putBits(p, bit, 10 + frame % 40, 6);
+
+			for (uint32 s = 0; s < 12; s++)
+				putBits(p, bit, (frame * 7 + s * 3) % 15, 4);
+		}
+
+		return data;
+	}
+
+	static void putBits(byte *p, uint32 &bit, uint32 value, uint32 count) {
+		while (count--) {
+			if (value & (1 << count))
+				p[bit / 8] |= 0x80 >> (bit % 8);
+			bit++;
+		}
+	}
+
+	static Audio::SeekableAudioStream *openStream(const byte *data, uint32 size) {
+		return Audio::makeMP3Stream(new Common::MemoryReadStream(data, size), DisposeAfterUse::YES);
+	}
+#endif
+
+public:
+	void test_seek_matches_linear_decode() {
+#ifdef USE_MAD
+		ConfMan.setBool("mp3_seek_index_cache", false, Common::ConfigManager::kTransientDomain);
+
+		uint32 size;
+		byte *data = makeStream(size);
+
+		const uint32 samples = kFrames * kSamplesPerFrame;
+		Common::Array<int16> linear(samples + 1);
+		{
+			Common::ScopedPtr<Audio::SeekableAudioStream> stream(openStream(data, size));
+			TS_ASSERT(stream);
+			if (!stream) {
+				free(data);
+				return;
+			}
+			TS_ASSERT_EQUALS(stream->getRate(), (int)kRate);
+			TS_ASSERT_EQUALS(stream->getLength().convertToFramerate(kRate).totalNumberOfFrames(), (int)samples);
+			TS_ASSERT_EQUALS(stream->readBuffer(&linear[0], samples + 1), (int)samples);
+		}
+
+		// Seek back and forth across and between indexed frames. The
+		// synthesis filter restarts at the seek target, so the samples of its
+		// first two frames may differ from those of the linear decode.
+		Common::ScopedPtr<Audio::SeekableAudioStream> stream(openStream(data, size));
+		static const uint32 targets[] = { 90, 3, 50, 17, 16, 33, 0, 64, 65, 99, 48, 1 };
+		const uint32 warmUp = 2 * kSamplesPerFrame;
+
+		for (uint i = 0; i < ARRAYSIZE(targets); i++) {
+			const uint32 start = targets[i] * kSamplesPerFrame;
+			TS_ASSERT(stream->seek(Audio::Timestamp(0, start, kRate)));
+
+			int16 buffer[6 * kSamplesPerFrame];
+			const uint32 wanted = MIN<uint32>(ARRAYSIZE(buffer), samples - start);
+			TS_ASSERT_EQUALS(stream->readBuffer(buffer, wanted), (int)wanted);
+
+			const uint32 from = start ? warmUp : 0;
+			for (uint32 j = from; j < wanted; j++) {
+				if (buffer[j] != linear[start + j]) {
+					TS_FAIL("Seeking to a frame decodes other samples than reading up to it");
+					break;
+				}
+			}
+		}
+
+		// Seeking to the end succeeds, seeking past it fails
+		TS_ASSERT(stream->seek(stream->getLength()));
+		TS_ASSERT(stream->endOfData());
+		TS_ASSERT(!stream->seek(Audio::Timestamp(0, samples + kSamplesPerFrame, kRate)));
+
+		stream.reset();
+		free(data);
+		ConfMan.removeKey("mp3_seek_index_cache", Common::ConfigManager::kTransientDomain);
+#endif
+	}
+};
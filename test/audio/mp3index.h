@@ -0,0 +1,79 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/decoders/mp3index.h"
+
+#include "common/hash-str.h"
+#include "common/memstream.h"
+
+class MP3SeekIndexCacheTestSuite : public CxxTest::TestSuite
+{
+public:
+	void test_read_write() {
+		Audio::MP3SeekIndexKey key;
+		key.size = 5 * 1024 * 1024;
+		key.crc = 0x12345678;
+
+		Audio::MP3SeekIndex index;
+		index.rate = 44100;
+		index.samplesPerFrame = 1152;
+		index.lengthMs = 120000;
+		index.frames = 4595;
+		index.interval = 16;
+		for (uint32 i = 0; i < (index.frames + index.interval - 1) / index.interval; i++)
+			index.offsets.push_back(i * 16 * 417);
+
+		Common::MemoryWriteStreamDynamic out(DisposeAfterUse::YES);
+		Audio::MP3SeekIndexCache::write(out, key, index);
+
+		Common::MemoryReadStream in(out.getData(), out.size());
+		Audio::MP3SeekIndex result;
+		TS_ASSERT(Audio::MP3SeekIndexCache::read(in, key, result));
+		TS_ASSERT_EQUALS(result.rate, index.rate);
+		TS_ASSERT_EQUALS(result.samplesPerFrame, index.samplesPerFrame);
+		TS_ASSERT_EQUALS(result.lengthMs, index.lengthMs);
+		TS_ASSERT_EQUALS(result.frames, index.frames);
+		TS_ASSERT_EQUALS(result.interval, index.interval);
+		TS_ASSERT(result.offsets == index.offsets);
+
+		// A slot holding the index of another stream is not used
+		Audio::MP3SeekIndexKey other = key;
+		other.crc++;
+		Common::MemoryReadStream in2(out.getData(), out.size());
+		TS_ASSERT(!Audio::MP3SeekIndexCache::read(in2, other, result));
+
+		// Nor is a truncated slot
+		Common::MemoryReadStream in3(out.getData(), out.size() - 4);
+		TS_ASSERT(!Audio::MP3SeekIndexCache::read(in3, key, result));
+	}
+
+	void test_key() {
+		// Small streams are not cached
+		byte small[1024] = {};
+		Common::MemoryReadStream smallStream(small, sizeof(small));
+		TS_ASSERT(!Audio::MP3SeekIndexCache::computeKey(smallStream).isValid());
+
+		const uint32 size = Audio::MP3SeekIndexCache::kMinStreamSize + 4096;
+		byte *data = (byte *)calloc(size, 1);
+		Common::MemoryReadStream stream(data, size, DisposeAfterUse::YES);
+		const Audio::MP3SeekIndexKey key = Audio::MP3SeekIndexCache::computeKey(stream);
+		TS_ASSERT(key.isValid());
+		TS_ASSERT_EQUALS(key.size, size);
+		TS_ASSERT_EQUALS(stream.pos(), 0);
+
+		// The last bytes are part of the checksum
+		data[size - 1] = 1;
+		TS_ASSERT_DIFFERS(Audio::MP3SeekIndexCache::computeKey(stream).crc, key.crc);
+	}
+
+	void test_slots() {
+		// Any number of streams share a bounded number of slot files
+		Common::StringMap names;
+		for (uint32 i = 0; i < 1000; i++) {
+			Audio::MP3SeekIndexKey key;
+			key.size = 1024 * 1024 + i * 7919;
+			key.crc = i * 2654435761U;
+			names[Audio::MP3SeekIndexCache::getSlotName(key)] = "";
+		}
+		TS_ASSERT_LESS_THAN_EQUALS(names.size(), (uint)Audio::MP3SeekIndexCache::kSlots);
+	}
+};
@@ -0,0 +1,85 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/pcmcache.h"
+#include "audio/audiostream.h"
+
+#include "helper.h"
+
+class PCMCacheTestSuite : public CxxTest::TestSuite
+{
+public:
+	void setUp() {
+		Audio::PCMCache::instance().clear();
+		Audio::PCMCache::instance().setBudget(Audio::PCMCache::kDefaultBudget);
+	}
+
+	void test_insert_find() {
+		Audio::PCMCache &cache = Audio::PCMCache::instance();
+		const Audio::PCMCacheKey key("sound.raw", 128, MKTAG('R', 'A', 'W', ' '));
+		const Audio::PCMCacheStats before = cache.getStats();
+
+		TS_ASSERT(!cache.find(key));
+
+		int16 *sine;
+		Audio::SeekableAudioStream *s = cache.insert(key, createSineStream<int16>(11025, 1, &sine, false, true), DisposeAfterUse::YES);
+		TS_ASSERT(s);
+		TS_ASSERT_EQUALS(s->isStereo(), true);
+		TS_ASSERT_EQUALS(s->getRate(), 11025);
+		TS_ASSERT_EQUALS(s->getLength(), Audio::Timestamp(1000, 11025));
+
+		Audio::SeekableAudioStream *s2 = cache.find(key);
+		TS_ASSERT(s2);
+
+		// Both views read the same data independently
+		const int totalSamples = 11025 * 2;
+		int16 *buffer = new int16[totalSamples];
+		TS_ASSERT_EQUALS(s->readBuffer(buffer, totalSamples), totalSamples);
+		TS_ASSERT_EQUALS(memcmp(sine, buffer, sizeof(int16) * totalSamples), 0);
+		TS_ASSERT(s->endOfData());
+		TS_ASSERT(!s2->endOfData());
+
+		TS_ASSERT(s2->seek(Audio::Timestamp(500, 11025)));
+		const int half = totalSamples - s2->readBuffer(buffer, totalSamples);
+		TS_ASSERT_EQUALS(memcmp(sine + half, buffer, sizeof(int16) * (totalSamples - half)), 0);
+
+		delete s;
+		delete s2;
+		delete[] sine;
+		delete[] buffer;
+
+		const Audio::PCMCacheStats after = cache.getStats();
+		TS_ASSERT_EQUALS(after.hits - before.hits, 1U);
+		TS_ASSERT_EQUALS(after.misses - before.misses, 1U);
+		TS_ASSERT_EQUALS(after.entries, 1U);
+		TS_ASSERT_EQUALS(after.bytes, (uint32)totalSamples * 2);
+	}
+
+	void test_eviction() {
+		Audio::PCMCache &cache = Audio::PCMCache::instance();
+		const uint32 bytes = 11025 * 2;
+		cache.setBudget(bytes * 8 * 2);
+
+		// Keep a stream over the first sound, which gets evicted
+		Audio::SeekableAudioStream *first = cache.insert(Audio::PCMCacheKey("0", 0, 0), createSineStream<int8>(11025, 1, nullptr, false, false), DisposeAfterUse::YES);
+		for (int i = 1; i < 17; i++) {
+			// Touch the second sound to keep it recently used
+			delete cache.find(Audio::PCMCacheKey("1", 0, 0));
+			delete cache.insert(Audio::PCMCacheKey(Common::String::format("%d", i), 0, 0), createSineStream<int8>(11025, 1, nullptr, false, false), DisposeAfterUse::YES);
+		}
+
+		const Audio::PCMCacheStats stats = cache.getStats();
+		TS_ASSERT_LESS_THAN_EQUALS(stats.bytes, stats.budget);
+		TS_ASSERT(!cache.find(Audio::PCMCacheKey("0", 0, 0)));
+		Audio::SeekableAudioStream *second = cache.find(Audio::PCMCacheKey("1", 0, 0));
+		TS_ASSERT(second);
+		delete second;
+
+		int16 buffer[16];
+		TS_ASSERT_EQUALS(first->readBuffer(buffer, 16), 16);
+		delete first;
+
+		// Sounds larger than an eighth of the budget are not stored
+		delete cache.insert(Audio::PCMCacheKey("large", 0, 0), createSineStream<int8>(11025, 3, nullptr, false, false), DisposeAfterUse::YES);
+		TS_ASSERT(!cache.find(Audio::PCMCacheKey("large", 0, 0)));
+	}
+};
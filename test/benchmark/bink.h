@@ -0,0 +1,61 @@
+#include <cxxtest/TestSuite.h>
+
+#include "helper.h"
+
+#include "common/jobsystem.h"
+
+#include "graphics/surface.h"
+#include "video/bink_decoder.h"
+
+#include "../video/bink_video.h"
+
+/**
+ * Decodes a synthetic BIKi video with an alpha plane on one and on several
+ * threads. This is the best case for the threaded decoder: the alpha plane
+ * is decoded next to the color planes, and the conversion to RGB is split
+ * into bands. Videos without alpha only get the split conversion.
+ */
+class BinkBenchmarkSuite : public CxxTest::TestSuite
+{
+	enum {
+		kWidth = 640,
+		kHeight = 480,
+		kFrames = 30,
+		kMaxThreads = 4
+	};
+
+	static void decode(Common::SeekableReadStream *stream) {
+		Video::BinkDecoder decoder;
+		TS_ASSERT(decoder.loadStream(stream));
+		decoder.setOutputPixelFormat(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+
+		for (uint frame = 0; frame < kFrames; frame++)
+			TS_ASSERT(decoder.decodeNextFrame());
+	}
+
+public:
+	void setUp() {
+		BenchmarkHelper::init();
+	}
+
+	void tearDown() {
+		Common::JobSystem::instance().setThreadCount(0);
+	}
+
+	void test_decode_alpha_video() {
+		for (uint32 threads = 1; threads <= kMaxThreads; threads *= 2) {
+			Common::JobSystem::instance().setThreadCount(threads);
+
+			// The same video every time
+			BinkTestVideo video(1);
+			Common::SeekableReadStream *stream = video.create(kWidth, kHeight, kFrames);
+
+			const uint32 start = BenchmarkHelper::now();
+			decode(stream);
+			const uint32 elapsed = BenchmarkHelper::now() - start;
+
+			Common::String name = Common::String::format("%u thread(s)", threads);
+			BenchmarkHelper::report("Bink decode", name.c_str(), kWidth * kHeight, kFrames, elapsed);
+		}
+	}
+};
@@ -0,0 +1,123 @@
+#include <cxxtest/TestSuite.h>
+
+#include "helper.h"
+
+#include "common/array.h"
+#include "common/flathashmap.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+#include "common/str.h"
+
+/**
+ * Compares insert, find, erase and iteration of HashMap and FlatHashMap
+ * with integer and string keys, at sizes from 1e2 to 1e6 entries. Small
+ * maps are refilled several times, so that every measurement covers about
+ * the same number of operations.
+ */
+class HashMapBenchmarkSuite : public CxxTest::TestSuite
+{
+	enum {
+		kTotalOps = 1000000
+	};
+
+	template<class Map, class Key>
+	static void runMap(const char *name, const Common::Array<Key> &keys, uint32 size, uint32 &checksum) {
+		const uint32 rounds = MAX<uint32>(1, kTotalOps / size);
+		const uint32 ops = rounds * size;
+		uint32 insertMs = 0, findMs = 0, missMs = 0, iterateMs = 0, eraseMs = 0;
+		uint32 found = 0;
+
+		for (uint32 r = 0; r < rounds; r++) {
+			Map map;
+
+			uint32 start = BenchmarkHelper::now();
+			for (uint32 i = 0; i < size; i++)
+				map[keys[i]] = i;
+			insertMs += BenchmarkHelper::now() - start;
+
+			start = BenchmarkHelper::now();
+			for (uint32 i = 0; i < size; i++)
+				found += map.contains(keys[(i * 7919) % size]);
+			findMs += BenchmarkHelper::now() - start;
+
+			// The second half of the keys was never inserted.
+			start = BenchmarkHelper::now();
+			for (uint32 i = 0; i < size; i++)
+				found += map.contains(keys[size + i]);
+			missMs += BenchmarkHelper::now() - start;
+
+			start = BenchmarkHelper::now();
+			for (typename Map::const_iterator i = map.begin(); i != map.end(); ++i)
+				found += i->_value & 1;
+			iterateMs += BenchmarkHelper::now() - start;
+
+			start = BenchmarkHelper::now();
+			for (uint32 i = 0; i < size; i++)
+				map.erase(keys[i]);
+			eraseMs += BenchmarkHelper::now() - start;
+			found += map.size();
+		}
+
+		BenchmarkHelper::report(name, "insert", size, ops, insertMs);
+		BenchmarkHelper::report(name, "find (hit)", size, ops, findMs);
+		BenchmarkHelper::report(name, "find (miss)", size, ops, missMs);
+		BenchmarkHelper::report(name, "iterate", size, ops, iterateMs);
+		BenchmarkHelper::report(name, "erase", size, ops, eraseMs);
+
+		if (checksum == 0)
+			checksum = found;
+		else
+			TS_ASSERT_EQUALS(checksum, found);
+	}
+
+	static void makeKeys(Common::Array<uint> &keys, uint32 count) {
+		// Spread the keys over the whole range, like resource ids or offsets.
+		keys.resize(count);
+		uint seed = 0x1234567;
+		for (uint32 i = 0; i < count; i++) {
+			seed = seed * 1664525 + 1013904223;
+			keys[i] = (seed & ~0xFFU) | (i & 0xFF);
+		}
+	}
+
+	static void makeKeys(Common::Array<Common::String> &keys, uint32 count) {
+		// File and symbol names share long prefixes.
+		keys.resize(count);
+		for (uint32 i = 0; i < count; i++)
+			keys[i] = Common::String::format("resource/%u.dat", i);
+	}
+
+public:
+	void setUp() {
+		BenchmarkHelper::init();
+	}
+
+	void test_uint_keys() {
+		for (uint32 size = 100; size <= 1000000; size *= 10) {
+			Common::Array<uint> keys;
+			makeKeys(keys, size * 2);
+
+			uint32 checksum = 0;
+			runMap<Common::HashMap<uint, uint> >("HashMap", keys, size, checksum);
+			runMap<Common::FlatHashMap<uint, uint> >("FlatHashMap", keys, size, checksum);
+		}
+	}
+
+	void test_string_keys() {
+		typedef Common::HashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> StringHashMap;
+		typedef Common::FlatHashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> StringFlatHashMap;
+		typedef Common::FlatHashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo, true> StringFlatHashMapCached;
+
+		for (uint32 size = 100; size <= 1000000; size *= 10) {
+			Common::Array<Common::String> keys;
+			makeKeys(keys, size * 2);
+
+			uint32 checksum = 0;
+			// The node pool of HashMap can't grow large enough to hold 1e6 strings.
+			if (size < 1000000)
+				runMap<StringHashMap>("HashMap<String>", keys, size, checksum);
+			runMap<StringFlatHashMap>("Flat<String>", keys, size, checksum);
+			runMap<StringFlatHashMapCached>("Flat<String,hash>", keys, size, checksum);
+		}
+	}
+};
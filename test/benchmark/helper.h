@@ -0,0 +1,77 @@
+#ifndef TEST_BENCHMARK_HELPER_H
+#define TEST_BENCHMARK_HELPER_H
+
+// System headers have to come before any ScummVM header, which forbid
+// some of the symbols they use. Benchmarks include this file first.
+#if defined(POSIX) && !defined(__EMSCRIPTEN__)
+#include <pthread.h>
+#define BENCHMARK_HAVE_THREADS 1
+#endif
+
+#include "common/debug.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+#include "../null_osystem.h"
+
+namespace BenchmarkHelper {
+
+/**
+ * Make sure g_system is available, as it provides the clock.
+ */
+inline void init() {
+	if (!g_system)
+		Common::install_null_g_system();
+}
+
+inline uint32 now() {
+	return g_system->getMillis(true);
+}
+
+/**
+ * Print the result of a single benchmark run, in a fixed format that is
+ * easy to compare between builds.
+ */
+inline void report(const char *group, const char *name, uint32 size, uint32 ops, uint32 millis) {
+	const double nsPerOp = ops ? (double)millis * 1000000.0 / ops : 0.0;
+	debug("%-16s %-24s %8u entries %10u ops %6u ms %9.1f ns/op", group, name, size, ops, millis, nsPerOp);
+}
+
+/**
+ * Run @p func(@p args[i]) for all @p count entries of @p args at once, each
+ * on its own thread. On ports without threads, they are run one after
+ * another instead.
+ */
+template<class T>
+void runThreads(void (*func)(T *), T *args, uint count) {
+#ifdef BENCHMARK_HAVE_THREADS
+	struct Thread {
+		pthread_t handle;
+		void (*func)(T *);
+		T *arg;
+
+		static void *run(void *thread) {
+			Thread *t = (Thread *)thread;
+			t->func(t->arg);
+			return nullptr;
+		}
+	};
+
+	Thread *threads = new Thread[count];
+	for (uint i = 0; i < count; i++) {
+		threads[i].func = func;
+		threads[i].arg = &args[i];
+		if (pthread_create(&threads[i].handle, nullptr, Thread::run, &threads[i]) != 0)
+			error("Failed to start benchmark thread");
+	}
+	for (uint i = 0; i < count; i++)
+		pthread_join(threads[i].handle, nullptr);
+	delete[] threads;
+#else
+	for (uint i = 0; i < count; i++)
+		func(&args[i]);
+#endif
+}
+
+} // End of namespace BenchmarkHelper
+
+#endif
@@ -0,0 +1,73 @@
+#include <cxxtest/TestSuite.h>
+
+#include "helper.h"
+
+#include "common/array.h"
+#include "common/str.h"
+
+/**
+ * Creates, copies, modifies and destroys heap-backed strings, first on one
+ * thread and then on several threads at once. Every thread only touches its
+ * own strings, so any slowdown with more threads comes from shared state in
+ * the String implementation.
+ */
+class StringBenchmarkSuite : public CxxTest::TestSuite
+{
+	enum {
+		kIterations = 200000,
+		kMaxThreads = 4
+	};
+
+	struct ChurnJob {
+		uint32 iterations;
+		uint32 checksum;
+	};
+
+	static void churn(ChurnJob *job) {
+		// Longer than the built-in storage, so that every string is on the heap.
+		const Common::String base("Strings longer than the built-in capacity live on the heap");
+		Common::Array<Common::String> kept;
+		kept.resize(16);
+
+		uint32 checksum = 0;
+		for (uint32 i = 0; i < job->iterations; i++) {
+			Common::String copy(base);               // share the storage
+			Common::String other = copy;
+			kept[i & 15] = other;                    // release an older string
+			copy += (char)('a' + (i % 26));          // unshare
+			Common::String formatted = Common::String::format("%s/%u", base.c_str(), i);
+			checksum += copy.size() + formatted.size() + other.lastChar();
+		}
+		job->checksum = checksum;
+	}
+
+	static uint32 runThreads(uint32 threads, uint32 iterations) {
+		ChurnJob jobs[kMaxThreads];
+		for (uint32 i = 0; i < threads; i++) {
+			jobs[i].iterations = iterations;
+			jobs[i].checksum = 0;
+		}
+
+		BenchmarkHelper::runThreads(churn, jobs, threads);
+
+		for (uint32 i = 1; i < threads; i++)
+			TS_ASSERT_EQUALS(jobs[i].checksum, jobs[0].checksum);
+		return jobs[0].checksum;
+	}
+
+public:
+	void setUp() {
+		BenchmarkHelper::init();
+	}
+
+	void test_string_churn() {
+		for (uint32 threads = 1; threads <= kMaxThreads; threads *= 2) {
+			const uint32 start = BenchmarkHelper::now();
+			runThreads(threads, kIterations);
+			const uint32 elapsed = BenchmarkHelper::now() - start;
+
+			Common::String name = Common::String::format("%u thread(s)", threads);
+			BenchmarkHelper::report("String churn", name.c_str(), 0, threads * kIterations, elapsed);
+		}
+	}
+};
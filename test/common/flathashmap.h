@@ -0,0 +1,173 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/flathashmap.h"
+#include "common/hash-str.h"
+
+struct FlatHashMapCollidingHash {
+	uint operator()(int) const { return 0; }
+};
+
+class FlatHashMapTestSuite : public CxxTest::TestSuite
+{
+	public:
+	typedef Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo, true> FlatStringMap;
+
+	void test_empty_clear() {
+		Common::FlatHashMap<int, int> container;
+		TS_ASSERT(container.empty());
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(!container.empty());
+		container.clear();
+		TS_ASSERT(container.empty());
+
+		FlatStringMap container2;
+		TS_ASSERT(container2.empty());
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(!container2.empty());
+		container2.clear(true);
+		TS_ASSERT(container2.empty());
+	}
+
+	void test_contains() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(container.contains(0));
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT(!container.contains(17));
+		TS_ASSERT(!container.contains(-1));
+
+		FlatStringMap container2;
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(container2.contains("foo"));
+		TS_ASSERT(container2.contains("FOO"));
+		TS_ASSERT(container2.contains("quux"));
+		TS_ASSERT(!container2.contains("bar"));
+		TS_ASSERT(!container2.contains("asdf"));
+	}
+
+	void test_add_remove() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		TS_ASSERT(container.contains(1));
+		container.erase(1);
+		TS_ASSERT(!container.contains(1));
+		container[1] = 42;
+		TS_ASSERT(container.contains(1));
+		container.erase(0);
+		container.erase(1);
+		container.erase(2);
+		container.erase(3);
+		TS_ASSERT(!container.empty());
+		container.erase(container.find(4));
+		TS_ASSERT(container.empty());
+		container[1] = 33;
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT_EQUALS(container.size(), 1U);
+	}
+
+	void test_lookup_with_default() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = -1;
+
+		const Common::FlatHashMap<int, int> &containerRef = container;
+
+		TS_ASSERT_EQUALS(containerRef[1], -1);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(0), 17);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(17), 0);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(17, -10), -10);
+
+		int out = 0;
+		TS_ASSERT(containerRef.tryGetVal(0, out));
+		TS_ASSERT_EQUALS(out, 17);
+		TS_ASSERT(!containerRef.tryGetVal(2, out));
+	}
+
+	void test_copy() {
+		FlatStringMap map1, map2;
+		map1["a"] = "1";
+		map1["b"] = "2";
+		map1.erase("a");
+		map2 = map1;
+		FlatStringMap map3(map2);
+		TS_ASSERT(!map3.contains("a"));
+		TS_ASSERT_EQUALS(map3["b"], "2");
+		TS_ASSERT_EQUALS(map3.size(), 1U);
+	}
+
+	void test_collision() {
+		// All keys share their home slot and end up in one probe sequence.
+		// Erasing from its middle must not hide the entries behind it.
+		Common::FlatHashMap<int, int, FlatHashMapCollidingHash> h;
+		for (int i = 0; i < 8; i++)
+			h[i] = i;
+		h.erase(2);
+		h.erase(5);
+		for (int i = 0; i < 8; i++)
+			TS_ASSERT_EQUALS(h.contains(i), i != 2 && i != 5);
+		h[5] = 50;
+		TS_ASSERT_EQUALS(h[5], 50);
+		TS_ASSERT_EQUALS(h[7], 7);
+		h.erase(7);
+		h.erase(6);
+		TS_ASSERT(!h.contains(7));
+		TS_ASSERT_EQUALS(h.size(), 5U);
+	}
+
+	void test_iterator_erase() {
+		Common::FlatHashMap<int, int> container;
+		for (int i = 0; i < 100; i++)
+			container[i] = i * 2;
+
+		for (Common::FlatHashMap<int, int>::iterator i = container.begin(); i != container.end(); ++i) {
+			if (i->_key & 1)
+				container.erase(i);
+		}
+
+		int sum = 0;
+		Common::FlatHashMap<int, int>::const_iterator j;
+		for (j = container.begin(); j != container.end(); ++j) {
+			TS_ASSERT(!(j->_key & 1));
+			TS_ASSERT_EQUALS(j->_value, j->_key * 2);
+			sum++;
+		}
+		TS_ASSERT_EQUALS(sum, 50);
+		TS_ASSERT_EQUALS(container.size(), 50U);
+	}
+
+	void test_matches_hashmap() {
+		// Interleave inserts and erases, so that both growing and rehashing
+		// away erased slots are exercised.
+		Common::FlatHashMap<uint, uint> flat;
+		Common::HashMap<uint, uint> ref;
+		uint seed = 1;
+		for (int i = 0; i < 20000; i++) {
+			seed = seed * 1103515245 + 12345;
+			uint key = (seed >> 8) % 3000;
+			if (seed & 0x10000) {
+				flat[key] = i;
+				ref[key] = i;
+			} else {
+				flat.erase(key);
+				ref.erase(key);
+			}
+		}
+
+		TS_ASSERT_EQUALS(flat.size(), ref.size());
+		for (Common::HashMap<uint, uint>::const_iterator i = ref.begin(); i != ref.end(); ++i)
+			TS_ASSERT_EQUALS(flat.getValOrDefault(i->_key, (uint)-1), i->_value);
+
+		flat.reserve(10000);
+		TS_ASSERT_EQUALS(flat.size(), ref.size());
+		for (Common::FlatHashMap<uint, uint>::const_iterator i = flat.begin(); i != flat.end(); ++i)
+			TS_ASSERT(ref.contains(i->_key));
+	}
+};
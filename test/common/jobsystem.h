@@ -0,0 +1,271 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/jobsystem.h"
+#include "common/system.h"
+#include "common/thread.h"
+
+#include "../null_osystem.h"
+
+// The tests run on worker threads where the backend has them, whatever the
+// number of CPU cores, and serially otherwise
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(HAS_PTHREADS)
+#define JOBSYSTEM_TEST_THREADS 4
+#else
+#define JOBSYSTEM_TEST_THREADS 1
+#endif
+
+class JobSystemTestSuite : public CxxTest::TestSuite {
+	struct Loop {
+		uint calls[256];
+	};
+
+	static void countProc(void *param, uint begin, uint end, uint worker) {
+		Loop *loop = (Loop *)param;
+		for (uint i = begin; i < end; i++)
+			loop->calls[i]++;
+	}
+
+	static void taskProc(void *param, uint worker) {
+		(*(uint *)param)++;
+	}
+
+	static void slowTaskProc(void *param, uint worker) {
+		g_system->delayMillis(2);
+		(*(uint *)param)++;
+	}
+
+	static void sleepProc(void *param, uint worker) {
+		g_system->delayMillis(20);
+		(*(uint *)param)++;
+	}
+
+	struct Spawner {
+		uint counters[64];
+	};
+
+	// Queue tasks on the queue of the running worker, so that the other
+	// workers can only get them by stealing
+	static void spawnProc(void *param, uint worker) {
+		Spawner *spawner = (Spawner *)param;
+		Common::TaskGroup group;
+		for (uint i = 0; i < ARRAYSIZE(spawner->counters); i++)
+			group.run(&slowTaskProc, &spawner->counters[i], worker);
+		group.wait(worker);
+	}
+
+	static void loopThreadProc(void *param) {
+		Common::JobSystem::instance().parallelFor(0, 256, 1, &countProc, param);
+	}
+
+	static void nestedProc(void *param, uint begin, uint end, uint worker) {
+		Loop *loop = (Loop *)param;
+
+		// Waiting for a loop from within a task must not deadlock
+		for (uint i = begin; i < end; i++) {
+			Loop inner = {};
+			Common::JobSystem::instance().parallelFor(0, 16, 1, &countProc, &inner, worker);
+			for (uint j = 0; j < 16; j++)
+				loop->calls[i] += inner.calls[j];
+		}
+	}
+
+	static void scratchProc(void *param, uint begin, uint end, uint worker) {
+		Loop *loop = (Loop *)param;
+		Common::ScratchArena &scratch = Common::JobSystem::instance().getScratch(worker);
+
+		for (uint i = begin; i < end; i++) {
+			uint *small = (uint *)scratch.allocate(sizeof(uint));
+			// Larger than the block, so that it is allocated separately
+			uint *large = (uint *)scratch.allocate(64 * 1024);
+			*small = i;
+			large[16 * 1024 - 1] = i;
+			TS_ASSERT_EQUALS((size_t)small % 16, 0U);
+			loop->calls[i] = *small + large[16 * 1024 - 1];
+		}
+	}
+
+public:
+	void setUp() override {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+#endif
+		Common::JobSystem::instance().setThreadCount(JOBSYSTEM_TEST_THREADS);
+	}
+
+	void tearDown() override {
+		Common::JobSystem::instance().setThreadCount(0);
+	}
+
+	void test_worker_count() {
+		TS_ASSERT_EQUALS(Common::JobSystem::instance().getWorkerCount(), (uint)JOBSYSTEM_TEST_THREADS);
+	}
+
+	void test_parallel_for() {
+		Loop loop = {};
+		Common::JobSystem::instance().parallelFor(10, 250, 7, &countProc, &loop);
+
+		for (uint i = 0; i < 256; i++)
+			TS_ASSERT_EQUALS(loop.calls[i], (i >= 10 && i < 250) ? 1U : 0U);
+	}
+
+	void test_parallel_for_empty() {
+		Loop loop = {};
+		Common::JobSystem::instance().parallelFor(5, 5, 1, &countProc, &loop);
+		Common::JobSystem::instance().parallelFor(6, 5, 1, &countProc, &loop);
+
+		for (uint i = 0; i < 256; i++)
+			TS_ASSERT_EQUALS(loop.calls[i], 0U);
+	}
+
+	void test_nested() {
+		Loop loop = {};
+		Common::JobSystem::instance().parallelFor(0, 32, 1, &nestedProc, &loop);
+
+		for (uint i = 0; i < 32; i++)
+			TS_ASSERT_EQUALS(loop.calls[i], 16U);
+	}
+
+	void test_task_group() {
+		uint counters[32] = {};
+		{
+			Common::TaskGroup group;
+			for (uint i = 0; i < 32; i++)
+				group.run(&taskProc, &counters[i]);
+			group.wait();
+
+			for (uint i = 0; i < 32; i++)
+				TS_ASSERT_EQUALS(counters[i], 1U);
+
+			// The group can be used again after waiting
+			group.run(&taskProc, &counters[0]);
+		}
+
+		// The destructor waits as well
+		TS_ASSERT_EQUALS(counters[0], 2U);
+	}
+
+	void test_scratch() {
+		Loop loop = {};
+		Common::JobSystem::instance().parallelFor(0, 64, 4, &scratchProc, &loop);
+
+		for (uint i = 0; i < 64; i++)
+			TS_ASSERT_EQUALS(loop.calls[i], i * 2);
+	}
+
+	void test_stats() {
+		Common::JobSystem &system = Common::JobSystem::instance();
+		system.getStats(true);
+
+		uint counter = 0;
+		Common::TaskGroup group;
+		group.run(&taskProc, &counter);
+		group.wait();
+
+		const Common::JobSystemStats stats = system.getStats(false);
+		TS_ASSERT_EQUALS(stats.workers.size(), system.getWorkerCount());
+
+		uint tasks = 0;
+		for (uint i = 0; i < stats.workers.size(); i++)
+			tasks += stats.workers[i].tasks;
+		TS_ASSERT_EQUALS(tasks, 1U);
+	}
+
+	void test_work_stealing() {
+		Common::JobSystem &system = Common::JobSystem::instance();
+		system.getStats(true);
+
+		Spawner spawner = {};
+		{
+			Common::TaskGroup group;
+			group.run(&spawnProc, &spawner);
+			group.wait();
+		}
+
+		for (uint i = 0; i < ARRAYSIZE(spawner.counters); i++)
+			TS_ASSERT_EQUALS(spawner.counters[i], 1U);
+
+		const Common::JobSystemStats stats = system.getStats(false);
+		uint tasks = 0, steals = 0;
+		for (uint i = 0; i < stats.workers.size(); i++) {
+			tasks += stats.workers[i].tasks;
+			steals += stats.workers[i].steals;
+		}
+		TS_ASSERT_EQUALS(tasks, ARRAYSIZE(spawner.counters) + 1);
+		if (JOBSYSTEM_TEST_THREADS > 1)
+			TS_ASSERT_LESS_THAN(0U, steals);
+	}
+
+	void test_blocking_wait() {
+		// The waiting thread runs what it finds queued, then has to block
+		// until the workers are done with the rest. The tasks mostly sleep,
+		// so they overlap even on a single core.
+		uint counters[8] = {};
+		const uint32 start = g_system->getMillis();
+		{
+			Common::TaskGroup group;
+			for (uint i = 0; i < ARRAYSIZE(counters); i++)
+				group.run(&sleepProc, &counters[i]);
+			group.wait();
+		}
+		const uint32 elapsed = g_system->getMillis() - start;
+
+		for (uint i = 0; i < ARRAYSIZE(counters); i++)
+			TS_ASSERT_EQUALS(counters[i], 1U);
+		if (JOBSYSTEM_TEST_THREADS > 1)
+			TS_ASSERT_LESS_THAN(elapsed, 20U * ARRAYSIZE(counters) * 3 / 4);
+	}
+
+	void test_helping_waiters() {
+		Common::JobSystem &system = Common::JobSystem::instance();
+		system.getStats(true);
+
+		// The thread waiting for the group runs tasks as worker 0
+		uint counters[64] = {};
+		{
+			Common::TaskGroup group;
+			for (uint i = 0; i < ARRAYSIZE(counters); i++)
+				group.run(&slowTaskProc, &counters[i]);
+			group.wait();
+		}
+		for (uint i = 0; i < ARRAYSIZE(counters); i++)
+			TS_ASSERT_EQUALS(counters[i], 1U);
+		TS_ASSERT_LESS_THAN(0U, system.getStats(false).workers[0].tasks);
+
+		// Only one thread outside of the pool helps at a time, the others
+		// wait for their tasks to be run by the workers
+		Loop loops[3] = {};
+		Common::ThreadInternal *threads[2];
+		for (uint i = 0; i < 2; i++)
+			threads[i] = g_system->createThread(&loopThreadProc, &loops[i]);
+		loopThreadProc(&loops[2]);
+		for (uint i = 0; i < 2; i++) {
+			// Without threads in the backend, run the loops here
+			if (threads[i])
+				delete threads[i];
+			else
+				loopThreadProc(&loops[i]);
+		}
+
+		for (uint i = 0; i < 3; i++) {
+			for (uint j = 0; j < 256; j++)
+				TS_ASSERT_EQUALS(loops[i].calls[j], 1U);
+		}
+	}
+
+	void test_serial_fallback() {
+		Common::JobSystem &system = Common::JobSystem::instance();
+		system.setThreadCount(1);
+		TS_ASSERT_EQUALS(system.getWorkerCount(), 1U);
+
+		Loop loop = {};
+		system.parallelFor(0, 256, 1, &nestedProc, &loop);
+		for (uint i = 0; i < 256; i++)
+			TS_ASSERT_EQUALS(loop.calls[i], 16U);
+
+		uint counter = 0;
+		Common::TaskGroup group;
+		group.run(&taskProc, &counter);
+		TS_ASSERT_EQUALS(counter, 1U);
+		group.wait();
+	}
+};
@@ -0,0 +1,67 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "common/profiler.h"
+#include "common/str.h"
+
+class ProfilerTestSuite : public CxxTest::TestSuite {
+	static Common::String writeTrace() {
+		Common::MemoryWriteStreamDynamic stream(DisposeAfterUse::YES);
+		Common::Profiler::instance().writeTrace(stream);
+		return Common::String((const char *)stream.getData(), stream.size());
+	}
+
+public:
+	void test_record() {
+		Common::Profiler &profiler = Common::Profiler::instance();
+		profiler.start(16);
+		TS_ASSERT(Common::Profiler::isRecording());
+
+		{
+			Common::ProfilerZone zone("zone", Common::kProfilerTrackAudio);
+		}
+		profiler.addZone("fixed", Common::kProfilerTrackMain, 100, 150);
+		profiler.addCounter("counter", Common::kProfilerTrackMain, -3);
+		profiler.stop();
+
+		// Nothing is recorded after stopping
+		profiler.addCounter("late", Common::kProfilerTrackMain, 1);
+		{
+			Common::ProfilerZone zone("late", Common::kProfilerTrackMain);
+		}
+
+		TS_ASSERT(!Common::Profiler::isRecording());
+		TS_ASSERT_EQUALS(profiler.getEventCount(), 3U);
+		TS_ASSERT_EQUALS(profiler.getDroppedCount(), 0U);
+
+		const Common::String trace = writeTrace();
+		TS_ASSERT(trace.hasPrefix("{"));
+		TS_ASSERT(trace.hasSuffix("]}\n"));
+		TS_ASSERT(trace.contains("{\"name\":\"zone\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"));
+		TS_ASSERT(trace.contains("{\"name\":\"fixed\",\"ph\":\"X\",\"pid\":1,\"tid\":0,\"ts\":100,\"dur\":50}"));
+		TS_ASSERT(trace.contains("\"name\":\"counter\",\"ph\":\"C\""));
+		TS_ASSERT(trace.contains("\"args\":{\"value\":-3}"));
+		TS_ASSERT(!trace.contains("late"));
+	}
+
+	void test_ring() {
+		Common::Profiler &profiler = Common::Profiler::instance();
+		profiler.start(4);
+
+		static const char *const names[] = { "e0", "e1", "e2", "e3", "e4", "e5" };
+		for (uint i = 0; i < 6; i++)
+			profiler.addZone(names[i], Common::kProfilerTrackMain, i * 10, i * 10 + 1);
+		profiler.stop();
+
+		TS_ASSERT_EQUALS(profiler.getEventCount(), 4U);
+		TS_ASSERT_EQUALS(profiler.getDroppedCount(), 2U);
+
+		// The oldest events are dropped, and the rest are written in order
+		const Common::String trace = writeTrace();
+		TS_ASSERT(!trace.contains("\"e0\""));
+		TS_ASSERT(!trace.contains("\"e1\""));
+		const char *e2 = strstr(trace.c_str(), "\"e2\"");
+		const char *e5 = strstr(trace.c_str(), "\"e5\"");
+		TS_ASSERT(e2 && e5 && e2 < e5);
+	}
+};
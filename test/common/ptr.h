@@ -166,6 +166,47 @@ class PtrTestSuite : public CxxTest::TestSuite {
 		TS_ASSERT(a.expired());
 		TS_ASSERT(!a.lock());
 	}
+
+	class RecordingTracker : public Common::BasePtrTrackerInternal {
+	public:
+		RecordingTracker(int *object, bool *destructed, bool *deleted) : _object(object), _destructed(destructed), _deleted(deleted) {}
+		~RecordingTracker() override { *_deleted = true; }
+
+	protected:
+		void destructObject() override {
+			*_destructed = true;
+			delete _object;
+		}
+
+	private:
+		int *_object;
+		bool *_destructed;
+		bool *_deleted;
+	};
+
+	void test_adopt() {
+		bool destructed = false;
+		bool deleted = false;
+
+		int *object = new int(1);
+		Common::SharedPtr<int> p = Common::SharedPtr<int>::adopt(object, new RecordingTracker(object, &destructed, &deleted));
+		TS_ASSERT_EQUALS(p.refCount(), 1);
+		TS_ASSERT_EQUALS(*p, 1);
+
+		Common::WeakPtr<int> w(p);
+		Common::SharedPtr<int> p2(p);
+		p.reset();
+		TS_ASSERT(!destructed);
+
+		p2.reset();
+		TS_ASSERT(destructed);
+		TS_ASSERT(!deleted);
+		TS_ASSERT(w.expired());
+
+		// The tracker lives on until the last weak reference is gone
+		w.reset();
+		TS_ASSERT(deleted);
+	}
 };
 
 int PtrTestSuite::InstanceCountingClass::count = 0;
@@ -0,0 +1,75 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/util.h"
+
+#include "engines/tetraedge/te/te_matrix4x4.h"
+
+class TeMatrix4x4TestSuite : public CxxTest::TestSuite {
+	uint32 _seed;
+
+	float nextRandom(float range) {
+		_seed = _seed * 1664525 + 1013904223;
+		return ((float)(_seed >> 8) / (1 << 24) - 0.5f) * 2 * range;
+	}
+
+	void randomize(Tetraedge::TeMatrix4x4 &matrix, bool projective) {
+		float *d = matrix.getData();
+		for (int i = 0; i < 16; i++)
+			d[i] = nextRandom(i >= 12 ? 100.0f : 2.0f);
+
+		if (!projective) {
+			d[3] = d[7] = d[11] = 0.0f;
+			d[15] = 1.0f;
+		}
+	}
+
+	// When the compiler may fuse multiply-adds, it may do so differently
+	// for the operators, so only require the results to be close
+	static bool same(float a, float b) {
+#ifdef __FP_FAST_FMAF
+		return fabsf(a - b) <= 1e-5f * MAX(1.0f, fabsf(b));
+#else
+		return memcmp(&a, &b, sizeof(float)) == 0;
+#endif
+	}
+
+public:
+	TeMatrix4x4TestSuite() : _seed(1) {}
+
+	// Skinning with addWeighted() must give exactly the same results as
+	// with the matrix and vector operators it replaces
+	void test_add_weighted() {
+		for (int i = 0; i < 1000; i++) {
+			const int bones = 1 + i % 4;
+			Tetraedge::TeVector3f32 vertex(nextRandom(50.0f), nextRandom(50.0f), nextRandom(50.0f));
+			Tetraedge::TeVector3f32 normal(nextRandom(1.0f), nextRandom(1.0f), nextRandom(1.0f));
+			if (i == 0)
+				vertex = Tetraedge::TeVector3f32();
+
+			Tetraedge::TeVector3f32 expectedVertex, expectedNormal;
+			float vertexSum[3] = { 0.0f, 0.0f, 0.0f };
+			float normalSum[3] = { 0.0f, 0.0f, 0.0f };
+
+			for (int j = 0; j < bones; j++) {
+				Tetraedge::TeMatrix4x4 matrix;
+				randomize(matrix, i % 3 == 0);
+
+				// w becomes zero
+				if (i % 50 == 0) {
+					float *d = matrix.getData();
+					d[3] = d[7] = d[11] = d[15] = 0.0f;
+				}
+
+				const float weight = nextRandom(0.5f) + 0.5f;
+				expectedVertex = expectedVertex + ((matrix * vertex) * weight);
+				expectedNormal = expectedNormal + (matrix.mult3x3(normal) * weight);
+				matrix.addWeighted(weight, vertex.x(), vertex.y(), vertex.z(), normal.x(), normal.y(), normal.z(), vertexSum, normalSum);
+			}
+
+			for (int k = 0; k < 3; k++) {
+				TS_ASSERT(same(vertexSum[k], expectedVertex.getValue(k)));
+				TS_ASSERT(same(normalSum[k], expectedNormal.getValue(k)));
+			}
+		}
+	}
+};
@@ -0,0 +1,157 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/fs.h"
+#include "common/ptr.h"
+#include "common/stream.h"
+
+#include "graphics/font.h"
+#include "graphics/fonts/ttf.h"
+#include "graphics/surface.h"
+
+#include "../null_osystem.h"
+
+class TTFGlyphCacheTestSuite : public CxxTest::TestSuite {
+#if defined(USE_FREETYPE2) && NULL_OSYSTEM_IS_AVAILABLE
+	static Graphics::Font *loadFont(int size) {
+		Common::FSNode node("gui/themes/fonts/FreeSans.ttf");
+		Common::ScopedPtr<Common::SeekableReadStream> stream(node.createReadStream());
+		if (!stream)
+			return nullptr;
+		return Graphics::loadTTFFont(*stream, size);
+	}
+
+	static Graphics::TTFGlyphCacheStats getStats() {
+		Graphics::TTFGlyphCacheStats stats;
+		Graphics::getTTFGlyphCacheStats(stats);
+		return stats;
+	}
+
+	/** Draw a character into a new surface, which the caller frees. */
+	static void drawChar(const Graphics::Font &font, uint32 chr, Graphics::Surface &surface) {
+		surface.create(font.getMaxCharWidth() * 2, font.getFontHeight() * 2, Graphics::PixelFormat::createFormatCLUT8());
+		font.drawChar(&surface, chr, font.getMaxCharWidth() / 2, font.getFontHeight() / 2, 1);
+	}
+
+	static bool equalSurfaces(const Graphics::Surface &a, const Graphics::Surface &b) {
+		if (a.w != b.w || a.h != b.h)
+			return false;
+		for (int y = 0; y < a.h; y++) {
+			if (memcmp(a.getBasePtr(0, y), b.getBasePtr(0, y), a.w))
+				return false;
+		}
+		return true;
+	}
+#endif
+
+public:
+	void test_shared_glyphs() {
+#if defined(USE_FREETYPE2) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Graphics::shutdownTTF();
+
+		Common::ScopedPtr<Graphics::Font> first(loadFont(12));
+		TS_ASSERT(first);
+		if (!first)
+			return;
+
+		const Graphics::TTFGlyphCacheStats loaded = getStats();
+		TS_ASSERT_LESS_THAN(0U, loaded.glyphs);
+
+		// A second font with the same settings finds all its glyphs in the
+		// cache, and draws them the same way
+		Common::ScopedPtr<Graphics::Font> second(loadFont(12));
+		TS_ASSERT(second);
+		if (!second)
+			return;
+
+		const Graphics::TTFGlyphCacheStats shared = getStats();
+		TS_ASSERT_EQUALS(shared.glyphs, loaded.glyphs);
+		TS_ASSERT_LESS_THAN_EQUALS(loaded.hits + loaded.glyphs, shared.hits);
+
+		Graphics::Surface a, b;
+		drawChar(*first, 'g', a);
+		drawChar(*second, 'g', b);
+		TS_ASSERT(equalSurfaces(a, b));
+		a.free();
+		b.free();
+
+		// Another size has glyphs of its own
+		Common::ScopedPtr<Graphics::Font> larger(loadFont(14));
+		TS_ASSERT(larger);
+		TS_ASSERT_LESS_THAN(shared.glyphs, getStats().glyphs);
+
+		// The fonts have to go before the FreeType library
+		first.reset();
+		second.reset();
+		larger.reset();
+		Graphics::shutdownTTF();
+#endif
+	}
+
+	void test_atlas_reuse() {
+#if defined(USE_FREETYPE2) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Graphics::shutdownTTF();
+
+		// The Latin-1 glyphs checked when loading a small font are packed
+		// into a single 256x256 atlas page
+		Common::ScopedPtr<Graphics::Font> font(loadFont(12));
+		TS_ASSERT(font);
+		if (!font)
+			return;
+
+		const Graphics::TTFGlyphCacheStats stats = getStats();
+		TS_ASSERT_LESS_THAN(100U, stats.glyphs);
+		TS_ASSERT_EQUALS(stats.bytes, 256U * 256U);
+		TS_ASSERT_EQUALS(stats.evictedPages, 0U);
+
+		font.reset();
+		Graphics::shutdownTTF();
+#endif
+	}
+
+	void test_eviction_at_budget() {
+#if defined(USE_FREETYPE2) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Graphics::shutdownTTF();
+
+		const uint32 budget = 2 * 256 * 256;
+		Graphics::setTTFGlyphCacheBudget(budget);
+
+		// The glyphs of a large font need more than two pages
+		Common::ScopedPtr<Graphics::Font> font(loadFont(48));
+		TS_ASSERT(font);
+		if (!font)
+			return;
+
+		Graphics::Surface before;
+		drawChar(*font, 'A', before);
+
+		// Drop the page holding 'A' by looking up enough other glyphs
+		for (uint32 chr = 0x100; chr < 0x180; chr++)
+			font->getCharWidth(chr);
+
+		const Graphics::TTFGlyphCacheStats stats = getStats();
+		TS_ASSERT_LESS_THAN(0U, stats.evictedPages);
+		TS_ASSERT_LESS_THAN_EQUALS(stats.bytes, budget);
+
+		// Evicted glyphs are rendered again the same way
+		const uint32 misses = stats.misses;
+		Graphics::Surface after;
+		drawChar(*font, 'A', after);
+		TS_ASSERT_LESS_THAN(misses, getStats().misses);
+		TS_ASSERT(equalSurfaces(before, after));
+		before.free();
+		after.free();
+
+		TS_ASSERT_LESS_THAN_EQUALS(getStats().bytes, budget);
+
+		font.reset();
+		Graphics::shutdownTTF();
+#endif
+	}
+};
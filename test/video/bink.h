@@ -0,0 +1,60 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/crc.h"
+#include "common/jobsystem.h"
+
+#include "graphics/surface.h"
+#include "video/bink_decoder.h"
+
+#include "../null_osystem.h"
+#include "bink_video.h"
+
+class BinkDecoderTestSuite : public CxxTest::TestSuite
+{
+	/** Decode a video on @p threads threads, and return the checksums of its frames. */
+	static Common::Array<uint32> decode(uint32 seed, uint threads) {
+		Common::JobSystem::instance().setThreadCount(threads);
+
+		Common::Array<uint32> crcs;
+		BinkTestVideo video(seed);
+		Video::BinkDecoder decoder;
+		TS_ASSERT(decoder.loadStream(video.create(64, 48, 8)));
+		decoder.setOutputPixelFormat(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+
+		for (uint frame = 0; frame < 8; frame++) {
+			const Graphics::Surface *surface = decoder.decodeNextFrame();
+			TS_ASSERT(surface);
+			if (!surface)
+				break;
+
+			uint32 crc = 0;
+			for (int y = 0; y < surface->h; y++)
+				crc = Common::CRC32().crcFast((const byte *)surface->getBasePtr(0, y), surface->w * surface->format.bytesPerPixel) ^ (crc * 31);
+			crcs.push_back(crc);
+		}
+
+		Common::JobSystem::instance().setThreadCount(0);
+		return crcs;
+	}
+
+public:
+	void test_split_decoding() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		// The planes are decoded at the same time once the offset to the
+		// color planes was right for four frames, and the conversion is
+		// split into bands. Neither may change the output.
+		for (uint32 seed = 1; seed <= 3; seed++) {
+			const Common::Array<uint32> serial = decode(seed, 1);
+			const Common::Array<uint32> split = decode(seed, 4);
+
+			TS_ASSERT_EQUALS(serial.size(), 8U);
+			TS_ASSERT_EQUALS(split.size(), 8U);
+			for (uint i = 0; i < serial.size() && i < split.size(); i++)
+				TS_ASSERT_EQUALS(serial[i], split[i]);
+		}
+#endif
+	}
+};
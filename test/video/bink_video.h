@@ -0,0 +1,200 @@
+#ifndef TEST_VIDEO_BINK_VIDEO_H
+#define TEST_VIDEO_BINK_VIDEO_H
+
+#include "common/array.h"
+#include "common/endian.h"
+#include "common/math.h"
+#include "common/memstream.h"
+
+/**
+ * Writes bits in the order the Bink decoder reads them.
+ */
+class BinkTestBitWriter {
+public:
+	BinkTestBitWriter() : _bits(0) {}
+
+	void putBit(uint bit) {
+		if ((_bits & 7) == 0)
+			_data.push_back(0);
+		_data[_bits >> 3] |= (bit & 1) << (_bits & 7);
+		_bits++;
+	}
+
+	void putBits(uint32 value, int count) {
+		for (int i = 0; i < count; i++)
+			putBit(value >> i);
+	}
+
+	/** Pad with zeroes up to the next 32-bit boundary. */
+	void align() {
+		while (_bits & 0x1F)
+			putBit(0);
+	}
+
+	uint32 pos() const { return _bits; }
+
+	Common::Array<byte> &data() { return _data; }
+
+private:
+	Common::Array<byte> _data;
+	uint32 _bits;
+};
+
+/**
+ * Builds BIKi videos with an alpha plane, made of random fill, pattern and
+ * raw blocks. All Huffman trees are the raw nibble tree, so any bits make
+ * valid values.
+ */
+class BinkTestVideo {
+public:
+	BinkTestVideo(uint32 seed) : _seed(seed) {}
+
+	Common::SeekableReadStream *create(uint width, uint height, uint frames) {
+		Common::Array<Common::Array<byte> > packets;
+		uint32 largest = 0;
+		for (uint i = 0; i < frames; i++) {
+			packets.push_back(writePacket(width, height));
+			largest = MAX<uint32>(largest, packets.back().size());
+		}
+
+		uint32 size = 11 * 4 + frames * 4;
+		for (uint i = 0; i < frames; i++)
+			size += packets[i].size();
+
+		Common::Array<byte> data;
+		putUint32BE(data, MKTAG('B', 'I', 'K', 'i'));
+		putUint32LE(data, size - 8);
+		putUint32LE(data, frames);
+		putUint32LE(data, largest);
+		putUint32LE(data, 0);
+		putUint32LE(data, width);
+		putUint32LE(data, height);
+		putUint32LE(data, 10);	// frame rate numerator
+		putUint32LE(data, 1);	// frame rate denominator
+		putUint32LE(data, 0x00100000);	// alpha plane
+		putUint32LE(data, 0);	// audio tracks
+
+		uint32 offset = 11 * 4 + frames * 4;
+		for (uint i = 0; i < frames; i++) {
+			putUint32LE(data, offset | (i == 0 ? 1 : 0));
+			offset += packets[i].size();
+		}
+		for (uint i = 0; i < frames; i++)
+			data.push_back(packets[i]);
+
+		byte *buffer = (byte *)malloc(data.size());
+		memcpy(buffer, &data[0], data.size());
+		return new Common::MemoryReadStream(buffer, data.size(), DisposeAfterUse::YES);
+	}
+
+private:
+	enum {
+		kBlockFill    = 6,
+		kBlockPattern = 8,
+		kBlockRaw     = 9
+	};
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 8;
+	}
+
+	static void putUint32LE(Common::Array<byte> &data, uint32 value) {
+		for (int i = 0; i < 4; i++)
+			data.push_back(value >> (8 * i));
+	}
+
+	static void putUint32BE(Common::Array<byte> &data, uint32 value) {
+		for (int i = 3; i >= 0; i--)
+			data.push_back(value >> (8 * i));
+	}
+
+	static int countLength(uint32 maxCount) {
+		return Common::intLog2(maxCount + 511) + 1;
+	}
+
+	Common::Array<byte> writePacket(uint width, uint height) {
+		BinkTestBitWriter w;
+
+		// The color planes start after the alpha plane and a field in
+		// front of them. The offset to them is stored in bytes from the
+		// start of the packet.
+		w.putBits(0, 32);
+		writePlane(w, width, height, false);
+		const uint32 start = w.pos() / 8;
+		w.putBits(0, 32);
+
+		writePlane(w, width, height, false);
+		writePlane(w, width, height, true);
+		writePlane(w, width, height, true);
+
+		Common::Array<byte> &data = w.data();
+		for (int i = 0; i < 4; i++)
+			data[i] = start >> (8 * i);
+		return data;
+	}
+
+	void writePlane(BinkTestBitWriter &w, uint width, uint height, bool isChroma) {
+		const uint blockWidth  = isChroma ? (width  + 15) >> 4 : (width  + 7) >> 3;
+		const uint blockHeight = isChroma ? (height + 15) >> 4 : (height + 7) >> 3;
+		const uint countWidth  = MAX<uint>(isChroma ? width >> 1 : width, 8);
+
+		const int blockTypesLength = countLength(countWidth >> 3);
+		const int subBlockTypesLength = countLength((countWidth + 7) >> 4);
+		const int colorsLength = countLength(blockWidth * 64);
+		const int patternLength = countLength(blockWidth << 3);
+		const int valuesLength = countLength(countWidth >> 3);
+		const int runLength = countLength(blockWidth * 48);
+
+		// The raw nibble tree for all bundles and the high color nibbles
+		for (int i = 0; i < 16; i++)
+			w.putBits(0, 4);
+		for (int i = 0; i < 7; i++)
+			w.putBits(0, 4);
+
+		// Patterns are read ahead for the next row of pattern blocks,
+		// since a count of 0 ends a bundle for the whole plane
+		uint patternsLeft = 0;
+
+		for (uint y = 0; y < blockHeight; y++) {
+			static const byte types[3] = { kBlockFill, kBlockPattern, kBlockRaw };
+			const byte type = types[nextRandom() % 3];
+
+			w.putBits(blockWidth, blockTypesLength);
+			w.putBit(1);
+			w.putBits(type, 4);
+
+			if (y == 0)
+				w.putBits(0, subBlockTypesLength);
+
+			const uint colors = blockWidth * (type == kBlockFill ? 1 : (type == kBlockPattern ? 2 : 64));
+			w.putBits(colors, colorsLength);
+			w.putBit(0);
+			for (uint i = 0; i < colors; i++)
+				w.putBits(nextRandom(), 8);
+
+			if (patternsLeft == 0) {
+				patternsLeft = blockWidth * 8;
+				w.putBits(patternsLeft, patternLength);
+				for (uint i = 0; i < patternsLeft; i++)
+					w.putBits(nextRandom(), 8);
+			}
+			if (type == kBlockPattern)
+				patternsLeft = 0;
+
+			if (y == 0) {
+				w.putBits(0, valuesLength);	// x offsets
+				w.putBits(0, valuesLength);	// y offsets
+				w.putBits(0, valuesLength);	// intra DC
+				w.putBits(0, valuesLength);	// inter DC
+				w.putBits(0, runLength);
+			}
+		}
+
+		w.align();
+	}
+
+	uint32 _seed;
+};
+
+#endif
@@ -0,0 +1,235 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/crc.h"
+#include "common/memstream.h"
+#include "common/stream.h"
+
+#include "graphics/surface.h"
+#include "video/smk_decoder.h"
+
+/**
+ * Writes bits in the order the Smacker decoder reads them.
+ */
+class SmackerTestBitWriter {
+public:
+	SmackerTestBitWriter() : _bits(0) {}
+
+	void putBit(uint bit) {
+		if ((_bits & 7) == 0)
+			_data.push_back(0);
+		_data[_bits >> 3] |= (bit & 1) << (_bits & 7);
+		_bits++;
+	}
+
+	void putBits(uint32 value, int count) {
+		for (int i = 0; i < count; i++)
+			putBit(value >> i);
+	}
+
+	void putCode(uint32 code, int length) {
+		// Codes are stored with their first bit in bit 0
+		putBits(code, length);
+	}
+
+	const Common::Array<byte> &data() const { return _data; }
+
+private:
+	Common::Array<byte> _data;
+	uint32 _bits;
+};
+
+/**
+ * Builds Smacker videos with random Huffman trees and random frame data.
+ * Any bit sequence decodes to some frame, so the decoded frames depend on
+ * every detail of the Huffman decoding.
+ */
+class SmackerTestVideo {
+public:
+	SmackerTestVideo(uint32 seed) : _seed(seed) {}
+
+	Common::SeekableReadStream *create(uint width, uint height, uint frames, uint frameSize) {
+		SmackerTestBitWriter trees;
+		uint32 treeSizes[4];
+		for (int i = 0; i < 4; i++)
+			treeSizes[i] = writeBigTree(trees, i == 3 ? 6 : 16);
+
+		Common::Array<byte> data;
+		putUint32BE(data, MKTAG('S', 'M', 'K', '4'));
+		putUint32LE(data, width);
+		putUint32LE(data, height);
+		putUint32LE(data, frames);
+		putUint32LE(data, 100);	// frame delay
+		putUint32LE(data, 0);	// flags
+		for (int i = 0; i < 7; i++)
+			putUint32LE(data, 0);	// audio size
+		putUint32LE(data, trees.data().size());
+		for (int i = 0; i < 4; i++)
+			putUint32LE(data, treeSizes[i]);
+		for (int i = 0; i < 7; i++)
+			putUint32LE(data, 0);	// audio rate
+		putUint32LE(data, 0);	// dummy
+		for (uint i = 0; i < frames; i++)
+			putUint32LE(data, frameSize);
+		for (uint i = 0; i < frames; i++)
+			data.push_back(0);	// frame type
+		data.push_back(trees.data());
+
+		for (uint i = 0; i < frames * frameSize; i++)
+			data.push_back(nextRandom() >> 8);
+
+		byte *buffer = (byte *)malloc(data.size());
+		memcpy(buffer, &data[0], data.size());
+		return new Common::MemoryReadStream(buffer, data.size(), DisposeAfterUse::YES);
+	}
+
+private:
+	struct Item {
+		bool leaf;
+		uint32 code;
+		int length;
+	};
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 8;
+	}
+
+	static void putUint32LE(Common::Array<byte> &data, uint32 value) {
+		for (int i = 0; i < 4; i++)
+			data.push_back(value >> (8 * i));
+	}
+
+	static void putUint32BE(Common::Array<byte> &data, uint32 value) {
+		for (int i = 3; i >= 0; i--)
+			data.push_back(value >> (8 * i));
+	}
+
+	/** Generates a random tree shape in the order it is stored in. */
+	void makeShape(Common::Array<Item> &items, uint32 code, int length, int maxDepth, uint &leaves, uint maxLeaves) {
+		Item item;
+		item.code = code;
+		item.length = length;
+		// Split less often further down, but reach deep codes now and then
+		item.leaf = length >= maxDepth || leaves + 2 > maxLeaves || (length > 0 && nextRandom() % 16 < (uint32)MIN(length + 3, 14));
+		items.push_back(item);
+
+		if (item.leaf) {
+			leaves++;
+			return;
+		}
+
+		makeShape(items, code, length + 1, maxDepth, leaves, maxLeaves);
+		makeShape(items, code | (1 << length), length + 1, maxDepth, leaves, maxLeaves);
+	}
+
+	/** Writes a SmallHuffmanTree, and returns the values of its leaves and their codes. */
+	void writeSmallTree(SmackerTestBitWriter &w, Common::Array<byte> &values, Common::Array<Item> &codes) {
+		Common::Array<Item> items;
+		uint leaves = 0;
+		makeShape(items, 0, 0, 12, leaves, 256);
+
+		w.putBit(1);
+		for (uint i = 0; i < items.size(); i++) {
+			w.putBit(!items[i].leaf);
+			if (items[i].leaf) {
+				const byte value = nextRandom() >> 4;
+				w.putBits(value, 8);
+				values.push_back(value);
+				codes.push_back(items[i]);
+			}
+		}
+		w.putBit(0);
+	}
+
+	/** Writes a BigHuffmanTree, and returns the size to allocate for it. */
+	uint32 writeBigTree(SmackerTestBitWriter &w, int maxDepth) {
+		Common::Array<byte> loValues, hiValues;
+		Common::Array<Item> loCodes, hiCodes;
+
+		w.putBit(1);
+		writeSmallTree(w, loValues, loCodes);
+		writeSmallTree(w, hiValues, hiCodes);
+
+		Common::Array<Item> items;
+		uint leaves = 0;
+		makeShape(items, 0, 0, maxDepth, leaves, 4096);
+
+		// Pick leaves for two of the markers, the third is not in the tree
+		uint32 markers[3];
+		uint32 values[3] = { 0, 0, 0 };
+		uint marker = 0;
+		Common::Array<uint32> leafValues;
+		for (uint i = 0; i < items.size(); i++) {
+			if (!items[i].leaf)
+				continue;
+			const uint lo = nextRandom() % loValues.size();
+			const uint hi = nextRandom() % hiValues.size();
+			leafValues.push_back(loValues[lo] | (hiValues[hi] << 8));
+			if (marker < 2 && nextRandom() % 8 == 0)
+				values[marker++] = leafValues.back();
+		}
+		markers[0] = values[0];
+		markers[1] = values[1];
+		markers[2] = 0xfedc;
+		for (int i = 0; i < 3; i++)
+			w.putBits(markers[i], 16);
+
+		uint leaf = 0;
+		for (uint i = 0; i < items.size(); i++) {
+			w.putBit(!items[i].leaf);
+			if (items[i].leaf) {
+				const uint32 value = leafValues[leaf++];
+				for (uint j = 0; j < loValues.size(); j++) {
+					if (loValues[j] == (value & 0xff)) {
+						w.putCode(loCodes[j].code, loCodes[j].length);
+						break;
+					}
+				}
+				for (uint j = 0; j < hiValues.size(); j++) {
+					if (hiValues[j] == (value >> 8)) {
+						w.putCode(hiCodes[j].code, hiCodes[j].length);
+						break;
+					}
+				}
+			}
+		}
+		w.putBit(0);
+
+		return (items.size() + 3) * 4;
+	}
+
+	uint32 _seed;
+};
+
+class SmackerDecoderTestSuite : public CxxTest::TestSuite
+{
+public:
+	void test_huffman_decoding() {
+		// Checksums of the frames decoded by the original tree-walking
+		// Huffman decoder
+		static const uint32 expected[3][4] = {
+			{ 0x027204b0, 0x2804f780, 0x8d396e80, 0x6e02372c },
+			{ 0xef3b1326, 0x59843eaf, 0x87236bc3, 0x9d740b48 },
+			{ 0x48361981, 0xa160ba73, 0x9f6d8837, 0x6ab564c0 }
+		};
+
+		for (uint32 seed = 0; seed < 3; seed++) {
+			SmackerTestVideo video(seed + 1);
+			Video::SmackerDecoder decoder;
+			TS_ASSERT(decoder.loadStream(video.create(64, 48, 4, 8192)));
+
+			for (uint frame = 0; frame < 4; frame++) {
+				const Graphics::Surface *surface = decoder.decodeNextFrame();
+				TS_ASSERT(surface);
+				if (!surface)
+					break;
+
+				uint32 crc = 0;
+				for (int y = 0; y < surface->h; y++)
+					crc = Common::CRC32().crcFast((const byte *)surface->getBasePtr(0, y), surface->w) ^ (crc * 31);
+				TS_ASSERT_EQUALS(crc, expected[seed][frame]);
+			}
+		}
+	}
+};
@@ -27,6 +27,7 @@
 #include "audio/decoders/raw.h"
 
 #include "common/util.h"
+#include "common/debug.h"
 #include "common/textconsole.h"
 #include "common/math.h"
 #include "common/stream.h"
@@ -35,7 +36,9 @@
 #include "common/str.h"
 #include "common/bitstream.h"
 #include "common/huffman.h"
+#include "common/memstream.h"
 #include "common/system.h"
+#include "common/jobsystem.h"
 
 #include "graphics/yuv_to_rgb.h"
 #include "graphics/surface.h"
@@ -59,6 +62,10 @@ static const uint16 kAudioFlagStereo = 0x2000;
 // Number of bits used to store first DC value in bundle
 static const uint32 kDCStartBits = 11;
 
+// Number of frames in which the offset of the color planes must be right
+// before the alpha plane is decoded along with them
+static const uint32 kPlaneOffsetChecks = 4;
+
 namespace Video {
 
 BinkDecoder::BinkDecoder() {
@@ -200,13 +207,16 @@ void BinkDecoder::readNextPacket() {
 		}
 	}
 
-	uint32 videoPacketStart = _bink->pos();
-	uint32 videoPacketEnd   = _bink->pos() + frameSize;
+	// Read the video packet into memory, so that several planes can be read
+	// from it at the same time
+	byte *videoPacket = (byte *)malloc(MAX<uint32>(frameSize, 1));
+	if (_bink->read(videoPacket, frameSize) != frameSize)
+		error("Bink video packet too short");
 
-	frame.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-			videoPacketStart, videoPacketEnd), DisposeAfterUse::YES);
+	frame.bits = new Common::BitStream32LELSB(new Common::MemoryReadStream(videoPacket, frameSize,
+			DisposeAfterUse::YES), DisposeAfterUse::YES);
 
-	videoTrack->decodePacket(frame);
+	videoTrack->decodePacket(frame, videoPacket, frameSize);
 
 	delete frame.bits;
 	frame.bits = 0;
@@ -249,25 +259,37 @@ BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, uint32
 	for (int i = 0; i < 16; i++)
 		_huffman[i] = 0;
 
-	for (int i = 0; i < kSourceMAX; i++) {
-		_bundles[i].countLength = 0;
+	for (int s = 0; s < 2; s++) {
+		PlaneState &state = _planeStates[s];
 
-		_bundles[i].huffman.index = 0;
-		for (int j = 0; j < 16; j++)
-			_bundles[i].huffman.symbols[j] = j;
+		state.bits = 0;
 
-		_bundles[i].data     = 0;
-		_bundles[i].dataEnd  = 0;
-		_bundles[i].curDec   = 0;
-		_bundles[i].curPtr   = 0;
-	}
+		for (int i = 0; i < kSourceMAX; i++) {
+			state.bundles[i].countLength = 0;
 
-	for (int i = 0; i < 16; i++) {
-		_colHighHuffman[i].index = 0;
-		for (int j = 0; j < 16; j++)
-			_colHighHuffman[i].symbols[j] = j;
+			state.bundles[i].huffman.index = 0;
+			for (int j = 0; j < 16; j++)
+				state.bundles[i].huffman.symbols[j] = j;
+
+			state.bundles[i].data     = 0;
+			state.bundles[i].dataEnd  = 0;
+			state.bundles[i].curDec   = 0;
+			state.bundles[i].curPtr   = 0;
+		}
+
+		for (int i = 0; i < 16; i++) {
+			state.colHighHuffman[i].index = 0;
+			for (int j = 0; j < 16; j++)
+				state.colHighHuffman[i].symbols[j] = j;
+		}
+
+		state.colLastVal = 0;
 	}
 
+	_planeOffsetMode = kPlaneOffsetUnknown;
+	_planeOffsetMatches = 0;
+	_convertBandHeight = 0;
+
 	// Make the surface even-sized:
 	_surfaceHeight = _height = height;
 	_surfaceWidth = _width = width;
@@ -446,7 +468,7 @@ bool BinkDecoder::BinkVideoTrack::rewind() {
 	return true;
 }
 
-void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
+void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame, const byte *data, uint32 size) {
 	assert(frame.bits);
 
 	if (!_surface) {
@@ -459,46 +481,179 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 		_surface->w = _width;
 	}
 
+	_planeStates[0].bits = frame.bits;
+	_planeStates[1].bits = frame.bits;
+
+	bool colorDecoded = false;
+
 	if (_hasAlpha) {
+		if (_id == kBIKiID) {
+			const uint32 fieldPos = frame.bits->pos();
+			const uint32 offset   = frame.bits->getBits<32>();
+			const uint32 start    = predictColorPlanesStart(fieldPos, offset);
+
+			if (start && (uint64)start + 32 <= (uint64)size * 8)
+				colorDecoded = decodePlanesConcurrently(data, size, start);
+			else
+				decodePlane(_planeStates[1], 3, false);
+
+			checkColorPlanesStart(fieldPos, offset, frame.bits->pos());
+		} else {
+			decodePlane(_planeStates[1], 3, false);
+		}
+	}
+
+	if (!colorDecoded) {
 		if (_id == kBIKiID)
 			frame.bits->skip(32);
 
-		decodePlane(frame, 3, false);
+		decodeColorPlanes(_planeStates[0]);
 	}
 
-	if (_id == kBIKiID)
-		frame.bits->skip(32);
+	_planeStates[0].bits = 0;
+	_planeStates[1].bits = 0;
+
+	convertPlanes();
 
+	// And swap the planes with the reference planes
+	for (int i = 0; i < 4; i++)
+		SWAP(_curPlanes[i], _oldPlanes[i]);
+
+	_curFrame++;
+}
+
+void BinkDecoder::BinkVideoTrack::decodeColorPlanes(PlaneState &state) {
 	for (int i = 0; i < 3; i++) {
 		int planeIdx = ((i == 0) || !_swapPlanes) ? i : (i ^ 3);
 
-		decodePlane(frame, planeIdx, i != 0);
+		decodePlane(state, planeIdx, i != 0);
 
-		if (frame.bits->pos() >= frame.bits->size())
+		if (state.bits->pos() >= state.bits->size())
 			break;
 	}
+}
+
+bool BinkDecoder::BinkVideoTrack::decodePlanesConcurrently(const byte *data, uint32 size, uint32 start) {
+	// The color planes get a bitstream of their own, starting after the
+	// offset field in front of them
+	Common::BitStream32LELSB colorBits(new Common::MemoryReadStream(data, size), DisposeAfterUse::YES);
+	colorBits.skip(start + 32);
+
+	Common::BitStream32LELSB *alphaBits = _planeStates[1].bits;
+	_planeStates[0].bits = &colorBits;
+
+	// The alpha plane is decoded on a worker while this thread decodes the
+	// color planes
+	Common::TaskGroup group;
+	group.run(&decodeAlphaPlaneProc, this);
+	decodeColorPlanes(_planeStates[0]);
+	group.wait();
+
+	_planeStates[0].bits = alphaBits;
+
+	if (alphaBits->pos() == start)
+		return true;
+
+	// The color planes have to be decoded again from the right position
+	warning("BinkVideoTrack: Alpha plane ends at %u instead of %u", alphaBits->pos(), start);
+	return false;
+}
+
+void BinkDecoder::BinkVideoTrack::decodeAlphaPlaneProc(void *param, uint worker) {
+	BinkVideoTrack *track = (BinkVideoTrack *)param;
+	track->decodePlane(track->_planeStates[1], 3, false);
+}
+
+uint32 BinkDecoder::BinkVideoTrack::predictColorPlanesStart(uint32 fieldPos, uint32 offset) const {
+	if (_planeOffsetMatches < kPlaneOffsetChecks || Common::JobSystem::instance().getWorkerCount() < 2)
+		return 0;
+
+	uint64 start;
+	if (_planeOffsetMode == kPlaneOffsetAbsolute)
+		start = (uint64)offset * 8;
+	else if (_planeOffsetMode == kPlaneOffsetRelative)
+		start = fieldPos + 32 + (uint64)offset * 8;
+	else
+		return 0;
+
+	// Planes start at 32-bit boundaries
+	if (start > 0xFFFFFFFF || (start & 0x1F))
+		return 0;
+
+	return (uint32)start;
+}
+
+void BinkDecoder::BinkVideoTrack::checkColorPlanesStart(uint32 fieldPos, uint32 offset, uint32 start) {
+	if (_planeOffsetMode == kPlaneOffsetInvalid)
+		return;
+
+	PlaneOffsetMode mode = kPlaneOffsetInvalid;
+	if ((uint64)offset * 8 == start)
+		mode = kPlaneOffsetAbsolute;
+	else if (fieldPos + 32 + (uint64)offset * 8 == start)
+		mode = kPlaneOffsetRelative;
+
+	if (_planeOffsetMode == kPlaneOffsetUnknown)
+		_planeOffsetMode = mode;
+
+	if (mode != _planeOffsetMode) {
+		// Never trust the offsets of this video again
+		debug(1, "BinkVideoTrack: Offset of the color planes does not match in frame %d", _curFrame + 1);
+		_planeOffsetMode = kPlaneOffsetInvalid;
+		return;
+	}
+
+	_planeOffsetMatches++;
+}
+
+void BinkDecoder::BinkVideoTrack::convertPlanes() {
+	// Convert the YUV data we have to our format in bands of an even number
+	// of lines. The first band is converted on its own, as the converter
+	// sets up its lookup tables on first use.
+	const uint threads = Common::JobSystem::instance().getWorkerCount();
+	const uint bands = (threads > 1) ? threads * 2 : 1;
+
+	_convertBandHeight = ((_surfaceHeight + bands - 1) / bands + 1) & ~1;
+
+	convertBand(0);
+
+	const uint remainingBands = (_surfaceHeight + _convertBandHeight - 1) / _convertBandHeight - 1;
+	Common::JobSystem::instance().parallelFor(0, remainingBands, 1, &convertBandProc, this);
+}
+
+void BinkDecoder::BinkVideoTrack::convertBandProc(void *param, uint begin, uint end, uint worker) {
+	for (uint i = begin; i < end; i++)
+		((BinkVideoTrack *)param)->convertBand(i + 1);
+}
+
+void BinkDecoder::BinkVideoTrack::convertBand(uint index) {
+	const int top    = index * _convertBandHeight;
+	const int height = MIN<int>(_convertBandHeight, _surfaceHeight - top);
+
+	const uint32 yPitch  = _yBlockWidth  * 8;
+	const uint32 uvPitch = _uvBlockWidth * 8;
 
-	// Convert the YUV data we have to our format
 	// The width used here is the surface-width, and not the video-width
 	// to allow for odd-sized videos.
+	Graphics::Surface band;
+	band.init(_surfaceWidth, height, _surface->pitch, _surface->getBasePtr(0, top), _surface->format);
+
+	const byte *y = _curPlanes[0] + top * yPitch;
+	const byte *u = _curPlanes[1] + (top / 2) * uvPitch;
+	const byte *v = _curPlanes[2] + (top / 2) * uvPitch;
+
 	if (_hasAlpha) {
 		assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2] && _curPlanes[3]);
-		YUVToRGBMan.convert420Alpha(_surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2], _curPlanes[3],
-				_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
+		YUVToRGBMan.convert420Alpha(&band, Graphics::YUVToRGBManager::kScaleITU, y, u, v, _curPlanes[3] + top * yPitch,
+				_surfaceWidth, height, yPitch, uvPitch);
 	} else {
 		assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2]);
-		YUVToRGBMan.convert420(_surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2],
-				_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
+		YUVToRGBMan.convert420(&band, Graphics::YUVToRGBManager::kScaleITU, y, u, v,
+				_surfaceWidth, height, yPitch, uvPitch);
 	}
-
-	// And swap the planes with the reference planes
-	for (int i = 0; i < 4; i++)
-		SWAP(_curPlanes[i], _oldPlanes[i]);
-
-	_curFrame++;
 }
 
-void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, bool isChroma) {
+void BinkDecoder::BinkVideoTrack::decodePlane(PlaneState &state, int planeIdx, bool isChroma) {
 	uint32 blockWidth  = isChroma ? _uvBlockWidth  : _yBlockWidth;
 	uint32 blockHeight = isChroma ? _uvBlockHeight : _yBlockHeight;
 	uint32 width       = blockWidth  * 8;
@@ -506,7 +661,7 @@ void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, b
 
 	DecodeContext ctx;
 
-	ctx.video     = &video;
+	ctx.state     = &state;
 	ctx.planeIdx  = planeIdx;
 	ctx.destStart = _curPlanes[planeIdx];
 	ctx.destEnd   = _curPlanes[planeIdx] + width * height;
@@ -524,27 +679,27 @@ void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, b
 	}
 
 	for (int i = 0; i < kSourceMAX; i++) {
-		_bundles[i].countLength = _bundles[i].countLengths[isChroma ? 1 : 0];
+		state.bundles[i].countLength = state.bundles[i].countLengths[isChroma ? 1 : 0];
 
-		readBundle(video, (Source) i);
+		readBundle(state, (Source) i);
 	}
 
 	for (ctx.blockY = 0; ctx.blockY < blockHeight; ctx.blockY++) {
-		readBlockTypes              (video, _bundles[kSourceBlockTypes]);
-		readBlockTypes              (video, _bundles[kSourceSubBlockTypes]);
-		readColors                  (video, _bundles[kSourceColors]);
-		readPatterns                (video, _bundles[kSourcePattern]);
-		readMotionValues            (video, _bundles[kSourceXOff]);
-		readMotionValues            (video, _bundles[kSourceYOff]);
-		readDCS<kDCStartBits, false>(video, _bundles[kSourceIntraDC]);
-		readDCS<kDCStartBits, true> (video, _bundles[kSourceInterDC]);
-		readRuns                    (video, _bundles[kSourceRun]);
+		readBlockTypes              (state, state.bundles[kSourceBlockTypes]);
+		readBlockTypes              (state, state.bundles[kSourceSubBlockTypes]);
+		readColors                  (state, state.bundles[kSourceColors]);
+		readPatterns                (state, state.bundles[kSourcePattern]);
+		readMotionValues            (state, state.bundles[kSourceXOff]);
+		readMotionValues            (state, state.bundles[kSourceYOff]);
+		readDCS<kDCStartBits, false>(state, state.bundles[kSourceIntraDC]);
+		readDCS<kDCStartBits, true> (state, state.bundles[kSourceInterDC]);
+		readRuns                    (state, state.bundles[kSourceRun]);
 
 		ctx.dest = ctx.destStart + 8 * ctx.blockY * ctx.pitch;
 		ctx.prev = ctx.prevStart + 8 * ctx.blockY * ctx.pitch;
 
 		for (ctx.blockX = 0; ctx.blockX < blockWidth; ctx.blockX++, ctx.dest += 8, ctx.prev += 8) {
-			BlockType blockType = (BlockType) getBundleValue(kSourceBlockTypes);
+			BlockType blockType = (BlockType) getBundleValue(*ctx.state, kSourceBlockTypes);
 
 			// 16x16 block type on odd line means part of the already decoded block, so skip it
 			if ((ctx.blockY & 1) && (blockType == kBlockScaled)) {
@@ -593,28 +748,28 @@ void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, b
 
 	}
 
-	if (video.bits->pos() & 0x1F) // next plane data starts at 32-bit boundary
-		video.bits->skip(32 - (video.bits->pos() & 0x1F));
+	if (state.bits->pos() & 0x1F) // next plane data starts at 32-bit boundary
+		state.bits->skip(32 - (state.bits->pos() & 0x1F));
 
 }
 
-void BinkDecoder::BinkVideoTrack::readBundle(VideoFrame &video, Source source) {
+void BinkDecoder::BinkVideoTrack::readBundle(PlaneState &state, Source source) {
 	if (source == kSourceColors) {
 		for (int i = 0; i < 16; i++)
-			readHuffman(video, _colHighHuffman[i]);
+			readHuffman(state, state.colHighHuffman[i]);
 
-		_colLastVal = 0;
+		state.colLastVal = 0;
 	}
 
 	if ((source != kSourceIntraDC) && (source != kSourceInterDC))
-		readHuffman(video, _bundles[source].huffman);
+		readHuffman(state, state.bundles[source].huffman);
 
-	_bundles[source].curDec = _bundles[source].data;
-	_bundles[source].curPtr = _bundles[source].data;
+	state.bundles[source].curDec = state.bundles[source].data;
+	state.bundles[source].curPtr = state.bundles[source].data;
 }
 
-void BinkDecoder::BinkVideoTrack::readHuffman(VideoFrame &video, Huffman &huffman) {
-	huffman.index = video.bits->getBits<4>();
+void BinkDecoder::BinkVideoTrack::readHuffman(PlaneState &state, Huffman &huffman) {
+	huffman.index = state.bits->getBits<4>();
 
 	if (huffman.index == 0) {
 		// The first tree always gives raw nibbles
@@ -626,13 +781,13 @@ void BinkDecoder::BinkVideoTrack::readHuffman(VideoFrame &video, Huffman &huffma
 
 	byte hasSymbol[16];
 
-	if (video.bits->getBit()) {
+	if (state.bits->getBit()) {
 		// Symbol selection
 		memset(hasSymbol, 0, 16);
 
-		uint8 length = video.bits->getBits<3>();
+		uint8 length = state.bits->getBits<3>();
 		for (int i = 0; i <= length; i++) {
-			huffman.symbols[i] = video.bits->getBits<4>();
+			huffman.symbols[i] = state.bits->getBits<4>();
 			hasSymbol[huffman.symbols[i]] = 1;
 		}
 
@@ -648,7 +803,7 @@ void BinkDecoder::BinkVideoTrack::readHuffman(VideoFrame &video, Huffman &huffma
 	byte tmp1[16], tmp2[16];
 	byte *in = tmp1, *out = tmp2;
 
-	uint8 depth = video.bits->getBits<2>();
+	uint8 depth = state.bits->getBits<2>();
 
 	for (int i = 0; i < 16; i++)
 		in[i] = i;
@@ -657,7 +812,7 @@ void BinkDecoder::BinkVideoTrack::readHuffman(VideoFrame &video, Huffman &huffma
 		int size = 1 << i;
 
 		for (int j = 0; j < 16; j += (size << 1))
-			mergeHuffmanSymbols(video, out + j, in + j, size);
+			mergeHuffmanSymbols(state, out + j, in + j, size);
 
 		SWAP(in, out);
 	}
@@ -665,12 +820,12 @@ void BinkDecoder::BinkVideoTrack::readHuffman(VideoFrame &video, Huffman &huffma
 	memcpy(huffman.symbols, in, 16);
 }
 
-void BinkDecoder::BinkVideoTrack::mergeHuffmanSymbols(VideoFrame &video, byte *dst, const byte *src, int size) {
+void BinkDecoder::BinkVideoTrack::mergeHuffmanSymbols(PlaneState &state, byte *dst, const byte *src, int size) {
 	const byte *src2  = src + size;
 	int size2 = size;
 
 	do {
-		if (!video.bits->getBit()) {
+		if (!state.bits->getBit()) {
 			*dst++ = *src++;
 			size--;
 		} else {
@@ -692,33 +847,42 @@ void BinkDecoder::BinkVideoTrack::initBundles() {
 	uint32 bh     = (_height + 7) >> 3;
 	uint32 blocks = bw * bh;
 
-	for (int i = 0; i < kSourceMAX; i++) {
-		_bundles[i].data    = new byte[blocks * 64];
-		_bundles[i].dataEnd = _bundles[i].data + blocks * 64;
+	for (int s = 0; s < 2; s++) {
+		for (int i = 0; i < kSourceMAX; i++) {
+			_planeStates[s].bundles[i].data    = new byte[blocks * 64];
+			_planeStates[s].bundles[i].dataEnd = _planeStates[s].bundles[i].data + blocks * 64;
+		}
 	}
 
 	uint32 cbw[2] = { (uint32)((_width + 7) >> 3), (uint32)((_width  + 15) >> 4) };
 	uint32 cw [2] = { (uint32)( _width          ), (uint32)( _width        >> 1) };
 
 	// Calculate the lengths of an element count in bits
+	Bundle *bundles = _planeStates[0].bundles;
 	for (int i = 0; i < 2; i++) {
 		int width = MAX<uint32>(cw[i], 8);
 
-		_bundles[kSourceBlockTypes   ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
-		_bundles[kSourceSubBlockTypes].countLengths[i] = Common::intLog2(((width + 7) >> 4) + 511) + 1;
-		_bundles[kSourceColors       ].countLengths[i] = Common::intLog2((cbw[i])     * 64  + 511) + 1;
-		_bundles[kSourceIntraDC      ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
-		_bundles[kSourceInterDC      ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
-		_bundles[kSourceXOff         ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
-		_bundles[kSourceYOff         ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
-		_bundles[kSourcePattern      ].countLengths[i] = Common::intLog2((cbw[i]      << 3) + 511) + 1;
-		_bundles[kSourceRun          ].countLengths[i] = Common::intLog2((cbw[i])     * 48  + 511) + 1;
+		bundles[kSourceBlockTypes   ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
+		bundles[kSourceSubBlockTypes].countLengths[i] = Common::intLog2(((width + 7) >> 4) + 511) + 1;
+		bundles[kSourceColors       ].countLengths[i] = Common::intLog2((cbw[i])     * 64  + 511) + 1;
+		bundles[kSourceIntraDC      ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
+		bundles[kSourceInterDC      ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
+		bundles[kSourceXOff         ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
+		bundles[kSourceYOff         ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
+		bundles[kSourcePattern      ].countLengths[i] = Common::intLog2((cbw[i]      << 3) + 511) + 1;
+		bundles[kSourceRun          ].countLengths[i] = Common::intLog2((cbw[i])     * 48  + 511) + 1;
+	}
+
+	for (int i = 0; i < kSourceMAX; i++) {
+		_planeStates[1].bundles[i].countLengths[0] = bundles[i].countLengths[0];
+		_planeStates[1].bundles[i].countLengths[1] = bundles[i].countLengths[1];
 	}
 }
 
 void BinkDecoder::BinkVideoTrack::deinitBundles() {
-	for (int i = 0; i < kSourceMAX; i++)
-		delete[] _bundles[i].data;
+	for (int s = 0; s < 2; s++)
+		for (int i = 0; i < kSourceMAX; i++)
+			delete[] _planeStates[s].bundles[i].data;
 }
 
 void BinkDecoder::BinkVideoTrack::initHuffman() {
@@ -726,29 +890,29 @@ void BinkDecoder::BinkVideoTrack::initHuffman() {
 		_huffman[i] = new Common::Huffman<Common::BitStream32LELSB>(binkHuffmanLengths[i][15], 16, binkHuffmanCodes[i], binkHuffmanLengths[i]);
 }
 
-byte BinkDecoder::BinkVideoTrack::getHuffmanSymbol(VideoFrame &video, Huffman &huffman) {
-	return huffman.symbols[_huffman[huffman.index]->getSymbol(*video.bits)];
+byte BinkDecoder::BinkVideoTrack::getHuffmanSymbol(PlaneState &state, Huffman &huffman) {
+	return huffman.symbols[_huffman[huffman.index]->getSymbol(*state.bits)];
 }
 
-int32 BinkDecoder::BinkVideoTrack::getBundleValue(Source source) {
+int32 BinkDecoder::BinkVideoTrack::getBundleValue(PlaneState &state, Source source) {
 	if ((source < kSourceXOff) || (source == kSourceRun))
-		return *_bundles[source].curPtr++;
+		return *state.bundles[source].curPtr++;
 
 	if ((source == kSourceXOff) || (source == kSourceYOff))
-		return (int8) *_bundles[source].curPtr++;
+		return (int8) *state.bundles[source].curPtr++;
 
-	int16 ret = *((int16 *) _bundles[source].curPtr);
+	int16 ret = *((int16 *) state.bundles[source].curPtr);
 
-	_bundles[source].curPtr += 2;
+	state.bundles[source].curPtr += 2;
 
 	return ret;
 }
 
-uint32 BinkDecoder::BinkVideoTrack::readBundleCount(VideoFrame &video, Bundle &bundle) {
+uint32 BinkDecoder::BinkVideoTrack::readBundleCount(PlaneState &state, Bundle &bundle) {
 	if (!bundle.curDec || (bundle.curDec > bundle.curPtr))
 		return 0;
 
-	uint32 n = video.bits->getBits(bundle.countLength);
+	uint32 n = state.bits->getBits(bundle.countLength);
 	if (n == 0)
 		bundle.curDec = 0;
 
@@ -772,19 +936,19 @@ void BinkDecoder::BinkVideoTrack::blockScaledSkip(DecodeContext &ctx) {
 }
 
 void BinkDecoder::BinkVideoTrack::blockScaledRun(DecodeContext &ctx) {
-	const uint8 *scan = binkPatterns[ctx.video->bits->getBits<4>()];
+	const uint8 *scan = binkPatterns[ctx.state->bits->getBits<4>()];
 
 	int i = 0;
 	do {
-		int run = getBundleValue(kSourceRun) + 1;
+		int run = getBundleValue(*ctx.state, kSourceRun) + 1;
 
 		i += run;
 		if (i > 64)
 			error("Run went out of bounds");
 
-		if (ctx.video->bits->getBit()) {
+		if (ctx.state->bits->getBit()) {
 
-			byte v = getBundleValue(kSourceColors);
+			byte v = getBundleValue(*ctx.state, kSourceColors);
 			for (int j = 0; j < run; j++, scan++)
 				ctx.dest[ctx.coordScaledMap1[*scan]] =
 				ctx.dest[ctx.coordScaledMap2[*scan]] =
@@ -796,7 +960,7 @@ void BinkDecoder::BinkVideoTrack::blockScaledRun(DecodeContext &ctx) {
 				ctx.dest[ctx.coordScaledMap1[*scan]] =
 				ctx.dest[ctx.coordScaledMap2[*scan]] =
 				ctx.dest[ctx.coordScaledMap3[*scan]] =
-				ctx.dest[ctx.coordScaledMap4[*scan]] = getBundleValue(kSourceColors);
+				ctx.dest[ctx.coordScaledMap4[*scan]] = getBundleValue(*ctx.state, kSourceColors);
 
 	} while (i < 63);
 
@@ -804,16 +968,16 @@ void BinkDecoder::BinkVideoTrack::blockScaledRun(DecodeContext &ctx) {
 		ctx.dest[ctx.coordScaledMap1[*scan]] =
 		ctx.dest[ctx.coordScaledMap2[*scan]] =
 		ctx.dest[ctx.coordScaledMap3[*scan]] =
-		ctx.dest[ctx.coordScaledMap4[*scan]] = getBundleValue(kSourceColors);
+		ctx.dest[ctx.coordScaledMap4[*scan]] = getBundleValue(*ctx.state, kSourceColors);
 }
 
 void BinkDecoder::BinkVideoTrack::blockScaledIntra(DecodeContext &ctx) {
 	int32 block[64];
 	memset(block, 0, 64 * sizeof(int32));
 
-	block[0] = getBundleValue(kSourceIntraDC);
+	block[0] = getBundleValue(*ctx.state, kSourceIntraDC);
 
-	readDCTCoeffs(*ctx.video, block, true);
+	readDCTCoeffs(*ctx.state, block, true);
 
 	IDCT(block);
 
@@ -829,7 +993,7 @@ void BinkDecoder::BinkVideoTrack::blockScaledIntra(DecodeContext &ctx) {
 }
 
 void BinkDecoder::BinkVideoTrack::blockScaledFill(DecodeContext &ctx) {
-	byte v = getBundleValue(kSourceColors);
+	byte v = getBundleValue(*ctx.state, kSourceColors);
 
 	byte *dest = ctx.dest;
 	for (int i = 0; i < 16; i++, dest += ctx.pitch)
@@ -840,12 +1004,12 @@ void BinkDecoder::BinkVideoTrack::blockScaledPattern(DecodeContext &ctx) {
 	byte col[2];
 
 	for (int i = 0; i < 2; i++)
-		col[i] = getBundleValue(kSourceColors);
+		col[i] = getBundleValue(*ctx.state, kSourceColors);
 
 	byte *dest1 = ctx.dest;
 	byte *dest2 = ctx.dest + ctx.pitch;
 	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16) {
-		byte v = getBundleValue(kSourcePattern);
+		byte v = getBundleValue(*ctx.state, kSourcePattern);
 
 		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2, v >>= 1)
 			dest1[0] = dest1[1] = dest2[0] = dest2[1] = col[v & 1];
@@ -858,17 +1022,17 @@ void BinkDecoder::BinkVideoTrack::blockScaledRaw(DecodeContext &ctx) {
 	byte *dest1 = ctx.dest;
 	byte *dest2 = ctx.dest + ctx.pitch;
 	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16) {
-		memcpy(row, _bundles[kSourceColors].curPtr, 8);
+		memcpy(row, ctx.state->bundles[kSourceColors].curPtr, 8);
 
 		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
 			dest1[0] = dest1[1] = dest2[0] = dest2[1] = row[i];
 
-		_bundles[kSourceColors].curPtr += 8;
+		ctx.state->bundles[kSourceColors].curPtr += 8;
 	}
 }
 
 void BinkDecoder::BinkVideoTrack::blockScaled(DecodeContext &ctx) {
-	BlockType blockType = (BlockType) getBundleValue(kSourceSubBlockTypes);
+	BlockType blockType = (BlockType) getBundleValue(*ctx.state, kSourceSubBlockTypes);
 
 	switch (blockType) {
 	case kBlockRun:
@@ -896,8 +1060,8 @@ void BinkDecoder::BinkVideoTrack::blockScaled(DecodeContext &ctx) {
 }
 
 void BinkDecoder::BinkVideoTrack::blockMotion(DecodeContext &ctx) {
-	int8 xOff = getBundleValue(kSourceXOff);
-	int8 yOff = getBundleValue(kSourceYOff);
+	int8 xOff = getBundleValue(*ctx.state, kSourceXOff);
+	int8 yOff = getBundleValue(*ctx.state, kSourceYOff);
 
 	byte *dest = ctx.dest;
 	byte *prev = ctx.prev + yOff * ((int32) ctx.pitch) + xOff;
@@ -909,41 +1073,41 @@ void BinkDecoder::BinkVideoTrack::blockMotion(DecodeContext &ctx) {
 }
 
 void BinkDecoder::BinkVideoTrack::blockRun(DecodeContext &ctx) {
-	const uint8 *scan = binkPatterns[ctx.video->bits->getBits<4>()];
+	const uint8 *scan = binkPatterns[ctx.state->bits->getBits<4>()];
 
 	int i = 0;
 	do {
-		int run = getBundleValue(kSourceRun) + 1;
+		int run = getBundleValue(*ctx.state, kSourceRun) + 1;
 
 		i += run;
 		if (i > 64)
 			error("Run went out of bounds");
 
-		if (ctx.video->bits->getBit()) {
+		if (ctx.state->bits->getBit()) {
 
-			byte v = getBundleValue(kSourceColors);
+			byte v = getBundleValue(*ctx.state, kSourceColors);
 			for (int j = 0; j < run; j++)
 				ctx.dest[ctx.coordMap[*scan++]] = v;
 
 		} else
 			for (int j = 0; j < run; j++)
-				ctx.dest[ctx.coordMap[*scan++]] = getBundleValue(kSourceColors);
+				ctx.dest[ctx.coordMap[*scan++]] = getBundleValue(*ctx.state, kSourceColors);
 
 	} while (i < 63);
 
 	if (i == 63)
-		ctx.dest[ctx.coordMap[*scan++]] = getBundleValue(kSourceColors);
+		ctx.dest[ctx.coordMap[*scan++]] = getBundleValue(*ctx.state, kSourceColors);
 }
 
 void BinkDecoder::BinkVideoTrack::blockResidue(DecodeContext &ctx) {
 	blockMotion(ctx);
 
-	byte v = ctx.video->bits->getBits<7>();
+	byte v = ctx.state->bits->getBits<7>();
 
 	int16 block[64];
 	memset(block, 0, 64 * sizeof(int16));
 
-	readResidue(*ctx.video, block, v);
+	readResidue(*ctx.state, block, v);
 
 	byte  *dst = ctx.dest;
 	int16 *src = block;
@@ -956,15 +1120,15 @@ void BinkDecoder::BinkVideoTrack::blockIntra(DecodeContext &ctx) {
 	int32 block[64];
 	memset(block, 0, 64 * sizeof(int32));
 
-	block[0] = getBundleValue(kSourceIntraDC);
+	block[0] = getBundleValue(*ctx.state, kSourceIntraDC);
 
-	readDCTCoeffs(*ctx.video, block, true);
+	readDCTCoeffs(*ctx.state, block, true);
 
 	IDCTPut(ctx, block);
 }
 
 void BinkDecoder::BinkVideoTrack::blockFill(DecodeContext &ctx) {
-	byte v = getBundleValue(kSourceColors);
+	byte v = getBundleValue(*ctx.state, kSourceColors);
 
 	byte *dest = ctx.dest;
 	for (int i = 0; i < 8; i++, dest += ctx.pitch)
@@ -977,9 +1141,9 @@ void BinkDecoder::BinkVideoTrack::blockInter(DecodeContext &ctx) {
 	int32 block[64];
 	memset(block, 0, 64 * sizeof(int32));
 
-	block[0] = getBundleValue(kSourceInterDC);
+	block[0] = getBundleValue(*ctx.state, kSourceInterDC);
 
-	readDCTCoeffs(*ctx.video, block, false);
+	readDCTCoeffs(*ctx.state, block, false);
 
 	IDCTAdd(ctx, block);
 }
@@ -988,11 +1152,11 @@ void BinkDecoder::BinkVideoTrack::blockPattern(DecodeContext &ctx) {
 	byte col[2];
 
 	for (int i = 0; i < 2; i++)
-		col[i] = getBundleValue(kSourceColors);
+		col[i] = getBundleValue(*ctx.state, kSourceColors);
 
 	byte *dest = ctx.dest;
 	for (int i = 0; i < 8; i++, dest += ctx.pitch - 8) {
-		byte v = getBundleValue(kSourcePattern);
+		byte v = getBundleValue(*ctx.state, kSourcePattern);
 
 		for (int j = 0; j < 8; j++, v >>= 1)
 			*dest++ = col[v & 1];
@@ -1001,15 +1165,15 @@ void BinkDecoder::BinkVideoTrack::blockPattern(DecodeContext &ctx) {
 
 void BinkDecoder::BinkVideoTrack::blockRaw(DecodeContext &ctx) {
 	byte *dest = ctx.dest;
-	byte *data = _bundles[kSourceColors].curPtr;
+	byte *data = ctx.state->bundles[kSourceColors].curPtr;
 	for (int i = 0; i < 8; i++, dest += ctx.pitch, data += 8)
 		memcpy(dest, data, 8);
 
-	_bundles[kSourceColors].curPtr += 64;
+	ctx.state->bundles[kSourceColors].curPtr += 64;
 }
 
-void BinkDecoder::BinkVideoTrack::readRuns(VideoFrame &video, Bundle &bundle) {
-	uint32 n = readBundleCount(video, bundle);
+void BinkDecoder::BinkVideoTrack::readRuns(PlaneState &state, Bundle &bundle) {
+	uint32 n = readBundleCount(state, bundle);
 	if (n == 0)
 		return;
 
@@ -1017,19 +1181,19 @@ void BinkDecoder::BinkVideoTrack::readRuns(VideoFrame &video, Bundle &bundle) {
 	if (decEnd > bundle.dataEnd)
 		error("Run value went out of bounds");
 
-	if (video.bits->getBit()) {
-		byte v = video.bits->getBits<4>();
+	if (state.bits->getBit()) {
+		byte v = state.bits->getBits<4>();
 
 		memset(bundle.curDec, v, n);
 		bundle.curDec += n;
 
 	} else
 		while (bundle.curDec < decEnd)
-			*bundle.curDec++ = getHuffmanSymbol(video, bundle.huffman);
+			*bundle.curDec++ = getHuffmanSymbol(state, bundle.huffman);
 }
 
-void BinkDecoder::BinkVideoTrack::readMotionValues(VideoFrame &video, Bundle &bundle) {
-	uint32 n = readBundleCount(video, bundle);
+void BinkDecoder::BinkVideoTrack::readMotionValues(PlaneState &state, Bundle &bundle) {
+	uint32 n = readBundleCount(state, bundle);
 	if (n == 0)
 		return;
 
@@ -1037,11 +1201,11 @@ void BinkDecoder::BinkVideoTrack::readMotionValues(VideoFrame &video, Bundle &bu
 	if (decEnd > bundle.dataEnd)
 		error("Too many motion values");
 
-	if (video.bits->getBit()) {
-		byte v = video.bits->getBits<4>();
+	if (state.bits->getBit()) {
+		byte v = state.bits->getBits<4>();
 
 		if (v) {
-			int sign = -(int)video.bits->getBit();
+			int sign = -(int)state.bits->getBit();
 			v = (v ^ sign) - sign;
 		}
 
@@ -1052,10 +1216,10 @@ void BinkDecoder::BinkVideoTrack::readMotionValues(VideoFrame &video, Bundle &bu
 	}
 
 	do {
-		byte v = getHuffmanSymbol(video, bundle.huffman);
+		byte v = getHuffmanSymbol(state, bundle.huffman);
 
 		if (v) {
-			int sign = -(int)video.bits->getBit();
+			int sign = -(int)state.bits->getBit();
 			v = (v ^ sign) - sign;
 		}
 
@@ -1065,8 +1229,8 @@ void BinkDecoder::BinkVideoTrack::readMotionValues(VideoFrame &video, Bundle &bu
 }
 
 const uint8 rleLens[4] = { 4, 8, 12, 32 };
-void BinkDecoder::BinkVideoTrack::readBlockTypes(VideoFrame &video, Bundle &bundle) {
-	uint32 n = readBundleCount(video, bundle);
+void BinkDecoder::BinkVideoTrack::readBlockTypes(PlaneState &state, Bundle &bundle) {
+	uint32 n = readBundleCount(state, bundle);
 	if (n == 0)
 		return;
 
@@ -1074,8 +1238,8 @@ void BinkDecoder::BinkVideoTrack::readBlockTypes(VideoFrame &video, Bundle &bund
 	if (decEnd > bundle.dataEnd)
 		error("Too many block type values");
 
-	if (video.bits->getBit()) {
-		byte v = video.bits->getBits<4>();
+	if (state.bits->getBit()) {
+		byte v = state.bits->getBits<4>();
 
 		memset(bundle.curDec, v, n);
 
@@ -1086,7 +1250,7 @@ void BinkDecoder::BinkVideoTrack::readBlockTypes(VideoFrame &video, Bundle &bund
 	byte last = 0;
 	do {
 
-		byte v = getHuffmanSymbol(video, bundle.huffman);
+		byte v = getHuffmanSymbol(state, bundle.huffman);
 
 		if (v < 12) {
 			last = v;
@@ -1102,8 +1266,8 @@ void BinkDecoder::BinkVideoTrack::readBlockTypes(VideoFrame &video, Bundle &bund
 	} while (bundle.curDec < decEnd);
 }
 
-void BinkDecoder::BinkVideoTrack::readPatterns(VideoFrame &video, Bundle &bundle) {
-	uint32 n = readBundleCount(video, bundle);
+void BinkDecoder::BinkVideoTrack::readPatterns(PlaneState &state, Bundle &bundle) {
+	uint32 n = readBundleCount(state, bundle);
 	if (n == 0)
 		return;
 
@@ -1113,15 +1277,15 @@ void BinkDecoder::BinkVideoTrack::readPatterns(VideoFrame &video, Bundle &bundle
 
 	byte v;
 	while (bundle.curDec < decEnd) {
-		v  = getHuffmanSymbol(video, bundle.huffman);
-		v |= getHuffmanSymbol(video, bundle.huffman) << 4;
+		v  = getHuffmanSymbol(state, bundle.huffman);
+		v |= getHuffmanSymbol(state, bundle.huffman) << 4;
 		*bundle.curDec++ = v;
 	}
 }
 
 
-void BinkDecoder::BinkVideoTrack::readColors(VideoFrame &video, Bundle &bundle) {
-	uint32 n = readBundleCount(video, bundle);
+void BinkDecoder::BinkVideoTrack::readColors(PlaneState &state, Bundle &bundle) {
+	uint32 n = readBundleCount(state, bundle);
 	if (n == 0)
 		return;
 
@@ -1129,12 +1293,12 @@ void BinkDecoder::BinkVideoTrack::readColors(VideoFrame &video, Bundle &bundle)
 	if (decEnd > bundle.dataEnd)
 		error("Too many color values");
 
-	if (video.bits->getBit()) {
-		_colLastVal = getHuffmanSymbol(video, _colHighHuffman[_colLastVal]);
+	if (state.bits->getBit()) {
+		state.colLastVal = getHuffmanSymbol(state, state.colHighHuffman[state.colLastVal]);
 
 		byte v;
-		v = getHuffmanSymbol(video, bundle.huffman);
-		v = (_colLastVal << 4) | v;
+		v = getHuffmanSymbol(state, bundle.huffman);
+		v = (state.colLastVal << 4) | v;
 
 		if (_id != kBIKiID) {
 			int sign = ((int8) v) >> 7;
@@ -1149,11 +1313,11 @@ void BinkDecoder::BinkVideoTrack::readColors(VideoFrame &video, Bundle &bundle)
 	}
 
 	while (bundle.curDec < decEnd) {
-		_colLastVal = getHuffmanSymbol(video, _colHighHuffman[_colLastVal]);
+		state.colLastVal = getHuffmanSymbol(state, state.colHighHuffman[state.colLastVal]);
 
 		byte v;
-		v = getHuffmanSymbol(video, bundle.huffman);
-		v = (_colLastVal << 4) | v;
+		v = getHuffmanSymbol(state, bundle.huffman);
+		v = (state.colLastVal << 4) | v;
 
 		if (_id != kBIKiID) {
 			int sign = ((int8) v) >> 7;
@@ -1165,16 +1329,16 @@ void BinkDecoder::BinkVideoTrack::readColors(VideoFrame &video, Bundle &bundle)
 }
 
 template<int startBits, bool hasSign>
-void BinkDecoder::BinkVideoTrack::readDCS(VideoFrame &video, Bundle &bundle) {
-	uint32 length = readBundleCount(video, bundle);
+void BinkDecoder::BinkVideoTrack::readDCS(PlaneState &state, Bundle &bundle) {
+	uint32 length = readBundleCount(state, bundle);
 	if (length == 0)
 		return;
 
 	int16 *dest = (int16 *) bundle.curDec;
 
-	int32 v = video.bits->getBits<startBits - (hasSign ? 1 : 0)>();
+	int32 v = state.bits->getBits<startBits - (hasSign ? 1 : 0)>();
 	if (v && hasSign) {
-		int sign = -(int)video.bits->getBit();
+		int sign = -(int)state.bits->getBit();
 		v = (v ^ sign) - sign;
 	}
 
@@ -1184,14 +1348,14 @@ void BinkDecoder::BinkVideoTrack::readDCS(VideoFrame &video, Bundle &bundle) {
 	for (uint32 i = 0; i < length; i += 8) {
 		uint32 length2 = MIN<uint32>(length - i, 8);
 
-		byte bSize = video.bits->getBits<4>();
+		byte bSize = state.bits->getBits<4>();
 
 		if (bSize) {
 
 			for (uint32 j = 0; j < length2; j++) {
-				int16 v2 = video.bits->getBits(bSize);
+				int16 v2 = state.bits->getBits(bSize);
 				if (v2) {
-					int sign = -(int)video.bits->getBit();
+					int sign = -(int)state.bits->getBit();
 					v2 = (v2 ^ sign) - sign;
 				}
 
@@ -1211,7 +1375,7 @@ void BinkDecoder::BinkVideoTrack::readDCS(VideoFrame &video, Bundle &bundle) {
 }
 
 /** Reads 8x8 block of DCT coefficients. */
-void BinkDecoder::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int32 *block, bool isIntra) {
+void BinkDecoder::BinkVideoTrack::readDCTCoeffs(PlaneState &state, int32 *block, bool isIntra) {
 	int coefCount = 0;
 	int coefIdx[64];
 
@@ -1226,13 +1390,13 @@ void BinkDecoder::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int32 *block,
 	coefList[listEnd] = 2;  modeList[listEnd++] = 3;
 	coefList[listEnd] = 3;  modeList[listEnd++] = 3;
 
-	int bits = video.bits->getBits<4>() - 1;
+	int bits = state.bits->getBits<4>() - 1;
 	for (int mask = bits >= 0 ? 1 << bits : 0; bits >= 0; mask >>= 1, bits--) {
 		int listPos = listStart;
 
 		while (listPos < listEnd) {
 
-			if (!(modeList[listPos] | coefList[listPos]) || !video.bits->getBit()) {
+			if (!(modeList[listPos] | coefList[listPos]) || !state.bits->getBit()) {
 				listPos++;
 				continue;
 			}
@@ -1251,17 +1415,17 @@ void BinkDecoder::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int32 *block,
 					modeList[listPos++] = 0;
 				}
 				for (int i = 0; i < 4; i++, ccoef++) {
-					if (video.bits->getBit()) {
+					if (state.bits->getBit()) {
 						coefList[--listStart] = ccoef;
 						modeList[  listStart] = 3;
 					} else {
 						int t;
 						if (!bits) {
-							t = 1 - (video.bits->getBit() << 1);
+							t = 1 - (state.bits->getBit() << 1);
 						} else {
-							t = video.bits->getBits(bits) | mask;
+							t = state.bits->getBits(bits) | mask;
 
-							int sign = -(int)video.bits->getBit();
+							int sign = -(int)state.bits->getBit();
 							t = (t ^ sign) - sign;
 						}
 						block[binkScan[ccoef]] = t;
@@ -1282,11 +1446,11 @@ void BinkDecoder::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int32 *block,
 			case 3:
 				int t;
 				if (!bits) {
-					t = 1 - (video.bits->getBit() << 1);
+					t = 1 - (state.bits->getBit() << 1);
 				} else {
-					t = video.bits->getBits(bits) | mask;
+					t = state.bits->getBits(bits) | mask;
 
-					int sign = -(int)video.bits->getBit();
+					int sign = -(int)state.bits->getBit();
 					t = (t ^ sign) - sign;
 				}
 				block[binkScan[ccoef]] = t;
@@ -1301,7 +1465,7 @@ void BinkDecoder::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int32 *block,
 		}
 	}
 
-	uint8 quantIdx = video.bits->getBits<4>();
+	uint8 quantIdx = state.bits->getBits<4>();
 	const int32 *quant = isIntra ? binkIntraQuant[quantIdx] : binkInterQuant[quantIdx];
 	block[0] = (block[0] * quant[0]) >> 11;
 
@@ -1313,7 +1477,7 @@ void BinkDecoder::BinkVideoTrack::readDCTCoeffs(VideoFrame &video, int32 *block,
 }
 
 /** Reads 8x8 block with residue after motion compensation. */
-void BinkDecoder::BinkVideoTrack::readResidue(VideoFrame &video, int16 *block, int masksCount) {
+void BinkDecoder::BinkVideoTrack::readResidue(PlaneState &state, int16 *block, int masksCount) {
 	int nzCoeff[64];
 	int nzCoeffCount = 0;
 
@@ -1326,10 +1490,10 @@ void BinkDecoder::BinkVideoTrack::readResidue(VideoFrame &video, int16 *block, i
 	coefList[listEnd] = 44; modeList[listEnd++] = 0;
 	coefList[listEnd] =  0; modeList[listEnd++] = 2;
 
-	for (int mask = 1 << video.bits->getBits<3>(); mask; mask >>= 1) {
+	for (int mask = 1 << state.bits->getBits<3>(); mask; mask >>= 1) {
 
 		for (int i = 0; i < nzCoeffCount; i++) {
-			if (!video.bits->getBit())
+			if (!state.bits->getBit())
 				continue;
 			if (block[nzCoeff[i]] < 0)
 				block[nzCoeff[i]] -= mask;
@@ -1343,7 +1507,7 @@ void BinkDecoder::BinkVideoTrack::readResidue(VideoFrame &video, int16 *block, i
 		int listPos = listStart;
 		while (listPos < listEnd) {
 
-			if (!(coefList[listPos] | modeList[listPos]) || !video.bits->getBit()) {
+			if (!(coefList[listPos] | modeList[listPos]) || !state.bits->getBit()) {
 				listPos++;
 				continue;
 			}
@@ -1363,13 +1527,13 @@ void BinkDecoder::BinkVideoTrack::readResidue(VideoFrame &video, int16 *block, i
 				}
 
 				for (int i = 0; i < 4; i++, ccoef++) {
-					if (video.bits->getBit()) {
+					if (state.bits->getBit()) {
 						coefList[--listStart] = ccoef;
 						modeList[  listStart] = 3;
 					} else {
 						nzCoeff[nzCoeffCount++] = binkScan[ccoef];
 
-						int sign = -(int)video.bits->getBit();
+						int sign = -(int)state.bits->getBit();
 						block[binkScan[ccoef]] = (mask ^ sign) - sign;
 
 						masksCount--;
@@ -1392,7 +1556,7 @@ void BinkDecoder::BinkVideoTrack::readResidue(VideoFrame &video, int16 *block, i
 				{
 					nzCoeff[nzCoeffCount++] = binkScan[ccoef];
 
-					int sign = -(int)video.bits->getBit();
+					int sign = -(int)state.bits->getBit();
 					block[binkScan[ccoef]] = (mask ^ sign) - sign;
 
 					coefList[listPos]   = 0;
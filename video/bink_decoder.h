@@ -162,15 +162,17 @@ private:
 		bool rewind() override;
 		void setCurFrame(uint32 frame) { _curFrame = frame; }
 
-		/** Decode a video packet. */
-		void decodePacket(VideoFrame &frame);
+		/** Decode a video packet, which was read into @p data. */
+		void decodePacket(VideoFrame &frame, const byte *data, uint32 size);
 
 		Common::Rational getFrameRate() const override { return _frameRate; }
 
 	private:
+		struct PlaneState;
+
 		/** A decoder state. */
 		struct DecodeContext {
-			VideoFrame *video;
+			PlaneState *state;
 
 			uint32 planeIdx;
 
@@ -241,6 +243,29 @@ private:
 			byte *curPtr; ///< Pointer to the data that wasn't yet read.
 		};
 
+		/**
+		 * Everything changed while decoding a plane. The alpha plane uses a
+		 * state of its own, so that it can be decoded along with the others.
+		 */
+		struct PlaneState {
+			Common::BitStream32LELSB *bits; ///< The bitstream of the plane.
+
+			Bundle bundles[kSourceMAX]; ///< Bundles for decoding all data types.
+
+			/** Huffman codebooks to use for decoding high nibbles in color data types. */
+			Huffman colHighHuffman[16];
+			/** Value of the last decoded high nibble in color data types. */
+			int colLastVal;
+		};
+
+		/** How the offset before a group of planes in Bink 'i' is stored. */
+		enum PlaneOffsetMode {
+			kPlaneOffsetUnknown,  ///< Not checked yet.
+			kPlaneOffsetAbsolute, ///< Byte offset from the start of the packet.
+			kPlaneOffsetRelative, ///< Byte offset from the end of the offset field.
+			kPlaneOffsetInvalid   ///< Does not point to the next plane.
+		};
+
 		int _curFrame;
 		int _frameCount;
 
@@ -258,14 +283,14 @@ private:
 
 		Common::Rational _frameRate;
 
-		Bundle _bundles[kSourceMAX]; ///< Bundles for decoding all data types.
+		PlaneState _planeStates[2]; ///< The states of the color planes and of the alpha plane.
 
 		Common::Huffman<Common::BitStream32LELSB> *_huffman[16]; ///< The 16 Huffman codebooks used in Bink decoding.
 
-		/** Huffman codebooks to use for decoding high nibbles in color data types. */
-		Huffman _colHighHuffman[16];
-		/** Value of the last decoded high nibble in color data types. */
-		int _colLastVal;
+		PlaneOffsetMode _planeOffsetMode; ///< How to find the color planes without decoding the alpha plane first.
+		uint32 _planeOffsetMatches;       ///< Frames in which the offset of the color planes was checked.
+
+		int _convertBandHeight; ///< Lines converted from YUV at once, an even number.
 
 		uint32 _yBlockWidth;   ///< Width of the Y plane in blocks
 		uint32 _yBlockHeight;  ///< Height of the Y plane in blocks
@@ -283,24 +308,42 @@ private:
 		/** Initialize the Huffman decoders. */
 		void initHuffman();
 
+		/** Decode the Y, U and V planes. */
+		void decodeColorPlanes(PlaneState &state);
+		/**
+		 * Decode the alpha plane and the color planes starting at @p start
+		 * at the same time. Returns false if the alpha plane did not end at
+		 * @p start, so that the color planes have to be decoded again.
+		 */
+		bool decodePlanesConcurrently(const byte *data, uint32 size, uint32 start);
+		static void decodeAlphaPlaneProc(void *param, uint worker);
 		/** Decode a plane. */
-		void decodePlane(VideoFrame &video, int planeIdx, bool isChroma);
+		void decodePlane(PlaneState &state, int planeIdx, bool isChroma);
+		/** Predict where the color planes start in a Bink 'i' packet with alpha, or return 0. */
+		uint32 predictColorPlanesStart(uint32 fieldPos, uint32 offset) const;
+		/** Check a prediction from predictColorPlanesStart() against the actual start. */
+		void checkColorPlanesStart(uint32 fieldPos, uint32 offset, uint32 start);
+		/** Convert the decoded planes into the surface. */
+		void convertPlanes();
+		/** Convert a band of lines of the decoded planes into the surface. */
+		void convertBand(uint index);
+		static void convertBandProc(void *param, uint begin, uint end, uint worker);
 
 		/** Read/Initialize a bundle for decoding a plane. */
-		void readBundle(VideoFrame &video, Source source);
+		void readBundle(PlaneState &state, Source source);
 
 		/** Read the symbols for a Huffman code. */
-		void readHuffman(VideoFrame &video, Huffman &huffman);
+		void readHuffman(PlaneState &state, Huffman &huffman);
 		/** Merge two Huffman symbol lists. */
-		void mergeHuffmanSymbols(VideoFrame &video, byte *dst, const byte *src, int size);
+		void mergeHuffmanSymbols(PlaneState &state, byte *dst, const byte *src, int size);
 
 		/** Read and translate a symbol out of a Huffman code. */
-		byte getHuffmanSymbol(VideoFrame &video, Huffman &huffman);
+		byte getHuffmanSymbol(PlaneState &state, Huffman &huffman);
 
 		/** Get a direct value out of a bundle. */
-		int32 getBundleValue(Source source);
+		int32 getBundleValue(PlaneState &state, Source source);
 		/** Read a count value out of a bundle. */
-		uint32 readBundleCount(VideoFrame &video, Bundle &bundle);
+		uint32 readBundleCount(PlaneState &state, Bundle &bundle);
 
 		// Handle the block types
 		void blockSkip         (DecodeContext &ctx);
@@ -321,15 +364,15 @@ private:
 		void blockRaw          (DecodeContext &ctx);
 
 		// Read the bundles
-		void readRuns        (VideoFrame &video, Bundle &bundle);
-		void readMotionValues(VideoFrame &video, Bundle &bundle);
-		void readBlockTypes  (VideoFrame &video, Bundle &bundle);
-		void readPatterns    (VideoFrame &video, Bundle &bundle);
-		void readColors      (VideoFrame &video, Bundle &bundle);
+		void readRuns        (PlaneState &state, Bundle &bundle);
+		void readMotionValues(PlaneState &state, Bundle &bundle);
+		void readBlockTypes  (PlaneState &state, Bundle &bundle);
+		void readPatterns    (PlaneState &state, Bundle &bundle);
+		void readColors      (PlaneState &state, Bundle &bundle);
 		template<int startBits, bool hasSign>
-		void readDCS         (VideoFrame &video, Bundle &bundle);
-		void readDCTCoeffs   (VideoFrame &video, int32 *block, bool isIntra);
-		void readResidue     (VideoFrame &video, int16 *block, int masksCount);
+		void readDCS         (PlaneState &state, Bundle &bundle);
+		void readDCTCoeffs   (PlaneState &state, int32 *block, bool isIntra);
+		void readResidue     (PlaneState &state, int16 *block, int masksCount);
 
 		// Bink video IDCT
 		void IDCT(int32 *block);
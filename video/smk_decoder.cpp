@@ -46,6 +46,20 @@ enum SmkBlockTypes {
 	SMK_BLOCK_FILL = 3
 };
 
+/*
+ * Both Huffman trees decode through a lookup table indexed with the next
+ * kLookupBits bits of the stream. An entry holds the length of the code
+ * and either the decoded value, or the tree node reached after kLookupBits
+ * bits for longer codes, which are walked bit by bit from there.
+ */
+
+enum {
+	SMK_LOOKUP_LENGTH = 0x0f,
+	SMK_LOOKUP_NODE   = 0x10,	// Payload is a tree node to continue at
+	SMK_LOOKUP_LAST   = 0x20,	// Payload is a tree slot holding a recently used value
+	SMK_LOOKUP_SHIFT  = 8
+};
+
 /*
  * class SmallHuffmanTree
  * A Huffman-tree to hold 8-bit values.
@@ -58,7 +72,8 @@ public:
 	uint16 getCode(SmackerBitStream &bs);
 private:
 	enum {
-		SMK_NODE = 0x8000
+		SMK_NODE = 0x8000,
+		kLookupBits = 10
 	};
 
 	uint16 decodeTree(uint32 prefix, int length);
@@ -66,8 +81,7 @@ private:
 	uint16 _treeSize;
 	uint16 _tree[511];
 
-	uint16 _prefixtree[256];
-	byte _prefixlength[256];
+	uint32 _lookup[1 << kLookupBits];
 
 	SmackerBitStream &_bs;
 	bool _empty;
@@ -80,8 +94,7 @@ SmallHuffmanTree::SmallHuffmanTree(SmackerBitStream &bs)
 		return;
 	}
 
-	for (uint16 i = 0; i < 256; ++i)
-		_prefixtree[i] = _prefixlength[i] = 0;
+	memset(_lookup, 0, sizeof(_lookup));
 
 	decodeTree(0, 0);
 
@@ -95,11 +108,10 @@ uint16 SmallHuffmanTree::decodeTree(uint32 prefix, int length) {
 	if (!_bs.getBit()) { // Leaf
 		_tree[_treeSize] = _bs.getBits<8>();
 
-		if (length <= 8) {
-			for (int i = 0; i < 256; i += (1 << length)) {
-				_prefixtree[prefix | i] = _treeSize;
-				_prefixlength[prefix | i] = length;
-			}
+		if (length <= kLookupBits) {
+			const uint32 entry = (_tree[_treeSize] << SMK_LOOKUP_SHIFT) | length;
+			for (int i = 0; i < (1 << kLookupBits); i += (1 << length))
+				_lookup[prefix | i] = entry;
 		}
 		++_treeSize;
 
@@ -108,10 +120,8 @@ uint16 SmallHuffmanTree::decodeTree(uint32 prefix, int length) {
 
 	uint16 t = _treeSize++;
 
-	if (length == 8) {
-		_prefixtree[prefix] = t;
-		_prefixlength[prefix] = 8;
-	}
+	if (length == kLookupBits)
+		_lookup[prefix] = (t << SMK_LOOKUP_SHIFT) | SMK_LOOKUP_NODE | kLookupBits;
 
 	uint16 r1 = decodeTree(prefix, length + 1);
 
@@ -129,10 +139,13 @@ uint16 SmallHuffmanTree::getCode(SmackerBitStream &bs) {
 	// Peeking data out of bounds is well-defined and returns 0 bits.
 	// This is for convenience when using speed-up techniques reading
 	// more bits than actually available.
-	byte peek = bs.peekBits<8>();
-	uint16 *p = &_tree[_prefixtree[peek]];
-	bs.skip(_prefixlength[peek]);
+	const uint32 entry = _lookup[bs.peekBits<kLookupBits>()];
+	bs.skip(entry & SMK_LOOKUP_LENGTH);
+
+	if (!(entry & SMK_LOOKUP_NODE))
+		return entry >> SMK_LOOKUP_SHIFT;
 
+	const uint16 *p = &_tree[entry >> SMK_LOOKUP_SHIFT];
 	while (*p & SMK_NODE) {
 		if (bs.getBit())
 			p += *p & ~SMK_NODE;
@@ -159,14 +172,17 @@ private:
 		SMK_NODE = 0x80000000
 	};
 
+	enum {
+		kLookupBits = 12
+	};
+
 	uint32 decodeTree(uint32 prefix, int length);
 
 	uint32  _treeSize;
 	uint32 *_tree;
 	uint32  _last[3];
 
-	uint32 _prefixtree[256];
-	byte _prefixlength[256];
+	uint32 *_lookup;
 
 	/* Used during construction */
 	SmackerBitStream &_bs;
@@ -177,16 +193,21 @@ private:
 
 BigHuffmanTree::BigHuffmanTree(SmackerBitStream &bs, int allocSize)
 	: _bs(bs) {
+	_lookup = new uint32[1 << kLookupBits];
+
 	uint32 bit = _bs.getBit();
 	if (!bit) {
 		_tree = new uint32[1];
 		_tree[0] = 0;
 		_last[0] = _last[1] = _last[2] = 0;
+
+		// Every code is the empty code of the (zero) value in slot 0
+		for (uint32 i = 0; i < (1 << kLookupBits); ++i)
+			_lookup[i] = SMK_LOOKUP_LAST;
 		return;
 	}
 
-	for (uint32 i = 0; i < 256; ++i)
-		_prefixtree[i] = _prefixlength[i] = 0;
+	memset(_lookup, 0, (1 << kLookupBits) * sizeof(uint32));
 
 	_loBytes = new SmallHuffmanTree(_bs);
 	_hiBytes = new SmallHuffmanTree(_bs);
@@ -214,6 +235,7 @@ BigHuffmanTree::BigHuffmanTree(SmackerBitStream &bs, int allocSize)
 }
 
 BigHuffmanTree::~BigHuffmanTree() {
+	delete[] _lookup;
 	delete[] _tree;
 }
 
@@ -232,19 +254,21 @@ uint32 BigHuffmanTree::decodeTree(uint32 prefix, int length) {
 
 		_tree[_treeSize] = v;
 
-		if (length <= 8) {
-			for (int i = 0; i < 256; i += (1 << length)) {
-				_prefixtree[prefix | i] = _treeSize;
-				_prefixlength[prefix | i] = length;
-			}
-		}
-
+		// Leaves of the marker values hold the recently used values, which
+		// change while decoding, so their entries refer to the tree slot
+		uint32 entry = (v << SMK_LOOKUP_SHIFT) | length;
 		for (int i = 0; i < 3; ++i) {
 			if (_markers[i] == v) {
 				_last[i] = _treeSize;
 				_tree[_treeSize] = 0;
+				entry = (_treeSize << SMK_LOOKUP_SHIFT) | SMK_LOOKUP_LAST | length;
 			}
 		}
+
+		if (length <= kLookupBits) {
+			for (int i = 0; i < (1 << kLookupBits); i += (1 << length))
+				_lookup[prefix | i] = entry;
+		}
 		++_treeSize;
 
 		return 1;
@@ -252,10 +276,8 @@ uint32 BigHuffmanTree::decodeTree(uint32 prefix, int length) {
 
 	uint32 t = _treeSize++;
 
-	if (length == 8) {
-		_prefixtree[prefix] = t;
-		_prefixlength[prefix] = 8;
-	}
+	if (length == kLookupBits)
+		_lookup[prefix] = (t << SMK_LOOKUP_SHIFT) | SMK_LOOKUP_NODE | kLookupBits;
 
 	uint32 r1 = decodeTree(prefix, length + 1);
 
@@ -269,17 +291,22 @@ uint32 BigHuffmanTree::getCode(SmackerBitStream &bs) {
 	// Peeking data out of bounds is well-defined and returns 0 bits.
 	// This is for convenience when using speed-up techniques reading
 	// more bits than actually available.
-	byte peek = bs.peekBits<8>();
-	uint32 *p = &_tree[_prefixtree[peek]];
-	bs.skip(_prefixlength[peek]);
+	const uint32 entry = _lookup[bs.peekBits<kLookupBits>()];
+	bs.skip(entry & SMK_LOOKUP_LENGTH);
 
-	while (*p & SMK_NODE) {
-		if (bs.getBit())
-			p += (*p) & ~SMK_NODE;
-		p++;
+	uint32 v;
+	if (!(entry & (SMK_LOOKUP_NODE | SMK_LOOKUP_LAST))) {
+		v = entry >> SMK_LOOKUP_SHIFT;
+	} else {
+		const uint32 *p = &_tree[entry >> SMK_LOOKUP_SHIFT];
+		while (*p & SMK_NODE) {
+			if (bs.getBit())
+				p += (*p) & ~SMK_NODE;
+			p++;
+		}
+		v = *p;
 	}
 
-	uint32 v = *p;
 	if (v != _tree[_last[0]]) {
 		_tree[_last[2]] = _tree[_last[1]];
 		_tree[_last[1]] = _tree[_last[0]];